@@ -60,6 +60,7 @@
 #include "space_upgrade.h"
 #include "box.h"
 #include "authentication.h"
+#include "compression_dict.h"
 
 /* {{{ Auxiliary functions and methods. */
 
@@ -242,6 +243,17 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->compaction_policy == compaction_policy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_policy must be one of 'tiered', "
+			 "'leveled', 'time_window'");
+		return -1;
+	}
+	if (opts->compaction_window <= 0) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_window must be greater than 0");
+		return -1;
+	}
 	return 0;
 }
 
@@ -526,6 +538,31 @@ space_def_new_from_tuple(struct tuple *tuple, uint32_t errcode,
 			 "local space can't be synchronous");
 		return NULL;
 	}
+	if (opts.ttl < 0) {
+		diag_set(ClientError, errcode, tt_cstr(name, name_len),
+			 "ttl must be non-negative");
+		return NULL;
+	}
+	if (opts.ttl > 0 && opts.ttl_field == UINT32_MAX) {
+		diag_set(ClientError, errcode, tt_cstr(name, name_len),
+			 "ttl_field must be set if ttl is set");
+		return NULL;
+	}
+	if (opts.ttl > 0 && opts.ttl_field < field_count) {
+		switch (fields[opts.ttl_field].type) {
+		case FIELD_TYPE_ANY:
+		case FIELD_TYPE_UNSIGNED:
+		case FIELD_TYPE_INTEGER:
+		case FIELD_TYPE_DOUBLE:
+		case FIELD_TYPE_NUMBER:
+		case FIELD_TYPE_SCALAR:
+			break;
+		default:
+			diag_set(ClientError, errcode, tt_cstr(name, name_len),
+				 "ttl_field must be of a numeric type");
+			return NULL;
+		}
+	}
 	if (space_opts_is_temporary(&opts) && opts.constraint_count > 0) {
 		diag_set(ClientError, ER_UNSUPPORTED, "temporary space",
 			 "constraints");
@@ -4093,6 +4130,66 @@ stop_synchro_filtering(va_list /* ap */)
 	return 0;
 }
 
+/** A compression dictionary stored in a _schema row. */
+struct compression_dict_row {
+	uint32_t space_id;
+	struct tt_compression_dict *dict;
+	uint64_t tuple_count;
+};
+
+/** Start using a new compression dictionary on commit. */
+static int
+on_commit_compression_dict_insert(struct trigger *trigger, void * /* event */)
+{
+	struct compression_dict_row *row =
+		(struct compression_dict_row *)trigger->data;
+	compression_dict_set(row->space_id, row->dict, row->tuple_count);
+	return 0;
+}
+
+/** Stop using a deleted compression dictionary on commit. */
+static int
+on_commit_compression_dict_delete(struct trigger *trigger, void * /* event */)
+{
+	struct compression_dict_row *row =
+		(struct compression_dict_row *)trigger->data;
+	compression_dict_unset(row->space_id, row->dict);
+	return 0;
+}
+
+/**
+ * Handle a change of a _schema row storing a compression dictionary.
+ * The dictionary is registered right away so that it can't be
+ * replaced with another dictionary with the same identifier, but
+ * it's used for compression only after commit. Deleted dictionaries
+ * stay registered, because there may still be data compressed with
+ * them.
+ */
+static int
+on_replace_dd_compression_dict(struct txn_stmt *stmt)
+{
+	if (stmt->old_tuple != NULL && stmt->new_tuple != NULL) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Space _schema",
+			 "updates of compression dictionaries");
+		return -1;
+	}
+	struct tuple *tuple = stmt->new_tuple != NULL ?
+			      stmt->new_tuple : stmt->old_tuple;
+	struct compression_dict_row *row = xregion_alloc_object(
+		&in_txn()->region, struct compression_dict_row);
+	row->dict = compression_dict_decode(tuple, &row->space_id,
+					    &row->tuple_count);
+	if (row->dict == NULL)
+		return -1;
+	struct trigger *on_commit = txn_alter_trigger_new(
+		stmt->new_tuple != NULL ? on_commit_compression_dict_insert :
+		on_commit_compression_dict_delete, row);
+	if (on_commit == NULL)
+		return -1;
+	txn_stmt_on_commit(stmt, on_commit);
+	return 0;
+}
+
 /**
  * This trigger is invoked only upon initial recovery, when
  * reading contents of the system spaces from the snapshot.
@@ -4163,6 +4260,9 @@ on_replace_dd_schema(struct trigger * /* trigger */, void *event)
 				return -1;
 			fiber_wakeup(fiber);
 		}
+	} else if (strncmp(key, COMPRESSION_DICT_KEY_PREFIX,
+			   strlen(COMPRESSION_DICT_KEY_PREFIX)) == 0) {
+		return on_replace_dd_compression_dict(stmt);
 	}
 	return 0;
 }
@@ -62,6 +62,10 @@
 #include "tt_static.h"
 #include "memory.h"
 #include "ssl_error.h"
+#include "assoc.h"
+#include "index.h"
+#include "space.h"
+#include "tuple.h"
 
 STRS(applier_state, applier_STATE);
 
@@ -1234,6 +1238,21 @@ applier_txn_rollback_cb(struct trigger *trigger, void *event)
 	return 0;
 }
 
+/**
+ * Same as applier_txn_rollback_cb(), but used for transactions applied in
+ * parallel with other transactions. Such a transaction may be aborted on
+ * commit because of a conflict with a concurrent transaction, in which case
+ * it is retried so there's no need to stop appliers.
+ */
+static int
+applier_parallel_txn_rollback_cb(struct trigger *trigger, void *event)
+{
+	struct txn *txn = (struct txn *)event;
+	if (txn->signature == TXN_SIGNATURE_ABORT)
+		return 0;
+	return applier_txn_rollback_cb(trigger, event);
+}
+
 struct replica_cb_data {
 	/** Replica ID the data belongs to. */
 	uint32_t replica_id;
@@ -1378,9 +1397,13 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows,
-	       bool skip_conflict, bool use_triggers)
+/**
+ * Begin a transaction and apply all rows of the given queue in it.
+ * Returns the transaction ready to be committed with
+ * apply_plain_tx_commit() or NULL on error.
+ */
+static struct txn *
+apply_plain_tx_begin(struct stailq *rows, bool skip_conflict)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1391,7 +1414,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 	txn->isolation = TXN_ISOLATION_READ_COMMITTED;
 
 	stailq_foreach_entry(item, rows, next) {
@@ -1434,8 +1457,22 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 			 "distributed transactions");
 		goto fail;
 	}
+	return txn;
+fail:
+	txn_abort(txn);
+	return NULL;
+}
 
-	if (use_triggers) {
+/**
+ * Commit a transaction started with apply_plain_tx_begin() without waiting
+ * for WAL write. If @a on_rollback_f is not NULL, WAL write and rollback
+ * triggers are set for the transaction, the latter running @a on_rollback_f.
+ */
+static int
+apply_plain_tx_commit(struct txn *txn, uint32_t replica_id,
+		      struct stailq *rows, trigger_f on_rollback_f)
+{
+	if (on_rollback_f != NULL) {
 		/* We are ready to submit txn to wal. */
 		struct trigger *on_rollback, *on_wal_write;
 		size_t size;
@@ -1456,7 +1493,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 			goto fail;
 		}
 
-		trigger_create(on_rollback, applier_txn_rollback_cb, NULL, NULL);
+		trigger_create(on_rollback, on_rollback_f, NULL, NULL);
 		txn_on_rollback(txn, on_rollback);
 
 		/*
@@ -1466,7 +1503,8 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		 * transaction traversed network + remote WAL bundle before
 		 * ack get received.
 		 */
-		item = stailq_last_entry(rows, struct applier_tx_row, next);
+		struct applier_tx_row *item =
+			stailq_last_entry(rows, struct applier_tx_row, next);
 		rcb->replica_id = replica_id;
 		rcb->txn_last_tm = item->row.tm;
 
@@ -1480,6 +1518,17 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	return -1;
 }
 
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows,
+	       bool skip_conflict, bool use_triggers)
+{
+	struct txn *txn = apply_plain_tx_begin(rows, skip_conflict);
+	if (txn == NULL)
+		return -1;
+	return apply_plain_tx_commit(txn, replica_id, rows, use_triggers ?
+				     applier_txn_rollback_cb : NULL);
+}
+
 /** A simpler version of applier_apply_tx() for final join stage. */
 static int
 apply_final_join_tx(uint32_t replica_id, struct stailq *rows)
@@ -1880,6 +1929,326 @@ applier_handle_raft(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+/** Max number of transactions in a group applied in parallel. */
+enum { APPLIER_TX_GROUP_MAX = 1024 };
+
+/**
+ * A group of consecutive transactions that originate from the same instance
+ * and don't modify the same primary keys. Rows of such transactions are
+ * applied by a few fibers concurrently, which lets vinyl transactions wait
+ * for disk reads in parallel, while the transactions are still submitted to
+ * WAL one by one in the original order.
+ */
+struct applier_tx_group {
+	/** Applier that received the transactions. */
+	struct applier *applier;
+	/** ID of the instance the transactions originate from. */
+	uint32_t replica_id;
+	/** Order latch of the instance the transactions originate from. */
+	struct latch *latch;
+	/** Transactions of the group in the commit order. */
+	struct applier_tx **txs;
+	/** Number of transactions in the group. */
+	uint32_t tx_count;
+	/** Index of the next transaction to be picked by a worker fiber. */
+	uint32_t next;
+	/** Number of transactions submitted to WAL. */
+	uint32_t committed;
+	/**
+	 * Set of primary keys modified by the group. A key is identified
+	 * by its hash combined with the space id, so a hash collision may
+	 * only result in an excessive group split.
+	 */
+	struct mh_i64ptr_t *keys;
+	/** Signalled when a transaction is submitted to WAL or fails. */
+	struct fiber_cond cond;
+	/** Set if a transaction of the group failed to apply. */
+	bool is_failed;
+	/** Error of the failed transaction. */
+	struct diag diag;
+};
+
+static void
+applier_tx_group_create(struct applier_tx_group *group,
+			struct applier *applier)
+{
+	memset(group, 0, sizeof(*group));
+	group->applier = applier;
+	group->txs = xregion_alloc_array(&fiber()->gc, struct applier_tx *,
+					 APPLIER_TX_GROUP_MAX);
+	group->keys = mh_i64ptr_new();
+	fiber_cond_create(&group->cond);
+	diag_create(&group->diag);
+}
+
+static void
+applier_tx_group_destroy(struct applier_tx_group *group)
+{
+	assert(group->tx_count == 0);
+	mh_i64ptr_delete(group->keys);
+	fiber_cond_destroy(&group->cond);
+	diag_destroy(&group->diag);
+}
+
+/**
+ * Hash the primary key modified by a DML row. Returns -1 if the row can't
+ * be applied in parallel.
+ */
+static int
+applier_tx_row_key_hash(struct applier_tx_row *item, uint64_t *hash)
+{
+	struct xrow_header *row = &item->row;
+	struct request *req = &item->req.dml;
+	if (row->type != IPROTO_INSERT && row->type != IPROTO_REPLACE &&
+	    row->type != IPROTO_UPSERT && row->type != IPROTO_UPDATE &&
+	    row->type != IPROTO_DELETE)
+		return -1;
+	struct space *space = space_by_id(req->space_id);
+	/*
+	 * Memtx transactions can't yield unless MVCC is enabled and don't
+	 * read disk anyway so there's no point in applying them in parallel.
+	 */
+	if (space == NULL || space_is_system(space) || !space_is_vinyl(space))
+		return -1;
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL)
+		return -1;
+	struct key_def *key_def = pk->def->key_def;
+	const char *key;
+	if (row->type == IPROTO_UPDATE || row->type == IPROTO_DELETE) {
+		if (req->index_id != 0)
+			return -1;
+		key = req->key;
+	} else {
+		if (mp_typeof(*req->tuple) != MP_ARRAY)
+			return -1;
+		uint32_t key_size;
+		key = tuple_extract_key_raw(req->tuple, req->tuple_end,
+					    key_def, MULTIKEY_NONE,
+					    &key_size);
+		if (key == NULL) {
+			diag_clear(diag_get());
+			return -1;
+		}
+	}
+	if (mp_typeof(*key) != MP_ARRAY)
+		return -1;
+	uint32_t part_count = mp_decode_array(&key);
+	if (exact_key_validate(key_def, key, part_count) != 0) {
+		/* Let the regular apply path report the error. */
+		diag_clear(diag_get());
+		return -1;
+	}
+	*hash = (uint64_t)req->space_id << 32 | key_hash(key, key_def);
+	return 0;
+}
+
+/**
+ * Try to add a transaction to a group. Returns false if the transaction
+ * can't be applied in parallel with the transactions of the group, in
+ * which case the group must be applied before the transaction.
+ */
+static bool
+applier_tx_group_add(struct applier_tx_group *group, struct applier_tx *tx)
+{
+	struct applier *applier = group->applier;
+	if (replication_apply_concurrency <= 1 ||
+	    group->tx_count == APPLIER_TX_GROUP_MAX ||
+	    (applier->state != APPLIER_SYNC &&
+	     applier->state != APPLIER_FOLLOW))
+		return false;
+	struct xrow_header *first_row =
+		&stailq_first_entry(&tx->rows, struct applier_tx_row,
+				    next)->row;
+	struct xrow_header *last_row =
+		&stailq_last_entry(&tx->rows, struct applier_tx_row,
+				   next)->row;
+	if (last_row->lsn == 0 ||
+	    (group->tx_count > 0 &&
+	     first_row->replica_id != group->replica_id))
+		return false;
+	/*
+	 * Only transactions that applier_synchro_filter_tx() would leave
+	 * intact are applied in parallel.
+	 */
+	if (latch_is_locked(&txn_limbo.promote_latch) ||
+	    txn_limbo_replica_term(&txn_limbo, last_row->replica_id) !=
+	    txn_limbo.promote_greatest_term)
+		return false;
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t key_count = 0;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, &tx->rows, next)
+		key_count++;
+	uint64_t *keys = xregion_alloc_array(region, uint64_t, key_count);
+	key_count = 0;
+	bool ok = true;
+	stailq_foreach_entry(item, &tx->rows, next) {
+		if (item->row.wait_sync ||
+		    applier_tx_row_key_hash(item, &keys[key_count]) != 0) {
+			ok = false;
+			break;
+		}
+		if (mh_i64ptr_find(group->keys, keys[key_count],
+				   NULL) != mh_end(group->keys)) {
+			ok = false;
+			break;
+		}
+		key_count++;
+	}
+	if (!ok)
+		goto out;
+	if (group->tx_count == 0) {
+		struct replica *replica = replica_by_id(first_row->replica_id);
+		group->replica_id = first_row->replica_id;
+		group->latch = replica != NULL ? &replica->order_latch :
+			       &replicaset.applier.order_latch;
+		latch_lock(group->latch);
+	}
+	/*
+	 * Transactions that have already been applied, probably partially,
+	 * are skipped by applier_apply_tx().
+	 */
+	if (vclock_get(&replicaset.applier.vclock,
+		       first_row->replica_id) >= first_row->lsn) {
+		if (group->tx_count == 0)
+			latch_unlock(group->latch);
+		ok = false;
+		goto out;
+	}
+	for (uint32_t i = 0; i < key_count; i++) {
+		struct mh_i64ptr_node_t node = {keys[i], NULL};
+		mh_i64ptr_put(group->keys, &node, NULL, NULL);
+	}
+	group->txs[group->tx_count++] = tx;
+	if (applier->version_id < version_id(2, 11, 0))
+		raft_process_heartbeat(box_raft(), applier->instance_id);
+out:
+	region_truncate(region, region_svp);
+	return ok;
+}
+
+/**
+ * Apply a transaction of a group. The rows are applied speculatively
+ * before the preceding transactions are submitted to WAL. Transactions of
+ * a group may still depend on each other, for example, via secondary
+ * unique keys, so a speculative attempt may fail or the transaction may be
+ * aborted by vinyl on commit due to a conflict. In this case the
+ * transaction is applied again once the preceding transactions have been
+ * submitted to WAL, which is exactly what the serial apply does.
+ */
+static int
+applier_tx_group_apply_tx(struct applier_tx_group *group, uint32_t i)
+{
+	struct stailq *rows = &group->txs[i]->rows;
+	uint32_t replica_id = group->applier->instance_id;
+	/* Conflicts are skipped only when the result is certain. */
+	struct txn *txn = apply_plain_tx_begin(rows, false);
+	if (txn == NULL)
+		diag_clear(diag_get());
+	while (group->committed < i && !group->is_failed)
+		fiber_cond_wait(&group->cond);
+	if (group->is_failed) {
+		if (txn != NULL) {
+			diag_set_error(diag_get(),
+				       diag_last_error(&group->diag));
+			txn_abort(txn);
+			diag_clear(diag_get());
+		}
+		return 0;
+	}
+	if (txn == NULL ||
+	    apply_plain_tx_commit(txn, replica_id, rows,
+				  applier_parallel_txn_rollback_cb) != 0) {
+		diag_clear(diag_get());
+		if (apply_plain_tx(replica_id, rows, replication_skip_conflict,
+				   true) != 0)
+			return -1;
+	}
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	vclock_follow(&replicaset.applier.vclock, last_row->replica_id,
+		      last_row->lsn);
+	group->committed++;
+	fiber_cond_broadcast(&group->cond);
+	return 0;
+}
+
+/** Worker fiber picking transactions of a group one by one. */
+static int
+applier_tx_group_f(va_list ap)
+{
+	struct applier_tx_group *group = va_arg(ap, struct applier_tx_group *);
+	while (!group->is_failed && group->next < group->tx_count) {
+		if (applier_tx_group_apply_tx(group, group->next++) != 0) {
+			group->is_failed = true;
+			diag_move(diag_get(), &group->diag);
+			fiber_cond_broadcast(&group->cond);
+		}
+	}
+	return 0;
+}
+
+static int
+applier_tx_group_call_f(struct applier_tx_group *group, ...)
+{
+	va_list ap;
+	va_start(ap, group);
+	int rc = applier_tx_group_f(ap);
+	va_end(ap);
+	return rc;
+}
+
+/**
+ * Apply all transactions of a group and make the group empty.
+ * Returns -1 if any of the transactions failed to apply.
+ */
+static int
+applier_tx_group_apply(struct applier_tx_group *group)
+{
+	if (group->tx_count == 0)
+		return 0;
+	uint32_t fiber_count = MIN(group->tx_count,
+				   (uint32_t)replication_apply_concurrency);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct fiber **fibers = xregion_alloc_array(region, struct fiber *,
+						    fiber_count);
+	uint32_t started = 0;
+	for (; started < fiber_count; started++) {
+		struct fiber *f = fiber_new_system("applier.apply",
+						   applier_tx_group_f);
+		if (f == NULL) {
+			/* The remaining fibers will do the job. */
+			diag_clear(diag_get());
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fibers[started] = f;
+		fiber_start(f, group);
+	}
+	/* Worker fibers never fail, errors are stored in the group. */
+	if (started == 0)
+		applier_tx_group_call_f(group);
+	for (uint32_t i = 0; i < started; i++)
+		fiber_join(fibers[i]);
+	region_truncate(region, region_svp);
+	latch_unlock(group->latch);
+	int rc = 0;
+	if (group->is_failed) {
+		diag_move(&group->diag, diag_get());
+		rc = -1;
+	}
+	group->tx_count = 0;
+	group->next = 0;
+	group->committed = 0;
+	group->is_failed = false;
+	mh_i64ptr_clear(group->keys);
+	return rc;
+}
+
 /**
  * The tx part of applier-in-thread machinery. Apply all the parsed
  * transactions.
@@ -1889,8 +2258,27 @@ applier_process_batch(struct cmsg *base)
 {
 	struct applier_data_msg *msg = (struct applier_data_msg *)base;
 	struct applier *applier = msg->base.applier;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct applier_tx_group group;
+	applier_tx_group_create(&group, applier);
+	auto guard = make_scoped_guard([&] {
+		applier_tx_group_destroy(&group);
+		region_truncate(region, region_svp);
+	});
 	struct applier_tx *tx;
 	stailq_foreach_entry(tx, &msg->txs, next) {
+		/*
+		 * Transactions that can be applied in parallel are collected
+		 * in a group. The group is applied as soon as a transaction
+		 * that can't be added to it is encountered.
+		 */
+		if (applier_tx_group_add(&group, tx))
+			continue;
+		if (applier_tx_group_apply(&group) != 0)
+			diag_raise();
+		if (applier_tx_group_add(&group, tx))
+			continue;
 		struct applier_tx_row *last_txr =
 			stailq_last_entry(&tx->rows, struct applier_tx_row,
 					  next);
@@ -1921,6 +2309,8 @@ applier_process_batch(struct cmsg *base)
 			applier_set_state(applier, APPLIER_FOLLOW);
 		}
 	}
+	if (applier_tx_group_apply(&group) != 0)
+		diag_raise();
 
 	/* Return the message to applier thread. */
 	cmsg_init(&msg->base.base, return_route);
@@ -46,6 +46,7 @@
 #include "iproto_constants.h"
 #include "recovery.h"
 #include "wal.h"
+#include "fio_uring.h"
 #include "relay.h"
 #include "applier.h"
 #include <rmean.h>
@@ -54,6 +55,8 @@
 #include "tuple_format.h"
 #include "session.h"
 #include "schema.h"
+#include "compression_dict.h"
+#include "space_ttl.h"
 #include "engine.h"
 #include "memtx_engine.h"
 #include "memtx_space.h"
@@ -75,6 +78,7 @@
 #include "xrow.h"
 #include "xrow_io.h"
 #include "xstream.h"
+#include "xlog_decoder.h"
 #include "authentication.h"
 #include "security.h"
 #include "path_lock.h"
@@ -1210,6 +1214,20 @@ box_check_replication_threads(void)
 	return 0;
 }
 
+static int
+box_check_replication_apply_concurrency(void)
+{
+	int count = cfg_geti("replication_apply_concurrency");
+	if (count <= 0 || count > REPLICATION_APPLY_CONCURRENCY_MAX) {
+		diag_set(ClientError, ER_CFG, "replication_apply_concurrency",
+			 tt_sprintf("must be greater than 0, less than or "
+				    "equal to %d",
+				    REPLICATION_APPLY_CONCURRENCY_MAX));
+		return -1;
+	}
+	return count;
+}
+
 /** Check bootstrap_strategy option validity. */
 static enum bootstrap_strategy
 box_check_bootstrap_strategy(void)
@@ -1463,6 +1481,21 @@ box_check_wal_mode(const char *mode_name)
 	return (enum wal_mode) mode;
 }
 
+static enum wal_io_backend
+box_check_wal_io_backend(void)
+{
+	const char *name = cfg_gets("wal_io_backend");
+	assert(name != NULL); /* checked in Lua */
+	int backend = strindex(wal_io_backend_STRS, name, WAL_IO_BACKEND_MAX);
+	if (backend == WAL_IO_BACKEND_MAX)
+		tnt_raise(ClientError, ER_CFG, "wal_io_backend", name);
+	if (backend == WAL_IO_URING && !fio_uring_is_supported()) {
+		tnt_raise(ClientError, ER_CFG, "wal_io_backend",
+			  "io_uring is not supported by this build");
+	}
+	return (enum wal_io_backend)backend;
+}
+
 static int64_t
 box_check_wal_queue_max_size(void)
 {
@@ -1510,6 +1543,17 @@ box_check_checkpoint_count(int checkpoint_count)
 	}
 }
 
+static int64_t
+box_check_wal_relay_buffer_size(void)
+{
+	int64_t size = cfg_geti64("wal_relay_buffer_size");
+	if (size < 0) {
+		tnt_raise(ClientError, ER_CFG, "wal_relay_buffer_size",
+			  "the value must be greater than or equal to 0");
+	}
+	return size;
+}
+
 static int64_t
 box_check_wal_max_size(int64_t wal_max_size)
 {
@@ -1533,6 +1577,18 @@ box_check_memory_quota(const char *quota_name)
 	return -1;
 }
 
+static double
+box_check_vinyl_compaction_io_rate_limit(void)
+{
+	double limit = cfg_getd("vinyl_compaction_io_rate_limit");
+	if (limit < 0) {
+		diag_set(ClientError, ER_CFG, "vinyl_compaction_io_rate_limit",
+			 "the value must be greater than or equal to 0");
+		return -1;
+	}
+	return limit;
+}
+
 static void
 box_check_vinyl_options(void)
 {
@@ -1572,6 +1628,8 @@ box_check_vinyl_options(void)
 		tnt_raise(ClientError, ER_CFG, "vinyl_bloom_fpr",
 			  "must be greater than 0 and less than or equal to 1");
 	}
+	if (box_check_vinyl_compaction_io_rate_limit() < 0)
+		diag_raise();
 }
 
 static int
@@ -1650,6 +1708,18 @@ box_check_iproto_options(void)
 	return 0;
 }
 
+static double
+box_check_iproto_read_view_staleness(void)
+{
+	double staleness = cfg_getd("iproto_read_view_staleness");
+	if (staleness < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_read_view_staleness",
+			 "the value must be greater than or equal to 0");
+		return -1;
+	}
+	return staleness;
+}
+
 static double
 box_check_txn_timeout(void)
 {
@@ -1740,6 +1810,36 @@ box_check_memtx_sort_threads(void)
 				     " equal to %d", TT_SORT_THREADS_MAX));
 }
 
+/**
+ * Checks whether snap_compression_threads configuration parameter is
+ * correct and returns its value.
+ */
+static int
+box_check_snap_compression_threads(void)
+{
+	int num = cfg_geti("snap_compression_threads");
+	if (num < 0 || num > XLOG_COMPRESS_THREADS_MAX)
+		tnt_raise(ClientError, ER_CFG, "snap_compression_threads",
+			  tt_sprintf("must be greater than or equal to 0 and"
+				     " less than or equal to %d",
+				     XLOG_COMPRESS_THREADS_MAX));
+	return num;
+}
+
+/**
+ * Checks whether memtx_recovery_threads configuration parameter is correct.
+ */
+static void
+box_check_memtx_recovery_threads(void)
+{
+	int num = cfg_geti("memtx_recovery_threads");
+	if (num < 0 || num > XLOG_DECODER_THREADS_MAX)
+		tnt_raise(ClientError, ER_CFG, "memtx_recovery_threads",
+			  tt_sprintf("must be greater than or equal to 0 and"
+				     " less than or equal to %d",
+				     XLOG_DECODER_THREADS_MAX));
+}
+
 void
 box_check_config(void)
 {
@@ -1772,13 +1872,17 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_replication_threads() < 0)
 		diag_raise();
+	if (box_check_replication_apply_concurrency() < 0)
+		diag_raise();
 	box_check_replication_sync_timeout();
 	if (box_check_bootstrap_strategy() == BOOTSTRAP_STRATEGY_INVALID)
 		diag_raise();
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
+	box_check_wal_relay_buffer_size();
 	box_check_wal_mode(cfg_gets("wal_mode"));
+	box_check_wal_io_backend();
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
@@ -1792,6 +1896,8 @@ box_check_config(void)
 	box_check_vinyl_options();
 	if (box_check_iproto_options() != 0)
 		diag_raise();
+	if (box_check_iproto_read_view_staleness() < 0)
+		diag_raise();
 	if (box_check_sql_cache_size(cfg_geti("sql_cache_size")) != 0)
 		diag_raise();
 	if (box_check_sql_vdbe_max_steps(cfg_geti("sql_vdbe_max_steps")) != 0)
@@ -1801,6 +1907,8 @@ box_check_config(void)
 	if (box_check_txn_isolation() == txn_isolation_level_MAX)
 		diag_raise();
 	box_check_memtx_sort_threads();
+	box_check_memtx_recovery_threads();
+	box_check_snap_compression_threads();
 }
 
 int
@@ -2036,6 +2144,16 @@ box_set_replication_skip_conflict(void)
 	replication_skip_conflict = cfg_geti("replication_skip_conflict");
 }
 
+int
+box_set_replication_apply_concurrency(void)
+{
+	int count = box_check_replication_apply_concurrency();
+	if (count < 0)
+		return -1;
+	replication_apply_concurrency = count;
+	return 0;
+}
+
 void
 box_set_replication_anon(void)
 {
@@ -2748,7 +2866,7 @@ box_listen(void)
 	struct uri_set uri_set;
 	int rc = cfg_get_uri_set("listen", &uri_set);
 	assert(rc == 0);
-	rc = iproto_listen(&uri_set);
+	rc = iproto_listen(&uri_set, cfg_getb("iproto_reuseport"));
 	uri_set_destroy(&uri_set);
 	return rc;
 }
@@ -2759,6 +2877,16 @@ box_set_io_collect_interval(void)
 	ev_set_io_collect_interval(loop(), cfg_getd("io_collect_interval"));
 }
 
+void
+box_set_snap_compression_threads(void)
+{
+	int num = box_check_snap_compression_threads();
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_compression_threads(memtx, num);
+}
+
 void
 box_set_snap_io_rate_limit(void)
 {
@@ -2890,6 +3018,43 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
+void
+box_set_vinyl_page_index_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_index_cache(vinyl,
+		cfg_geti64("vinyl_page_index_cache"));
+}
+
+void
+box_set_vinyl_partition_page_index(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_partition_page_index(vinyl,
+		cfg_getb("vinyl_partition_page_index"));
+}
+
+void
+box_set_vinyl_compaction_io_rate_limit(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	double limit = box_check_vinyl_compaction_io_rate_limit();
+	if (limit < 0)
+		diag_raise();
+	vinyl_engine_set_compaction_io_rate_limit(vinyl, limit);
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -2914,6 +3079,16 @@ box_set_net_msg_max(void)
 				IPROTO_FIBER_POOL_SIZE_FACTOR);
 }
 
+int
+box_set_iproto_read_view_staleness(void)
+{
+	double staleness = box_check_iproto_read_view_staleness();
+	if (staleness < 0)
+		return -1;
+	iproto_set_read_view_staleness(staleness);
+	return 0;
+}
+
 int
 box_set_prepared_stmt_cache_size(void)
 {
@@ -3424,8 +3599,9 @@ box_select(uint32_t space_id, uint32_t index_id,
 	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
 		return -1;
 
-	struct iterator *it = index_create_iterator_after(index, type, key,
-							  part_count, pos);
+	struct iterator *it = index_create_iterator_with_offset(index, type,
+								key, part_count,
+								pos, offset);
 	if (it == NULL) {
 		txn_end_ro_stmt(txn, &svp);
 		return -1;
@@ -3445,10 +3621,6 @@ box_select(uint32_t space_id, uint32_t index_id,
 		result_process_perform(&res_proc, &rc, &tuple);
 		if (rc != 0 || tuple == NULL)
 			break;
-		if (offset > 0) {
-			offset--;
-			continue;
-		}
 		rc = port_c_add_tuple(port, tuple);
 		if (rc != 0)
 			break;
@@ -3552,6 +3724,23 @@ box_delete(uint32_t space_id, uint32_t index_id, const char *key,
 	return box_process1(&request, result);
 }
 
+API_EXPORT int
+box_delete_range(uint32_t space_id, const char *begin, const char *begin_end,
+		 const char *end, const char *end_end)
+{
+	mp_tuple_assert(begin, begin_end);
+	mp_tuple_assert(end, end_end);
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = IPROTO_DELETE_RANGE;
+	request.space_id = space_id;
+	request.key = begin;
+	request.key_end = begin_end;
+	request.tuple = end;
+	request.tuple_end = end_end;
+	return box_process1(&request, NULL);
+}
+
 API_EXPORT int
 box_update(uint32_t space_id, uint32_t index_id, const char *key,
 	   const char *key_end, const char *ops, const char *ops_end,
@@ -4429,6 +4618,7 @@ engine_init()
 				    cfg_gets("memtx_allocator"),
 				    cfg_getd("slab_alloc_factor"),
 				    cfg_geti("memtx_sort_threads"),
+				    cfg_geti("memtx_recovery_threads"),
 				    box_on_indexes_built);
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
@@ -4451,6 +4641,10 @@ engine_init()
 	engine_register((struct engine *)vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
+	box_set_vinyl_page_index_cache();
+	box_set_vinyl_partition_page_index();
+	box_set_vinyl_compaction_io_rate_limit();
 	box_set_vinyl_timeout();
 }
 
@@ -5017,6 +5211,8 @@ box_cfg_xc(void)
 		diag_raise();
 	box_set_replication_sync_timeout();
 	box_set_replication_skip_conflict();
+	if (box_set_replication_apply_concurrency() != 0)
+		diag_raise();
 	box_set_replication_anon();
 	/*
 	 * Must be set before opening the server port, because it may be
@@ -5102,6 +5298,12 @@ box_cfg_xc(void)
 
 	is_box_configured = true;
 	box_broadcast_ballot();
+	/*
+	 * Start serving selects from read views only after recovery
+	 * is complete, because a read view can't be opened earlier.
+	 */
+	if (box_set_iproto_read_view_staleness() != 0)
+		diag_raise();
 	/*
 	 * Fill in leader election parameters after bootstrap. Before it is not
 	 * possible - there may be relevant data to recover from WAL and
@@ -5506,6 +5708,8 @@ box_storage_init(void)
 	gc_init(on_garbage_collection);
 	engine_init();
 	schema_init();
+	compression_dict_init();
+	space_ttl_init();
 	replication_init(cfg_geti_default("replication_threads", 1));
 	port_init();
 	iproto_init(cfg_geti("iproto_threads"));
@@ -5517,7 +5721,9 @@ box_storage_init(void)
 	int64_t wal_max_size = box_check_wal_max_size(
 		cfg_geti64("wal_max_size"));
 	enum wal_mode wal_mode = box_check_wal_mode(cfg_gets("wal_mode"));
-	if (wal_init(wal_mode, cfg_gets("wal_dir"), wal_max_size,
+	if (wal_init(wal_mode, box_check_wal_io_backend(),
+		     cfg_gets("wal_dir"), wal_max_size,
+		     box_check_wal_relay_buffer_size(),
 		     &INSTANCE_UUID, on_wal_garbage_collection,
 		     on_wal_checkpoint_threshold) != 0) {
 		diag_raise();
@@ -5534,6 +5740,8 @@ box_storage_free(void)
 	replication_free();
 	gc_free();
 	engine_shutdown();
+	compression_dict_free();
+	space_ttl_free();
 	/* schema_free(); */
 	wal_free();
 	flightrec_free();
@@ -295,6 +295,7 @@ int box_listen(void);
 void box_set_replication(void);
 void box_set_io_collect_interval(void);
 void box_set_snap_io_rate_limit(void);
+void box_set_snap_compression_threads(void);
 void box_set_too_long_threshold(void);
 void box_set_readahead(void);
 void box_set_checkpoint_count(void);
@@ -307,6 +308,10 @@ void box_set_memtx_max_tuple_size(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
+void box_set_vinyl_page_index_cache(void);
+void box_set_vinyl_partition_page_index(void);
+void box_set_vinyl_compaction_io_rate_limit(void);
 void box_set_vinyl_timeout(void);
 void box_set_force_recovery(void);
 int box_set_election_mode(void);
@@ -321,8 +326,10 @@ int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
 void box_set_replication_sync_timeout(void);
 void box_set_replication_skip_conflict(void);
+int box_set_replication_apply_concurrency(void);
 void box_set_replication_anon(void);
 void box_set_net_msg_max(void);
+int box_set_iproto_read_view_staleness(void);
 int box_set_prepared_stmt_cache_size(void);
 int box_set_vdbe_max_steps(void);
 int box_set_feedback(void);
@@ -551,6 +558,26 @@ API_EXPORT int
 box_delete(uint32_t space_id, uint32_t index_id, const char *key,
 	   const char *key_end, box_tuple_t **result);
 
+/**
+ * Execute a DELETE_RANGE request: delete all tuples with primary
+ * keys in the range [begin, end). The keys may be partial. Only
+ * supported by vinyl spaces without secondary indexes.
+ *
+ * \param space_id space identifier
+ * \param begin encoded begin key in MsgPack Array format
+ * ([part1, part2, ...]), inclusive.
+ * \param begin_end the end of encoded \a begin.
+ * \param end encoded end key in MsgPack Array format, exclusive.
+ * An empty array means that the range is unbounded.
+ * \param end_end the end of encoded \a end.
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \sa \code box.space[space_id]:delete_range(begin, end) \endcode
+ */
+API_EXPORT int
+box_delete_range(uint32_t space_id, const char *begin, const char *begin_end,
+		 const char *end, const char *end_end);
+
 /**
  * Execute an UPDATE request.
  *
@@ -0,0 +1,427 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "compression_dict.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "assoc.h"
+#include "box.h"
+#include "coio_task.h"
+#include "diag.h"
+#include "errcode.h"
+#include "fiber.h"
+#include "index.h"
+#include "msgpuck.h"
+#include "schema_def.h"
+#include "session.h"
+#include "small/region.h"
+#include "space.h"
+#include "space_cache.h"
+#include "trivia/util.h"
+#include "tt_compression.h"
+#include "tt_static.h"
+#include "tuple.h"
+#include "tuple_format.h"
+
+enum {
+	/** Max size of a dictionary. */
+	COMPRESSION_DICT_SIZE = 16 * 1024,
+	/** Min number of tuples in a space to train a dictionary. */
+	COMPRESSION_DICT_MIN_TUPLE_COUNT = 1000,
+	/** Max number of samples used for training a dictionary. */
+	COMPRESSION_DICT_SAMPLE_COUNT_MAX = 4096,
+	/** Max total size of samples used for training a dictionary. */
+	COMPRESSION_DICT_SAMPLE_SIZE_MAX = 4 * 1024 * 1024,
+};
+
+/** How often the training fiber checks spaces, in seconds. */
+static const double COMPRESSION_DICT_CHECK_PERIOD = 60;
+
+/** Current dictionary of a space. */
+struct compression_dict_space {
+	/** Dictionary used for compression of new data. */
+	struct tt_compression_dict *dict;
+	/** Number of tuples in the space when the dictionary was trained. */
+	uint64_t tuple_count;
+};
+
+/** Space id -> struct compression_dict_space. */
+static struct mh_i32ptr_t *compression_dict_spaces;
+
+/** Max identifier of a registered dictionary. */
+static uint32_t compression_dict_id_max;
+
+/** Fiber that trains dictionaries in background. */
+static struct fiber *compression_dict_fiber;
+
+struct tt_compression_dict *
+compression_dict_decode(struct tuple *tuple, uint32_t *space_id,
+			uint64_t *tuple_count)
+{
+	if (tuple_field_u32(tuple, COMPRESSION_DICT_FIELD_SPACE_ID,
+			    space_id) != 0 ||
+	    tuple_field_u64(tuple, COMPRESSION_DICT_FIELD_TUPLE_COUNT,
+			    tuple_count) != 0)
+		return NULL;
+	const char *data = tuple_field_with_type(
+		tuple, COMPRESSION_DICT_FIELD_DATA, MP_BIN);
+	if (data == NULL)
+		return NULL;
+	uint32_t size;
+	data = mp_decode_bin(&data, &size);
+	struct tt_compression_dict *dict = tt_compression_dict_new(data, size);
+	if (dict == NULL) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 "invalid compression dictionary");
+		return NULL;
+	}
+	uint32_t id = tt_compression_dict_id(dict);
+	dict = tt_compression_dict_register(dict);
+	if (dict == NULL) {
+		/*
+		 * Identifiers are assigned locally so two instances
+		 * may train different dictionaries with the same one.
+		 * Data compressed with them can't be told apart.
+		 */
+		diag_set(ClientError, ER_COMPRESSION, tt_sprintf(
+			"compression dictionary %u conflicts with "
+			"another dictionary with the same identifier", id));
+		return NULL;
+	}
+	compression_dict_id_max = MAX(compression_dict_id_max,
+				      tt_compression_dict_id(dict));
+	return dict;
+}
+
+void
+compression_dict_set(uint32_t space_id, struct tt_compression_dict *dict,
+		     uint64_t tuple_count)
+{
+	mh_int_t k = mh_i32ptr_find(compression_dict_spaces, space_id, NULL);
+	struct compression_dict_space *entry;
+	if (k != mh_end(compression_dict_spaces)) {
+		entry = mh_i32ptr_node(compression_dict_spaces, k)->val;
+		if (tt_compression_dict_id(entry->dict) >=
+		    tt_compression_dict_id(dict))
+			return;
+	} else {
+		entry = xmalloc(sizeof(*entry));
+		const struct mh_i32ptr_node_t node = { space_id, entry };
+		mh_i32ptr_put(compression_dict_spaces, &node, NULL, NULL);
+	}
+	entry->dict = dict;
+	entry->tuple_count = tuple_count;
+}
+
+void
+compression_dict_unset(uint32_t space_id, struct tt_compression_dict *dict)
+{
+	mh_int_t k = mh_i32ptr_find(compression_dict_spaces, space_id, NULL);
+	if (k == mh_end(compression_dict_spaces))
+		return;
+	struct compression_dict_space *entry =
+		mh_i32ptr_node(compression_dict_spaces, k)->val;
+	if (entry->dict != dict)
+		return;
+	mh_i32ptr_del(compression_dict_spaces, k, NULL);
+	free(entry);
+}
+
+/** Return the current dictionary entry of a space or NULL. */
+static struct compression_dict_space *
+compression_dict_space_find(uint32_t space_id)
+{
+	mh_int_t k = mh_i32ptr_find(compression_dict_spaces, space_id, NULL);
+	if (k == mh_end(compression_dict_spaces))
+		return NULL;
+	return mh_i32ptr_node(compression_dict_spaces, k)->val;
+}
+
+struct tt_compression_dict *
+compression_dict_get(uint32_t space_id)
+{
+	struct compression_dict_space *entry =
+		compression_dict_space_find(space_id);
+	return entry != NULL ? entry->dict : NULL;
+}
+
+/** Samples of space data used for training a dictionary. */
+struct compression_dict_samples {
+	/** Samples stored one after another, allocated on region. */
+	char *data;
+	/** Total size of the samples. */
+	size_t size;
+	/** Sizes of the samples, allocated on region. */
+	size_t *sizes;
+	/** Number of samples. */
+	unsigned count;
+};
+
+/**
+ * Collect samples for training a dictionary for a space. Samples
+ * are taken from the first tuples of the primary index. If the space
+ * has fields that are compressed individually (memtx), the samples
+ * are the values of such fields, otherwise the samples are whole
+ * tuples (vinyl pages). The samples are allocated on the fiber region.
+ */
+static int
+compression_dict_collect_samples(struct space *space,
+				 struct compression_dict_samples *samples)
+{
+	struct region *region = &fiber()->gc;
+	struct tuple_format *format = space->format;
+	bool sample_fields = format->is_compressed;
+	samples->data = xregion_alloc(region, COMPRESSION_DICT_SAMPLE_SIZE_MAX);
+	samples->sizes = xregion_alloc_array(
+		region, size_t, COMPRESSION_DICT_SAMPLE_COUNT_MAX);
+	samples->size = 0;
+	samples->count = 0;
+	char key[1];
+	char *key_end = mp_encode_array(key, 0);
+	box_iterator_t *it = box_index_iterator(space_id(space), 0, ITER_ALL,
+						key, key_end);
+	if (it == NULL)
+		return -1;
+	/*
+	 * The iterator may yield so the space may be altered or
+	 * dropped. Pin the format we use for decoding samples.
+	 */
+	tuple_format_ref(format);
+	int rc = 0;
+	while (samples->count < COMPRESSION_DICT_SAMPLE_COUNT_MAX) {
+		struct tuple *tuple;
+		rc = box_iterator_next(it, &tuple);
+		if (rc != 0 || tuple == NULL)
+			break;
+		uint32_t bsize;
+		const char *data = tuple_data_range(tuple, &bsize);
+		if (!sample_fields) {
+			if (samples->size + bsize >
+			    COMPRESSION_DICT_SAMPLE_SIZE_MAX)
+				break;
+			memcpy(samples->data + samples->size, data, bsize);
+			samples->size += bsize;
+			samples->sizes[samples->count++] = bsize;
+			continue;
+		}
+		uint32_t field_count = mp_decode_array(&data);
+		field_count = MIN(field_count,
+				  tuple_format_field_count(format));
+		for (uint32_t i = 0; i < field_count &&
+		     samples->count < COMPRESSION_DICT_SAMPLE_COUNT_MAX; i++) {
+			const char *field = data;
+			mp_next(&data);
+			if (tuple_format_field(format, i)->compression_type ==
+			    COMPRESSION_TYPE_NONE)
+				continue;
+			size_t size = data - field;
+			if (samples->size + size >
+			    COMPRESSION_DICT_SAMPLE_SIZE_MAX)
+				goto out;
+			memcpy(samples->data + samples->size, field, size);
+			samples->size += size;
+			samples->sizes[samples->count++] = size;
+		}
+	}
+out:
+	box_iterator_free(it);
+	tuple_format_unref(format);
+	return rc;
+}
+
+static ssize_t
+compression_dict_train_f(va_list ap)
+{
+	struct compression_dict_samples *samples =
+		va_arg(ap, struct compression_dict_samples *);
+	uint32_t id = va_arg(ap, uint32_t);
+	char *buf = va_arg(ap, char *);
+	return tt_compression_dict_train(samples->data, samples->sizes,
+					 samples->count, id, buf,
+					 COMPRESSION_DICT_SIZE);
+}
+
+/** Insert a dictionary row into _schema. */
+static int
+compression_dict_store(uint32_t id, uint32_t space_id, const char *data,
+		       size_t size, uint64_t tuple_count)
+{
+	struct region *region = &fiber()->gc;
+	char key[sizeof(COMPRESSION_DICT_KEY_PREFIX) + 10];
+	snprintf(key, sizeof(key), COMPRESSION_DICT_KEY_PREFIX "%u", id);
+	size_t tuple_size = mp_sizeof_array(4) + mp_sizeof_str(strlen(key)) +
+			    mp_sizeof_uint(space_id) + mp_sizeof_bin(size) +
+			    mp_sizeof_uint(tuple_count);
+	char *tuple = xregion_alloc(region, tuple_size);
+	char *tuple_end = mp_encode_array(tuple, 4);
+	tuple_end = mp_encode_str0(tuple_end, key);
+	tuple_end = mp_encode_uint(tuple_end, space_id);
+	tuple_end = mp_encode_bin(tuple_end, data, size);
+	tuple_end = mp_encode_uint(tuple_end, tuple_count);
+	assert(tuple_end == tuple + tuple_size);
+
+	struct credentials *orig_credentials = effective_user();
+	fiber_set_user(fiber(), &admin_credentials);
+
+	int rc = box_insert(BOX_SCHEMA_ID, tuple, tuple_end, NULL);
+
+	fiber_set_user(fiber(), orig_credentials);
+	return rc;
+}
+
+int
+compression_dict_train(uint32_t space_id)
+{
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return -1;
+	if (!space->def->opts.compression_dict) {
+		diag_set(ClientError, ER_UNSUPPORTED, space_name(space),
+			 "compression dictionary training without "
+			 "compression_dict option");
+		return -1;
+	}
+	if (compression_dict_id_max + 1 >= TT_COMPRESSION_DICT_ID_MAX) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 "too many compression dictionaries");
+		return -1;
+	}
+	ssize_t count = box_index_len(space_id, 0);
+	if (count < 0)
+		return -1;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int rc = -1;
+	struct compression_dict_samples samples;
+	if (compression_dict_collect_samples(space, &samples) != 0)
+		goto out;
+	/*
+	 * Collecting samples and training yield, and the space may
+	 * be dropped meanwhile, so look it up again after each.
+	 */
+	space = space_cache_find(space_id);
+	if (space == NULL)
+		goto out;
+	/*
+	 * The identifier may be taken by another dictionary trained
+	 * while we were waiting for the worker thread.
+	 */
+	char *buf = xregion_alloc(region, COMPRESSION_DICT_SIZE);
+	uint32_t id;
+	ssize_t size;
+	do {
+		id = compression_dict_id_max + 1;
+		size = coio_call(compression_dict_train_f, &samples, id, buf);
+	} while (size >= 0 && id <= compression_dict_id_max);
+	if (size < 0) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 "not enough data to train a dictionary");
+		goto out;
+	}
+	space = space_cache_find(space_id);
+	if (space == NULL)
+		goto out;
+	rc = compression_dict_store(id, space_id, buf, size, count);
+	if (rc == 0) {
+		say_info("trained compression dictionary %u for space '%s' "
+			 "on %u samples", id, space_name(space), samples.count);
+	}
+out:
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+/** Check if a new dictionary should be trained for a space. */
+static bool
+compression_dict_needs_training(struct space *space)
+{
+	if (!space->def->opts.compression_dict ||
+	    space_index(space, 0) == NULL)
+		return false;
+	ssize_t count = box_index_len(space_id(space), 0);
+	if (count < COMPRESSION_DICT_MIN_TUPLE_COUNT)
+		return false;
+	struct compression_dict_space *entry =
+		compression_dict_space_find(space_id(space));
+	return entry == NULL || (uint64_t)count >= 2 * entry->tuple_count;
+}
+
+/** Ids of spaces that need a new dictionary. */
+struct compression_dict_queue {
+	uint32_t *space_ids;
+	int count;
+	int capacity;
+};
+
+static int
+compression_dict_queue_add(struct space *space, void *arg)
+{
+	struct compression_dict_queue *queue = arg;
+	if (!compression_dict_needs_training(space))
+		return 0;
+	if (queue->count == queue->capacity) {
+		queue->capacity = MAX(queue->capacity * 2, 16);
+		queue->space_ids = xrealloc(
+			queue->space_ids,
+			queue->capacity * sizeof(*queue->space_ids));
+	}
+	queue->space_ids[queue->count++] = space_id(space);
+	return 0;
+}
+
+static int
+compression_dict_fiber_f(va_list ap)
+{
+	(void)ap;
+	struct compression_dict_queue queue = {NULL, 0, 0};
+	while (!fiber_is_cancelled()) {
+		fiber_sleep(COMPRESSION_DICT_CHECK_PERIOD);
+		fiber_check_gc();
+		if (!box_is_configured() || box_is_ro())
+			continue;
+		queue.count = 0;
+		space_foreach(compression_dict_queue_add, &queue);
+		for (int i = 0; i < queue.count; i++) {
+			/* Training yields so recheck the space. */
+			struct space *space = space_by_id(queue.space_ids[i]);
+			if (box_is_ro() || space == NULL ||
+			    !compression_dict_needs_training(space))
+				continue;
+			if (compression_dict_train(space_id(space)) != 0)
+				diag_log();
+		}
+	}
+	free(queue.space_ids);
+	return 0;
+}
+
+void
+compression_dict_init(void)
+{
+	compression_dict_spaces = mh_i32ptr_new();
+	compression_dict_fiber = fiber_new_system("compression_dict",
+						  compression_dict_fiber_f);
+	if (compression_dict_fiber == NULL)
+		panic("failed to start compression dictionary fiber");
+	fiber_start(compression_dict_fiber);
+}
+
+void
+compression_dict_free(void)
+{
+	/*
+	 * Can't stop the training fiber as the event loop isn't
+	 * running when this function is called.
+	 */
+	while (mh_size(compression_dict_spaces) > 0) {
+		mh_int_t k = mh_first(compression_dict_spaces);
+		free(mh_i32ptr_node(compression_dict_spaces, k)->val);
+		mh_i32ptr_del(compression_dict_spaces, k, NULL);
+	}
+	mh_i32ptr_delete(compression_dict_spaces);
+}
@@ -0,0 +1,97 @@
+#pragma once
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+/*
+ * Per-space compression dictionaries.
+ *
+ * A zstd dictionary is trained in background on tuples sampled from
+ * a space that has the compression_dict option set. It's used for
+ * compression of memtx tuple fields and vinyl run pages, which is
+ * much more effective for small data than compression without a
+ * dictionary.
+ *
+ * Dictionaries are stored in the _schema system space so they are
+ * persisted in snapshots and replicated. The key of a row storing
+ * a dictionary is COMPRESSION_DICT_KEY_PREFIX followed by the
+ * dictionary identifier, the other fields are the space identifier,
+ * the dictionary data, and the number of tuples in the space at the
+ * time the dictionary was trained.
+ *
+ * A dictionary is retrained when the space size doubles. The new
+ * dictionary is used for new data while the old one is kept so that
+ * data compressed with it remains readable: a compressed zstd frame
+ * stores the identifier of the dictionary used for compression.
+ */
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct tuple;
+struct tt_compression_dict;
+
+/** Key prefix of _schema rows that store compression dictionaries. */
+#define COMPRESSION_DICT_KEY_PREFIX "compression_dict."
+
+/** _schema fields of a compression dictionary row. */
+enum {
+	COMPRESSION_DICT_FIELD_SPACE_ID = 1,
+	COMPRESSION_DICT_FIELD_DATA = 2,
+	COMPRESSION_DICT_FIELD_TUPLE_COUNT = 3,
+};
+
+/** Initialize the module and start the training fiber. */
+void
+compression_dict_init(void);
+
+/** Free the module. */
+void
+compression_dict_free(void);
+
+/**
+ * Decode a compression dictionary stored in a _schema row and
+ * register it so that data compressed with it can be decompressed.
+ * Returns NULL and sets diag if the row is invalid.
+ */
+struct tt_compression_dict *
+compression_dict_decode(struct tuple *tuple, uint32_t *space_id,
+			uint64_t *tuple_count);
+
+/**
+ * Make a dictionary the current dictionary of a space unless the
+ * space already uses a newer dictionary.
+ */
+void
+compression_dict_set(uint32_t space_id, struct tt_compression_dict *dict,
+		     uint64_t tuple_count);
+
+/**
+ * Stop using a dictionary for compression of a space's data.
+ * The dictionary remains registered.
+ */
+void
+compression_dict_unset(uint32_t space_id, struct tt_compression_dict *dict);
+
+/**
+ * Return the dictionary to use for compression of a space's data
+ * or NULL if there's no dictionary trained for the space.
+ */
+struct tt_compression_dict *
+compression_dict_get(uint32_t space_id);
+
+/**
+ * Train a new dictionary for a space and store it in _schema.
+ * Returns 0 on success, -1 on failure, in which case diag is set.
+ * Yields.
+ */
+int
+compression_dict_train(uint32_t space_id);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -324,6 +324,63 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	return 0;
 }
 
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, box_tuple_t **result)
+{
+	assert(keys != NULL && keys_end != NULL && result != NULL);
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (!index->def->opts.is_unique) {
+		diag_set(ClientError, ER_MORE_THAN_ONE_TUPLE);
+		return -1;
+	}
+	if (mp_typeof(*keys) != MP_ARRAY) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "keys must be an array");
+		return -1;
+	}
+	uint32_t key_count = mp_decode_array(&keys);
+	const char *key = keys;
+	for (uint32_t i = 0; i < key_count; i++) {
+		const char *key_array = key;
+		if (mp_typeof(*key) != MP_ARRAY) {
+			diag_set(ClientError, ER_ILLEGAL_PARAMS,
+				 "key must be an array");
+			return -1;
+		}
+		uint32_t part_count = mp_decode_array(&key);
+		if (exact_key_validate(index->def->key_def, key, part_count))
+			return -1;
+		box_run_on_select(space, index, ITER_EQ, key_array);
+		key = key_array;
+		mp_next(&key);
+	}
+	assert(key == keys_end);
+	(void)keys_end;
+	if (key_count == 0)
+		return 0;
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	struct result_processor res_proc;
+	result_process_prepare(&res_proc, space);
+	int rc = index_get_many(index, keys, key_count, result);
+	result_process_perform_many(&res_proc, &rc, result, key_count);
+	txn_end_ro_stmt(txn, &svp);
+	if (rc != 0)
+		return -1;
+	/* Count statistics. */
+	rmean_collect(rmean_box, IPROTO_SELECT, key_count);
+	return 0;
+}
+
 int
 box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result)
@@ -949,6 +1006,29 @@ generic_index_get(struct index *index, const char *key,
 	return -1;
 }
 
+int
+generic_index_get_many(struct index *index, const char *keys,
+		       uint32_t key_count, struct tuple **result)
+{
+	for (uint32_t i = 0; i < key_count; i++) {
+		uint32_t part_count = mp_decode_array(&keys);
+		const char *key = keys;
+		for (uint32_t j = 0; j < part_count; j++)
+			mp_next(&keys);
+		if (index_get(index, key, part_count, &result[i]) != 0) {
+			for (uint32_t j = 0; j < i; j++) {
+				if (result[j] != NULL)
+					tuple_unref(result[j]);
+			}
+			memset(result, 0, key_count * sizeof(*result));
+			return -1;
+		}
+		if (result[i] != NULL)
+			tuple_ref(result[i]);
+	}
+	return 0;
+}
+
 int
 generic_index_replace(struct index *index, struct tuple *old_tuple,
 		      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -976,6 +1056,28 @@ generic_index_create_iterator(struct index *base, enum iterator_type type,
 	return NULL;
 }
 
+struct iterator *
+generic_index_create_iterator_with_offset(struct index *index,
+					  enum iterator_type type,
+					  const char *key, uint32_t part_count,
+					  const char *pos, uint32_t offset)
+{
+	struct iterator *it = index_create_iterator_after(index, type, key,
+							  part_count, pos);
+	if (it == NULL)
+		return NULL;
+	struct tuple *tuple;
+	for (; offset > 0; offset--) {
+		if (box_check_slice() != 0 ||
+		    iterator_next(it, &tuple) != 0) {
+			iterator_delete(it);
+			return NULL;
+		}
+		if (tuple == NULL)
+			break;
+	}
+	return it;
+}
 
 struct index_read_view *
 generic_index_create_read_view(struct index *index)
@@ -1029,9 +1131,10 @@ generic_index_build_next(struct index *index, struct tuple *tuple)
 	return index_replace(index, NULL, tuple, DUP_INSERT, &unused, &unused);
 }
 
-void
+int
 generic_index_end_build(struct index *)
 {
+	return 0;
 }
 
 int
@@ -187,6 +187,32 @@ int
 box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result);
 
+/**
+ * Get tuples from index by a batch of keys.
+ *
+ * Works like box_index_get() called for each key, but may be much
+ * faster for indexes that store data on disk, because the engine
+ * can read data for different keys concurrently.
+ *
+ * Unlike box_index_get(), found tuples are referenced and must be
+ * unreferenced with box_tuple_unref() after use.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys MsgPack Array of keys, each of which is encoded in
+ *             MsgPack Array format ([part1, part2, ...]).
+ * \param keys_end the end of encoded \a keys
+ * \param[out] result array of tuples of the size equal to the number
+ *             of keys; NULL is stored for keys that are not found
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \pre keys != NULL
+ * \sa \code box.space[space_id].index[index_id]:get_many(keys) \endcode
+ */
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, box_tuple_t **result);
+
 /**
  * Return a first (minimal) tuple matched the provided key.
  *
@@ -580,6 +606,14 @@ struct index_vtab {
 			    uint32_t part_count, struct tuple **result);
 	int (*get)(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result);
+	/**
+	 * Get tuples by a batch of keys. Keys are passed as
+	 * @key_count consecutive MsgPack arrays. Found tuples are
+	 * returned referenced. On failure, @result is filled with
+	 * NULLs.
+	 */
+	int (*get_many)(struct index *index, const char *keys,
+			uint32_t key_count, struct tuple **result);
 	/**
 	 * Main entrance point for changing data in index. Once built and
 	 * before deletion this is the only way to insert, replace and delete
@@ -603,6 +637,14 @@ struct index_vtab {
 					    const char *key,
 					    uint32_t part_count,
 					    const char *pos);
+	/**
+	 * Same as create_iterator(), but the iterator skips the first
+	 * offset tuples it would return otherwise.
+	 */
+	struct iterator *(*create_iterator_with_offset)(
+		struct index *index, enum iterator_type type,
+		const char *key, uint32_t part_count, const char *pos,
+		uint32_t offset);
 	/** Create an index read view. */
 	struct index_read_view *(*create_read_view)(struct index *index);
 	/** Introspection (index:stat()) */
@@ -625,7 +667,12 @@ struct index_vtab {
 	 */
 	int (*reserve)(struct index *index, uint32_t size_hint);
 	int (*build_next)(struct index *index, struct tuple *tuple);
-	void (*end_build)(struct index *index);
+	/**
+	 * Finish building. May yield. Returns 0 on success, -1 and sets
+	 * diag on error, e.g. if a duplicate is found in a unique index
+	 * that doesn't check uniqueness on build_next().
+	 */
+	int (*end_build)(struct index *index);
 };
 
 struct index {
@@ -938,6 +985,13 @@ index_get(struct index *index, const char *key,
 	return index->vtab->get(index, key, part_count, result);
 }
 
+static inline int
+index_get_many(struct index *index, const char *keys,
+	       uint32_t key_count, struct tuple **result)
+{
+	return index->vtab->get_many(index, keys, key_count, result);
+}
+
 static inline int
 index_replace(struct index *index, struct tuple *old_tuple,
 	      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -963,6 +1017,16 @@ index_create_iterator(struct index *index, enum iterator_type type,
 	return index->vtab->create_iterator(index, type, key, part_count, NULL);
 }
 
+static inline struct iterator *
+index_create_iterator_with_offset(struct index *index, enum iterator_type type,
+				  const char *key, uint32_t part_count,
+				  const char *pos, uint32_t offset)
+{
+	return index->vtab->create_iterator_with_offset(index, type, key,
+							part_count, pos,
+							offset);
+}
+
 static inline struct index_read_view *
 index_create_read_view(struct index *index)
 {
@@ -1005,10 +1069,10 @@ index_build_next(struct index *index, struct tuple *tuple)
 	return index->vtab->build_next(index, tuple);
 }
 
-static inline void
+static inline int
 index_end_build(struct index *index)
 {
-	index->vtab->end_build(index);
+	return index->vtab->end_build(index);
 }
 
 /**
@@ -1076,6 +1140,9 @@ int
 generic_index_get_internal(struct index *index, const char *key,
 			   uint32_t part_count, struct tuple **result);
 int generic_index_get(struct index *, const char *, uint32_t, struct tuple **);
+int
+generic_index_get_many(struct index *index, const char *keys,
+		       uint32_t key_count, struct tuple **result);
 int generic_index_replace(struct index *, struct tuple *, struct tuple *,
 			  enum dup_replace_mode,
 			  struct tuple **, struct tuple **);
@@ -1090,8 +1157,17 @@ struct iterator *
 generic_index_create_iterator(struct index *base, enum iterator_type type,
 			      const char *key, uint32_t part_count,
 			      const char *pos);
+/**
+ * Create an iterator with index_create_iterator_after() and skip
+ * the first offset tuples by iterating over them.
+ */
+struct iterator *
+generic_index_create_iterator_with_offset(struct index *index,
+					  enum iterator_type type,
+					  const char *key, uint32_t part_count,
+					  const char *pos, uint32_t offset);
 int generic_index_build_next(struct index *, struct tuple *);
-void generic_index_end_build(struct index *);
+int generic_index_end_build(struct index *);
 int
 disabled_index_build_next(struct index *index, struct tuple *tuple);
 int
@@ -39,6 +39,8 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *compaction_policy_strs[] = { "tiered", "leveled", "time_window" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -48,10 +50,14 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .compaction_policy   = */ COMPACTION_POLICY_TIERED,
+	/* .compaction_window   = */ 3600,
 	/* .lsn                 = */ 0,
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
 	/* .hint                = */ INDEX_HINT_DEFAULT,
+	/* .fast_offset         = */ false,
+	/* .covering            = */ false,
 };
 
 /**
@@ -85,10 +91,16 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF_ENUM("compaction_policy", compaction_policy, struct index_opts,
+		     compaction_policy, NULL),
+	OPT_DEF("compaction_window", OPT_FLOAT, struct index_opts,
+		compaction_window),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
 	OPT_DEF_CUSTOM("hint", index_opts_parse_hint),
+	OPT_DEF("fast_offset", OPT_BOOL, struct index_opts, fast_offset),
+	OPT_DEF("covering", OPT_BOOL, struct index_opts, covering),
 	OPT_END,
 };
 
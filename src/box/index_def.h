@@ -65,6 +65,29 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Vinyl compaction policy, see vy_range_update_compaction_priority(). */
+enum compaction_policy {
+	/**
+	 * Size-tiered: a level may store up to run_count_per_level
+	 * runs before it's compacted to the next level.
+	 */
+	COMPACTION_POLICY_TIERED,
+	/**
+	 * Leveled: each level stores at most one run, which reduces
+	 * read and space amplification at the cost of increased write
+	 * amplification.
+	 */
+	COMPACTION_POLICY_LEVELED,
+	/**
+	 * Time-window: runs dumped within the same time window are
+	 * compacted together, runs from different windows are never
+	 * merged. Suits append-only data.
+	 */
+	COMPACTION_POLICY_TIME_WINDOW,
+	compaction_policy_MAX
+};
+extern const char *compaction_policy_strs[];
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -160,6 +183,13 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/** Vinyl compaction policy. */
+	enum compaction_policy compaction_policy;
+	/**
+	 * Size of a time window, in seconds, used by the time-window
+	 * compaction policy.
+	 */
+	double compaction_window;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -176,6 +206,17 @@ struct index_opts {
 	 * Use hint optimization for tree index.
 	 */
 	enum index_hint_cfg hint;
+	/**
+	 * Maintain the number of tuples under each inner node of
+	 * a tree index so that count and offset take logarithmic
+	 * time.
+	 */
+	bool fast_offset;
+	/**
+	 * Store full tuples in a secondary index so that reads
+	 * from it don't need to look up the primary index.
+	 */
+	bool covering;
 };
 
 extern const struct index_opts index_opts_default;
@@ -220,10 +261,18 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return o1->compaction_policy - o2->compaction_policy;
+	if (o1->compaction_window != o2->compaction_window)
+		return o1->compaction_window < o2->compaction_window ? -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
 		return o1->hint - o2->hint;
+	if (o1->fast_offset != o2->fast_offset)
+		return o1->fast_offset < o2->fast_offset ? -1 : 1;
+	if (o1->covering != o2->covering)
+		return o1->covering < o2->covering ? -1 : 1;
 	return 0;
 }
 
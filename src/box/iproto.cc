@@ -30,6 +30,7 @@
  */
 #include "iproto.h"
 #include <string.h>
+#include <limits.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <fcntl.h>
@@ -55,6 +56,7 @@
 #include "port.h"
 #include "box.h"
 #include "call.h"
+#include "tuple.h"
 #include "tuple_convert.h"
 #include "session.h"
 #include "xrow.h"
@@ -72,6 +74,11 @@
 #include "on_shutdown.h"
 #include "flightrec.h"
 #include "security.h"
+#include "read_view.h"
+#include "space.h"
+#include "user.h"
+#include "index.h"
+#include "tweaks.h"
 
 enum {
 	IPROTO_SALT_SIZE = 32,
@@ -128,6 +135,73 @@ iproto_wpos_create(struct iproto_wpos *wpos, struct obuf *out)
 	wpos->svp = obuf_create_svp(out);
 }
 
+/**
+ * Tuple data written to the socket in between the connection output
+ * buffer data without copying it to the buffer, see tx_dump_select().
+ *
+ * A splice is created and the tuple is referenced by the tx thread,
+ * which passes it to the iproto thread along with the response. Once
+ * the data is sent, the iproto thread passes the splice back to the
+ * tx thread along with the next request, and the tx thread releases
+ * the tuple.
+ */
+struct iproto_splice {
+	/** Link in a list of splices. */
+	struct stailq_entry in_list;
+	/** Output buffer the data is inserted into. */
+	struct obuf *obuf;
+	/** Size of the output buffer data preceding the tuple data. */
+	size_t offset;
+	/** Referenced tuple. */
+	struct tuple *tuple;
+	/** Tuple data. */
+	const char *data;
+	/** Tuple data size. */
+	size_t size;
+};
+
+/**
+ * Tuples of this size or larger are sent directly from the tuple memory
+ * in response to IPROTO_SELECT, see tx_dump_select(). 0 disables.
+ */
+static int iproto_select_splice_size = 4096;
+TWEAK_INT(iproto_select_splice_size);
+
+/** Splice allocator. Used only by the tx thread. */
+static struct mempool iproto_splice_pool;
+
+/** Max number of vectors written to the socket at once. */
+enum { IPROTO_IOV_MAX = 256 };
+
+/** A space served by iproto threads from a read view. */
+struct iproto_read_view_space {
+	/** Space read view. */
+	struct space_read_view *space;
+	/**
+	 * Bit mask of auth tokens of the users that were allowed to read
+	 * the space at the time when the read view was created.
+	 */
+	uint32_t read_access;
+};
+
+static_assert(BOX_USER_MAX <= sizeof(uint32_t) * CHAR_BIT,
+	      "auth tokens must fit in iproto_read_view_space::read_access");
+
+/**
+ * Read view used by iproto threads to serve selects on spaces with the
+ * iproto_read_view option without going to the tx thread. Created and
+ * destroyed by the tx thread, which refreshes it periodically, see
+ * iproto_set_read_view_staleness().
+ */
+struct iproto_read_view {
+	/** Database read view. */
+	struct read_view rv;
+	/** Schema version at the time when the read view was created. */
+	uint64_t schema_version;
+	/** Space id -> struct iproto_read_view_space. */
+	struct mh_i32ptr_t *spaces;
+};
+
 struct iproto_thread {
 	/**
 	 * Slab cache used for allocating memory for output network buffers
@@ -199,6 +273,12 @@ struct iproto_thread {
 	struct evio_service binary;
 	/** Requests count currently pending in stream queue. */
 	size_t requests_in_stream_queue;
+	/**
+	 * Read view used to serve selects in this thread or NULL if
+	 * read view selects are disabled. Set by the tx thread with
+	 * the IPROTO_CFG_READ_VIEW message.
+	 */
+	struct iproto_read_view *read_view;
 	/**
 	 * The following fields are used exclusively by the tx thread.
 	 * Align them to prevent false-sharing.
@@ -399,6 +479,13 @@ struct iproto_msg
 	 * more output to flush.
 	 */
 	struct iproto_wpos wpos;
+	/**
+	 * List of iproto_splice. When sending a message to the tx thread,
+	 * iproto moves the splices it has sent to the socket here so that
+	 * tx releases them. The tx thread, in turn, adds the splices of
+	 * the response here.
+	 */
+	struct stailq splices;
 	/**
 	 * Message sent by the tx thread to notify iproto that input has
 	 * been processed and can be discarded before request completion.
@@ -410,6 +497,12 @@ struct iproto_msg
 	 * and the connection must be closed.
 	 */
 	bool close_connection;
+	/**
+	 * Auth token of the session user after the request was
+	 * processed by the tx thread or BOX_USER_MAX if unknown.
+	 * Used for access checks of selects served from a read view.
+	 */
+	uint8_t auth_token;
 	/**
 	 * A stailq_entry to hold message in stream.
 	 * All messages processed in stream sequently. Before processing
@@ -448,6 +541,19 @@ static void
 iproto_msg_prepare(struct iproto_msg *msg, const char **pos, const char *reqend,
 		   bool *stop_input);
 
+/**
+ * Tries to process a select request in the iproto thread using the thread's
+ * read view. Returns true if a response was written to the connection's
+ * read view output buffer, false if the request must be processed by the
+ * tx thread.
+ */
+static bool
+iproto_process_select_from_read_view(struct iproto_msg *msg);
+
+/** Account msg data in connection input buffer as processed. */
+static void
+iproto_msg_finish_input(iproto_msg *msg);
+
 enum rmean_net_name {
 	IPROTO_SENT,
 	IPROTO_RECEIVED,
@@ -608,6 +714,37 @@ struct iproto_connection
 	 * output is available (see iproto_msg::wpos).
 	 */
 	struct iproto_wpos wend;
+	/**
+	 * Tuple data to write in between the output buffer data, received
+	 * from the tx thread along with responses. Ordered by the position
+	 * in the output.
+	 */
+	struct stailq splices;
+	/** Size of the data of the first splice sent to the socket. */
+	size_t splice_sent;
+	/**
+	 * Splices sent to the socket. Passed to the tx thread along with
+	 * the next request to be released.
+	 */
+	struct stailq sent_splices;
+	/**
+	 * Output buffer for responses to selects served from a read view
+	 * (see iproto_process_select_from_read_view()). Unlike obuf[2],
+	 * it is allocated and written by the iproto thread, which flushes
+	 * it in between responses written by the tx thread.
+	 */
+	struct obuf rv_obuf;
+	/**
+	 * Position in rv_obuf that points to the beginning of the data
+	 * awaiting to be flushed.
+	 */
+	struct obuf_svp rv_wpos;
+	/**
+	 * Auth token of the session user as of the last response received
+	 * from the tx thread or BOX_USER_MAX if unknown. Used by the iproto
+	 * thread for access checks of selects served from a read view.
+	 */
+	uint8_t auth_token;
 	/*
 	 * Size of readahead which is not parsed yet, i.e. size of
 	 * a piece of request which is not fully read. Is always
@@ -816,13 +953,25 @@ iproto_msg_new(struct iproto_connection *con)
 		return NULL;
 	}
 	msg->close_connection = false;
+	msg->auth_token = BOX_USER_MAX;
 	msg->connection = con;
 	msg->stream = NULL;
 	msg->accepted = false;
+	stailq_create(&msg->splices);
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	return msg;
 }
 
+/**
+ * Passes the splices sent to the socket to the tx thread along with
+ * a message so that tx releases them, see tx_accept_msg().
+ */
+static inline void
+iproto_msg_take_sent_splices(struct iproto_msg *msg)
+{
+	stailq_concat(&msg->splices, &msg->connection->sent_splices);
+}
+
 /**
  * Signal input unless it's blocked on I/O or stopped.
  */
@@ -1202,6 +1351,17 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 
 		iproto_msg_prepare(msg, &pos, reqend, &stop_input);
 
+		if (iproto_process_select_from_read_view(msg)) {
+			/* Request is parsed and processed. */
+			assert(con->parse_size >= (size_t) (reqend - reqstart));
+			con->parse_size -= reqend - reqstart;
+			iproto_msg_finish_input(msg);
+			iproto_msg_delete(msg);
+			iproto_connection_feed_output(con);
+			n_requests++;
+			continue;
+		}
+
 		int rc = iproto_msg_start_processing_in_stream(msg);
 		if (rc < 0) {
 			iproto_msg_delete(msg);
@@ -1212,6 +1372,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		 * empty, skip push.
 		 */
 		if (rc == 0) {
+			iproto_msg_take_sent_splices(msg);
 			/*
 			 * This can't throw, but should not be
 			 * done in case of exception.
@@ -1371,64 +1532,161 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
-/** writev() to the socket and handle the result. */
-static int
-iproto_flush(struct iproto_connection *con)
+/**
+ * Returns the size of the contiguous output buffer data at @a svp, which
+ * must precede @a end. Moves @a svp to the next vector if the current
+ * one is exhausted.
+ */
+static inline size_t
+iproto_obuf_chunk_size(struct obuf *obuf, struct obuf_svp *svp,
+		       const struct obuf_svp *end)
 {
-	struct obuf *obuf = con->wpos.obuf;
-	struct obuf_svp obuf_end = obuf_create_svp(obuf);
-	struct obuf_svp *begin = &con->wpos.svp;
-	struct obuf_svp *end = &con->wend.svp;
-	if (con->wend.obuf != obuf) {
+	while (true) {
 		/*
-		 * Flush the current buffer before
-		 * advancing to the next one.
+		 * iov[i].iov_len may be concurrently modified in tx thread,
+		 * but only for the last position.
 		 */
-		if (begin->used == obuf_end.used) {
-			obuf = con->wpos.obuf = con->wend.obuf;
-			obuf_svp_reset(begin);
-		} else {
-			end = &obuf_end;
-		}
+		size_t iov_len = svp->pos == end->pos ? end->iov_len :
+				 obuf->iov[svp->pos].iov_len;
+		if (svp->iov_len < iov_len)
+			return iov_len - svp->iov_len;
+		assert(svp->pos < end->pos);
+		svp->pos++;
+		svp->iov_len = 0;
 	}
-	if (begin->used == end->used) {
-		/* Nothing to do. */
-		return 1;
+}
+
+/** Advances @a svp by @a size bytes, not past @a end. */
+static void
+iproto_obuf_svp_advance(struct obuf *obuf, struct obuf_svp *svp,
+			const struct obuf_svp *end, size_t size)
+{
+	while (size > 0) {
+		size_t len = MIN(iproto_obuf_chunk_size(obuf, svp, end), size);
+		svp->iov_len += len;
+		svp->used += len;
+		size -= len;
+	}
+}
+
+/**
+ * Fills @a iov with the output buffer data starting at @a svp up to
+ * the @a limit offset, which must not exceed @a end, and advances @a svp.
+ * Returns the new number of vectors.
+ */
+static int
+iproto_obuf_to_iov(struct obuf *obuf, struct obuf_svp *svp,
+		   const struct obuf_svp *end, size_t limit,
+		   struct iovec *iov, int iovcnt)
+{
+	assert(limit <= end->used);
+	while (svp->used < limit && iovcnt < IPROTO_IOV_MAX) {
+		size_t len = iproto_obuf_chunk_size(obuf, svp, end);
+		len = MIN(len, limit - svp->used);
+		iov[iovcnt].iov_base =
+			(char *)obuf->iov[svp->pos].iov_base + svp->iov_len;
+		iov[iovcnt].iov_len = len;
+		iovcnt++;
+		svp->iov_len += len;
+		svp->used += len;
 	}
+	return iovcnt;
+}
+
+/** Returns the first splice if it's inserted into @a obuf, NULL otherwise. */
+static inline struct iproto_splice *
+iproto_connection_first_splice(struct iproto_connection *con,
+			       struct obuf *obuf)
+{
+	if (stailq_empty(&con->splices))
+		return NULL;
+	struct iproto_splice *splice = stailq_first_entry(
+		&con->splices, struct iproto_splice, in_list);
+	return splice->obuf == obuf ? splice : NULL;
+}
+
+/** Marks the first splice as sent to the socket. */
+static inline void
+iproto_connection_complete_splice(struct iproto_connection *con)
+{
+	struct stailq_entry *splice = stailq_shift(&con->splices);
+	stailq_add_tail(&con->sent_splices, splice);
+	con->splice_sent = 0;
+}
+
+/**
+ * writev() the [begin, end) range of the output buffer to the socket and
+ * handle the result. Advances the begin position. The data of the splices
+ * inserted into the range are written in between the buffer data.
+ */
+static int
+iproto_flush_obuf(struct iproto_connection *con, struct obuf *obuf,
+		  struct obuf_svp *begin, struct obuf_svp *end)
+{
 	if (!con->can_write) {
 		/* Receiving end was closed. Discard the output. */
 		*begin = *end;
+		while (iproto_connection_first_splice(con, obuf) != NULL)
+			iproto_connection_complete_splice(con);
 		return 0;
 	}
-	assert(begin->used < end->used);
-	struct iovec iov[SMALL_OBUF_IOV_MAX+1];
-	struct iovec *src = obuf->iov;
-	int iovcnt = end->pos - begin->pos + 1;
-	/*
-	 * iov[i].iov_len may be concurrently modified in tx thread,
-	 * but only for the last position.
-	 */
-	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
-	sio_add_to_iov(iov, -begin->iov_len);
-	/* *Overwrite* iov_len of the last pos as it may be garbage. */
-	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
+	struct iovec iov[IPROTO_IOV_MAX];
+	/* Splice written by each vector or NULL if it's the buffer data. */
+	struct iproto_splice *iov_splice[IPROTO_IOV_MAX];
+	int iovcnt = 0;
+	struct obuf_svp pos = *begin;
+	struct iproto_splice *splice =
+		iproto_connection_first_splice(con, obuf);
+	size_t splice_sent = con->splice_sent;
+	while (iovcnt < IPROTO_IOV_MAX) {
+		size_t limit = splice != NULL ? splice->offset : end->used;
+		assert(limit <= end->used);
+		int n = iproto_obuf_to_iov(obuf, &pos, end, limit, iov, iovcnt);
+		for (; iovcnt < n; iovcnt++)
+			iov_splice[iovcnt] = NULL;
+		if (splice == NULL || pos.used < limit ||
+		    iovcnt == IPROTO_IOV_MAX)
+			break;
+		iov[iovcnt].iov_base = (char *)splice->data + splice_sent;
+		iov[iovcnt].iov_len = splice->size - splice_sent;
+		iov_splice[iovcnt++] = splice;
+		splice_sent = 0;
+		struct stailq_entry *next = stailq_next(&splice->in_list);
+		splice = next == NULL ? NULL :
+			 stailq_entry(next, struct iproto_splice, in_list);
+		if (splice != NULL && splice->obuf != obuf)
+			splice = NULL;
+	}
+	assert(iovcnt > 0);
 
 	ssize_t nwr = iostream_writev(&con->io, iov, iovcnt);
 	if (nwr >= 0) {
 		/* Count statistics */
 		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
-		if (begin->used + nwr == end->used) {
+		size_t left = nwr;
+		for (int i = 0; i < iovcnt && left > 0; i++) {
+			size_t len = MIN(iov[i].iov_len, left);
+			left -= len;
+			if (iov_splice[i] == NULL) {
+				iproto_obuf_svp_advance(obuf, begin, end, len);
+				continue;
+			}
+			assert(iproto_connection_first_splice(con, obuf) ==
+			       iov_splice[i]);
+			con->splice_sent += len;
+			if (len == iov[i].iov_len)
+				iproto_connection_complete_splice(con);
+		}
+		if (begin->used == end->used &&
+		    iproto_connection_first_splice(con, obuf) == NULL) {
 			*begin = *end;
 			return 0;
 		}
-		size_t offset = 0;
-		int advance = 0;
-		advance = sio_move_iov(iov, nwr, &offset);
-		begin->used += nwr;             /* advance write position */
-		begin->iov_len = advance == 0 ? begin->iov_len + offset: offset;
-		begin->pos += advance;
-		assert(begin->pos <= end->pos);
-		return IOSTREAM_WANT_WRITE;
+		/* Continue if the socket accepted everything we had. */
+		size_t size = 0;
+		for (int i = 0; i < iovcnt; i++)
+			size += iov[i].iov_len;
+		return (size_t)nwr == size ? 0 : IOSTREAM_WANT_WRITE;
 	} else if (nwr == IOSTREAM_ERROR) {
 		/*
 		 * Don't close the connection on write error. Log the error and
@@ -1439,11 +1697,79 @@ iproto_flush(struct iproto_connection *con)
 		diag_log();
 		con->can_write = false;
 		*begin = *end;
+		while (iproto_connection_first_splice(con, obuf) != NULL)
+			iproto_connection_complete_splice(con);
 		return 0;
 	}
 	return nwr;
 }
 
+/** Check if there's output from the tx thread not flushed yet. */
+static inline bool
+iproto_connection_has_tx_output(struct iproto_connection *con)
+{
+	return con->wpos.obuf != con->wend.obuf ||
+	       con->wpos.svp.used != con->wend.svp.used ||
+	       !stailq_empty(&con->splices);
+}
+
+/**
+ * Flush responses to selects served from a read view. Returns 1 if there
+ * is nothing to flush.
+ */
+static int
+iproto_flush_rv_obuf(struct iproto_connection *con)
+{
+	struct obuf *obuf = &con->rv_obuf;
+	struct obuf_svp end = obuf_create_svp(obuf);
+	if (con->rv_wpos.used == end.used)
+		return 1;
+	int rc = iproto_flush_obuf(con, obuf, &con->rv_wpos, &end);
+	if (rc == 0) {
+		/* Everything is flushed, recycle the buffer. */
+		obuf_reset(obuf);
+		con->rv_wpos = obuf_create_svp(obuf);
+	}
+	return rc;
+}
+
+/** Flush the connection output buffers to the socket. */
+static int
+iproto_flush(struct iproto_connection *con)
+{
+	/*
+	 * Responses to selects served from a read view precede all
+	 * the output from the tx thread that hasn't been flushed yet,
+	 * see iproto_process_select_from_read_view().
+	 */
+	int rc = iproto_flush_rv_obuf(con);
+	if (rc != 1)
+		return rc;
+	struct obuf *obuf = con->wpos.obuf;
+	struct obuf_svp obuf_end = obuf_create_svp(obuf);
+	struct obuf_svp *begin = &con->wpos.svp;
+	struct obuf_svp *end = &con->wend.svp;
+	if (con->wend.obuf != obuf) {
+		/*
+		 * Flush the current buffer before
+		 * advancing to the next one.
+		 */
+		if (begin->used == obuf_end.used &&
+		    iproto_connection_first_splice(con, obuf) == NULL) {
+			obuf = con->wpos.obuf = con->wend.obuf;
+			obuf_svp_reset(begin);
+		} else {
+			end = &obuf_end;
+		}
+	}
+	if (begin->used == end->used &&
+	    iproto_connection_first_splice(con, obuf) == NULL) {
+		/* Nothing to do. */
+		return 1;
+	}
+	return iproto_flush_obuf(con, obuf, begin, end);
+}
+
 static void
 iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 			    int /* revents */)
@@ -1501,6 +1827,12 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	con->tx.p_obuf = &con->obuf[0];
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
+	stailq_create(&con->splices);
+	con->splice_sent = 0;
+	stailq_create(&con->sent_splices);
+	obuf_create(&con->rv_obuf, cord_slab_cache(), iproto_readahead);
+	con->rv_wpos = obuf_create_svp(&con->rv_obuf);
+	con->auth_token = BOX_USER_MAX;
 	con->parse_size = 0;
 	con->can_write = true;
 	con->long_poll_count = 0;
@@ -1530,6 +1862,7 @@ iproto_connection_delete(struct iproto_connection *con)
 	 */
 	ibuf_destroy(&con->ibuf[0]);
 	ibuf_destroy(&con->ibuf[1]);
+	obuf_destroy(&con->rv_obuf);
 	assert(con->obuf[0].pos == 0 &&
 	       con->obuf[0].iov[0].iov_base == NULL);
 	assert(con->obuf[1].pos == 0 &&
@@ -1663,6 +1996,104 @@ iproto_msg_prepare(struct iproto_msg *msg, const char **pos, const char *reqend,
 	cmsg_init(&msg->base, iproto_thread->error_route);
 }
 
+static bool
+iproto_process_select_from_read_view(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct iproto_read_view *rv = iproto_thread->read_view;
+	if (rv == NULL || msg->base.route != iproto_thread->select_route)
+		return false;
+	/*
+	 * Don't overtake requests being processed by the tx thread, because
+	 * they may change the session user. This also guarantees that
+	 * the connection auth token is known if it was ever set.
+	 *
+	 * Don't overtake responses that haven't been flushed either, so
+	 * that responses are sent in the order of requests.
+	 */
+	if (con->input_msg_count[0] + con->input_msg_count[1] != 1 ||
+	    con->long_poll_count != 0 || con->auth_token == BOX_USER_MAX ||
+	    iproto_connection_has_tx_output(con))
+		return false;
+	struct request *req = &msg->dml;
+	if (msg->header.stream_id != 0 || req->after_position != NULL ||
+	    req->after_tuple != NULL || req->fetch_position)
+		return false;
+	/* Let the tx thread reply with ER_WRONG_SCHEMA_VERSION. */
+	if (msg->header.schema_version != 0 &&
+	    msg->header.schema_version != rv->schema_version)
+		return false;
+	mh_int_t k = mh_i32ptr_find(rv->spaces, req->space_id, NULL);
+	if (k == mh_end(rv->spaces))
+		return false;
+	struct iproto_read_view_space *space =
+		(struct iproto_read_view_space *)
+		mh_i32ptr_node(rv->spaces, k)->val;
+	if ((space->read_access & (1U << con->auth_token)) == 0)
+		return false;
+	struct index_read_view *index =
+		space_read_view_index(space->space, req->index_id);
+	if (index == NULL || req->iterator >= iterator_type_MAX)
+		return false;
+	/*
+	 * Any error is handled by falling back to the tx thread, which
+	 * reports it to the client, so we don't care about diag here.
+	 */
+	enum iterator_type type = (enum iterator_type)req->iterator;
+	const char *key = req->key;
+	uint32_t part_count = key != NULL ? mp_decode_array(&key) : 0;
+	struct index_read_view_iterator it;
+	if (key_validate(index->def, type, key, part_count) != 0 ||
+	    index_read_view_create_iterator(index, type, key, part_count,
+					    &it) != 0) {
+		diag_clear(diag_get());
+		return false;
+	}
+	struct obuf *out = &con->rv_obuf;
+	struct obuf_svp svp;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	if (iproto_prepare_select(out, &svp) != 0) {
+		index_read_view_iterator_destroy(&it);
+		diag_clear(diag_get());
+		return false;
+	}
+	uint32_t offset = req->offset;
+	uint32_t count = 0;
+	int rc = 0;
+	while (count < req->limit) {
+		struct read_view_tuple tuple;
+		rc = index_read_view_iterator_next_raw(&it, &tuple);
+		if (rc != 0 || tuple.data == NULL)
+			break;
+		assert(!tuple.needs_upgrade);
+		if (offset > 0) {
+			offset--;
+		} else if (obuf_dup(out, tuple.data, tuple.size) !=
+			   tuple.size) {
+			diag_set(OutOfMemory, tuple.size, "obuf_dup", "data");
+			rc = -1;
+		} else {
+			count++;
+		}
+		/* The tuple data may be decompressed on the region. */
+		region_truncate(region, region_svp);
+		if (rc != 0)
+			break;
+	}
+	index_read_view_iterator_destroy(&it);
+	if (rc != 0) {
+		obuf_rollback_to_svp(out, &svp);
+		diag_clear(diag_get());
+		return false;
+	}
+	iproto_reply_select(out, &svp, msg->header.sync, rv->schema_version,
+			    count, 0);
+	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+	return true;
+}
+
 static int
 iproto_msg_decode(struct iproto_msg *msg, struct cmsg_hop **route)
 {
@@ -1675,6 +2106,7 @@ iproto_msg_decode(struct iproto_msg *msg, struct cmsg_hop **route)
 	case IPROTO_UPDATE:
 	case IPROTO_DELETE:
 	case IPROTO_UPSERT:
+	case IPROTO_DELETE_RANGE:
 		assert(type < sizeof(iproto_thread->dml_route) /
 			      sizeof(*iproto_thread->dml_route));
 		*route = iproto_thread->dml_route[type];
@@ -1842,6 +2274,18 @@ net_finish_disconnect(struct cmsg *m)
 	iproto_connection_try_to_start_destroy(con);
 }
 
+/** Releases splices and unreferences their tuples. */
+static void
+tx_release_splices(struct stailq *splices)
+{
+	struct iproto_splice *splice, *next;
+	stailq_foreach_entry_safe(splice, next, splices, in_list) {
+		tuple_unref(splice->tuple);
+		mempool_free(&iproto_splice_pool, splice);
+	}
+	stailq_create(splices);
+}
+
 /**
  * Destroy the session object, as well as output buffers of the
  * connection.
@@ -1862,6 +2306,9 @@ tx_process_destroy(struct cmsg *m)
 	 */
 	obuf_destroy(&con->obuf[0]);
 	obuf_destroy(&con->obuf[1]);
+	/* The connection is closed so the splices won't be sent. */
+	tx_release_splices(&con->splices);
+	tx_release_splices(&con->sent_splices);
 }
 
 /**
@@ -1989,6 +2436,7 @@ tx_accept_msg(struct cmsg *m)
 		return msg;
 	msg->accepted = true;
 	tx_accept_wpos(msg->connection, &msg->wpos);
+	tx_release_splices(&msg->splices);
 	tx_fiber_init(msg->connection->session, msg->header.sync);
 	tx_prepare_transaction_for_request(msg);
 	msg->connection->iproto_thread->tx.requests_in_progress++;
@@ -2044,6 +2492,7 @@ tx_end_msg(struct iproto_msg *msg, struct obuf_svp *svp)
 		msg->stream->txn = txn_detach();
 	}
 	msg->connection->iproto_thread->tx.requests_in_progress--;
+	msg->auth_token = msg->connection->session->credentials.auth_token;
 	struct obuf *out = msg->connection->tx.p_obuf;
 	if (msg->connection->tx.p_obuf->used != svp->used)
 		/* Log response to the flight recorder. */
@@ -2200,7 +2649,7 @@ tx_process1(struct cmsg *m)
 	if (tuple && tuple_to_obuf(tuple, out))
 		goto error;
 	iproto_reply_select(out, &svp, msg->header.sync, box_schema_version(),
-			    tuple != 0);
+			    tuple != 0, 0);
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg, &svp);
 	return;
@@ -2211,6 +2660,65 @@ tx_process1(struct cmsg *m)
 	tx_end_msg(msg, &svp);
 }
 
+/** Context of tx_splice_tuple(). */
+struct tx_splice_ctx {
+	/** Message the splices are added to. */
+	struct iproto_msg *msg;
+	/** Total size of the spliced tuple data. */
+	size_t size;
+};
+
+/**
+ * Callback for port_c_dump_msgpack_16_splice(). References the tuple
+ * and adds it to the message splices to be written to the socket
+ * directly by the iproto thread. Falls back on copying if a splice
+ * can't be allocated.
+ */
+static bool
+tx_splice_tuple(struct tuple *tuple, struct obuf *out, void *arg)
+{
+	struct tx_splice_ctx *ctx = (struct tx_splice_ctx *)arg;
+	struct iproto_splice *splice = (struct iproto_splice *)
+		mempool_alloc(&iproto_splice_pool);
+	if (splice == NULL)
+		return false;
+	splice->obuf = out;
+	splice->offset = obuf_size(out);
+	splice->tuple = tuple;
+	tuple_ref(tuple);
+	uint32_t bsize;
+	splice->data = tuple_data_range(tuple, &bsize);
+	splice->size = bsize;
+	stailq_add_tail_entry(&ctx->msg->splices, splice, in_list);
+	ctx->size += bsize;
+	return true;
+}
+
+/**
+ * Dumps a select result set to the output buffer. The data of tuples of
+ * iproto_select_splice_size or larger isn't copied, see tx_splice_tuple().
+ * Returns the number of tuples or -1 on error. The size of the data of
+ * the spliced tuples is returned in @a splice_size.
+ */
+static int
+tx_dump_select(struct iproto_msg *msg, struct port *port, struct obuf *out,
+	       size_t *splice_size)
+{
+	*splice_size = 0;
+	int threshold = iproto_select_splice_size;
+#if defined(ENABLE_FLIGHT_RECORDER)
+	/* The flight recorder logs responses from the output buffer. */
+	threshold = 0;
+#endif
+	if (threshold <= 0)
+		return port_dump_msgpack_16(port, out);
+	struct tx_splice_ctx ctx = {msg, 0};
+	int rc = port_c_dump_msgpack_16_splice(port, out, threshold,
+					       tx_splice_tuple, &ctx);
+	*splice_size = ctx.size;
+	return rc;
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
@@ -2220,6 +2728,7 @@ tx_process_select(struct cmsg *m)
 	struct port port;
 	int count;
 	int rc;
+	size_t splice_size;
 	const char *packed_pos, *packed_pos_end;
 	bool reply_position;
 	struct request *req = &msg->dml;
@@ -2260,7 +2769,7 @@ tx_process_select(struct cmsg *m)
 	/*
 	 * SELECT output format has not changed since Tarantool 1.6
 	 */
-	count = port_dump_msgpack_16(&port, out);
+	count = tx_dump_select(msg, &port, out, &splice_size);
 	port_destroy(&port);
 	if (count < 0) {
 		goto discard;
@@ -2270,13 +2779,13 @@ tx_process_select(struct cmsg *m)
 		if (iproto_reply_select_with_position(out, &svp,
 						      msg->header.sync,
 						      box_schema_version(),
-						      count,
+						      count, splice_size,
 						      packed_pos,
 						      packed_pos_end) != 0)
 			goto discard;
 	} else {
 		iproto_reply_select(out, &svp, msg->header.sync,
-				    box_schema_version(), count);
+				    box_schema_version(), count, splice_size);
 	}
 	region_truncate(&fiber()->gc, region_svp);
 	iproto_wpos_create(&msg->wpos, out);
@@ -2285,6 +2794,7 @@ tx_process_select(struct cmsg *m)
 discard:
 	/* Discard the prepared select. */
 	obuf_rollback_to_svp(out, &svp);
+	tx_release_splices(&msg->splices);
 error:
 	region_truncate(&fiber()->gc, region_svp);
 	out = msg->connection->tx.p_obuf;
@@ -2392,7 +2902,7 @@ tx_process_call(struct cmsg *m)
 	}
 
 	iproto_reply_select(out, &svp, msg->header.sync,
-			    box_schema_version(), count);
+			    box_schema_version(), count, 0);
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg, &svp);
 	return;
@@ -2745,6 +3255,7 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 					   in_stream);
 		assert(stream->current != NULL);
 		stream->current->wpos = con->wpos;
+		iproto_msg_take_sent_splices(stream->current);
 		con->iproto_thread->requests_in_stream_queue--;
 		cpipe_push_input(&con->iproto_thread->tx_pipe,
 				 &stream->current->base);
@@ -2768,6 +3279,8 @@ net_send_msg(struct cmsg *m)
 		con->long_poll_count--;
 	}
 	con->wend = msg->wpos;
+	con->auth_token = msg->auth_token;
+	stailq_concat(&con->splices, &msg->splices);
 
 	if (con->state == IPROTO_CONNECTION_ALIVE) {
 		iproto_connection_feed_output(con);
@@ -3199,6 +3712,8 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->dml_route[12] = NULL;
 	/* IPROTO_PREPARE */
 	iproto_thread->dml_route[13] = iproto_thread->sql_route;
+	/* IPROTO_DELETE_RANGE */
+	iproto_thread->dml_route[17] = iproto_thread->process1_route;
 	iproto_thread->connect_route[0] =
 		{ tx_process_connect, &iproto_thread->net_pipe };
 	iproto_thread->connect_route[1] = { net_send_greeting, NULL };
@@ -3250,6 +3765,8 @@ iproto_init(int threads_count)
 	 * we don't need any accept functions.
 	 */
 	evio_service_create(loop(), &tx_binary, "tx_binary", NULL, NULL);
+	mempool_create(&iproto_splice_pool, &cord()->slabc,
+		       sizeof(struct iproto_splice));
 	iproto_threads = (struct iproto_thread *)
 		xcalloc(threads_count, sizeof(struct iproto_thread));
 
@@ -3313,6 +3830,11 @@ enum iproto_cfg_op {
 	 * reset.
 	 */
 	IPROTO_CFG_OVERRIDE,
+	/**
+	 * Command code to set the read view used to serve selects in
+	 * IPROTO threads.
+	 */
+	IPROTO_CFG_READ_VIEW,
 };
 
 /**
@@ -3338,6 +3860,8 @@ struct iproto_cfg_msg: public cbus_call_msg
 			/** Whether the request handler is set or reset. */
 			bool is_set;
 		} override;
+		/** New read view or NULL. */
+		struct iproto_read_view *read_view;
 	};
 	struct iproto_thread *iproto_thread;
 };
@@ -3402,7 +3926,12 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 			}
 			evio_service_create(loop(), binary, "binary",
 					    iproto_on_accept, iproto_thread);
-			evio_service_attach(binary, cfg_msg->binary);
+			if (!cfg_msg->binary->reuseport) {
+				evio_service_attach(binary, cfg_msg->binary);
+			} else if (evio_service_attach_reuseport(
+					binary, cfg_msg->binary) != 0) {
+				diag_raise();
+			}
 			if (evio_service_listen(binary) != 0)
 				diag_raise();
 			break;
@@ -3429,6 +3958,9 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 				mh_i32_del(req_handlers, k, NULL);
 			}
 			break;
+		case IPROTO_CFG_READ_VIEW:
+			iproto_thread->read_view = cfg_msg->read_view;
+			break;
 		default:
 			unreachable();
 		}
@@ -3478,16 +4010,22 @@ iproto_send_listen_msg(struct evio_service *binary)
 }
 
 int
-iproto_listen(const struct uri_set *uri_set)
+iproto_listen(const struct uri_set *uri_set, bool reuseport)
 {
 	iproto_send_stop_msg();
 	evio_service_stop(&tx_binary);
 	evio_service_create(loop(), &tx_binary, "tx_binary", NULL, NULL);
+	tx_binary.reuseport = reuseport;
 	/*
 	 * Please note, we bind sockets in main thread, and then
 	 * listen these sockets in all iproto threads! With this
 	 * implementation, we rely on the Linux kernel to distribute
-	 * incoming connections across iproto threads.
+	 * incoming connections across iproto threads. A connection
+	 * is accepted by the thread that wins the race, so under
+	 * load some threads may get much more connections than
+	 * others. To avoid that, in the reuseport mode each iproto
+	 * thread binds its own socket to the same address and the
+	 * kernel distributes connections evenly among the sockets.
 	 */
 	if (evio_service_bind(&tx_binary, uri_set) != 0)
 		return -1;
@@ -3575,6 +4113,155 @@ iproto_cfg_override(uint32_t req_type, bool is_set)
 		iproto_do_cfg_crit(&iproto_threads[i], &cfg_msg);
 }
 
+/** Max staleness of the iproto read view, in seconds, or 0 if disabled. */
+static double iproto_read_view_staleness;
+/** Fiber that refreshes the iproto read view. */
+static struct fiber *iproto_read_view_fiber;
+/** Read view currently used by iproto threads or NULL. */
+static struct iproto_read_view *iproto_read_view;
+
+/** Space filter of the iproto read view. */
+static bool
+iproto_read_view_filter_space(struct space *space, void *arg)
+{
+	(void)arg;
+	/*
+	 * Tuples of a space that is being upgraded may need to be upgraded
+	 * before being sent to the client, which is done in tx.
+	 */
+	return space->def->opts.iproto_read_view && space->upgrade == NULL;
+}
+
+/**
+ * Returns the bit mask of auth tokens of the users that are allowed to
+ * read the given space.
+ */
+static uint32_t
+iproto_read_view_space_access(struct space *space)
+{
+	uint32_t mask = 0;
+	for (uint8_t token = 0; token < BOX_USER_MAX; token++) {
+		struct user *user = user_find_by_token(token);
+		if (user->def == NULL)
+			continue;
+		struct credentials cr;
+		credentials_create(&cr, user);
+		if (space_access_is_granted(space, &cr, BOX_PRIVILEGE_READ))
+			mask |= 1U << token;
+		credentials_destroy(&cr);
+	}
+	return mask;
+}
+
+/**
+ * Opens a new iproto read view. Returns NULL and sets diag on error.
+ * Access rights are evaluated at the time of the read view creation.
+ */
+static struct iproto_read_view *
+iproto_read_view_new(void)
+{
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = "iproto";
+	opts.filter_space = iproto_read_view_filter_space;
+	opts.enable_data_temporary_spaces = true;
+	struct iproto_read_view *rv =
+		(struct iproto_read_view *)xmalloc(sizeof(*rv));
+	if (read_view_open(&rv->rv, &opts) != 0) {
+		free(rv);
+		return NULL;
+	}
+	rv->schema_version = box_schema_version();
+	rv->spaces = mh_i32ptr_new();
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, &rv->rv) {
+		struct space *space = space_by_id(space_rv->id);
+		assert(space != NULL);
+		struct iproto_read_view_space *rv_space =
+			(struct iproto_read_view_space *)
+			xmalloc(sizeof(*rv_space));
+		rv_space->space = space_rv;
+		rv_space->read_access = iproto_read_view_space_access(space);
+		struct mh_i32ptr_node_t node = {space_rv->id, rv_space};
+		mh_i32ptr_put(rv->spaces, &node, NULL, NULL);
+	}
+	return rv;
+}
+
+/** Closes an iproto read view. */
+static void
+iproto_read_view_delete(struct iproto_read_view *rv)
+{
+	mh_int_t i;
+	mh_foreach(rv->spaces, i)
+		free(mh_i32ptr_node(rv->spaces, i)->val);
+	mh_i32ptr_delete(rv->spaces);
+	read_view_close(&rv->rv);
+	free(rv);
+}
+
+/**
+ * Makes iproto threads use the given read view (may be NULL) and closes
+ * the read view used before. Selects are processed by iproto threads
+ * without yielding so once all threads have confirmed the switch, the old
+ * read view isn't used anymore.
+ */
+static void
+iproto_read_view_set(struct iproto_read_view *rv)
+{
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_READ_VIEW);
+	cfg_msg.read_view = rv;
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_do_cfg_crit(&iproto_threads[i], &cfg_msg);
+	if (iproto_read_view != NULL)
+		iproto_read_view_delete(iproto_read_view);
+	iproto_read_view = rv;
+}
+
+/** Fiber function that periodically refreshes the iproto read view. */
+static int
+iproto_read_view_f(va_list ap)
+{
+	(void)ap;
+	while (!fiber_is_cancelled()) {
+		struct iproto_read_view *rv = NULL;
+		/*
+		 * on_select triggers must fire for every select so serve
+		 * all selects from tx if there are any.
+		 */
+		if (iproto_read_view_staleness > 0 &&
+		    rlist_empty(&box_on_select)) {
+			rv = iproto_read_view_new();
+			if (rv == NULL)
+				diag_log();
+		}
+		if (rv != NULL || iproto_read_view != NULL)
+			iproto_read_view_set(rv);
+		if (iproto_read_view_staleness > 0)
+			fiber_sleep(iproto_read_view_staleness);
+		else
+			fiber_yield();
+	}
+	return 0;
+}
+
+void
+iproto_set_read_view_staleness(double staleness)
+{
+	assert(staleness >= 0);
+	iproto_read_view_staleness = staleness;
+	if (iproto_read_view_fiber == NULL) {
+		if (staleness == 0)
+			return;
+		iproto_read_view_fiber = fiber_new_system("iproto_read_view",
+							  iproto_read_view_f);
+		if (iproto_read_view_fiber == NULL)
+			panic("failed to start iproto read view fiber");
+	}
+	fiber_wakeup(iproto_read_view_fiber);
+}
+
 int
 iproto_session_send(struct session *session,
 		    const char *header, const char *header_end,
@@ -3631,6 +4318,7 @@ iproto_free(void)
 	for (int i = 0; i < iproto_threads_count; i++) {
 		cord_cancel_and_join(&iproto_threads[i].net_cord);
 		mh_i32_delete(iproto_threads[i].req_handlers);
+		iproto_threads[i].read_view = NULL;
 		/*
 		 * Close socket descriptor to prevent hot standby instance
 		 * failing to bind in case it tries to bind before socket
@@ -3642,6 +4330,11 @@ iproto_free(void)
 		slab_cache_destroy(&iproto_threads[i].net_slabc);
 	}
 	free(iproto_threads);
+	mempool_destroy(&iproto_splice_pool);
+	if (iproto_read_view != NULL) {
+		iproto_read_view_delete(iproto_read_view);
+		iproto_read_view = NULL;
+	}
 
 	mh_int_t i;
 	mh_foreach(tx_req_handlers, i) {
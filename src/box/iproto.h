@@ -138,12 +138,25 @@ iproto_override(uint32_t req_type, iproto_handler_t cb,
 void
 iproto_init(int threads_count);
 
+/**
+ * Binds to the given URIs and starts listening in all IPROTO threads.
+ * If @a reuseport is set, each IPROTO thread listens on its own TCP
+ * socket bound with SO_REUSEPORT.
+ */
 int
-iproto_listen(const struct uri_set *uri_set);
+iproto_listen(const struct uri_set *uri_set, bool reuseport);
 
 void
 iproto_set_msg_max(int iproto_msg_max);
 
+/**
+ * Sets the max staleness, in seconds, of the read view used by IPROTO
+ * threads to serve selects from spaces with the iproto_read_view option
+ * bypassing the tx thread. Zero disables read view selects.
+ */
+void
+iproto_set_read_view_staleness(double staleness);
+
 /**
  * Sends a packet with the given header and body over the IPROTO session's
  * socket.
@@ -49,6 +49,7 @@ const uint64_t iproto_body_key_map[IPROTO_TYPE_STAT_MAX] = {
 	0,                                                     /* BEGIN */
 	0,                                                     /* COMMIT */
 	0,                                                     /* ROLLBACK */
+	bit(SPACE_ID) | bit(KEY),                              /* DELETE_RANGE */
 };
 #undef bit
 
@@ -115,6 +116,13 @@ const char *vy_page_info_key_strs[vy_page_info_key_MAX] = {
 	VY_PAGE_INFO_KEYS(VY_PAGE_INFO_KEY_STRS_MEMBER)
 };
 
+#define VY_PART_INFO_KEY_STRS_MEMBER(s, ...) \
+	[VY_PART_INFO_ ## s] = #s,
+
+const char *vy_part_info_key_strs[vy_part_info_key_MAX] = {
+	VY_PART_INFO_KEYS(VY_PART_INFO_KEY_STRS_MEMBER)
+};
+
 #define VY_ROW_INDEX_KEY_STRS_MEMBER(s, ...) \
 	[VY_ROW_INDEX_ ## s] = #s,
 
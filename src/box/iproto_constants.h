@@ -310,6 +310,8 @@ iproto_key_bit(unsigned char key)
 	_(COMMIT, 15)							\
 	/* Rollback transaction */					\
 	_(ROLLBACK, 16)							\
+	/** DELETE_RANGE request, see box_delete_range(). */		\
+	_(DELETE_RANGE, 17)						\
 									\
 	_(RAFT, 30)							\
 	/** PROMOTE request. */						\
@@ -365,11 +367,13 @@ iproto_key_bit(unsigned char key)
 	_(EVENT, 76)							\
 									\
 	/**
-	 * The following three requests are reserved for vinyl types.
+	 * The following requests are reserved for vinyl types.
 	 *
 	 * VY_INDEX_RUN_INFO = 100
 	 * VY_INDEX_PAGE_INFO = 101
 	 * VY_RUN_ROW_INDEX = 102
+	 * VY_INDEX_PART_INFO = 103
+	 * VY_RUN_PART_BLOOM = 104
 	 */								\
 									\
 	/** Non-final response type. */					\
@@ -388,7 +392,7 @@ enum iproto_type {
 	IPROTO_UNKNOWN = -1,
 
 	/** The maximum typecode used for box.stat() */
-	IPROTO_TYPE_STAT_MAX = IPROTO_ROLLBACK + 1,
+	IPROTO_TYPE_STAT_MAX = IPROTO_DELETE_RANGE + 1,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -396,6 +400,10 @@ enum iproto_type {
 	VY_INDEX_PAGE_INFO = 101,
 	/** Vinyl row index stored in .run file */
 	VY_RUN_ROW_INDEX = 102,
+	/** Vinyl page index partition info stored in .index file */
+	VY_INDEX_PART_INFO = 103,
+	/** Vinyl page index partition bloom filter stored in .run file */
+	VY_RUN_PART_BLOOM = 104,
 };
 
 /** IPROTO type name by code */
@@ -436,6 +444,10 @@ iproto_type_name(uint16_t type)
 		return "PAGEINFO";
 	case VY_RUN_ROW_INDEX:
 		return "ROWINDEX";
+	case VY_INDEX_PART_INFO:
+		return "PARTINFO";
+	case VY_RUN_PART_BLOOM:
+		return "PARTBLOOM";
 	default:
 		return NULL;
 	}
@@ -480,7 +492,8 @@ static inline bool
 iproto_type_is_dml(uint16_t type)
 {
 	return (type >= IPROTO_SELECT && type <= IPROTO_DELETE) ||
-		type == IPROTO_UPSERT || type == IPROTO_NOP;
+		type == IPROTO_UPSERT || type == IPROTO_NOP ||
+		type == IPROTO_DELETE_RANGE;
 }
 
 /**
@@ -565,6 +578,12 @@ request_replace_body_create(struct request_replace_body *body,
 	_(BLOOM_FILTER, 7)						\
 	/** Number of statements of each type (map). */			\
 	_(STMT_STAT, 8)							\
+	/** Number of page index partitions in the run. */		\
+	_(PART_COUNT, 9)						\
+	/** Range deletes: array of [begin, end, lsn]. */		\
+	_(RANGE_DELETES, 10)						\
+	/** Time when the run data was dumped, in seconds. */		\
+	_(MAX_TIME, 11)							\
 
 #define VY_RUN_INFO_KEY_MEMBER(s, v) VY_RUN_INFO_ ## s = v,
 
@@ -624,6 +643,48 @@ vy_page_info_key_name(enum vy_page_info_key key)
 	return vy_page_info_key_strs[key];
 }
 
+/**
+ * Xrow keys for Vinyl page index partition information.
+ * @sa struct vy_page_index_part_info.
+ */
+#define VY_PART_INFO_KEYS(_)						\
+	/** Offset of partition data in the run file. */		\
+	_(OFFSET, 1)							\
+	/** Size of partition data in the run file. */			\
+	_(SIZE, 2)							\
+	/** Size of partition data in memory, i.e. unpacked. */	\
+	_(UNPACKED_SIZE, 3)						\
+	/** Number of pages in the partition. */			\
+	_(PAGE_COUNT, 4)						\
+	/** Minimal key stored in the partition. */			\
+	_(MIN_KEY, 5)							\
+	/** Number of statements in the partition pages. */		\
+	_(ROW_COUNT, 6)							\
+	/** Size of the partition pages in memory. */			\
+	_(BYTES, 7)							\
+	/** Size of the partition pages in the run file. */		\
+	_(BYTES_COMPRESSED, 8)						\
+
+#define VY_PART_INFO_KEY_MEMBER(s, v) VY_PART_INFO_ ## s = v,
+
+enum vy_part_info_key {
+	VY_PART_INFO_KEYS(VY_PART_INFO_KEY_MEMBER)
+	vy_part_info_key_MAX
+};
+
+/**
+ * Return vy_page_index_part_info key name by @a key code.
+ * @param key key
+ */
+static inline const char *
+vy_part_info_key_name(enum vy_part_info_key key)
+{
+	if (key <= 0 || key >= vy_part_info_key_MAX)
+		return NULL;
+	extern const char *vy_part_info_key_strs[];
+	return vy_part_info_key_strs[key];
+}
+
 /**
  * Xrow keys for Vinyl row index.
  * @sa struct vy_page_info.
@@ -136,6 +136,17 @@ lbox_cfg_set_snap_io_rate_limit(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_snap_compression_threads(struct lua_State *L)
+{
+	try {
+		box_set_snap_compression_threads();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_checkpoint_count(struct lua_State *L)
 {
@@ -251,6 +262,50 @@ lbox_cfg_set_vinyl_cache(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_page_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_page_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_page_index_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_page_index_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_compaction_io_rate_limit(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_compaction_io_rate_limit();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_partition_page_index(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_partition_page_index();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 {
@@ -281,6 +336,14 @@ lbox_cfg_set_net_msg_max(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_iproto_read_view_staleness(struct lua_State *L)
+{
+	if (box_set_iproto_read_view_staleness() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_set_prepared_stmt_cache_size(struct lua_State *L)
 {
@@ -412,6 +475,14 @@ lbox_cfg_set_replication_skip_conflict(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_apply_concurrency(struct lua_State *L)
+{
+	if (box_set_replication_apply_concurrency() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_feedback(struct lua_State *L)
 {
@@ -458,6 +529,8 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_io_collect_interval", lbox_cfg_set_io_collect_interval},
 		{"cfg_set_too_long_threshold", lbox_cfg_set_too_long_threshold},
 		{"cfg_set_snap_io_rate_limit", lbox_cfg_set_snap_io_rate_limit},
+		{"cfg_set_snap_compression_threads",
+		 lbox_cfg_set_snap_compression_threads},
 		{"cfg_set_checkpoint_count", lbox_cfg_set_checkpoint_count},
 		{"cfg_set_checkpoint_interval", lbox_cfg_set_checkpoint_interval},
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
@@ -469,6 +542,12 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_vinyl_memory", lbox_cfg_set_vinyl_memory},
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
+		{"cfg_set_vinyl_page_cache", lbox_cfg_set_vinyl_page_cache},
+		{"cfg_set_vinyl_page_index_cache", lbox_cfg_set_vinyl_page_index_cache},
+		{"cfg_set_vinyl_partition_page_index",
+		 lbox_cfg_set_vinyl_partition_page_index},
+		{"cfg_set_vinyl_compaction_io_rate_limit",
+		 lbox_cfg_set_vinyl_compaction_io_rate_limit},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
 		{"cfg_set_force_recovery", lbox_cfg_set_force_recovery},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
@@ -482,8 +561,12 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_replication_synchro_timeout", lbox_cfg_set_replication_synchro_timeout},
 		{"cfg_set_replication_sync_timeout", lbox_cfg_set_replication_sync_timeout},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
+		{"cfg_set_replication_apply_concurrency",
+		 lbox_cfg_set_replication_apply_concurrency},
 		{"cfg_set_replication_anon", lbox_cfg_set_replication_anon},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
+		{"cfg_set_iproto_read_view_staleness",
+		 lbox_cfg_set_iproto_read_view_staleness},
 		{"cfg_set_sql_cache_size", lbox_set_prepared_stmt_cache_size},
 		{"cfg_set_feedback", lbox_cfg_set_feedback},
 		{"cfg_set_txn_timeout", lbox_cfg_set_txn_timeout},
@@ -34,6 +34,7 @@
 #include "info/info.h"
 #include "box/box.h"
 #include "box/index.h"
+#include "box/tuple.h"
 #include "box/lua/tuple.h"
 #include "box/lua/misc.h"
 #include "small/region.h"
@@ -160,6 +161,30 @@ lbox_index_delete(lua_State *L)
 	return rc == 0 ? luaT_pushtupleornil(L, result) : luaT_error(L);
 }
 
+static int
+lbox_delete_range(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) ||
+	    (lua_type(L, 2) != LUA_TTABLE && luaT_istuple(L, 2) == NULL) ||
+	    (lua_type(L, 3) != LUA_TTABLE && luaT_istuple(L, 3) == NULL))
+		return luaL_error(L, "Usage space:delete_range(begin, end)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	size_t begin_len, end_len;
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *begin = lbox_encode_tuple_on_gc(L, 2, &begin_len);
+	if (begin == NULL)
+		return luaT_error(L);
+	const char *end = lbox_encode_tuple_on_gc(L, 3, &end_len);
+	if (end == NULL)
+		return luaT_error(L);
+
+	int rc = box_delete_range(space_id, begin, begin + begin_len,
+				  end, end + end_len);
+	region_truncate(&fiber()->gc, region_svp);
+	return rc == 0 ? 0 : luaT_error(L);
+}
+
 static int
 lbox_index_random(lua_State *L)
 {
@@ -197,6 +222,44 @@ lbox_index_get(lua_State *L)
 	return rc == 0 ? luaT_pushtupleornil(L, tuple) : luaT_error(L);
 }
 
+static int
+lbox_index_get_many(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2))
+		return luaL_error(L, "Usage index.get_many(space_id, index_id, "
+				  "keys)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	size_t keys_len;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	const char *keys = lbox_encode_tuple_on_gc(L, 3, &keys_len);
+	if (keys == NULL)
+		return luaT_error(L);
+	const char *pos = keys;
+	uint32_t key_count = mp_decode_array(&pos);
+	struct tuple **result = xregion_alloc_array(region, typeof(result[0]),
+						    key_count);
+	if (box_index_get_many(space_id, index_id, keys, keys + keys_len,
+			       result) != 0) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	lua_createtable(L, key_count, 0);
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (result[i] != NULL) {
+			luaT_pushtuple(L, result[i]);
+			tuple_unref(result[i]);
+		} else {
+			luaL_pushnull(L);
+		}
+		lua_rawseti(L, -2, i + 1);
+	}
+	region_truncate(region, region_svp);
+	return 1;
+}
+
 static int
 lbox_index_min(lua_State *L)
 {
@@ -401,8 +464,10 @@ box_lua_index_init(struct lua_State *L)
 		{"update", lbox_index_update},
 		{"upsert",  lbox_upsert},
 		{"delete",  lbox_index_delete},
+		{"delete_range", lbox_delete_range},
 		{"random", lbox_index_random},
 		{"get",  lbox_index_get},
+		{"get_many", lbox_index_get_many},
 		{"min", lbox_index_min},
 		{"max", lbox_index_max},
 		{"count", lbox_index_count},
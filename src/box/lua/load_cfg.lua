@@ -91,6 +91,7 @@ local default_cfg = {
     slab_alloc_granularity = 8,
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
+    iproto_reuseport    = false,
     memtx_allocator     = "small",
     work_dir            = nil,
     memtx_dir           = ".",
@@ -100,6 +101,10 @@ local default_cfg = {
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
     vinyl_max_tuple_size = 1024 * 1024,
+    vinyl_page_cache    = 0,
+    vinyl_page_index_cache = 128 * 1024 * 1024,
+    vinyl_partition_page_index = false,
+    vinyl_compaction_io_rate_limit = nil, -- no limit
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
     vinyl_timeout       = 60,
@@ -145,11 +150,14 @@ local default_cfg = {
     io_collect_interval = nil,
     readahead           = 16320,
     snap_io_rate_limit  = nil, -- no limit
+    snap_compression_threads = nil,
     too_long_threshold  = 0.5,
     wal_mode            = "write",
     wal_max_size        = 256 * 1024 * 1024,
+    wal_io_backend      = "posix",
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
+    wal_relay_buffer_size = 16 * 1024 * 1024,
     wal_cleanup_delay   = 4 * 3600,
     wal_ext             = ifdef_wal_ext(nil),
     force_recovery      = false,
@@ -181,6 +189,7 @@ local default_cfg = {
     replication_skip_conflict = false,
     replication_anon      = false,
     replication_threads   = 1,
+    replication_apply_concurrency = 1,
     bootstrap_strategy    = "auto",
     feedback_enabled      = ifdef_feedback(true),
     feedback_crashinfo    = ifdef_feedback(true),
@@ -190,11 +199,13 @@ local default_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback(60),
     feedback_metrics_limit = ifdef_feedback(1024 * 1024),
     net_msg_max           = 768,
+    iproto_read_view_staleness = nil, -- disabled
     sql_cache_size        = 5 * 1024 * 1024,
     sql_vdbe_max_steps    = 45000,
     txn_timeout           = 365 * 100 * 86400,
     txn_isolation         = "best-effort",
     memtx_sort_threads    = nil,
+    memtx_recovery_threads = nil,
 
     metrics     = {
         include = 'all',
@@ -284,6 +295,7 @@ local template_cfg = {
     slab_alloc_granularity = 'number',
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
+    iproto_reuseport    = 'boolean',
     memtx_allocator     = 'string',
     work_dir            = 'string',
     memtx_dir            = 'string',
@@ -292,6 +304,10 @@ local template_cfg = {
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
     vinyl_max_tuple_size      = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_page_index_cache    = 'number',
+    vinyl_partition_page_index = 'boolean',
+    vinyl_compaction_io_rate_limit = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
     vinyl_timeout             = 'number',
@@ -337,9 +353,11 @@ local template_cfg = {
     io_collect_interval = 'number',
     readahead           = 'number',
     snap_io_rate_limit  = 'number',
+    snap_compression_threads = 'number',
     too_long_threshold  = 'number',
     wal_mode            = 'string',
     wal_max_size        = 'number',
+    wal_io_backend      = 'string',
     wal_dir_rescan_delay= 'number',
     wal_cleanup_delay   = 'number',
     wal_ext             = ifdef_wal_ext('table'),
@@ -355,6 +373,7 @@ local template_cfg = {
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
     wal_queue_max_size  = 'number',
+    wal_relay_buffer_size = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
@@ -374,6 +393,7 @@ local template_cfg = {
     replication_skip_conflict = 'boolean',
     replication_anon      = 'boolean',
     replication_threads   = 'number',
+    replication_apply_concurrency = 'number',
     bootstrap_strategy    = 'string',
     feedback_enabled      = ifdef_feedback('boolean'),
     feedback_crashinfo    = ifdef_feedback('boolean'),
@@ -383,10 +403,12 @@ local template_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback('number'),
     feedback_metrics_limit = ifdef_feedback('number'),
     net_msg_max           = 'number',
+    iproto_read_view_staleness = 'number',
     sql_cache_size        = 'number',
     sql_vdbe_max_steps    = 'number',
     txn_timeout           = 'number',
     memtx_sort_threads    = 'number',
+    memtx_recovery_threads = 'number',
 
     metrics = 'table',
 }
@@ -455,12 +477,18 @@ local dynamic_cfg = {
     readahead               = private.cfg_set_readahead,
     too_long_threshold      = private.cfg_set_too_long_threshold,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
+    snap_compression_threads = private.cfg_set_snap_compression_threads,
     read_only               = private.cfg_set_read_only,
     memtx_memory            = private.cfg_set_memtx_memory,
     memtx_max_tuple_size    = private.cfg_set_memtx_max_tuple_size,
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
+    vinyl_page_index_cache  = private.cfg_set_vinyl_page_index_cache,
+    vinyl_partition_page_index = private.cfg_set_vinyl_partition_page_index,
+    vinyl_compaction_io_rate_limit =
+        private.cfg_set_vinyl_compaction_io_rate_limit,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     vinyl_defer_deletes     = nop,
     checkpoint_count        = private.cfg_set_checkpoint_count,
@@ -486,11 +514,15 @@ local dynamic_cfg = {
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
+    replication_apply_concurrency =
+        private.cfg_set_replication_apply_concurrency,
     replication_anon        = private.cfg_set_replication_anon,
     bootstrap_strategy      = private.cfg_set_bootstrap_strategy,
     instance_uuid           = check_instance_uuid,
     replicaset_uuid         = check_replicaset_uuid,
     net_msg_max             = private.cfg_set_net_msg_max,
+    iproto_read_view_staleness =
+        private.cfg_set_iproto_read_view_staleness,
     sql_cache_size          = private.cfg_set_sql_cache_size,
     txn_timeout             = private.cfg_set_txn_timeout,
     txn_isolation           = private.cfg_set_txn_isolation,
@@ -525,11 +557,13 @@ local dynamic_cfg_modules = {
         cfg = private.cfg_set_listen,
         options = {
             listen = true,
+            iproto_reuseport = true,
         },
         skip_at_load = true,
         revert_cfg = private.cfg_set_listen,
         revert_fallback = {
             listen = nil,
+            iproto_reuseport = false,
         },
     },
     feedback = {
@@ -629,7 +663,12 @@ local dynamic_cfg_skip_at_load = {
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
+    vinyl_page_index_cache  = true,
+    vinyl_partition_page_index = true,
+    vinyl_compaction_io_rate_limit = true,
     vinyl_timeout           = true,
+    iproto_read_view_staleness = true,
     too_long_threshold      = true,
     election_mode           = true,
     election_timeout        = true,
@@ -643,6 +682,7 @@ local dynamic_cfg_skip_at_load = {
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
     replication_skip_conflict = true,
+    replication_apply_concurrency = true,
     replication_anon        = true,
     bootstrap_strategy      = true,
     wal_dir_rescan_delay    = true,
@@ -38,6 +38,7 @@
 
 #include "box/authentication.h"
 #include "box/box.h"
+#include "box/compression_dict.h"
 #include "box/errcode.h"
 #include "box/lua/tuple.h"
 #include "box/port.h"
@@ -235,6 +236,19 @@ lbox_generate_space_id(lua_State *L)
 	return 1;
 }
 
+/**
+ * Train a compression dictionary for a space right away, without
+ * waiting for the background fiber. Takes the space id.
+ */
+static int
+lbox_train_compression_dict(lua_State *L)
+{
+	uint32_t space_id = luaL_checkinteger(L, 1);
+	if (compression_dict_train(space_id) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
 /** Generate unique id for a function. */
 static int
 lbox_generate_func_id(lua_State *L)
@@ -556,6 +570,7 @@ box_lua_misc_init(struct lua_State *L)
 		{"read_view_status", lbox_read_view_status},
 		{"generate_space_id", lbox_generate_space_id},
 		{"generate_func_id", lbox_generate_func_id},
+		{"train_compression_dict", lbox_train_compression_dict},
 		{NULL, NULL}
 	};
 
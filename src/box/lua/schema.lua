@@ -693,6 +693,34 @@ local function check_space_type(space_type)
               table.concat(space_types, "', '") .. "'.")
 end
 
+-- Convert the ttl_field space option given by a field name or
+-- a field number (1-based) to a zero-based field number.
+local function normalize_ttl_field(ttl_field, format)
+    if type(ttl_field) == 'number' then
+        if ttl_field < 1 or ttl_field % 1 ~= 0 then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "ttl_field must be a positive integer or a field name")
+        end
+        return ttl_field - 1
+    end
+    for i, field in ipairs(format) do
+        if field.name == ttl_field then
+            return i - 1
+        end
+    end
+    box.error(box.error.ILLEGAL_PARAMS,
+              "ttl_field: field '" .. ttl_field .. "' was not found")
+end
+
+-- A tuple expiration time is taken from ttl_field so it must be set
+-- explicitly for a space with ttl.
+local function check_ttl_field(ttl, ttl_field)
+    if type(ttl) == 'number' and ttl > 0 and ttl_field == nil then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "ttl_field must be set if ttl is set")
+    end
+end
+
 box.schema.space = {}
 box.schema.space.create = function(name, options)
     check_param(name, 'name', 'string')
@@ -708,6 +736,10 @@ box.schema.space.create = function(name, options)
         temporary = 'boolean',
         is_sync = 'boolean',
         defer_deletes = 'boolean',
+        compression_dict = 'boolean',
+        iproto_read_view = 'boolean',
+        ttl = 'number',
+        ttl_field = 'string, number',
         constraint = 'string, table',
         foreign_key = 'table',
     }
@@ -753,6 +785,11 @@ box.schema.space.create = function(name, options)
     local constraint = normalize_constraint(options.constraint, '')
     local foreign_key = normalize_foreign_key(id, name, options.foreign_key, '',
                                               true)
+    local ttl_field
+    if options.ttl_field ~= nil then
+        ttl_field = normalize_ttl_field(options.ttl_field, format)
+    end
+    check_ttl_field(options.ttl, ttl_field)
     -- filter out global parameters from the options array
     local space_options = setmap({
         group_id = options.is_local and 1 or nil,
@@ -760,6 +797,10 @@ box.schema.space.create = function(name, options)
         type = options.type,
         is_sync = options.is_sync,
         defer_deletes = options.defer_deletes and true or nil,
+        compression_dict = options.compression_dict and true or nil,
+        iproto_read_view = options.iproto_read_view and true or nil,
+        ttl = options.ttl,
+        ttl_field = ttl_field,
         constraint = constraint,
         foreign_key = foreign_key,
     })
@@ -839,6 +880,21 @@ box.schema.space.drop = function(space_id, space_name, opts)
     if _truncate:get{space_id} ~= nil then
         _truncate:delete{space_id}
     end
+    -- Delete compression dictionaries trained for the space.
+    local _schema = box.space[box.schema.SCHEMA_ID]
+    local dict_prefix = 'compression_dict.'
+    local dict_keys = {}
+    for _, t in _schema:pairs(dict_prefix, {iterator = 'GE'}) do
+        if not t.key:startswith(dict_prefix) then
+            break
+        end
+        if t[2] == space_id then
+            table.insert(dict_keys, t.key)
+        end
+    end
+    for _, key in ipairs(dict_keys) do
+        _schema:delete{key}
+    end
     if _space:delete{space_id} == nil then
         if space_name == nil then
             space_name = '#'..tostring(space_id)
@@ -867,6 +923,10 @@ local alter_space_template = {
     temporary = 'boolean',
     is_sync = 'boolean',
     defer_deletes = 'boolean',
+    compression_dict = 'boolean',
+    iproto_read_view = 'boolean',
+    ttl = 'number',
+    ttl_field = 'string, number',
     name = 'string',
     constraint = 'string, table',
     foreign_key = 'table',
@@ -914,6 +974,14 @@ box.schema.space.alter = function(space_id, options)
         flags.defer_deletes = options.defer_deletes
     end
 
+    if options.compression_dict ~= nil then
+        flags.compression_dict = options.compression_dict
+    end
+
+    if options.iproto_read_view ~= nil then
+        flags.iproto_read_view = options.iproto_read_view
+    end
+
     local format
     if options.format ~= nil then
         format = normalize_format(space_id, tuple.name, options.format)
@@ -921,6 +989,15 @@ box.schema.space.alter = function(space_id, options)
         format = tuple.format
     end
 
+    if options.ttl ~= nil then
+        flags.ttl = options.ttl
+    end
+
+    if options.ttl_field ~= nil then
+        flags.ttl_field = normalize_ttl_field(options.ttl_field, format)
+    end
+    check_ttl_field(flags.ttl, flags.ttl_field)
+
     if options.constraint ~= nil then
         if table.equals(options.constraint, {}) then
             options.constraint = nil
@@ -1395,8 +1472,12 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    compaction_policy = 'string',
+    compaction_window = 'number',
     func = 'number, string',
     hint = 'boolean',
+    fast_offset = 'boolean',
+    covering = 'boolean',
 }
 
 local function jsonpaths_from_idx_parts(parts)
@@ -1500,6 +1581,10 @@ box.schema.index.create = function(space_id, name, options)
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "functional index can't use hints")
     end
+    if options.fast_offset and options.func then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "functional index can't use fast_offset")
+    end
 
     local _index = box.space[box.schema.INDEX_ID]
     local _vindex = box.space[box.schema.VINDEX_ID]
@@ -1537,8 +1622,12 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            compaction_policy = options.compaction_policy,
+            compaction_window = options.compaction_window,
             func = options.func,
             hint = options.hint,
+            fast_offset = options.fast_offset,
+            covering = options.covering,
     }
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
@@ -1561,6 +1650,10 @@ box.schema.index.create = function(space_id, name, options)
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "multikey index can't use hints")
     end
+    if options.fast_offset and is_multikey_index(parts) then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "multikey index can't use fast_offset")
+    end
     if index_opts.func ~= nil and type(index_opts.func) == 'string' then
         index_opts.func = func_id_by_name(index_opts.func)
     end
@@ -1693,6 +1786,11 @@ box.schema.index.alter = function(space_id, index_id, options)
                                           space.name,
                 "functional index can't use hints")
     end
+    if options.fast_offset and options.func then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "functional index can't use fast_offset")
+    end
     if options.parts then
         parts = update_index_parts(format, options.parts)
         -- save parts in old format if possible
@@ -1703,6 +1801,11 @@ box.schema.index.alter = function(space_id, index_id, options)
                                           space.name,
                 "multikey index can't use hints")
     end
+    if options.fast_offset and is_multikey_index(parts) then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "multikey index can't use fast_offset")
+    end
     if index_opts.func ~= nil and type(index_opts.func) == 'string' then
         index_opts.func = func_id_by_name(index_opts.func)
     end
@@ -2373,6 +2476,17 @@ base_index_mt.get_luac = function(index, key)
     key = keify(key)
     return internal.get(index.space_id, index.id, key)
 end
+base_index_mt.get_many = function(index, keys)
+    check_index_arg(index, 'get_many')
+    if type(keys) ~= 'table' then
+        error('Usage: index:get_many({key1, key2, ...})')
+    end
+    local keified = {}
+    for i, key in ipairs(keys) do
+        keified[i] = keify(key)
+    end
+    return internal.get_many(index.space_id, index.id, keified)
+end
 
 local function check_select_opts(opts, key_is_nil)
     local offset = 0
@@ -2579,6 +2693,10 @@ space_mt.get = function(space, key)
     check_space_arg(space, 'get')
     return check_primary_index(space):get(key)
 end
+space_mt.get_many = function(space, keys)
+    check_space_arg(space, 'get_many')
+    return check_primary_index(space):get_many(keys)
+end
 space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select')
     return check_primary_index(space):select(key, opts)
@@ -2622,6 +2740,13 @@ space_mt.delete = function(space, key)
     check_space_arg(space, 'delete')
     return check_primary_index(space):delete(key)
 end
+-- Deletes all tuples with primary keys in the range [begin, end).
+-- A nil end means that the range is unbounded.
+space_mt.delete_range = function(space, begin_key, end_key)
+    check_space_arg(space, 'delete_range')
+    check_primary_index(space)
+    return internal.delete_range(space.id, keify(begin_key), keify(end_key))
+end
 -- Assumes that spaceno has a TREE (NUM) primary key
 -- inserts a tuple after getting the next value of the
 -- primary key and returns it back to the user
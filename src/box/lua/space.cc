@@ -427,6 +427,20 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnil(L);
 			lua_setfield(L, -2, "hint");
 		}
+		/*
+		 * The options are omitted unless they're set so as not
+		 * to clutter the output for most indexes.
+		 */
+		if (index_opts->fast_offset)
+			lua_pushboolean(L, true);
+		else
+			lua_pushnil(L);
+		lua_setfield(L, -2, "fast_offset");
+		if (index_opts->covering)
+			lua_pushboolean(L, true);
+		else
+			lua_pushnil(L);
+		lua_setfield(L, -2, "covering");
 
 		if (index_opts->func_id > 0) {
 			lua_pushstring(L, "func");
@@ -515,6 +529,20 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->compaction_policy !=
+			    COMPACTION_POLICY_TIERED) {
+				lua_pushstring(L, compaction_policy_strs[
+					index_opts->compaction_policy]);
+				lua_setfield(L, -2, "compaction_policy");
+			}
+
+			if (index_opts->compaction_policy ==
+			    COMPACTION_POLICY_TIME_WINDOW) {
+				lua_pushnumber(L,
+					       index_opts->compaction_window);
+				lua_setfield(L, -2, "compaction_window");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -44,6 +44,8 @@
 #include "box/vinyl.h"
 #include "box/sql.h"
 #include "box/memtx_engine.h"
+#include "cbus.h"
+#include "fiber.h"
 #include "info/info.h"
 #include "lua/info.h"
 #include "lua/utils.h"
@@ -326,6 +328,40 @@ lbox_stat_sql(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * box.stat.cbus() returns a table of cbus pipe statistics indexed by
+ * consumer and producer names.
+ */
+static int
+lbox_stat_cbus(struct lua_State *L)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int count;
+	struct cbus_pipe_stat *stat = cbus_get_pipe_stat(region, &count);
+	lua_newtable(L);
+	for (int i = 0; i < count; i++) {
+		lua_getfield(L, -1, stat[i].consumer);
+		if (lua_isnil(L, -1)) {
+			lua_pop(L, 1);
+			lua_newtable(L);
+			lua_pushvalue(L, -1);
+			lua_setfield(L, -3, stat[i].consumer);
+		}
+		lua_newtable(L);
+		luaL_pushuint64(L, stat[i].messages);
+		lua_setfield(L, -2, "messages");
+		luaL_pushuint64(L, stat[i].batches);
+		lua_setfield(L, -2, "batches");
+		luaL_pushuint64(L, stat[i].wakeups);
+		lua_setfield(L, -2, "wakeups");
+		lua_setfield(L, -2, stat[i].producer);
+		lua_pop(L, 1);
+	}
+	region_truncate(region, region_svp);
+	return 1;
+}
+
 static const struct luaL_Reg lbox_stat_meta [] = {
 	{"__index", lbox_stat_index},
 	{"__call",  lbox_stat_call},
@@ -367,6 +403,7 @@ box_lua_stat_init(struct lua_State *L)
 		{"vinyl", lbox_stat_vinyl},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
+		{"cbus", lbox_stat_cbus},
 		{NULL, NULL}
 	};
 
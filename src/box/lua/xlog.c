@@ -118,6 +118,10 @@ lbox_xlog_parse_body_kv(struct lua_State *L, int type, const char **beg)
 		lbox_xlog_pushkey(L, vy_page_info_key_name(v));
 	} else if (type == VY_RUN_ROW_INDEX && vy_row_index_key_name(v)) {
 		lbox_xlog_pushkey(L, vy_row_index_key_name(v));
+	} else if (type == VY_INDEX_PART_INFO && vy_part_info_key_name(v)) {
+		lbox_xlog_pushkey(L, vy_part_info_key_name(v));
+	} else if (type == VY_RUN_PART_BLOOM && vy_run_info_key_name(v)) {
+		lbox_xlog_pushkey(L, vy_run_info_key_name(v));
 	} else if (iproto_type_is_synchro_request(type) &&
 		   iproto_key_name(v)) {
 		lbox_xlog_pushkey(L, iproto_key_name(v));
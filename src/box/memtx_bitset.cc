@@ -510,8 +510,11 @@ static const struct index_vtab memtx_bitset_index_vtab = {
 	/* .count = */ memtx_bitset_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ generic_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ memtx_bitset_index_replace,
 	/* .create_iterator = */ memtx_bitset_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
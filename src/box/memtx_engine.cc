@@ -45,6 +45,7 @@
 #include "iproto_constants.h"
 #include "xrow.h"
 #include "xstream.h"
+#include "xlog_decoder.h"
 #include "bootstrap.h"
 #include "replication.h"
 #include "schema.h"
@@ -106,53 +107,92 @@ memtx_end_build_primary_key(struct space *space, void *param)
 	    memtx_space->replace == memtx_space_replace_all_keys)
 		return 0;
 
-	index_end_build(space->index[0]);
+	if (index_end_build(space->index[0]) != 0)
+		return -1;
 	memtx_space->replace = memtx_space_replace_primary_key;
 	return 0;
 }
 
 /**
- * Build memtx secondary index based on the contents of primary index.
+ * Build all memtx secondary indexes of a space based on the contents
+ * of its primary index.
+ *
+ * The primary index is scanned only once to collect all the tuples in
+ * an array. Keys of the tree indexes that support bulk build are then
+ * extracted and sorted in memtx_sort_threads threads, see
+ * memtx_tree_index_build_bulk(), other indexes are fed one tuple at
+ * a time. Note, this means that build arrays of all the indexes are
+ * allocated at the same time.
  */
 static int
-memtx_build_secondary_index(struct index *index, struct index *pk)
+memtx_build_secondary_indexes(struct space *space)
 {
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	struct index *pk = space->index[0];
 	ssize_t n_tuples = index_size(pk);
 	if (n_tuples < 0)
 		return -1;
 	uint32_t estimated_tuples = n_tuples * 1.2;
 
-	index_begin_build(index);
-	if (index_reserve(index, estimated_tuples) < 0)
-		return -1;
-
-	if (n_tuples > 0) {
-		say_info("Adding %zd keys to %s index '%s' ...",
-			 n_tuples, index_type_strs[index->def->type],
-			 index->def->name);
+	struct index **bulk_indexes = (struct index **)
+		xmalloc(space->index_count * sizeof(*bulk_indexes));
+	int bulk_index_count = 0;
+	for (uint32_t j = 1; j < space->index_count; j++) {
+		struct index *index = space->index[j];
+		index_begin_build(index);
+		if (index_reserve(index, estimated_tuples) < 0) {
+			free(bulk_indexes);
+			return -1;
+		}
+		if (memtx_tree_index_supports_bulk_build(index))
+			bulk_indexes[bulk_index_count++] = index;
+		if (n_tuples > 0) {
+			say_info("Adding %zd keys to %s index '%s' ...",
+				 n_tuples, index_type_strs[index->def->type],
+				 index->def->name);
+		}
 	}
 
+	struct tuple **tuples = (struct tuple **)
+		xmalloc(MAX(n_tuples, (ssize_t)1) * sizeof(*tuples));
+	size_t tuple_count = 0;
 	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
-	if (it == NULL)
+	if (it == NULL) {
+		free(tuples);
+		free(bulk_indexes);
 		return -1;
-
+	}
 	int rc = 0;
 	while (true) {
 		struct tuple *tuple;
 		rc = iterator_next_internal(it, &tuple);
-		if (rc != 0)
-			break;
-		if (tuple == NULL)
-			break;
-		rc = index_build_next(index, tuple);
-		if (rc != 0)
+		if (rc != 0 || tuple == NULL)
 			break;
+		assert(tuple_count < (size_t)n_tuples);
+		tuples[tuple_count++] = tuple;
 	}
 	iterator_delete(it);
+	for (uint32_t j = 1; j < space->index_count && rc == 0; j++) {
+		struct index *index = space->index[j];
+		if (memtx_tree_index_supports_bulk_build(index))
+			continue;
+		for (size_t i = 0; i < tuple_count && rc == 0; i++)
+			rc = index_build_next(index, tuples[i]);
+	}
+	if (rc == 0 && bulk_index_count > 0) {
+		rc = memtx_tree_index_build_bulk(bulk_indexes, bulk_index_count,
+						 tuples, tuple_count,
+						 memtx->sort_threads);
+	}
+	free(tuples);
+	free(bulk_indexes);
 	if (rc != 0)
 		return -1;
 
-	index_end_build(index);
+	for (uint32_t j = 1; j < space->index_count; j++) {
+		if (index_end_build(space->index[j]) != 0)
+			return -1;
+	}
 	return 0;
 }
 
@@ -180,11 +220,8 @@ memtx_build_secondary_keys(struct space *space, void *param)
 				 space_name(space));
 		}
 
-		for (uint32_t j = 1; j < space->index_count; j++) {
-			if (memtx_build_secondary_index(space->index[j],
-							pk) < 0)
-				return -1;
-		}
+		if (memtx_build_secondary_indexes(space) != 0)
+			return -1;
 
 		if (n_tuples > 0) {
 			say_info("Space '%s': done", space_name(space));
@@ -262,11 +299,29 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 		return -1;
 
 	int rc;
+	/*
+	 * Skipping corrupted rows in the force recovery mode relies on
+	 * the sequential cursor, so the snapshot is decoded in the tx
+	 * thread in this case.
+	 */
+	struct xlog_decoder *decoder = NULL;
+	if (memtx->recovery_threads > 0 && !memtx->force_recovery) {
+		decoder = xlog_decoder_new(&cursor, memtx->recovery_threads);
+		if (decoder == NULL) {
+			xlog_cursor_close(&cursor, false);
+			return -1;
+		}
+		say_info("decoding snapshot in %d threads",
+			 memtx->recovery_threads);
+	}
+
 	struct xrow_header row;
 	uint64_t row_count = 0;
 	bool force_recovery = false;
 	enum snapshot_recovery_state state = SNAPSHOT_RECOVERY_NOT_STARTED;
-	while ((rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
+	while ((rc = decoder != NULL ?
+		     xlog_decoder_next(decoder, &row) :
+		     xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
 		row.lsn = signature;
 		rc = memtx_engine_recover_snapshot_row(memtx, &row, &state);
 		if (state == DONE_RECOVERING_SYSTEM_SPACES)
@@ -284,6 +339,8 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			fiber_yield_timeout(0);
 		}
 	}
+	if (decoder != NULL)
+		xlog_decoder_delete(decoder);
 	xlog_cursor_close(&cursor, false);
 	if (rc < 0)
 		return -1;
@@ -453,10 +510,10 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 
 	assert(memtx->state == MEMTX_INITIAL_RECOVERY);
 	/* End of the fast path: loaded the primary key. */
-	space_foreach(memtx_end_build_primary_key, memtx);
-
+	int rc = space_foreach(memtx_end_build_primary_key, memtx);
 	/* Complete space initialization. */
-	int rc = space_foreach(space_on_initial_recovery_complete, NULL);
+	if (rc == 0)
+		rc = space_foreach(space_on_initial_recovery_complete, NULL);
 	/* If failed - the snapshot has inconsistent data. We cannot start. */
 	if (rc != 0) {
 		diag_log();
@@ -842,7 +899,8 @@ is_tuple_temporary(const char *data, uint32_t space_id,
 }
 
 static struct checkpoint *
-checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
+checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit,
+	       int compression_threads)
 {
 	struct checkpoint *ckpt = (struct checkpoint *)malloc(sizeof(*ckpt));
 	if (ckpt == NULL) {
@@ -863,6 +921,7 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 	ckpt->waiting_for_snap_thread = false;
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = snap_io_rate_limit;
+	opts.compress_threads = compression_threads;
 	opts.sync_interval = SNAP_SYNC_INTERVAL;
 	opts.free_cache = true;
 	xdir_create(&ckpt->dir, snap_dirname, SNAP, &INSTANCE_UUID, &opts);
@@ -1052,6 +1111,16 @@ checkpoint_f(va_list ap)
 						    result.data, result.size);
 			if (rc != 0)
 				break;
+			ERROR_INJECT(ERRINJ_SNAP_WRITE_DUPLICATE_ROW, {
+				if (!space_id_is_system(space_rv->id)) {
+					rc = checkpoint_write_tuple(
+						&snap, space_rv->id,
+						space_rv->group_id,
+						result.data, result.size);
+				}
+			});
+			if (rc != 0)
+				break;
 		}
 		index_read_view_iterator_destroy(&it);
 		if (rc != 0)
@@ -1101,7 +1170,8 @@ memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 
 	assert(memtx->checkpoint == NULL);
 	memtx->checkpoint = checkpoint_new(memtx->snap_dir.dirname,
-					   memtx->snap_io_rate_limit);
+					   memtx->snap_io_rate_limit,
+					   memtx->snap_compression_threads);
 	if (memtx->checkpoint == NULL)
 		return -1;
 	return 0;
@@ -1474,6 +1544,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		 bool dontdump, unsigned granularity,
 		 const char *allocator, float alloc_factor, int sort_threads,
+		 int recovery_threads,
 		 memtx_on_indexes_built_cb on_indexes_built)
 {
 	int64_t snap_signature;
@@ -1615,6 +1686,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		}
 	}
 	memtx->sort_threads = sort_threads;
+	memtx->recovery_threads = recovery_threads;
 
 	memtx->replica_join_cord = NULL;
 
@@ -1706,11 +1778,28 @@ memtx_engine_stat_tx(struct memtx_engine *memtx, struct info_handler *h)
 	info_table_end(h); /* tx */
 }
 
+static void
+memtx_engine_stat_compression(struct memtx_engine *memtx,
+			      struct info_handler *h)
+{
+	(void)memtx;
+	struct memtx_tuple_compression_stat stat;
+	memtx_tuple_compression_stat(&stat);
+	info_table_begin(h, "compression");
+	info_append_int(h, "tuples", stat.count);
+	info_append_int(h, "raw_size", stat.raw_size);
+	info_append_int(h, "compressed_size", stat.compressed_size);
+	info_append_double(h, "ratio", stat.compressed_size == 0 ? 1 :
+			   (double)stat.raw_size / stat.compressed_size);
+	info_table_end(h); /* compression */
+}
+
 void
 memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h)
 {
 	info_begin(h);
 	memtx_engine_stat_tx(memtx, h);
+	memtx_engine_stat_compression(memtx, h);
 	info_end(h);
 }
 
@@ -1728,6 +1817,15 @@ memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit)
 	memtx->snap_io_rate_limit = limit * 1024 * 1024;
 }
 
+void
+memtx_engine_set_snap_compression_threads(struct memtx_engine *memtx,
+					  int thread_count)
+{
+	assert(thread_count >= 0 &&
+	       thread_count <= XLOG_COMPRESS_THREADS_MAX);
+	memtx->snap_compression_threads = thread_count;
+}
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size)
 {
@@ -1826,6 +1924,8 @@ static void
 memtx_tuple_delete(struct tuple_format *format, struct tuple *tuple)
 {
 	assert(tuple_is_unreferenced(tuple));
+	if (tuple_has_flag(tuple, TUPLE_IS_COMPRESSED))
+		memtx_tuple_compression_on_delete(tuple);
 	MemtxAllocator<ALLOC>::free_tuple(tuple);
 	tuple_format_unref(format);
 }
@@ -1934,6 +2034,8 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (old_def->opts.fast_offset != new_def->opts.fast_offset)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -1997,7 +2099,8 @@ memtx_prepare_read_view_tuple(struct tuple *tuple,
 				memtx_read_view_tuple_needs_upgrade(
 					index->space->upgrade, tuple);
 	result->data = tuple_data_range(tuple, &result->size);
-	if (!index->space->rv->disable_decompression) {
+	if (!index->space->rv->disable_decompression &&
+	    tuple_has_flag(tuple, TUPLE_IS_COMPRESSED)) {
 		result->data = memtx_tuple_decompress_raw(
 				result->data, result->data + result->size,
 				&result->size);
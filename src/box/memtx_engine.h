@@ -126,6 +126,11 @@ struct memtx_engine {
 	struct xdir snap_dir;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t snap_io_rate_limit;
+	/**
+	 * Number of threads used for compressing snapshot data.
+	 * Zero means that data is compressed by the snapshot thread.
+	 */
+	int snap_compression_threads;
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/**
@@ -191,6 +196,11 @@ struct memtx_engine {
 	 * start.
 	 */
 	int sort_threads;
+	/**
+	 * Number of threads used to decode the snapshot on engine start.
+	 * If zero, the snapshot is decoded in the tx thread.
+	 */
+	int recovery_threads;
 };
 
 struct memtx_gc_task;
@@ -227,6 +237,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		 bool dontdump, unsigned granularity,
 		 const char *allocator, float alloc_factor, int threads_num,
+		 int recovery_threads,
 		 memtx_on_indexes_built_cb on_indexes_built);
 
 /**
@@ -242,6 +253,10 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
+void
+memtx_engine_set_snap_compression_threads(struct memtx_engine *memtx,
+					  int thread_count);
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 
@@ -367,14 +382,15 @@ memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		    bool dontdump, unsigned granularity,
 		    const char *allocator, float alloc_factor,
-		    int sort_threads,
+		    int sort_threads, int recovery_threads,
 		    memtx_on_indexes_built_cb on_indexes_built)
 {
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size, objsize_min, dontdump,
 				 granularity, allocator, alloc_factor,
-				 sort_threads, on_indexes_built);
+				 sort_threads, recovery_threads,
+				 on_indexes_built);
 	if (memtx == NULL)
 		diag_raise();
 	return memtx;
@@ -36,10 +36,13 @@
 #include "txn.h"
 #include "memtx_tx.h"
 #include "memtx_engine.h"
+#include "memtx_space.h"
 #include "memtx_tuple_compression.h"
 #include "space.h"
 #include "schema.h" /* space_by_id(), space_cache_find() */
 #include "errinj.h"
+#include "tt_sort.h"
+#include "qsort_arg.h"
 #include "trivia/config.h"
 
 #include <small/mempool.h>
@@ -81,6 +84,12 @@ struct memtx_hash_index {
 	struct light_index_core hash_table;
 	struct memtx_gc_task gc_task;
 	struct light_index_iterator gc_iterator;
+	/** Tuples added to the index being built, see build_next(). */
+	struct light_index_build_entry *build_array;
+	/** Number of elements in the build array. */
+	size_t build_array_size;
+	/** Number of elements the build array has room for. */
+	size_t build_array_alloc_size;
 };
 
 /* {{{ MemtxHash Iterators ****************************************/
@@ -189,6 +198,7 @@ static void
 memtx_hash_index_free(struct memtx_hash_index *index)
 {
 	light_index_destroy(&index->hash_table);
+	free(index->build_array);
 	free(index);
 }
 
@@ -585,28 +595,66 @@ hash_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 	return 0;
 }
 
+/**
+ * Implementation of next_raw index_read_view_iterator callback for
+ * the EQ iterator: returns the tuple the iterator was positioned at by
+ * the key lookup, if any, and stops.
+ */
+static int
+hash_read_view_iterator_next_raw_eq(struct index_read_view_iterator *iterator,
+				    struct read_view_tuple *result)
+{
+	struct hash_read_view_iterator *it =
+		(struct hash_read_view_iterator *)iterator;
+	struct hash_read_view *rv = (struct hash_read_view *)it->base.index;
+	it->base.next_raw = exhausted_index_read_view_iterator_next_raw;
+	struct tuple **res = light_index_view_iterator_get_and_next(
+		&rv->view, &it->iterator);
+	if (res == NULL) {
+		*result = read_view_tuple_none();
+		return 0;
+	}
+	return memtx_prepare_read_view_tuple(*res, &rv->base, &rv->cleaner,
+					     result);
+}
+
 /** Positions the iterator to the given key. */
 static int
 hash_read_view_iterator_start(struct hash_read_view_iterator *it,
 			      enum iterator_type type,
 			      const char *key, uint32_t part_count)
 {
-	assert(type == ITER_ALL);
-	assert(key == NULL);
-	assert(part_count == 0);
-	(void)type;
-	(void)key;
-	(void)part_count;
 	struct hash_read_view *rv = (struct hash_read_view *)it->base.index;
-	it->base.next_raw = hash_read_view_iterator_next_raw;
-	light_index_view_iterator_begin(&rv->view, &it->iterator);
-	return 0;
+	struct key_def *key_def = rv->base.def->key_def;
+	if (type == ITER_EQ && part_count == 0)
+		type = ITER_ALL;
+	switch (type) {
+	case ITER_ALL:
+		it->base.next_raw = hash_read_view_iterator_next_raw;
+		light_index_view_iterator_begin(&rv->view, &it->iterator);
+		return 0;
+	case ITER_EQ:
+		assert(part_count == key_def->part_count);
+		it->base.next_raw = hash_read_view_iterator_next_raw_eq;
+		light_index_view_iterator_key(&rv->view, &it->iterator,
+					      key_hash(key, key_def), key);
+		return 0;
+	default:
+		diag_set(UnsupportedIndexFeature, rv->base.def,
+			 "requested iterator type");
+		return -1;
+	}
 }
 
+/**
+ * Sets the key definition used for key lookups in the read view. Uses
+ * the read view copy of the index definition, because the index may be
+ * altered while the read view is open.
+ */
 static void
 hash_read_view_reset_key_def(struct hash_read_view *rv)
 {
-	rv->view.common.arg = NULL;
+	rv->view.common.arg = rv->base.def->key_def;
 }
 
 #endif /* !defined(ENABLE_READ_VIEW) */
@@ -650,6 +698,279 @@ memtx_hash_index_create_read_view(struct index *base)
 	return (struct index_read_view *)rv;
 }
 
+/* {{{ Bulk build. ************************************************/
+
+static int
+memtx_hash_index_reserve(struct index *base, uint32_t size_hint)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	if (size_hint <= index->build_array_alloc_size)
+		return 0;
+	struct light_index_build_entry *tmp =
+		(struct light_index_build_entry *)
+		realloc(index->build_array, size_hint * sizeof(*tmp));
+	if (tmp == NULL) {
+		diag_set(OutOfMemory, size_hint * sizeof(*tmp),
+			 "memtx_hash_index", "reserve");
+		return -1;
+	}
+	index->build_array = tmp;
+	index->build_array_alloc_size = size_hint;
+	return 0;
+}
+
+/**
+ * Only remember the tuple, hashes are calculated and the hash table is
+ * filled in one go in end_build().
+ */
+static int
+memtx_hash_index_build_next(struct index *base, struct tuple *tuple)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	if (index->build_array_size == index->build_array_alloc_size) {
+		size_t size = MAX(index->build_array_alloc_size +
+				  DIV_ROUND_UP(index->build_array_alloc_size, 2),
+				  MEMTX_EXTENT_SIZE /
+				  sizeof(index->build_array[0]));
+		if (memtx_hash_index_reserve(base, size) != 0)
+			return -1;
+	}
+	struct light_index_build_entry *entry =
+		&index->build_array[index->build_array_size++];
+	entry->hash = 0;
+	entry->value = tuple;
+	return 0;
+}
+
+/** Bulk build worker thread calculating tuple hashes. */
+struct memtx_hash_build_worker {
+	/** Worker thread. */
+	struct cord cord;
+	/** Key definition of the index being built. */
+	struct key_def *key_def;
+	/** Part of the build array handled by this worker. */
+	struct light_index_build_entry *entries;
+	/** Number of entries handled by this worker. */
+	size_t count;
+};
+
+/** Calculate hashes of the tuples of the worker's part of the array. */
+static int
+memtx_hash_build_worker_f(va_list ap)
+{
+	struct memtx_hash_build_worker *worker =
+		va_arg(ap, struct memtx_hash_build_worker *);
+	for (size_t i = 0; i < worker->count; i++) {
+		struct light_index_build_entry *entry = &worker->entries[i];
+		entry->hash = tuple_hash(entry->value, worker->key_def);
+	}
+	return 0;
+}
+
+/**
+ * If the number of tuples is less than this threshold, hashes are
+ * calculated in the calling thread.
+ */
+static const size_t MEMTX_HASH_BUILD_NOSPAWN_THRESHOLD = 1024;
+
+/**
+ * Calculate hashes of all the tuples of the build array in @a thread_count
+ * threads. If @a can_yield is false, the calling thread is blocked until
+ * the threads are done.
+ */
+static void
+memtx_hash_index_build_calc_hashes(struct memtx_hash_index *index,
+				   int thread_count, bool can_yield)
+{
+	size_t count = index->build_array_size;
+	if (count < MEMTX_HASH_BUILD_NOSPAWN_THRESHOLD)
+		thread_count = 1;
+	struct memtx_hash_build_worker *workers =
+		(struct memtx_hash_build_worker *)
+		xcalloc(thread_count, sizeof(*workers));
+	size_t part_size = count / thread_count;
+	for (int i = 0; i < thread_count; i++) {
+		struct memtx_hash_build_worker *worker = &workers[i];
+		worker->key_def = index->base.def->key_def;
+		worker->entries = index->build_array + i * part_size;
+		worker->count = i == thread_count - 1 ?
+				count - i * part_size : part_size;
+	}
+	if (thread_count == 1) {
+		for (size_t i = 0; i < count; i++) {
+			struct light_index_build_entry *entry =
+				&index->build_array[i];
+			entry->hash = tuple_hash(entry->value,
+						 index->base.def->key_def);
+		}
+		free(workers);
+		return;
+	}
+	for (int i = 0; i < thread_count; i++) {
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "build.worker.%d", i);
+		if (cord_costart(&workers[i].cord, name,
+				 memtx_hash_build_worker_f, &workers[i]) != 0) {
+			diag_log();
+			panic("cord_start failed");
+		}
+	}
+	for (int i = 0; i < thread_count; i++) {
+		int rc = can_yield ? cord_cojoin(&workers[i].cord) :
+			 cord_join(&workers[i].cord);
+		if (rc != 0) {
+			diag_log();
+			panic("cord_join failed");
+		}
+	}
+	free(workers);
+}
+
+/**
+ * Order build array entries by the slot they take in the hash table,
+ * then by hash, so that equal keys are adjacent.
+ */
+static int
+memtx_hash_build_entry_cmp(const void *a, const void *b, void *arg)
+{
+	const struct light_index_core *hash_table =
+		(const struct light_index_core *)arg;
+	const struct light_index_build_entry *entry_a =
+		(const struct light_index_build_entry *)a;
+	const struct light_index_build_entry *entry_b =
+		(const struct light_index_build_entry *)b;
+	uint32_t slot_a = light_index_build_slot(hash_table, entry_a->hash);
+	uint32_t slot_b = light_index_build_slot(hash_table, entry_b->hash);
+	if (slot_a != slot_b)
+		return slot_a < slot_b ? -1 : 1;
+	if (entry_a->hash != entry_b->hash)
+		return entry_a->hash < entry_b->hash ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Check the sorted build array for duplicates. Returns -1 and sets diag
+ * if there are any, unless @a force_recovery is set, in which case the
+ * duplicates are logged and removed from the array.
+ */
+static int
+memtx_hash_index_build_check_dup(struct memtx_hash_index *index,
+				 bool force_recovery)
+{
+	struct key_def *key_def = index->base.def->key_def;
+	struct light_index_build_entry *array = index->build_array;
+	size_t count = index->build_array_size;
+	size_t new_count = 0;
+	for (size_t begin = 0, end; begin < count; begin = end) {
+		/*
+		 * Entries [begin, end) have the same hash. Note, the
+		 * first of them may be swapped with a dropped entry.
+		 */
+		uint32_t hash = array[begin].hash;
+		size_t new_begin = new_count;
+		for (end = begin; end < count && array[end].hash == hash;
+		     end++) {
+			struct tuple *new_tuple = array[end].value;
+			size_t i;
+			for (i = new_begin; i < new_count; i++) {
+				if (memtx_hash_equal(array[i].value, new_tuple,
+						     key_def))
+					break;
+			}
+			if (i == new_count) {
+				/* Keep all the entries in the array. */
+				SWAP(array[new_count], array[end]);
+				new_count++;
+				continue;
+			}
+			struct space *space = space_by_id(
+				index->base.def->space_id);
+			assert(space != NULL);
+			diag_set(ClientError, ER_TUPLE_FOUND,
+				 index->base.def->name, space_name(space),
+				 tuple_str(array[i].value),
+				 tuple_str(new_tuple));
+			if (!force_recovery)
+				return -1;
+			diag_log();
+			say_error("dropping tuple %s from index '%s' of "
+				  "space '%s'", tuple_str(new_tuple),
+				  index->base.def->name, space_name(space));
+			if (index->base.def->iid == 0) {
+				/* The primary index owns the tuples. */
+				memtx_space_update_bsize(space, new_tuple,
+							 NULL);
+				tuple_unref(new_tuple);
+			}
+		}
+	}
+	index->build_array_size = new_count;
+	return 0;
+}
+
+/**
+ * Fill the hash table with the tuples of the build array: the table is
+ * allocated for the exact number of tuples in advance, hashes are
+ * calculated in memtx_sort_threads threads, and then the tuples are
+ * sorted by the slot they take in the table so that the table is filled
+ * in the memory order without rehashing.
+ *
+ * On recovery the calling fiber yields while waiting for the threads.
+ * If the index is built in a transaction (DDL), it must not yield, since
+ * concurrent changes of the space would be missed by the new index.
+ */
+static int
+memtx_hash_index_end_build(struct index *base)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	struct light_index_core *hash_table = &index->hash_table;
+	bool can_yield = in_txn() == NULL;
+	size_t count = index->build_array_size;
+	assert(count <= UINT32_MAX);
+	int rc = 0;
+	if (count == 0)
+		goto out;
+	memtx_hash_index_build_calc_hashes(index, memtx->sort_threads,
+					   can_yield);
+	if (light_index_build_begin(hash_table, count) != 0) {
+		diag_set(OutOfMemory, MEMTX_EXTENT_SIZE, "hash_table", "build");
+		rc = -1;
+		goto out;
+	}
+	if (can_yield) {
+		tt_sort(index->build_array, count,
+			sizeof(index->build_array[0]),
+			memtx_hash_build_entry_cmp, hash_table,
+			memtx->sort_threads);
+	} else {
+		qsort_arg(index->build_array, count,
+			  sizeof(index->build_array[0]),
+			  memtx_hash_build_entry_cmp, hash_table);
+	}
+	/*
+	 * Duplicates are dropped only on recovery: a unique index built
+	 * in a transaction must fail.
+	 */
+	rc = memtx_hash_index_build_check_dup(
+		index, memtx->force_recovery && can_yield);
+	/*
+	 * Fill the table even if there are duplicates: tuples referenced
+	 * by a primary index are freed by its destructor.
+	 */
+	if (rc == 0)
+		count = index->build_array_size;
+	light_index_build_end(hash_table, index->build_array, count);
+out:
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
+	return rc;
+}
+
+/* }}} */
+
 static const struct index_vtab memtx_hash_index_vtab = {
 	/* .destroy = */ memtx_hash_index_destroy,
 	/* .commit_create = */ generic_index_commit_create,
@@ -668,16 +989,19 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .count = */ memtx_hash_index_count,
 	/* .get_internal = */ memtx_hash_index_get_internal,
 	/* .get = */ memtx_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ memtx_hash_index_replace,
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_read_view = */ memtx_hash_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
 	/* .begin_build = */ generic_index_begin_build,
-	/* .reserve = */ generic_index_reserve,
-	/* .build_next = */ generic_index_build_next,
-	/* .end_build = */ generic_index_end_build,
+	/* .reserve = */ memtx_hash_index_reserve,
+	/* .build_next = */ memtx_hash_index_build_next,
+	/* .end_build = */ memtx_hash_index_end_build,
 };
 
 struct index *
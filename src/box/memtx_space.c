@@ -42,6 +42,7 @@
 #include "memtx_bitset.h"
 #include "memtx_engine.h"
 #include "column_mask.h"
+#include "compression_dict.h"
 #include "sequence.h"
 #include "memtx_space_upgrade.h"
 #include "memtx_tuple_compression.h"
@@ -349,7 +350,8 @@ memtx_space_replace_tuple(struct space *space, struct txn_stmt *stmt,
 	struct tuple *orig_new_tuple = new_tuple;
 	bool was_referenced = false;
 	if (new_tuple != NULL && space->format->is_compressed) {
-		new_tuple = memtx_tuple_compress(new_tuple);
+		new_tuple = memtx_tuple_compress(
+			new_tuple, compression_dict_get(space_id(space)));
 		if (new_tuple == NULL)
 			return -1;
 		tuple_ref(new_tuple);
@@ -742,7 +744,14 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 		}
 		break;
 	case TREE:
-		/* TREE index has no limitations. */
+		if (index_def->opts.fast_offset &&
+		    (key_def->is_multikey || key_def->for_func_index)) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "fast_offset can't be used with multikey or "
+				 "functional index");
+			return -1;
+		}
 		break;
 	case RTREE:
 		if (key_def->part_count != 1) {
@@ -830,6 +839,12 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "hint is only reasonable with memtx tree index");
 		return -1;
 	}
+	if (index_def->type != TREE && index_def->opts.fast_offset) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "fast_offset is only reasonable with memtx tree index");
+		return -1;
+	}
 
 	/* Only HASH and TREE indexes checks parts there */
 	/* Check that there are no ANY, ARRAY, MAP parts */
@@ -1270,6 +1285,20 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 			       NULL);
 		trigger_add(&src_space->on_replace, &on_replace);
 	}
+	/*
+	 * If the build doesn't yield, a secondary hash index is filled
+	 * in one go in index_end_build(), which is much faster than
+	 * inserting tuples one by one.
+	 */
+	bool is_bulk = !can_yield && new_index->def->type == HASH &&
+		       new_index->def->iid != 0;
+	if (is_bulk) {
+		index_begin_build(new_index);
+		if (index_reserve(new_index, index_size(pk)) != 0) {
+			iterator_delete(it);
+			return -1;
+		}
+	}
 
 	/*
 	 * The index has to be built tuple by tuple, since
@@ -1297,6 +1326,12 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		rc = memtx_tuple_validate(new_format, tuple);
 		if (rc != 0)
 			break;
+		if (is_bulk) {
+			rc = index_build_next(new_index, tuple);
+			if (rc != 0)
+				break;
+			continue;
+		}
 		/*
 		 * @todo: better message if there is a duplicate.
 		 */
@@ -1347,6 +1382,8 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		}
 	}
 	iterator_delete(it);
+	if (is_bulk && rc == 0)
+		rc = index_end_build(new_index);
 	if (can_yield) {
 		diag_destroy(&state.diag);
 		trigger_clear(&on_replace);
@@ -1399,6 +1436,7 @@ static const struct space_vtab memtx_space_vtab = {
 	/* .execute_delete = */ memtx_space_execute_delete,
 	/* .execute_update = */ memtx_space_execute_update,
 	/* .execute_upsert = */ memtx_space_execute_upsert,
+	/* .execute_delete_range = */ generic_space_execute_delete_range,
 	/* .ephemeral_replace = */ memtx_space_ephemeral_replace,
 	/* .ephemeral_delete = */ memtx_space_ephemeral_delete,
 	/* .ephemeral_rowid_next = */ memtx_space_ephemeral_rowid_next,
@@ -43,6 +43,7 @@
 #include "trivia/config.h"
 #include "trivia/util.h"
 #include "tt_sort.h"
+#include "qsort_arg.h"
 #include <small/mempool.h>
 
 /**
@@ -142,6 +143,35 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
 
+/*
+ * Trees of indexes with the fast_offset option maintain cardinalities
+ * of inner block children so that offset and count operations take
+ * logarithmic time.
+ */
+#define BPS_INNER_CARD
+
+#define BPS_TREE_NAMESPACE NS_FAST_OFFSET_NO_HINT
+#define bps_tree_elem_t struct memtx_tree_data<false>
+#define bps_tree_key_t struct memtx_tree_key_data<false> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
+#define BPS_TREE_NAMESPACE NS_FAST_OFFSET_USE_HINT
+#define bps_tree_elem_t struct memtx_tree_data<true>
+#define bps_tree_key_t struct memtx_tree_key_data<true> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
+#undef BPS_INNER_CARD
+
 #undef BPS_TREE_NAME
 #undef BPS_TREE_BLOCK_SIZE
 #undef BPS_TREE_EXTENT_SIZE
@@ -153,46 +183,78 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 
 using namespace NS_NO_HINT;
 using namespace NS_USE_HINT;
+using namespace NS_FAST_OFFSET_NO_HINT;
+using namespace NS_FAST_OFFSET_USE_HINT;
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 struct memtx_tree_selector;
 
 template <>
-struct memtx_tree_selector<false> : NS_NO_HINT::memtx_tree {};
+struct memtx_tree_selector<false, false> : NS_NO_HINT::memtx_tree {};
 
 template <>
-struct memtx_tree_selector<true> : NS_USE_HINT::memtx_tree {};
+struct memtx_tree_selector<true, false> : NS_USE_HINT::memtx_tree {};
 
-template <bool USE_HINT>
-using memtx_tree_t = struct memtx_tree_selector<USE_HINT>;
+template <>
+struct memtx_tree_selector<false, true> :
+	NS_FAST_OFFSET_NO_HINT::memtx_tree {};
 
-template <bool USE_HINT>
+template <>
+struct memtx_tree_selector<true, true> :
+	NS_FAST_OFFSET_USE_HINT::memtx_tree {};
+
+template <bool USE_HINT, bool FAST_OFFSET>
+using memtx_tree_t = struct memtx_tree_selector<USE_HINT, FAST_OFFSET>;
+
+template <bool USE_HINT, bool FAST_OFFSET>
 struct memtx_tree_view_selector;
 
 template <>
-struct memtx_tree_view_selector<false> : NS_NO_HINT::memtx_tree_view {};
+struct memtx_tree_view_selector<false, false> :
+	NS_NO_HINT::memtx_tree_view {};
 
 template <>
-struct memtx_tree_view_selector<true> : NS_USE_HINT::memtx_tree_view {};
+struct memtx_tree_view_selector<true, false> :
+	NS_USE_HINT::memtx_tree_view {};
 
-template <bool USE_HINT>
-using memtx_tree_view_t = struct memtx_tree_view_selector<USE_HINT>;
+template <>
+struct memtx_tree_view_selector<false, true> :
+	NS_FAST_OFFSET_NO_HINT::memtx_tree_view {};
 
-template <bool USE_HINT>
+template <>
+struct memtx_tree_view_selector<true, true> :
+	NS_FAST_OFFSET_USE_HINT::memtx_tree_view {};
+
+template <bool USE_HINT, bool FAST_OFFSET>
+using memtx_tree_view_t =
+	struct memtx_tree_view_selector<USE_HINT, FAST_OFFSET>;
+
+template <bool USE_HINT, bool FAST_OFFSET>
 struct memtx_tree_iterator_selector;
 
 template <>
-struct memtx_tree_iterator_selector<false> {
+struct memtx_tree_iterator_selector<false, false> {
 	using type = NS_NO_HINT::memtx_tree_iterator;
 };
 
 template <>
-struct memtx_tree_iterator_selector<true> {
+struct memtx_tree_iterator_selector<true, false> {
 	using type = NS_USE_HINT::memtx_tree_iterator;
 };
 
-template <bool USE_HINT>
-using memtx_tree_iterator_t = typename memtx_tree_iterator_selector<USE_HINT>::type;
+template <>
+struct memtx_tree_iterator_selector<false, true> {
+	using type = NS_FAST_OFFSET_NO_HINT::memtx_tree_iterator;
+};
+
+template <>
+struct memtx_tree_iterator_selector<true, true> {
+	using type = NS_FAST_OFFSET_USE_HINT::memtx_tree_iterator;
+};
+
+template <bool USE_HINT, bool FAST_OFFSET>
+using memtx_tree_iterator_t =
+	typename memtx_tree_iterator_selector<USE_HINT, FAST_OFFSET>::type;
 
 static void
 invalidate_tree_iterator(NS_NO_HINT::memtx_tree_iterator *itr)
@@ -206,14 +268,28 @@ invalidate_tree_iterator(NS_USE_HINT::memtx_tree_iterator *itr)
 	*itr = NS_USE_HINT::memtx_tree_invalid_iterator();
 }
 
-template <bool USE_HINT>
+static void
+invalidate_tree_iterator(NS_FAST_OFFSET_NO_HINT::memtx_tree_iterator *itr)
+{
+	*itr = NS_FAST_OFFSET_NO_HINT::memtx_tree_invalid_iterator();
+}
+
+static void
+invalidate_tree_iterator(NS_FAST_OFFSET_USE_HINT::memtx_tree_iterator *itr)
+{
+	*itr = NS_FAST_OFFSET_USE_HINT::memtx_tree_invalid_iterator();
+}
+
+template <bool USE_HINT, bool FAST_OFFSET>
 struct memtx_tree_index {
 	struct index base;
-	memtx_tree_t<USE_HINT> tree;
+	memtx_tree_t<USE_HINT, FAST_OFFSET> tree;
 	struct memtx_tree_data<USE_HINT> *build_array;
 	size_t build_array_size, build_array_alloc_size;
+	/** Set if the build array is sorted by bulk build. */
+	bool build_array_is_sorted;
 	struct memtx_gc_task gc_task;
-	memtx_tree_iterator_t<USE_HINT> gc_iterator;
+	memtx_tree_iterator_t<USE_HINT, FAST_OFFSET> gc_iterator;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -239,7 +315,7 @@ memtx_tree_qcompare(const void* a, const void *b, void *c)
 }
 
 /* {{{ MemtxTree Iterators ****************************************/
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 struct tree_iterator {
 	struct iterator base;
 
@@ -263,7 +339,7 @@ struct tree_iterator {
 	 * One need not care about the iterator's position: it will
 	 * automatically get adjusted on iterator->next call.
 	 */
-	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+	memtx_tree_iterator_t<USE_HINT, FAST_OFFSET> tree_iterator;
 	enum iterator_type type;
 	struct memtx_tree_key_data<USE_HINT> after_data;
 	struct memtx_tree_key_data<USE_HINT> key_data;
@@ -287,17 +363,27 @@ struct tree_iterator {
 	struct mempool *pool;
 };
 
-static_assert(sizeof(struct tree_iterator<false>) <= MEMTX_ITERATOR_SIZE,
-	      "sizeof(struct tree_iterator<false>) must be less than or equal "
-	      "to MEMTX_ITERATOR_SIZE");
-static_assert(sizeof(struct tree_iterator<true>) <= MEMTX_ITERATOR_SIZE,
-	      "sizeof(struct tree_iterator<true>) must be less than or equal "
-	      "to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<false, false>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<false, false>) must be "
+	      "less than or equal to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<true, false>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<true, false>) must be "
+	      "less than or equal to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<false, true>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<false, true>) must be "
+	      "less than or equal to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<true, true>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<true, true>) must be "
+	      "less than or equal to MEMTX_ITERATOR_SIZE");
 
 /** Set last fetched tuple. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static inline void
-tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT> *it,
+tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT, FAST_OFFSET> *it,
 			     struct tuple *tuple)
 {
 	assert(tuple != NULL);
@@ -308,9 +394,10 @@ tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT> *it,
 }
 
 /** Set hint of last fetched tuple. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static inline void
-tree_iterator_set_last_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
+tree_iterator_set_last_hint(struct tree_iterator<USE_HINT, FAST_OFFSET> *it,
+			    hint_t hint)
 {
 	if (!USE_HINT)
 		return;
@@ -330,9 +417,9 @@ tree_iterator_set_last_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
  * Prerequisites: last is not NULL and last->tuple is not NULL.
  * Use set_last_tuple and set_last_hint manually to free occupied resources.
  */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static inline void
-tree_iterator_set_last(struct tree_iterator<USE_HINT> *it,
+tree_iterator_set_last(struct tree_iterator<USE_HINT, FAST_OFFSET> *it,
 		       struct memtx_tree_data<USE_HINT> *last)
 {
 	assert(last != NULL && last->tuple != NULL);
@@ -340,23 +427,24 @@ tree_iterator_set_last(struct tree_iterator<USE_HINT> *it,
 	tree_iterator_set_last_hint(it, last->hint);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 tree_iterator_free(struct iterator *iterator);
 
-template <bool USE_HINT>
-static inline struct tree_iterator<USE_HINT> *
+template <bool USE_HINT, bool FAST_OFFSET>
+static inline struct tree_iterator<USE_HINT, FAST_OFFSET> *
 get_tree_iterator(struct iterator *it)
 {
-	assert(it->free == &tree_iterator_free<USE_HINT>);
-	return (struct tree_iterator<USE_HINT> *) it;
+	assert(it->free == (&tree_iterator_free<USE_HINT, FAST_OFFSET>));
+	return (struct tree_iterator<USE_HINT, FAST_OFFSET> *) it;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 tree_iterator_free(struct iterator *iterator)
 {
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *it =
+		get_tree_iterator<USE_HINT, FAST_OFFSET>(iterator);
 	if (it->last.tuple != NULL)
 		tuple_unref(it->last.tuple);
 	if (it->last_func_key != NULL)
@@ -368,10 +456,11 @@ tree_iterator_free(struct iterator *iterator)
  * If the iterator's underlying tuple does not match its last tuple, it needs
  * to be repositioned.
  */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
-tree_iterator_prev_reposition(struct tree_iterator<USE_HINT> *iterator,
-			      struct memtx_tree_index<USE_HINT> *index)
+tree_iterator_prev_reposition(
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *iterator,
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index)
 {
 	bool exact = false;
 	iterator->tree_iterator =
@@ -391,13 +480,15 @@ tree_iterator_prev_reposition(struct tree_iterator<USE_HINT> *iterator,
 	assert(exact || in_txn() == NULL || !memtx_tx_manager_use_mvcc_engine);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *it =
+		get_tree_iterator<USE_HINT, FAST_OFFSET>(iterator);
 	assert(it->last.tuple != NULL);
 	struct memtx_tree_data<USE_HINT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
@@ -415,7 +506,7 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	if (*ret == NULL) {
 		iterator->next_internal = exhausted_iterator_next;
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, FAST_OFFSET>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -434,13 +525,15 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *it =
+		get_tree_iterator<USE_HINT, FAST_OFFSET>(iterator);
 	assert(it->last.tuple != NULL);
 	struct memtx_tree_data<USE_HINT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
@@ -457,7 +550,7 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	if (*ret == NULL) {
 		iterator->next_internal = exhausted_iterator_next;
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, FAST_OFFSET>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -480,13 +573,15 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *it =
+		get_tree_iterator<USE_HINT, FAST_OFFSET>(iterator);
 	assert(it->last.tuple != NULL);
 	struct memtx_tree_data<USE_HINT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
@@ -520,7 +615,7 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 				   it->key_data.key, it->key_data.part_count);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, FAST_OFFSET>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -539,13 +634,15 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *it =
+		get_tree_iterator<USE_HINT, FAST_OFFSET>(iterator);
 	assert(it->last.tuple != NULL);
 	struct memtx_tree_data<USE_HINT> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
@@ -577,7 +674,7 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 				   it->key_data.key, it->key_data.part_count);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, FAST_OFFSET>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -601,12 +698,12 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 }
 
 #define WRAP_ITERATOR_METHOD(name)						\
-template <bool USE_HINT>							\
+template <bool USE_HINT, bool FAST_OFFSET>					\
 static int									\
 name(struct iterator *iterator, struct tuple **ret)				\
 {										\
 	do {									\
-		int rc = name##_base<USE_HINT>(iterator, ret);			\
+		int rc = name##_base<USE_HINT, FAST_OFFSET>(iterator, ret);	\
 		if (rc != 0 ||							\
 		    iterator->next_internal == exhausted_iterator_next)		\
 			return rc;						\
@@ -622,25 +719,29 @@ WRAP_ITERATOR_METHOD(tree_iterator_prev_equal);
 
 #undef WRAP_ITERATOR_METHOD
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
-tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
+tree_iterator_set_next_method(struct tree_iterator<USE_HINT, FAST_OFFSET> *it)
 {
 	assert(it->last.tuple != NULL);
 	switch (it->type) {
 	case ITER_EQ:
-		it->base.next_internal = tree_iterator_next_equal<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_next_equal<USE_HINT, FAST_OFFSET>;
 		break;
 	case ITER_REQ:
-		it->base.next_internal = tree_iterator_prev_equal<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_prev_equal<USE_HINT, FAST_OFFSET>;
 		break;
 	case ITER_LT:
 	case ITER_LE:
-		it->base.next_internal = tree_iterator_prev<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_prev<USE_HINT, FAST_OFFSET>;
 		break;
 	case ITER_GE:
 	case ITER_GT:
-		it->base.next_internal = tree_iterator_next<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_next<USE_HINT, FAST_OFFSET>;
 		break;
 	default:
 		/* The type was checked in initIterator */
@@ -649,16 +750,18 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 	it->base.next = memtx_iterator_next;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 {
 	*ret = NULL;
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *it =
+		get_tree_iterator<USE_HINT, FAST_OFFSET>(iterator);
 	iterator->next_internal = exhausted_iterator_next;
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
+	memtx_tree_t<USE_HINT, FAST_OFFSET> *tree = &index->tree;
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(iterator->space_id);
 	assert(space != NULL || iterator->space_id == 0);
@@ -798,16 +901,16 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 
 /* {{{ MemtxTree  **********************************************************/
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
-memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
+memtx_tree_index_free(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index)
 {
 	memtx_tree_destroy(&index->tree);
 	free(index->build_array);
 	free(index);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 {
@@ -821,10 +924,10 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	enum { YIELD_LOOPS = 10 };
 #endif
 
-	struct memtx_tree_index<USE_HINT> *index = container_of(task,
-			struct memtx_tree_index<USE_HINT>, gc_task);
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
-	memtx_tree_iterator_t<USE_HINT> *itr = &index->gc_iterator;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		container_of(task, typeof(*index), gc_task);
+	memtx_tree_t<USE_HINT, FAST_OFFSET> *tree = &index->tree;
+	memtx_tree_iterator_t<USE_HINT, FAST_OFFSET> *itr = &index->gc_iterator;
 
 	unsigned int loops = 0;
 	while (!memtx_tree_iterator_is_invalid(itr)) {
@@ -840,32 +943,32 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	*done = true;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 memtx_tree_index_gc_free(struct memtx_gc_task *task)
 {
-	struct memtx_tree_index<USE_HINT> *index = container_of(task,
-			struct memtx_tree_index<USE_HINT>, gc_task);
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		container_of(task, typeof(*index), gc_task);
 	memtx_tree_index_free(index);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static struct memtx_gc_task_vtab * get_memtx_tree_index_gc_vtab()
 {
 	static memtx_gc_task_vtab tab =
 	{
-		.run = memtx_tree_index_gc_run<USE_HINT>,
-		.free = memtx_tree_index_gc_free<USE_HINT>,
+		.run = memtx_tree_index_gc_run<USE_HINT, FAST_OFFSET>,
+		.free = memtx_tree_index_gc_free<USE_HINT, FAST_OFFSET>,
 	};
 	return &tab;
 };
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 memtx_tree_index_destroy(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	if (base->def->iid == 0) {
 		/*
@@ -873,7 +976,8 @@ memtx_tree_index_destroy(struct index *base)
 		 * in the index, which may take a while. Schedule a
 		 * background task in order not to block tx thread.
 		 */
-		index->gc_task.vtab = get_memtx_tree_index_gc_vtab<USE_HINT>();
+		index->gc_task.vtab =
+			get_memtx_tree_index_gc_vtab<USE_HINT, FAST_OFFSET>();
 		index->gc_iterator = memtx_tree_first(&index->tree);
 		memtx_engine_schedule_gc(memtx, &index->gc_task);
 	} else {
@@ -885,12 +989,12 @@ memtx_tree_index_destroy(struct index *base)
 	}
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 memtx_tree_index_update_def(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct index_def *def = base->def;
 	/*
 	 * We use extended key def for non-unique and nullable
@@ -911,37 +1015,37 @@ memtx_tree_index_depends_on_pk(struct index *base)
 	return !def->opts.is_unique || def->key_def->is_nullable;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static ssize_t
 memtx_tree_index_size(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct space *space = space_by_id(base->def->space_id);
 	/* Substract invisible count. */
 	return memtx_tree_size(&index->tree) -
 	       memtx_tx_index_invisible_count(in_txn(), space, base);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static ssize_t
 memtx_tree_index_bsize(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	return memtx_tree_mem_used(&index->tree);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(base->def->space_id);
 	bool is_multikey = base->def->key_def->is_multikey;
-	if (memtx_tree_index_size<USE_HINT>(base) == 0) {
+	if (memtx_tree_index_size<USE_HINT, FAST_OFFSET>(base) == 0) {
 		*result = NULL;
 		memtx_tx_track_gap(txn, space, base, NULL, ITER_GE, NULL, 0);
 		return 0;
@@ -961,25 +1065,92 @@ memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 	return memtx_prepare_result_tuple(result);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static ssize_t
 memtx_tree_index_count(struct index *base, enum iterator_type type,
 		       const char *key, uint32_t part_count)
 {
+	/* Optimization. */
 	if (type == ITER_ALL)
-		return memtx_tree_index_size<USE_HINT>(base); /* optimization */
+		return memtx_tree_index_size<USE_HINT, FAST_OFFSET>(base);
 	return generic_index_count(base, type, key, part_count);
 }
 
+/**
+ * Count implementation for trees with the fast_offset option. The number
+ * of matching tuples is computed from the offsets of the key bounds in
+ * the tree, which takes logarithmic time. If MVCC is enabled, falls back
+ * to the generic implementation, because some of the tuples stored in
+ * the tree may be invisible to the current transaction.
+ */
 template <bool USE_HINT>
+static ssize_t
+memtx_tree_index_count_fast_offset(struct index *base, enum iterator_type type,
+				   const char *key, uint32_t part_count)
+{
+	if (memtx_tx_manager_use_mvcc_engine)
+		return memtx_tree_index_count<USE_HINT, true>(base, type, key,
+							      part_count);
+	struct memtx_tree_index<USE_HINT, true> *index =
+		(struct memtx_tree_index<USE_HINT, true> *)base;
+	size_t size = memtx_tree_size(&index->tree);
+	if (part_count == 0 || type == ITER_ALL)
+		return size;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	struct memtx_tree_key_data<USE_HINT> key_data;
+	key_data.key = key;
+	key_data.part_count = part_count;
+	if (USE_HINT)
+		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	size_t lower = 0, upper = 0;
+	switch (type) {
+	case ITER_EQ:
+	case ITER_REQ:
+	case ITER_GE:
+	case ITER_LT:
+		memtx_tree_lower_bound_get_offset(&index->tree, &key_data,
+						  NULL, &lower);
+		break;
+	default:
+		break;
+	}
+	switch (type) {
+	case ITER_EQ:
+	case ITER_REQ:
+	case ITER_GT:
+	case ITER_LE:
+		memtx_tree_upper_bound_get_offset(&index->tree, &key_data,
+						  NULL, &upper);
+		break;
+	default:
+		break;
+	}
+	switch (type) {
+	case ITER_EQ:
+	case ITER_REQ:
+		return upper - lower;
+	case ITER_GE:
+		return size - lower;
+	case ITER_GT:
+		return size - upper;
+	case ITER_LE:
+		return upper;
+	case ITER_LT:
+		return lower;
+	default:
+		return generic_index_count(base, type, key, part_count);
+	}
+}
+
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 memtx_tree_index_get_internal(struct index *base, const char *key,
 			      uint32_t part_count, struct tuple **result)
 {
 	assert(base->def->opts.is_unique &&
 	       part_count == base->def->key_def->part_count);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(base->def->space_id);
@@ -1011,17 +1182,17 @@ memtx_tree_index_get_internal(struct index *base, const char *key,
 /**
  * Implementation of iterator position for general and multikey indexes.
  */
-template <bool USE_HINT, bool IS_MULTIKEY>
+template <bool USE_HINT, bool FAST_OFFSET, bool IS_MULTIKEY>
 static int
 tree_iterator_position(struct iterator *it, const char **pos, uint32_t *size)
 {
 	static_assert(!IS_MULTIKEY || USE_HINT,
 		      "Multikey index actually uses hint.");
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)it->index;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)it->index;
 	struct key_def *cmp_def = index->base.def->cmp_def;
-	struct tree_iterator<USE_HINT> *tree_it =
-		get_tree_iterator<USE_HINT>(it);
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *tree_it =
+		get_tree_iterator<USE_HINT, FAST_OFFSET>(it);
 	struct tuple *tuple = tree_it->last.tuple;
 	if (tuple == NULL) {
 		*pos = NULL;
@@ -1050,7 +1221,8 @@ tree_iterator_position_func(struct iterator *it, const char **pos,
 	 * primary key right after it. So to extract cmp_def in func index,
 	 * we need to pack an array with concatenated func key and primary key.
 	 */
-	struct tree_iterator<true> *tree_it = get_tree_iterator<true>(it);
+	struct tree_iterator<true, false> *tree_it =
+		get_tree_iterator<true, false>(it);
 	if (tree_it->last_func_key == NULL) {
 		*pos = NULL;
 		*size = 0;
@@ -1093,14 +1265,14 @@ tree_iterator_position_func(struct iterator *it, const char **pos,
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 			 struct tuple *new_tuple, enum dup_replace_mode mode,
 			 struct tuple **result, struct tuple **successor)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct key_def *key_def = base->def->key_def;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	if (new_tuple != NULL &&
@@ -1168,7 +1340,8 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
  * by all it's multikey indexes.
  */
 static int
-memtx_tree_index_replace_multikey_one(struct memtx_tree_index<true> *index,
+memtx_tree_index_replace_multikey_one(
+			struct memtx_tree_index<true, false> *index,
 			struct tuple *old_tuple, struct tuple *new_tuple,
 			enum dup_replace_mode mode, hint_t hint,
 			struct memtx_tree_data<true> *replaced_data,
@@ -1230,7 +1403,8 @@ memtx_tree_index_replace_multikey_one(struct memtx_tree_index<true> *index,
  * delete operation is fault-tolerant.
  */
 static void
-memtx_tree_index_replace_multikey_rollback(struct memtx_tree_index<true> *index,
+memtx_tree_index_replace_multikey_rollback(
+			struct memtx_tree_index<true, false> *index,
 			struct tuple *new_tuple, struct tuple *replaced_tuple,
 			int err_multikey_idx)
 {
@@ -1313,8 +1487,8 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 			struct tuple *new_tuple, enum dup_replace_mode mode,
 			struct tuple **result, struct tuple **successor)
 {
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<true, false> *index =
+		(struct memtx_tree_index<true, false> *)base;
 
 	/* MUTLIKEY doesn't support successor for now. */
 	*successor = NULL;
@@ -1404,9 +1578,9 @@ func_key_undo_new(struct region *region)
  * return a given index object in it's original state.
  */
 static void
-memtx_tree_func_index_replace_rollback(struct memtx_tree_index<true> *index,
-				       struct rlist *old_keys,
-				       struct rlist *new_keys)
+memtx_tree_func_index_replace_rollback(
+	struct memtx_tree_index<true, false> *index,
+	struct rlist *old_keys, struct rlist *new_keys)
 {
 	struct func_key_undo *entry;
 	rlist_foreach_entry(entry, new_keys, link) {
@@ -1438,8 +1612,8 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 	*successor = NULL;
 
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<true, false> *index =
+		(struct memtx_tree_index<true, false> *)base;
 	struct index_def *index_def = index->base.def;
 	assert(index_def->key_def->for_func_index);
 
@@ -1562,14 +1736,14 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 	return rc;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static struct iterator *
 memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 				 const char *key, uint32_t part_count,
 				 const char *pos)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 
@@ -1596,26 +1770,28 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 		return NULL;
 	});
 
-	struct tree_iterator<USE_HINT> *it = (struct tree_iterator<USE_HINT> *)
+	struct tree_iterator<USE_HINT, FAST_OFFSET> *it =
+		(struct tree_iterator<USE_HINT, FAST_OFFSET> *)
 		mempool_alloc(&memtx->iterator_pool);
 	if (it == NULL) {
-		diag_set(OutOfMemory, sizeof(struct tree_iterator<USE_HINT>),
+		diag_set(OutOfMemory, sizeof(*it),
 			 "memtx_tree_index", "iterator");
 		return NULL;
 	}
 	iterator_create(&it->base, base);
 	it->pool = &memtx->iterator_pool;
-	it->base.next_internal = tree_iterator_start<USE_HINT>;
+	it->base.next_internal = tree_iterator_start<USE_HINT, FAST_OFFSET>;
 	it->base.next = memtx_iterator_next;
-	it->base.free = tree_iterator_free<USE_HINT>;
+	it->base.free = tree_iterator_free<USE_HINT, FAST_OFFSET>;
 	if (base->def->key_def->for_func_index) {
 		assert(USE_HINT);
 		it->base.position = tree_iterator_position_func;
 	} else if (base->def->key_def->is_multikey) {
 		assert(USE_HINT);
-		it->base.position = tree_iterator_position<true, true>;
+		it->base.position = tree_iterator_position<true, false, true>;
 	} else {
-		it->base.position = tree_iterator_position<USE_HINT, false>;
+		it->base.position =
+			tree_iterator_position<USE_HINT, FAST_OFFSET, false>;
 	}
 	it->type = type;
 	it->key_data.key = key;
@@ -1639,22 +1815,120 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	return (struct iterator *)it;
 }
 
+/**
+ * Create an iterator over a tree with the fast_offset option. Instead of
+ * fetching and dropping the skipped tuples one by one, the iterator is
+ * positioned at the last skipped tuple by its offset in the tree, which
+ * takes logarithmic time. If MVCC is enabled, some of the tuples stored
+ * in the tree may be invisible to the current transaction, so the skipped
+ * tuples are iterated over like in the generic implementation.
+ */
 template <bool USE_HINT>
+static struct iterator *
+memtx_tree_index_create_iterator_with_offset(struct index *base,
+					     enum iterator_type type,
+					     const char *key,
+					     uint32_t part_count,
+					     const char *pos, uint32_t offset)
+{
+	if (offset == 0 || memtx_tx_manager_use_mvcc_engine)
+		return generic_index_create_iterator_with_offset(
+			base, type, key, part_count, pos, offset);
+	struct iterator *iterator =
+		memtx_tree_index_create_iterator<USE_HINT, true>(
+			base, type, key, part_count, pos);
+	if (iterator == NULL)
+		return NULL;
+	struct memtx_tree_index<USE_HINT, true> *index =
+		(struct memtx_tree_index<USE_HINT, true> *)base;
+	struct tree_iterator<USE_HINT, true> *it =
+		get_tree_iterator<USE_HINT, true>(iterator);
+	memtx_tree_t<USE_HINT, true> *tree = &index->tree;
+	/* Iterator type is normalized by create_iterator(). */
+	type = it->type;
+	/*
+	 * Find the offsets of the first element of the iteration range and
+	 * of the element following the last one, like tree_iterator_start()
+	 * does to position the iterator.
+	 */
+	size_t begin = 0;
+	size_t end = memtx_tree_size(tree);
+	if (it->key_data.key != NULL) {
+		switch (type) {
+		case ITER_EQ:
+		case ITER_REQ:
+			memtx_tree_lower_bound_get_offset(tree, &it->key_data,
+							  NULL, &begin);
+			memtx_tree_upper_bound_get_offset(tree, &it->key_data,
+							  NULL, &end);
+			break;
+		case ITER_GE:
+			memtx_tree_lower_bound_get_offset(tree, &it->key_data,
+							  NULL, &begin);
+			break;
+		case ITER_GT:
+			memtx_tree_upper_bound_get_offset(tree, &it->key_data,
+							  NULL, &begin);
+			break;
+		case ITER_LE:
+			memtx_tree_upper_bound_get_offset(tree, &it->key_data,
+							  NULL, &end);
+			break;
+		case ITER_LT:
+			memtx_tree_lower_bound_get_offset(tree, &it->key_data,
+							  NULL, &end);
+			break;
+		default:
+			unreachable();
+		}
+	}
+	if (it->after_data.key != NULL) {
+		/* Iteration starts right after the position. */
+		if (iterator_type_is_reverse(type)) {
+			memtx_tree_lower_bound_get_offset(tree, &it->after_data,
+							  NULL, &end);
+		} else {
+			memtx_tree_upper_bound_get_offset(tree, &it->after_data,
+							  NULL, &begin);
+		}
+	}
+	if (begin >= end) {
+		iterator->next_internal = exhausted_iterator_next;
+		return iterator;
+	}
+	/*
+	 * Position the iterator at the last skipped element. If all the
+	 * elements of the range are skipped, the next iteration step will
+	 * leave the range and exhaust the iterator.
+	 */
+	size_t skipped = MIN((size_t)offset, end - begin);
+	size_t last = iterator_type_is_reverse(type) ? end - skipped :
+			begin + skipped - 1;
+	it->tree_iterator = memtx_tree_iterator_at(tree, last);
+	struct memtx_tree_data<USE_HINT> *res =
+		memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
+	assert(res != NULL);
+	tree_iterator_set_last(it, res);
+	tree_iterator_set_next_method(it);
+	return iterator;
+}
+
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 memtx_tree_index_begin_build(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	assert(memtx_tree_size(&index->tree) == 0);
 	(void)index;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	if (size_hint < index->build_array_alloc_size)
 		return 0;
 	struct memtx_tree_data<USE_HINT> *tmp =
@@ -1670,11 +1944,12 @@ memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 /** Initialize the next element of the index build_array. */
 static int
-memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
-				    struct tuple *tuple, hint_t hint)
+memtx_tree_index_build_array_append(
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index,
+	struct tuple *tuple, hint_t hint)
 {
 	if (index->build_array == NULL) {
 		index->build_array =
@@ -1709,14 +1984,14 @@ memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 {
 	if (tuple_key_is_excluded(tuple, base->def->key_def, MULTIKEY_NONE))
 		return 0;
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	return memtx_tree_index_build_array_append(index, tuple,
 						   tuple_hint(tuple, cmp_def));
@@ -1725,7 +2000,8 @@ memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 static int
 memtx_tree_index_build_next_multikey(struct index *base, struct tuple *tuple)
 {
-	struct memtx_tree_index<true> *index = (struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<true, false> *index =
+		(struct memtx_tree_index<true, false> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	uint32_t multikey_count = tuple_multikey_count(tuple, cmp_def);
 	for (uint32_t multikey_idx = 0; multikey_idx < multikey_count;
@@ -1744,8 +2020,8 @@ static int
 memtx_tree_func_index_build_next(struct index *base, struct tuple *tuple)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<true, false> *index =
+		(struct memtx_tree_index<true, false> *)base;
 	struct index_def *index_def = index->base.def;
 	assert(index_def->key_def->for_func_index);
 
@@ -1781,10 +2057,10 @@ memtx_tree_func_index_build_next(struct index *base, struct tuple *tuple)
  * of equal tuples (in terms of index's cmp_def and have same
  * tuple pointer). The build_array is expected to be sorted.
  */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 memtx_tree_index_build_array_deduplicate(
-	struct memtx_tree_index<USE_HINT> *index)
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index)
 {
 	if (index->build_array_size == 0)
 		return;
@@ -1817,17 +2093,21 @@ memtx_tree_index_build_array_deduplicate(
 	index->build_array_size = w_idx + 1;
 }
 
-template <bool USE_HINT>
-static void
+template <bool USE_HINT, bool FAST_OFFSET>
+static int
 memtx_tree_index_end_build(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
-	tt_sort(index->build_array, index->build_array_size,
-		sizeof(index->build_array[0]), memtx_tree_qcompare<USE_HINT>,
-		cmp_def, memtx->sort_threads);
+	if (!index->build_array_is_sorted) {
+		tt_sort(index->build_array, index->build_array_size,
+			sizeof(index->build_array[0]),
+			memtx_tree_qcompare<USE_HINT>, cmp_def,
+			memtx->sort_threads);
+	}
+	index->build_array_is_sorted = false;
 	if (cmp_def->is_multikey || cmp_def->for_func_index) {
 		/*
 		 * Multikey index may have equal(in terms of
@@ -1836,56 +2116,66 @@ memtx_tree_index_end_build(struct index *base)
 		 * the following memtx_tree_build assumes that
 		 * all keys are unique.
 		 */
-		memtx_tree_index_build_array_deduplicate<USE_HINT>(index);
+		memtx_tree_index_build_array_deduplicate<USE_HINT,
+							 FAST_OFFSET>(index);
 	}
-	memtx_tree_build(&index->tree, index->build_array,
-			 index->build_array_size);
+	int rc = memtx_tree_build(&index->tree, index->build_array,
+				  index->build_array_size);
 
 	free(index->build_array);
 	index->build_array = NULL;
 	index->build_array_size = 0;
 	index->build_array_alloc_size = 0;
+	return rc;
 }
 
 /** Read view implementation. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 struct tree_read_view {
 	/** Base class. */
 	struct index_read_view base;
 	/** Read view index. Ref counter incremented. */
-	struct memtx_tree_index<USE_HINT> *index;
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index;
 	/** BPS tree read view. */
-	memtx_tree_view_t<USE_HINT> tree_view;
+	memtx_tree_view_t<USE_HINT, FAST_OFFSET> tree_view;
 	/** Used for clarifying read view tuples. */
 	struct memtx_tx_snapshot_cleaner cleaner;
 };
 
 /** Read view iterator implementation. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 struct tree_read_view_iterator {
 	/** Base class. */
 	struct index_read_view_iterator_base base;
 	/** Iterator key. */
 	struct memtx_tree_key_data<USE_HINT> key_data;
 	/** BPS tree iterator. */
-	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+	memtx_tree_iterator_t<USE_HINT, FAST_OFFSET> tree_iterator;
 };
 
-static_assert(sizeof(struct tree_read_view_iterator<false>) <=
+static_assert(sizeof(struct tree_read_view_iterator<false, false>) <=
 	      INDEX_READ_VIEW_ITERATOR_SIZE,
-	      "sizeof(struct tree_read_view_iterator<false>) must be less than "
-	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
-static_assert(sizeof(struct tree_read_view_iterator<true>) <=
+	      "sizeof(struct tree_read_view_iterator<false, false>) must be "
+	      "less than or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_read_view_iterator<true, false>) <=
 	      INDEX_READ_VIEW_ITERATOR_SIZE,
-	      "sizeof(struct tree_read_view_iterator<true>) must be less than "
-	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+	      "sizeof(struct tree_read_view_iterator<true, false>) must be "
+	      "less than or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_read_view_iterator<false, true>) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct tree_read_view_iterator<false, true>) must be "
+	      "less than or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_read_view_iterator<true, true>) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct tree_read_view_iterator<true, true>) must be "
+	      "less than or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
 tree_read_view_free(struct index_read_view *base)
 {
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)base;
+	struct tree_read_view<USE_HINT, FAST_OFFSET> *rv =
+		(struct tree_read_view<USE_HINT, FAST_OFFSET> *)base;
 	memtx_tree_view_destroy(&rv->tree_view);
 	index_unref(&rv->index->base);
 	memtx_tx_snapshot_cleaner_destroy(&rv->cleaner);
@@ -1897,7 +2187,7 @@ tree_read_view_free(struct index_read_view *base)
 # include "memtx_tree_read_view.cc"
 #else /* !defined(ENABLE_READ_VIEW) */
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 tree_read_view_get_raw(struct index_read_view *rv,
 		       const char *key, uint32_t part_count,
@@ -1911,29 +2201,47 @@ tree_read_view_get_raw(struct index_read_view *rv,
 	return 0;
 }
 
-/** Implementation of next_raw index_read_view_iterator callback. */
-template <bool USE_HINT>
+/**
+ * Implementation of next_raw index_read_view_iterator callback.
+ * Moves the iterator backwards if IS_REVERSE is set. If IS_EQ is set,
+ * stops at the first tuple that doesn't match the iterator key.
+ */
+template <bool USE_HINT, bool FAST_OFFSET, bool IS_REVERSE, bool IS_EQ>
 static int
 tree_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 				 struct read_view_tuple *result)
 {
-	struct tree_read_view_iterator<USE_HINT> *it =
-		(struct tree_read_view_iterator<USE_HINT> *)iterator;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)it->base.index;
+	struct tree_read_view_iterator<USE_HINT, FAST_OFFSET> *it =
+		(struct tree_read_view_iterator<USE_HINT, FAST_OFFSET> *)
+		iterator;
+	struct tree_read_view<USE_HINT, FAST_OFFSET> *rv =
+		(struct tree_read_view<USE_HINT, FAST_OFFSET> *)it->base.index;
 
 	while (true) {
 		struct memtx_tree_data<USE_HINT> *res =
 			memtx_tree_view_iterator_get_elem(&rv->tree_view,
 							  &it->tree_iterator);
 
-		if (res == NULL) {
+		/* Use user key def to save a few loops. */
+		if (res == NULL ||
+		    (IS_EQ &&
+		     tuple_compare_with_key(res->tuple, res->hint,
+					    it->key_data.key,
+					    it->key_data.part_count,
+					    it->key_data.hint,
+					    rv->base.def->key_def) != 0)) {
+			it->base.next_raw =
+				exhausted_index_read_view_iterator_next_raw;
 			*result = read_view_tuple_none();
 			return 0;
 		}
 
-		memtx_tree_view_iterator_next(&rv->tree_view,
-					      &it->tree_iterator);
+		if (IS_REVERSE)
+			memtx_tree_view_iterator_prev(&rv->tree_view,
+						      &it->tree_iterator);
+		else
+			memtx_tree_view_iterator_next(&rv->tree_view,
+						      &it->tree_iterator);
 		if (memtx_prepare_read_view_tuple(res->tuple, &rv->base,
 						  &rv->cleaner, result) != 0)
 			return -1;
@@ -1942,45 +2250,117 @@ tree_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 	}
 }
 
-/** Positions the iterator to the given key. */
-template <bool USE_HINT>
+/**
+ * Positions the iterator to the given key. Works similarly to
+ * tree_iterator_start(), but without transaction tracking, because
+ * a read view is immutable.
+ */
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
-tree_read_view_iterator_start(struct tree_read_view_iterator<USE_HINT> *it,
-			      enum iterator_type type,
-			      const char *key, uint32_t part_count)
+tree_read_view_iterator_start(
+	struct tree_read_view_iterator<USE_HINT, FAST_OFFSET> *it,
+	enum iterator_type type, const char *key, uint32_t part_count)
 {
-	assert(type == ITER_ALL);
-	assert(key == NULL);
-	assert(part_count == 0);
-	(void)type;
-	(void)key;
-	(void)part_count;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)it->base.index;
-	it->base.next_raw = tree_read_view_iterator_next_raw<USE_HINT>;
-	it->tree_iterator = memtx_tree_view_first(&rv->tree_view);
+	struct tree_read_view<USE_HINT, FAST_OFFSET> *rv =
+		(struct tree_read_view<USE_HINT, FAST_OFFSET> *)it->base.index;
+	assert(part_count == 0 || key != NULL);
+	if (type > ITER_GT) {
+		diag_set(UnsupportedIndexFeature, rv->base.def,
+			 "requested iterator type");
+		return -1;
+	}
+	if (part_count == 0) {
+		/*
+		 * If no key is specified, downgrade equality
+		 * iterators to a full range.
+		 */
+		type = iterator_type_is_reverse(type) ? ITER_LE : ITER_GE;
+		key = NULL;
+	}
+	if (type == ITER_ALL)
+		type = ITER_GE;
+	bool is_reverse = iterator_type_is_reverse(type);
+	bool is_eq = type == ITER_EQ || type == ITER_REQ;
+	if (key == NULL) {
+		/*
+		 * A back step from an invalid iterator positions it at
+		 * the last element, see tree_iterator_start().
+		 */
+		if (is_reverse)
+			invalidate_tree_iterator(&it->tree_iterator);
+		else
+			it->tree_iterator =
+				memtx_tree_view_first(&rv->tree_view);
+	} else {
+		it->key_data.key = key;
+		it->key_data.part_count = part_count;
+		if (USE_HINT)
+			it->key_data.set_hint(key_hint(
+				key, part_count, rv->tree_view.common.arg));
+		/*
+		 * Lower bound is used for EQ, GE and LT iterators,
+		 * upper bound is used for REQ, GT and LE iterators.
+		 * Reverse iterators then step back to reach the target
+		 * position, see tree_iterator_start().
+		 */
+		if (type == ITER_EQ || type == ITER_GE || type == ITER_LT) {
+			it->tree_iterator =
+				memtx_tree_view_lower_bound(&rv->tree_view,
+							    &it->key_data,
+							    NULL);
+		} else {
+			it->tree_iterator =
+				memtx_tree_view_upper_bound(&rv->tree_view,
+							    &it->key_data,
+							    NULL);
+		}
+	}
+	if (is_reverse)
+		memtx_tree_view_iterator_prev(&rv->tree_view,
+					      &it->tree_iterator);
+	if (is_reverse && is_eq)
+		it->base.next_raw = tree_read_view_iterator_next_raw<
+			USE_HINT, FAST_OFFSET, true, true>;
+	else if (is_reverse)
+		it->base.next_raw = tree_read_view_iterator_next_raw<
+			USE_HINT, FAST_OFFSET, true, false>;
+	else if (is_eq)
+		it->base.next_raw = tree_read_view_iterator_next_raw<
+			USE_HINT, FAST_OFFSET, false, true>;
+	else
+		it->base.next_raw = tree_read_view_iterator_next_raw<
+			USE_HINT, FAST_OFFSET, false, false>;
 	return 0;
 }
 
-template <bool USE_HINT>
+/**
+ * Sets the key definition used for comparisons in the read view. Uses
+ * the read view copy of the index definition, because the index may be
+ * altered while the read view is open, see memtx_tree_index_update_def().
+ */
+template <bool USE_HINT, bool FAST_OFFSET>
 static void
-tree_read_view_reset_key_def(struct tree_read_view<USE_HINT> *rv)
+tree_read_view_reset_key_def(struct tree_read_view<USE_HINT, FAST_OFFSET> *rv)
 {
-	rv->tree_view.common.arg = NULL;
+	struct index_def *def = rv->base.def;
+	rv->tree_view.common.arg = def->opts.is_unique &&
+				   !def->key_def->is_nullable ?
+				   def->key_def : def->cmp_def;
 }
 
 #endif /* !defined(ENABLE_READ_VIEW) */
 
 /** Implementation of create_iterator index_read_view callback. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static int
 tree_read_view_create_iterator(struct index_read_view *base,
 			       enum iterator_type type,
 			       const char *key, uint32_t part_count,
 			       struct index_read_view_iterator *iterator)
 {
-	struct tree_read_view_iterator<USE_HINT> *it =
-		(struct tree_read_view_iterator<USE_HINT> *)iterator;
+	struct tree_read_view_iterator<USE_HINT, FAST_OFFSET> *it =
+		(struct tree_read_view_iterator<USE_HINT, FAST_OFFSET> *)
+		iterator;
 	it->base.index = base;
 	it->base.next_raw = exhausted_index_read_view_iterator_next_raw;
 	it->key_data.key = NULL;
@@ -1992,19 +2372,21 @@ tree_read_view_create_iterator(struct index_read_view *base,
 }
 
 /** Implementation of create_read_view index callback. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static struct index_read_view *
 memtx_tree_index_create_read_view(struct index *base)
 {
 	static const struct index_read_view_vtab vtab = {
-		.free = tree_read_view_free<USE_HINT>,
-		.get_raw = tree_read_view_get_raw<USE_HINT>,
-		.create_iterator = tree_read_view_create_iterator<USE_HINT>,
+		.free = tree_read_view_free<USE_HINT, FAST_OFFSET>,
+		.get_raw = tree_read_view_get_raw<USE_HINT, FAST_OFFSET>,
+		.create_iterator =
+			tree_read_view_create_iterator<USE_HINT, FAST_OFFSET>,
 	};
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)xmalloc(sizeof(*rv));
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
+	struct tree_read_view<USE_HINT, FAST_OFFSET> *rv =
+		(struct tree_read_view<USE_HINT, FAST_OFFSET> *)
+		xmalloc(sizeof(*rv));
 	index_read_view_create(&rv->base, &vtab, base->def);
 	struct space *space = space_by_id(base->def->space_id);
 	assert(space != NULL);
@@ -2023,7 +2405,7 @@ memtx_tree_index_create_read_view(struct index *base)
  * key defintion is not completely initialized at that moment).
  */
 static const struct index_vtab memtx_tree_disabled_index_vtab = {
-	/* .destroy = */ memtx_tree_index_destroy<true>,
+	/* .destroy = */ memtx_tree_index_destroy<true, false>,
 	/* .commit_create = */ generic_index_commit_create,
 	/* .abort_create = */ generic_index_abort_create,
 	/* .commit_modify = */ generic_index_commit_modify,
@@ -2040,8 +2422,11 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .count = */ generic_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ generic_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ disabled_index_replace,
 	/* .create_iterator = */ generic_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
@@ -2067,15 +2452,19 @@ enum memtx_tree_vtab_type {
 };
 
 /**
- * Get index vtab by @a TYPE and @a USE_HINT, template version.
- * USE_HINT == false is only allowed for general index type.
+ * Get index vtab by @a TYPE, @a USE_HINT and @a FAST_OFFSET, template
+ * version. USE_HINT == false and FAST_OFFSET == true are only allowed
+ * for general index type.
  */
-template <memtx_tree_vtab_type TYPE, bool USE_HINT = true>
+template <memtx_tree_vtab_type TYPE, bool USE_HINT = true,
+	  bool FAST_OFFSET = false>
 static const struct index_vtab *
 get_memtx_tree_index_vtab(void)
 {
 	static_assert(USE_HINT || TYPE == MEMTX_TREE_VTAB_GENERAL,
 		      "Multikey and func indexes must use hints");
+	static_assert(!FAST_OFFSET || TYPE == MEMTX_TREE_VTAB_GENERAL,
+		      "Multikey and func indexes can't use fast offset");
 
 	if (TYPE == MEMTX_TREE_VTAB_DISABLED)
 		return &memtx_tree_disabled_index_vtab;
@@ -2083,50 +2472,65 @@ get_memtx_tree_index_vtab(void)
 	const bool is_mk = TYPE == MEMTX_TREE_VTAB_MULTIKEY;
 	const bool is_func = TYPE == MEMTX_TREE_VTAB_FUNC;
 	static const struct index_vtab vtab = {
-		/* .destroy = */ memtx_tree_index_destroy<USE_HINT>,
+		/* .destroy = */
+			memtx_tree_index_destroy<USE_HINT, FAST_OFFSET>,
 		/* .commit_create = */ generic_index_commit_create,
 		/* .abort_create = */ generic_index_abort_create,
 		/* .commit_modify = */ generic_index_commit_modify,
 		/* .commit_drop = */ generic_index_commit_drop,
-		/* .update_def = */ memtx_tree_index_update_def<USE_HINT>,
+		/* .update_def = */
+			memtx_tree_index_update_def<USE_HINT, FAST_OFFSET>,
 		/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
 		/* .def_change_requires_rebuild = */
 			memtx_index_def_change_requires_rebuild,
-		/* .size = */ memtx_tree_index_size<USE_HINT>,
-		/* .bsize = */ memtx_tree_index_bsize<USE_HINT>,
+		/* .size = */ memtx_tree_index_size<USE_HINT, FAST_OFFSET>,
+		/* .bsize = */ memtx_tree_index_bsize<USE_HINT, FAST_OFFSET>,
 		/* .min = */ generic_index_min,
 		/* .max = */ generic_index_max,
-		/* .random = */ memtx_tree_index_random<USE_HINT>,
-		/* .count = */ memtx_tree_index_count<USE_HINT>,
-		/* .get_internal */ memtx_tree_index_get_internal<USE_HINT>,
+		/* .random = */ memtx_tree_index_random<USE_HINT, FAST_OFFSET>,
+		/* .count = */ FAST_OFFSET ?
+			memtx_tree_index_count_fast_offset<USE_HINT> :
+			memtx_tree_index_count<USE_HINT, FAST_OFFSET>,
+		/* .get_internal */
+			memtx_tree_index_get_internal<USE_HINT, FAST_OFFSET>,
 		/* .get = */ memtx_index_get,
+		/* .get_many = */ generic_index_get_many,
 		/* .replace = */ is_mk ? memtx_tree_index_replace_multikey :
 				 is_func ? memtx_tree_func_index_replace :
-				 memtx_tree_index_replace<USE_HINT>,
+				 memtx_tree_index_replace<USE_HINT,
+							  FAST_OFFSET>,
 		/* .create_iterator = */
-			memtx_tree_index_create_iterator<USE_HINT>,
+			memtx_tree_index_create_iterator<USE_HINT, FAST_OFFSET>,
+		/* .create_iterator_with_offset = */ FAST_OFFSET ?
+			memtx_tree_index_create_iterator_with_offset<USE_HINT> :
+			generic_index_create_iterator_with_offset,
 		/* .create_read_view = */
-			memtx_tree_index_create_read_view<USE_HINT>,
+			memtx_tree_index_create_read_view<USE_HINT,
+							  FAST_OFFSET>,
 		/* .stat = */ generic_index_stat,
 		/* .compact = */ generic_index_compact,
 		/* .reset_stat = */ generic_index_reset_stat,
-		/* .begin_build = */ memtx_tree_index_begin_build<USE_HINT>,
-		/* .reserve = */ memtx_tree_index_reserve<USE_HINT>,
+		/* .begin_build = */
+			memtx_tree_index_begin_build<USE_HINT, FAST_OFFSET>,
+		/* .reserve = */
+			memtx_tree_index_reserve<USE_HINT, FAST_OFFSET>,
 		/* .build_next = */ is_mk ? memtx_tree_index_build_next_multikey :
 				    is_func ? memtx_tree_func_index_build_next :
-				    memtx_tree_index_build_next<USE_HINT>,
-		/* .end_build = */ memtx_tree_index_end_build<USE_HINT>,
+				    memtx_tree_index_build_next<USE_HINT,
+								FAST_OFFSET>,
+		/* .end_build = */
+			memtx_tree_index_end_build<USE_HINT, FAST_OFFSET>,
 	};
 	return &vtab;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool FAST_OFFSET>
 static struct index *
 memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 			 const struct index_vtab *vtab)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)
 		xcalloc(1, sizeof(*index));
 	index_create(&index->base, (struct engine *)memtx, vtab, def);
 
@@ -2144,6 +2548,7 @@ struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 {
 	bool use_hint = false;
+	bool fast_offset = false;
 	const struct index_vtab *vtab;
 	if (def->key_def->for_func_index) {
 		if (def->key_def->func_index_func != NULL) {
@@ -2157,16 +2562,371 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 	} else if (def->key_def->is_multikey) {
 		vtab = get_memtx_tree_index_vtab<MEMTX_TREE_VTAB_MULTIKEY>();
 		use_hint = true;
-	} else if (def->opts.hint == INDEX_HINT_ON) {
-		vtab = get_memtx_tree_index_vtab
-			<MEMTX_TREE_VTAB_GENERAL, true>();
-		use_hint = true;
 	} else {
-		vtab = get_memtx_tree_index_vtab
-			<MEMTX_TREE_VTAB_GENERAL, false>();
+		use_hint = def->opts.hint == INDEX_HINT_ON;
+		fast_offset = def->opts.fast_offset;
+		if (use_hint && fast_offset) {
+			vtab = get_memtx_tree_index_vtab
+				<MEMTX_TREE_VTAB_GENERAL, true, true>();
+		} else if (use_hint) {
+			vtab = get_memtx_tree_index_vtab
+				<MEMTX_TREE_VTAB_GENERAL, true, false>();
+		} else if (fast_offset) {
+			vtab = get_memtx_tree_index_vtab
+				<MEMTX_TREE_VTAB_GENERAL, false, true>();
+		} else {
+			vtab = get_memtx_tree_index_vtab
+				<MEMTX_TREE_VTAB_GENERAL, false, false>();
+		}
 	}
-	if (use_hint)
-		return memtx_tree_index_new_tpl<true>(memtx, def, vtab);
+	if (use_hint && fast_offset)
+		return memtx_tree_index_new_tpl<true, true>(memtx, def, vtab);
+	else if (use_hint)
+		return memtx_tree_index_new_tpl<true, false>(memtx, def, vtab);
+	else if (fast_offset)
+		return memtx_tree_index_new_tpl<false, true>(memtx, def, vtab);
 	else
-		return memtx_tree_index_new_tpl<false>(memtx, def, vtab);
+		return memtx_tree_index_new_tpl<false, false>(memtx, def, vtab);
+}
+
+/* {{{ Bulk build. ************************************************/
+
+/** Make room in the build array for @a count more elements. */
+template <bool USE_HINT, bool FAST_OFFSET>
+static int
+memtx_tree_index_build_bulk_prepare(struct index *base, size_t count)
+{
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
+	size_t size = index->build_array_size + count;
+	if (size <= index->build_array_alloc_size)
+		return 0;
+	return memtx_tree_index_reserve<USE_HINT, FAST_OFFSET>(base, size);
 }
+
+/**
+ * Fill build array elements following the last used one for tuples
+ * [begin, end). Tuples which keys are excluded from the index get NULL
+ * elements. Thread-safe, called from bulk build worker threads.
+ */
+template <bool USE_HINT, bool FAST_OFFSET>
+static void
+memtx_tree_index_build_bulk_fill(struct index *base, struct tuple **tuples,
+				 size_t begin, size_t end)
+{
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	struct memtx_tree_data<USE_HINT> *elem =
+		&index->build_array[index->build_array_size + begin];
+	for (size_t i = begin; i < end; i++, elem++) {
+		struct tuple *tuple = tuples[i];
+		if (tuple_key_is_excluded(tuple, base->def->key_def,
+					  MULTIKEY_NONE)) {
+			elem->tuple = NULL;
+			continue;
+		}
+		elem->tuple = tuple;
+		if (USE_HINT)
+			elem->set_hint(tuple_hint(tuple, cmp_def));
+	}
+}
+
+/**
+ * Account @a count elements filled by memtx_tree_index_build_bulk_fill()
+ * in the build array, dropping NULL elements.
+ */
+template <bool USE_HINT, bool FAST_OFFSET>
+static void
+memtx_tree_index_build_bulk_commit(struct index *base, size_t count)
+{
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
+	struct memtx_tree_data<USE_HINT> *array = index->build_array;
+	size_t w_idx = index->build_array_size;
+	size_t end = index->build_array_size + count;
+	for (size_t r_idx = w_idx; r_idx < end; r_idx++) {
+		if (array[r_idx].tuple == NULL)
+			continue;
+		if (w_idx != r_idx)
+			array[w_idx] = array[r_idx];
+		w_idx++;
+	}
+	index->build_array_size = w_idx;
+}
+
+/**
+ * Sort the build array in @a thread_count threads so that it isn't sorted
+ * again by memtx_tree_index_end_build(). If called from a bulk build worker
+ * thread with @a thread_count equal to 1, sorts in the calling thread.
+ */
+template <bool USE_HINT, bool FAST_OFFSET>
+static void
+memtx_tree_index_build_bulk_sort(struct index *base, int thread_count)
+{
+	struct memtx_tree_index<USE_HINT, FAST_OFFSET> *index =
+		(struct memtx_tree_index<USE_HINT, FAST_OFFSET> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	if (thread_count > 1 || cord_is_main()) {
+		tt_sort(index->build_array, index->build_array_size,
+			sizeof(index->build_array[0]),
+			memtx_tree_qcompare<USE_HINT>, cmp_def, thread_count);
+	} else {
+		qsort_arg(index->build_array, index->build_array_size,
+			  sizeof(index->build_array[0]),
+			  memtx_tree_qcompare<USE_HINT>, cmp_def);
+	}
+	index->build_array_is_sorted = true;
+}
+
+/** Bulk build methods of a general tree index. */
+struct memtx_tree_build_bulk_ops {
+	/** See memtx_tree_index_build_bulk_prepare(). */
+	int (*prepare)(struct index *base, size_t count);
+	/** See memtx_tree_index_build_bulk_fill(). */
+	void (*fill)(struct index *base, struct tuple **tuples,
+		     size_t begin, size_t end);
+	/** See memtx_tree_index_build_bulk_commit(). */
+	void (*commit)(struct index *base, size_t count);
+	/** See memtx_tree_index_build_bulk_sort(). */
+	void (*sort)(struct index *base, int thread_count);
+};
+
+template <bool USE_HINT, bool FAST_OFFSET>
+static const struct memtx_tree_build_bulk_ops *
+get_memtx_tree_build_bulk_ops(void)
+{
+	static const struct memtx_tree_build_bulk_ops ops = {
+		/* .prepare = */
+			memtx_tree_index_build_bulk_prepare<USE_HINT,
+							    FAST_OFFSET>,
+		/* .fill = */
+			memtx_tree_index_build_bulk_fill<USE_HINT, FAST_OFFSET>,
+		/* .commit = */
+			memtx_tree_index_build_bulk_commit<USE_HINT,
+							   FAST_OFFSET>,
+		/* .sort = */
+			memtx_tree_index_build_bulk_sort<USE_HINT, FAST_OFFSET>,
+	};
+	return &ops;
+}
+
+template <bool USE_HINT, bool FAST_OFFSET>
+static bool
+memtx_tree_index_is_general(struct index *index)
+{
+	return index->vtab ==
+	       get_memtx_tree_index_vtab<MEMTX_TREE_VTAB_GENERAL,
+					 USE_HINT, FAST_OFFSET>();
+}
+
+/**
+ * Return bulk build methods if the index is a general tree index which
+ * build array can be filled in multiple threads with
+ * memtx_tree_index_build_bulk(), NULL otherwise. Multikey and functional
+ * indexes are not supported, because the number of their keys is not
+ * known in advance and the latter must run Lua functions in the tx thread.
+ */
+static const struct memtx_tree_build_bulk_ops *
+memtx_tree_index_build_bulk_ops(struct index *index)
+{
+	if (memtx_tree_index_is_general<true, false>(index))
+		return get_memtx_tree_build_bulk_ops<true, false>();
+	if (memtx_tree_index_is_general<false, false>(index))
+		return get_memtx_tree_build_bulk_ops<false, false>();
+	if (memtx_tree_index_is_general<true, true>(index))
+		return get_memtx_tree_build_bulk_ops<true, true>();
+	if (memtx_tree_index_is_general<false, true>(index))
+		return get_memtx_tree_build_bulk_ops<false, true>();
+	return NULL;
+}
+
+bool
+memtx_tree_index_supports_bulk_build(struct index *index)
+{
+	return memtx_tree_index_build_bulk_ops(index) != NULL;
+}
+
+/** Bulk build worker thread, see memtx_tree_index_build_bulk(). */
+struct memtx_tree_build_worker {
+	/** Worker thread. */
+	struct cord cord;
+	/** Indexes being built. */
+	struct index **indexes;
+	/** Number of indexes being built. */
+	int index_count;
+	/** Tuples being added to the indexes. */
+	struct tuple **tuples;
+	/** Range of tuples handled by this worker. */
+	size_t begin, end;
+};
+
+/** Fill build arrays of all the indexes for a range of tuples. */
+static void
+memtx_tree_build_worker_run(struct memtx_tree_build_worker *worker)
+{
+	for (int i = 0; i < worker->index_count; i++) {
+		struct index *index = worker->indexes[i];
+		memtx_tree_index_build_bulk_ops(index)->fill(
+			index, worker->tuples, worker->begin, worker->end);
+	}
+}
+
+/** Bulk build worker thread function. */
+static int
+memtx_tree_build_worker_f(va_list ap)
+{
+	struct memtx_tree_build_worker *worker =
+		va_arg(ap, struct memtx_tree_build_worker *);
+	memtx_tree_build_worker_run(worker);
+	return 0;
+}
+
+/** Bulk build sort thread, see memtx_tree_index_build_bulk_sort_all(). */
+struct memtx_tree_sort_worker {
+	/** Worker thread. */
+	struct cord cord;
+	/** Indexes being built. */
+	struct index **indexes;
+	/** Number of indexes being built. */
+	int index_count;
+	/** Sort indexes [first, index_count) with this step. */
+	int first, step;
+	/** Number of threads used to sort one index. */
+	int thread_count;
+};
+
+/** Sort build arrays of the indexes assigned to a worker. */
+static void
+memtx_tree_sort_worker_run(struct memtx_tree_sort_worker *worker)
+{
+	for (int i = worker->first; i < worker->index_count;
+	     i += worker->step) {
+		struct index *index = worker->indexes[i];
+		memtx_tree_index_build_bulk_ops(index)->sort(
+			index, worker->thread_count);
+	}
+}
+
+/** Bulk build sort thread function. */
+static int
+memtx_tree_sort_worker_f(va_list ap)
+{
+	struct memtx_tree_sort_worker *worker =
+		va_arg(ap, struct memtx_tree_sort_worker *);
+	memtx_tree_sort_worker_run(worker);
+	return 0;
+}
+
+/**
+ * Sort build arrays of the given indexes concurrently: each index is
+ * sorted in its own thread, which uses its share of @a thread_count
+ * threads. If there are more indexes than threads, each thread sorts
+ * several indexes one by one.
+ */
+static void
+memtx_tree_index_build_bulk_sort_all(struct index **indexes, int index_count,
+				     int thread_count)
+{
+	int worker_count = MIN(index_count, thread_count);
+	struct memtx_tree_sort_worker *workers =
+		(struct memtx_tree_sort_worker *)
+		xcalloc(worker_count, sizeof(*workers));
+	for (int i = 0; i < worker_count; i++) {
+		struct memtx_tree_sort_worker *worker = &workers[i];
+		worker->indexes = indexes;
+		worker->index_count = index_count;
+		worker->first = i;
+		worker->step = worker_count;
+		worker->thread_count = MAX(thread_count / index_count, 1);
+	}
+	if (worker_count == 1) {
+		memtx_tree_sort_worker_run(&workers[0]);
+	} else {
+		for (int i = 0; i < worker_count; i++) {
+			char name[FIBER_NAME_MAX];
+			snprintf(name, sizeof(name), "build.sort.%d", i);
+			if (cord_costart(&workers[i].cord, name,
+					 memtx_tree_sort_worker_f,
+					 &workers[i]) != 0) {
+				diag_log();
+				panic("cord_start failed");
+			}
+		}
+		for (int i = 0; i < worker_count; i++) {
+			if (cord_cojoin(&workers[i].cord) != 0) {
+				diag_log();
+				panic("cord_cojoin failed");
+			}
+		}
+	}
+	free(workers);
+}
+
+/**
+ * If the number of tuples is less than this threshold, bulk build is
+ * done in the calling thread.
+ */
+static const size_t MEMTX_TREE_BUILD_BULK_NOSPAWN_THRESHOLD = 1024;
+
+int
+memtx_tree_index_build_bulk(struct index **indexes, int index_count,
+			    struct tuple **tuples, size_t tuple_count,
+			    int thread_count)
+{
+	for (int i = 0; i < index_count; i++) {
+		struct index *index = indexes[i];
+		assert(memtx_tree_index_supports_bulk_build(index));
+		if (memtx_tree_index_build_bulk_ops(index)->prepare(
+				index, tuple_count) != 0)
+			return -1;
+	}
+
+	if (tuple_count < MEMTX_TREE_BUILD_BULK_NOSPAWN_THRESHOLD)
+		thread_count = 1;
+	struct memtx_tree_build_worker *workers =
+		(struct memtx_tree_build_worker *)
+		xcalloc(thread_count, sizeof(*workers));
+	size_t part_size = tuple_count / thread_count;
+	for (int i = 0; i < thread_count; i++) {
+		struct memtx_tree_build_worker *worker = &workers[i];
+		worker->indexes = indexes;
+		worker->index_count = index_count;
+		worker->tuples = tuples;
+		worker->begin = i * part_size;
+		worker->end = i == thread_count - 1 ? tuple_count :
+			      worker->begin + part_size;
+	}
+	if (thread_count == 1) {
+		memtx_tree_build_worker_run(&workers[0]);
+	} else {
+		for (int i = 0; i < thread_count; i++) {
+			char name[FIBER_NAME_MAX];
+			snprintf(name, sizeof(name), "build.worker.%d", i);
+			if (cord_costart(&workers[i].cord, name,
+					 memtx_tree_build_worker_f,
+					 &workers[i]) != 0) {
+				diag_log();
+				panic("cord_start failed");
+			}
+		}
+		for (int i = 0; i < thread_count; i++) {
+			if (cord_cojoin(&workers[i].cord) != 0) {
+				diag_log();
+				panic("cord_cojoin failed");
+			}
+		}
+	}
+	free(workers);
+
+	for (int i = 0; i < index_count; i++) {
+		struct index *index = indexes[i];
+		memtx_tree_index_build_bulk_ops(index)->commit(index,
+							       tuple_count);
+	}
+	memtx_tree_index_build_bulk_sort_all(indexes, index_count,
+					     thread_count);
+	return 0;
+}
+
+/* }}} */
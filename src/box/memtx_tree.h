@@ -30,6 +30,8 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stdbool.h>
+#include <stddef.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -38,10 +40,35 @@ extern "C" {
 struct index;
 struct index_def;
 struct memtx_engine;
+struct tuple;
 
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Return true if the given index is a tree index that supports
+ * memtx_tree_index_build_bulk(), i.e. it is neither multikey nor
+ * functional.
+ */
+bool
+memtx_tree_index_supports_bulk_build(struct index *index);
+
+/**
+ * Add tuples to the given tree indexes being built, i.e. an equivalent of
+ * calling index_build_next() for each of the tuples and indexes. Keys and
+ * hints are extracted in @a thread_count threads, each of them handles its
+ * own part of the tuples for all the indexes. Then the build arrays of the
+ * indexes are sorted concurrently, sharing the threads, so that they aren't
+ * sorted by index_end_build(). Must be called at most once per index build,
+ * no tuples may be added to the indexes after it. Yields if threads are used.
+ *
+ * Returns 0 on success. On error returns -1 and sets diag.
+ */
+int
+memtx_tree_index_build_bulk(struct index **indexes, int index_count,
+			    struct tuple **tuples, size_t tuple_count,
+			    int thread_count);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -0,0 +1,214 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_tuple_compression.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "diag.h"
+#include "errcode.h"
+#include "fiber.h"
+#include "memtx_engine.h"
+#include "mp_compression.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tuple_format.h"
+
+#if defined(ENABLE_TUPLE_COMPRESSION)
+# error unimplemented
+#endif
+
+enum {
+	/**
+	 * Fields shorter than this are stored as is, because there's
+	 * hardly anything to gain from compressing them.
+	 */
+	MEMTX_TUPLE_COMPRESS_MIN_SIZE = 64,
+	/**
+	 * Same as MEMTX_TUPLE_COMPRESS_MIN_SIZE, but for compression
+	 * with a dictionary, which is effective even for short data.
+	 */
+	MEMTX_TUPLE_COMPRESS_DICT_MIN_SIZE = 16,
+};
+
+/** Statistics of compressed tuples. Only accessed from tx. */
+static struct memtx_tuple_compression_stat compression_stat;
+
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple, struct tt_compression_dict *dict)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	assert(format->is_compressed);
+	assert(!tuple_has_flag(tuple, TUPLE_IS_COMPRESSED));
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	const char *data_end = data + bsize;
+	const char *fields = data;
+	uint32_t field_count = mp_decode_array(&fields);
+	uint32_t format_field_count = MIN(field_count,
+					  tuple_format_field_count(format));
+	/* Estimate the size of the compressed data. */
+	size_t capacity = bsize;
+	const char *pos = fields;
+	for (uint32_t i = 0; i < format_field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		enum compression_type type =
+			tuple_format_field(format, i)->compression_type;
+		if (type != COMPRESSION_TYPE_NONE)
+			capacity += mp_compress_bound(pos - field, type);
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *buf = xregion_alloc(region, capacity);
+	char *buf_end = mp_encode_array(buf, field_count);
+	size_t min_size = dict != NULL ? MEMTX_TUPLE_COMPRESS_DICT_MIN_SIZE :
+			  MEMTX_TUPLE_COMPRESS_MIN_SIZE;
+	size_t raw_size = 0;
+	size_t compressed_size = 0;
+	pos = fields;
+	for (uint32_t i = 0; i < format_field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		size_t size = pos - field;
+		enum compression_type type =
+			tuple_format_field(format, i)->compression_type;
+		char *end = NULL;
+		if (type != COMPRESSION_TYPE_NONE && size >= min_size)
+			end = mp_compress(buf_end, field, size, type, dict);
+		/*
+		 * Store the field as is if it failed to compress or
+		 * compression didn't save any memory.
+		 */
+		if (end != NULL && (size_t)(end - buf_end) < size) {
+			raw_size += size;
+			compressed_size += end - buf_end;
+			buf_end = end;
+		} else {
+			memcpy(buf_end, field, size);
+			buf_end += size;
+		}
+	}
+	if (raw_size == 0) {
+		region_truncate(region, region_svp);
+		return tuple;
+	}
+	memcpy(buf_end, pos, data_end - pos);
+	buf_end += data_end - pos;
+	assert((size_t)(buf_end - buf) <= capacity);
+	struct tuple *result = memtx_tuple_new_raw(format, buf, buf_end,
+						   /*validate=*/false);
+	region_truncate(region, region_svp);
+	if (result == NULL)
+		return NULL;
+	tuple_set_flag(result, TUPLE_IS_COMPRESSED);
+	compression_stat.count++;
+	compression_stat.raw_size += raw_size;
+	compression_stat.compressed_size += compressed_size;
+	return result;
+}
+
+struct tuple *
+memtx_tuple_decompress_slow(struct tuple *tuple)
+{
+	assert(tuple_has_flag(tuple, TUPLE_IS_COMPRESSED));
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t size;
+	struct tuple *result = NULL;
+	data = memtx_tuple_decompress_raw(data, data + bsize, &size);
+	if (data != NULL) {
+		/* The tuple was validated before it was compressed. */
+		result = memtx_tuple_new_raw(tuple_format(tuple), data,
+					     data + size, /*validate=*/false);
+	}
+	region_truncate(region, region_svp);
+	return result;
+}
+
+const char *
+memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
+			   uint32_t *p_size)
+{
+	/* Calculate the size of the decompressed data. */
+	const char *fields = tuple;
+	uint32_t field_count = mp_decode_array(&fields);
+	size_t size = tuple_end - tuple;
+	bool is_compressed = false;
+	const char *pos = fields;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!mp_is_compression(field))
+			continue;
+		size_t raw_size = mp_decompress(&field, NULL, 0);
+		if (raw_size == 0)
+			goto error;
+		size = size - (pos - field) + raw_size;
+		is_compressed = true;
+	}
+	if (!is_compressed) {
+		*p_size = tuple_end - tuple;
+		return tuple;
+	}
+	char *buf = xregion_alloc(&fiber()->gc, size);
+	char *buf_end = buf;
+	memcpy(buf_end, tuple, fields - tuple);
+	buf_end += fields - tuple;
+	pos = fields;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!mp_is_compression(field)) {
+			memcpy(buf_end, field, pos - field);
+			buf_end += pos - field;
+			continue;
+		}
+		size_t raw_size = mp_decompress(&field, buf_end,
+						buf + size - buf_end);
+		if (raw_size == 0 || field != pos)
+			goto error;
+		buf_end += raw_size;
+	}
+	assert(buf_end == buf + size);
+	*p_size = size;
+	return buf;
+error:
+	diag_set(ClientError, ER_DECOMPRESSION, "invalid compressed data");
+	return NULL;
+}
+
+void
+memtx_tuple_compression_on_delete(struct tuple *tuple)
+{
+	assert(tuple_has_flag(tuple, TUPLE_IS_COMPRESSED));
+	uint32_t bsize;
+	const char *pos = tuple_data_range(tuple, &bsize);
+	uint32_t field_count = mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!mp_is_compression(field))
+			continue;
+		size_t compressed_size = pos - field;
+		size_t raw_size = mp_decompress(&field, NULL, 0);
+		assert(compression_stat.raw_size >= raw_size);
+		assert(compression_stat.compressed_size >= compressed_size);
+		compression_stat.raw_size -= raw_size;
+		compression_stat.compressed_size -= compressed_size;
+	}
+	assert(compression_stat.count > 0);
+	compression_stat.count--;
+}
+
+void
+memtx_tuple_compression_stat(struct memtx_tuple_compression_stat *stat)
+{
+	*stat = compression_stat;
+}
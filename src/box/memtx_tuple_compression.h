@@ -11,34 +11,77 @@
 # include "memtx_tuple_compression_impl.h"
 #else /* !defined(ENABLE_TUPLE_COMPRESSION) */
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "tuple.h"
 
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
-static inline struct tuple *
-memtx_tuple_compress(struct tuple *tuple)
-{
-        (void)tuple;
-        unreachable();
-        return NULL;
-}
+/** Statistics of memtx tuple compression. */
+struct memtx_tuple_compression_stat {
+	/** Number of tuples that have compressed fields. */
+	size_t count;
+	/** Size of the compressed fields before compression. */
+	size_t raw_size;
+	/** Size of the compressed fields after compression. */
+	size_t compressed_size;
+};
+
+struct tt_compression_dict;
+
+/**
+ * Compress the fields of a memtx tuple that have a compression type
+ * set in the tuple format. If @a dict isn't NULL, it's used for
+ * compression. Returns a new tuple or the same tuple if compression
+ * of all the fields turned out to be ineffective. Returns NULL and
+ * sets diag on failure.
+ */
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple, struct tt_compression_dict *dict);
+
+/**
+ * Decompress a tuple compressed with memtx_tuple_compress().
+ * Slow path of memtx_tuple_decompress().
+ */
+struct tuple *
+memtx_tuple_decompress_slow(struct tuple *tuple);
 
+/**
+ * Decompress a memtx tuple. Returns a new tuple, which isn't
+ * referenced, or the same tuple if it isn't compressed. Returns
+ * NULL and sets diag on failure.
+ */
 static inline struct tuple *
 memtx_tuple_decompress(struct tuple *tuple)
 {
-	assert(!tuple_is_compressed(tuple));
-	return tuple;
+	if (likely(!tuple_has_flag(tuple, TUPLE_IS_COMPRESSED)))
+		return tuple;
+	return memtx_tuple_decompress_slow(tuple);
 }
 
-static inline const char *
+/**
+ * Decompress raw tuple data. The result is allocated on the fiber
+ * region unless there are no compressed fields in the tuple, in which
+ * case the original data is returned. Returns NULL and sets diag on
+ * failure. May be called from any thread.
+ */
+const char *
 memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
-			   uint32_t *p_size)
-{
-	*p_size = tuple_end - tuple;
-	return tuple;
-}
+			   uint32_t *p_size);
+
+/**
+ * Account a compressed tuple that is about to be deleted in the
+ * compression statistics.
+ */
+void
+memtx_tuple_compression_on_delete(struct tuple *tuple);
+
+/** Get the compression statistics. */
+void
+memtx_tuple_compression_stat(struct memtx_tuple_compression_stat *stat);
 
 #if defined(__cplusplus)
 } /* extern "C" */
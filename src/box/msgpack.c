@@ -105,6 +105,11 @@ msgpack_check_ext_data(int8_t type, const char *data, uint32_t len)
 	case MP_INTERVAL:
 		return mp_validate_interval(data, len);
 	case MP_COMPRESSION:
+		/*
+		 * Compressed values are only created by memtx for
+		 * internal use and must not come from the outside.
+		 */
+		return -1;
 	default:
 		return mp_check_ext_data_default(type, data, len);
 	}
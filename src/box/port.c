@@ -206,12 +206,24 @@ port_c_add_str(struct port *base, const char *str, uint32_t len)
 
 static int
 port_c_dump_msgpack(struct port *base, struct obuf *out)
+{
+	return port_c_dump_msgpack_16_splice(base, out, 0, NULL, NULL);
+}
+
+int
+port_c_dump_msgpack_16_splice(struct port *base, struct obuf *out,
+			      uint32_t splice_size, port_c_splice_f splice,
+			      void *ctx)
 {
 	struct port_c *port = (struct port_c *)base;
 	struct port_c_entry *pe;
 	for (pe = port->first; pe != NULL; pe = pe->next) {
 		uint32_t size = pe->mp_size;
-		if (size == 0) {
+		if (size == 0 && splice != NULL &&
+		    tuple_bsize(pe->tuple) >= splice_size &&
+		    splice(pe->tuple, out, ctx)) {
+			/* The tuple data is sent by the caller. */
+		} else if (size == 0) {
 			if (tuple_to_obuf(pe->tuple, out) != 0)
 				return -1;
 		} else if (obuf_dup(out, pe->mp, size) != size) {
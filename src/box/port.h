@@ -188,6 +188,25 @@ port_free(void);
 int
 port_c_dump_msgpack_wrapped(struct port *port, struct obuf *out);
 
+/**
+ * Callback for port_c_dump_msgpack_16_splice(). Returns true if it took
+ * over sending the tuple data that would otherwise be copied to the
+ * output buffer at its current end, false if the tuple should be copied.
+ */
+typedef bool
+(*port_c_splice_f)(struct tuple *tuple, struct obuf *out, void *ctx);
+
+/**
+ * Same as port_dump_msgpack_16() for a C port, but invokes the splice
+ * callback for tuples that are splice_size bytes or larger instead of
+ * copying them to the output buffer. Returns the number of results or
+ * -1 on error.
+ */
+int
+port_c_dump_msgpack_16_splice(struct port *port, struct obuf *out,
+			      uint32_t splice_size, port_c_splice_f splice,
+			      void *ctx);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined __cplusplus */
@@ -165,6 +165,22 @@ recovery_close_log(struct recovery *r)
 	trigger_run_xc(&r->on_close_log, NULL);
 }
 
+void
+recovery_reset_log(struct recovery *r)
+{
+	if (xlog_cursor_is_open(&r->cursor)) {
+		xlog_cursor_close(&r->cursor, false);
+		trigger_run_xc(&r->on_close_log, NULL);
+	}
+	/*
+	 * Forget the last scanned WAL so that the next call to
+	 * recover_remaining_wals() looks up the WAL to scan by
+	 * the recovery vclock without checking for gaps between
+	 * the WAL files.
+	 */
+	r->cursor.state = XLOG_CURSOR_NEW;
+}
+
 static void
 recovery_open_log(struct recovery *r, const struct vclock *vclock)
 {
@@ -90,6 +90,15 @@ recovery_finalize(struct recovery *r);
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
 
+/**
+ * Close the WAL file being scanned, if any, and make recovery forget
+ * about it. Used by a reader that fetched rows bypassing WAL files,
+ * so that the next call to recover_remaining_wals() resumes from the
+ * WAL file containing the recovery vclock.
+ */
+void
+recovery_reset_log(struct recovery *r);
+
 /**
  * Find out if there are new .xlog files since the current
  * vclock, and read them all up.
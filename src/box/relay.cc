@@ -51,6 +51,7 @@
 #include "vclock/vclock.h"
 #include "version.h"
 #include "xrow.h"
+#include "xrow_buf.h"
 #include "xrow_io.h"
 #include "xstream.h"
 #include "wal.h"
@@ -128,6 +129,15 @@ struct relay {
 	struct replica *replica;
 	/** WAL event watcher. */
 	struct wal_watcher wal_watcher;
+	/** Position in the WAL memory buffer, see wal_relay_buf(). */
+	struct xrow_buf_cursor wal_buf_cursor;
+	/**
+	 * Set if the relay reads rows from the WAL memory buffer
+	 * rather than from WAL files.
+	 */
+	bool is_reading_wal_buf;
+	/** Rows copied from the WAL memory buffer. */
+	struct ibuf wal_buf_ibuf;
 	/** Relay reader cond. */
 	struct fiber_cond reader_cond;
 	/** Relay diagnostics. */
@@ -710,6 +720,66 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Send rows written to the WAL since the last call, reading them
+ * from the WAL memory buffer. Returns false if some of the rows
+ * aren't stored in the buffer and so must be read from WAL files.
+ */
+static bool
+relay_send_wal_buf(struct relay *relay)
+{
+	struct xrow_buf *buf = wal_relay_buf();
+	if (buf == NULL)
+		return false;
+	struct recovery *r = relay->r;
+	if (!relay->is_reading_wal_buf) {
+		if (xrow_buf_cursor_create(buf, &r->vclock,
+					   &relay->wal_buf_cursor) != 0)
+			return false;
+		recovery_reset_log(r);
+		relay->is_reading_wal_buf = true;
+		say_info("reading WAL from memory");
+	}
+	struct ibuf *ibuf = &relay->wal_buf_ibuf;
+	while (true) {
+		ibuf_reset(ibuf);
+		bool is_rotate;
+		int rc = xrow_buf_cursor_next(buf, &relay->wal_buf_cursor,
+					      ibuf, &is_rotate);
+		if (rc > 0)
+			break;
+		if (rc < 0) {
+			relay->is_reading_wal_buf = false;
+			say_info("fell behind the WAL memory buffer, "
+				 "reading WAL from disk");
+			return false;
+		}
+		/*
+		 * The rows preceding the new WAL file have been sent
+		 * so the old WAL file may be collected once the replica
+		 * acknowledges them.
+		 */
+		if (is_rotate)
+			trigger_run_xc(&r->on_close_log, NULL);
+		const char *pos = ibuf->rpos;
+		const char *end = ibuf->wpos;
+		while (pos < end) {
+			struct xrow_header row;
+			xrow_header_decode_xc(&row, &pos, end, false);
+			if (++relay->stream.row_count %
+			    WAL_ROWS_PER_YIELD == 0)
+				xstream_yield(&relay->stream);
+			/* Skip rows that have already been sent. */
+			if (row.lsn <= vclock_get(&r->vclock, row.replica_id))
+				continue;
+			vclock_follow_xrow(&r->vclock, &row);
+			xstream_write_xc(&relay->stream, &row);
+		}
+	}
+	ibuf_reset(ibuf);
+	return true;
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -726,9 +796,17 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		 */
 		return;
 	}
+	/*
+	 * Rescan the WAL directory if the relay has been reading rows
+	 * from memory, because it could miss some WAL rotations.
+	 */
+	bool scan_dir = (events & WAL_EVENT_ROTATE) != 0 ||
+			relay->is_reading_wal_buf;
 	try {
+		if (relay_send_wal_buf(relay))
+			return;
 		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+				       scan_dir);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -983,6 +1061,8 @@ relay_subscribe_f(va_list ap)
 	cbus_endpoint_create(&relay->wal_endpoint,
 			     tt_sprintf("relay_wal_%p", relay),
 			     fiber_schedule_cb, fiber());
+	ibuf_create(&relay->wal_buf_ibuf, &cord()->slabc, 16 * 1024);
+	relay->is_reading_wal_buf = false;
 
 	/*
 	 * Setup garbage collection trigger.
@@ -1062,6 +1142,7 @@ relay_subscribe_f(va_list ap)
 		    relay_thread_on_stop, relay, cbus_process);
 	cbus_endpoint_destroy(&relay->wal_endpoint, cbus_process);
 	cbus_endpoint_destroy(&relay->tx_endpoint, cbus_process);
+	ibuf_destroy(&relay->wal_buf_ibuf);
 
 	relay_exit(relay);
 
@@ -57,6 +57,7 @@ double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 bool replication_anon = false;
 int replication_threads = 1;
+int replication_apply_concurrency = 1;
 
 struct replicaset replicaset;
 
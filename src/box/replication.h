@@ -100,6 +100,9 @@ static const int REPLICATION_CONNECT_QUORUM_ALL = INT_MAX;
 
 enum { REPLICATION_THREADS_MAX = 1000 };
 
+/** Max value of the replication_apply_concurrency option. */
+enum { REPLICATION_APPLY_CONCURRENCY_MAX = 1000 };
+
 enum bootstrap_strategy {
 	BOOTSTRAP_STRATEGY_INVALID = -1,
 	BOOTSTRAP_STRATEGY_AUTO,
@@ -179,6 +182,12 @@ extern bool replication_anon;
 /** How many threads to use for decoding incoming replication stream. */
 extern int replication_threads;
 
+/**
+ * How many fibers may apply non-conflicting transactions received from
+ * a master concurrently. 1 means that transactions are applied one by one.
+ */
+extern int replication_apply_concurrency;
+
 /**
  * A list of triggers fired once quorum of "healthy" connections is acquired.
  */
@@ -60,6 +60,40 @@ result_process_perform(struct result_processor *p, int *rc,
 	space_upgrade_unref(p->upgrade);
 }
 
+/**
+ * Same as result_process_perform(), but processes an array of
+ * referenced tuples, as returned by index_get_many(). On failure
+ * all the tuples are unreferenced.
+ */
+static inline void
+result_process_perform_many(struct result_processor *p, int *rc,
+			    struct tuple **result, uint32_t count)
+{
+	if (likely(p->upgrade == NULL))
+		return;
+	for (uint32_t i = 0; *rc == 0 && i < count; i++) {
+		if (result[i] == NULL)
+			continue;
+		struct tuple *tuple = space_upgrade_apply(p->upgrade,
+							  result[i]);
+		if (tuple == NULL) {
+			*rc = -1;
+			break;
+		}
+		tuple_ref(tuple);
+		tuple_unref(result[i]);
+		result[i] = tuple;
+	}
+	if (*rc != 0) {
+		for (uint32_t i = 0; i < count; i++) {
+			if (result[i] != NULL)
+				tuple_unref(result[i]);
+			result[i] = NULL;
+		}
+	}
+	space_upgrade_unref(p->upgrade);
+}
+
 /**
  * A shortcut for
  *
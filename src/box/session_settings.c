@@ -281,8 +281,11 @@ static const struct index_vtab session_settings_index_vtab = {
 	/* .count = */ generic_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ session_settings_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ session_settings_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
@@ -425,6 +428,7 @@ const struct space_vtab session_settings_space_vtab = {
 	/* .execute_delete = */ session_settings_space_execute_delete,
 	/* .execute_update = */ session_settings_space_execute_update,
 	/* .execute_upsert = */ session_settings_space_execute_upsert,
+	/* .execute_delete_range = */ generic_space_execute_delete_range,
 	/* .ephemeral_replace = */ generic_space_ephemeral_replace,
 	/* .ephemeral_delete = */ generic_space_ephemeral_delete,
 	/* .ephemeral_rowid_next = */ generic_space_ephemeral_rowid_next,
@@ -55,10 +55,10 @@
 #include "wal_ext.h"
 #include "coll_id_cache.h"
 
-int
-access_check_space(struct space *space, box_user_access_mask_t access)
+bool
+space_access_is_granted(struct space *space, const struct credentials *cr,
+			box_user_access_mask_t access)
 {
-	struct credentials *cr = effective_user();
 	/* Any space access also requires global USAGE privilege. */
 	access |= BOX_PRIVILEGE_USAGE;
 	/*
@@ -76,12 +76,23 @@ access_check_space(struct space *space, box_user_access_mask_t access)
 	space_access &= ~entity_access_get(
 		BOX_SC_SPACE)[cr->auth_token].effective;
 
-	if (space_access &&
-	    /* Check for missing USAGE access, ignore owner rights. */
-	    (space_access & BOX_PRIVILEGE_USAGE ||
-	     /* Check for missing specific access, respect owner rights. */
-	    (space->def->uid != cr->uid &&
-	     space_access & ~space->access[cr->auth_token].effective))) {
+	if (space_access == 0)
+		return true;
+	/* Check for missing USAGE access, ignore owner rights. */
+	if (space_access & BOX_PRIVILEGE_USAGE)
+		return false;
+	/* Check for missing specific access, respect owner rights. */
+	return space->def->uid == cr->uid ||
+	       (space_access & ~space->access[cr->auth_token].effective) == 0;
+}
+
+int
+access_check_space(struct space *space, box_user_access_mask_t access)
+{
+	struct credentials *cr = effective_user();
+	/* Any space access also requires global USAGE privilege. */
+	access |= BOX_PRIVILEGE_USAGE;
+	if (!space_access_is_granted(space, cr, access)) {
 		/*
 		 * Report access violation. Throw "no such user"
 		 * error if there is no user with this id.
@@ -800,6 +811,24 @@ int
 space_execute_dml(struct space *space, struct txn *txn,
 		  struct request *request, struct tuple **result)
 {
+	if (unlikely(request->type == IPROTO_DELETE_RANGE)) {
+		/*
+		 * A range delete doesn't know which tuples it deletes
+		 * so it neither runs triggers nor checks foreign keys.
+		 */
+		struct space_cache_holder *h;
+		rlist_foreach_entry(h, &space->space_cache_pin_list, link) {
+			if (h->type == SPACE_HOLDER_FOREIGN_KEY) {
+				diag_set(ClientError, ER_UNSUPPORTED,
+					 space_name(space),
+					 "range delete in spaces referenced "
+					 "by foreign keys");
+				return -1;
+			}
+		}
+		*result = NULL;
+		return space->vtab->execute_delete_range(space, txn, request);
+	}
 	if (unlikely(space->sequence != NULL) &&
 	    (request->type == IPROTO_INSERT ||
 	     request->type == IPROTO_REPLACE)) {
@@ -937,6 +966,17 @@ generic_space_bsize(struct space *space)
 	return 0;
 }
 
+int
+generic_space_execute_delete_range(struct space *space, struct txn *txn,
+				   struct request *request)
+{
+	(void)txn;
+	(void)request;
+	diag_set(ClientError, ER_UNSUPPORTED, space->engine->name,
+		 "range delete");
+	return -1;
+}
+
 int
 generic_space_ephemeral_replace(struct space *space, const char *tuple,
 				const char *tuple_end)
@@ -54,6 +54,7 @@ struct tuple;
 struct tuple_format;
 struct constraint_id;
 struct space_upgrade;
+struct credentials;
 struct space_wal_ext;
 
 struct space_vtab {
@@ -69,6 +70,12 @@ struct space_vtab {
 	int (*execute_update)(struct space *, struct txn *,
 			      struct request *, struct tuple **result);
 	int (*execute_upsert)(struct space *, struct txn *, struct request *);
+	/**
+	 * Delete all tuples with primary keys in the range
+	 * [request->key, request->tuple).
+	 */
+	int (*execute_delete_range)(struct space *, struct txn *,
+				    struct request *);
 
 	int (*ephemeral_replace)(struct space *, const char *, const char *);
 
@@ -479,6 +486,15 @@ space_index_def(struct space *space, int n);
 const char *
 index_name_by_id(struct space *space, uint32_t id);
 
+/**
+ * Check whether or not the given credentials grant the requested
+ * access to the space. Unlike access_check_space(), doesn't set
+ * diag so it may be used to check access of any user.
+ */
+bool
+space_access_is_granted(struct space *space, const struct credentials *cr,
+			box_user_access_mask_t access);
+
 /**
  * Check whether or not the current user can be granted
  * the requested access to the space.
@@ -683,6 +699,8 @@ size_t generic_space_bsize(struct space *);
 int generic_space_ephemeral_replace(struct space *, const char *, const char *);
 int generic_space_ephemeral_delete(struct space *, const char *);
 int generic_space_ephemeral_rowid_next(struct space *, uint64_t *);
+int generic_space_execute_delete_range(struct space *, struct txn *,
+				       struct request *);
 void generic_init_system_space(struct space *);
 void generic_init_ephemeral_space(struct space *);
 int generic_space_check_index_def(struct space *, struct index_def *);
@@ -45,6 +45,10 @@ const struct space_opts space_opts_default = {
 	/* .view = */ false,
 	/* .is_sync = */ false,
 	/* .defer_deletes = */ false,
+	/* .compression_dict = */ false,
+	/* .iproto_read_view = */ false,
+	/* .ttl = */ 0,
+	/* .ttl_field = */ UINT32_MAX,
 	/* .sql        = */ NULL,
 	/* .constraint_def = */ NULL,
 	/* .constraint_count = */ 0,
@@ -97,6 +101,12 @@ const struct opt_def space_opts_reg[] = {
 	OPT_DEF("view", OPT_BOOL, struct space_opts, is_view),
 	OPT_DEF("is_sync", OPT_BOOL, struct space_opts, is_sync),
 	OPT_DEF("defer_deletes", OPT_BOOL, struct space_opts, defer_deletes),
+	OPT_DEF("compression_dict", OPT_BOOL, struct space_opts,
+		compression_dict),
+	OPT_DEF("iproto_read_view", OPT_BOOL, struct space_opts,
+		iproto_read_view),
+	OPT_DEF("ttl", OPT_FLOAT, struct space_opts, ttl),
+	OPT_DEF("ttl_field", OPT_UINT32, struct space_opts, ttl_field),
 	OPT_DEF("sql", OPT_STRPTR, struct space_opts, sql),
 	OPT_DEF_CUSTOM("constraint", space_opts_parse_constraint),
 	OPT_DEF_CUSTOM("foreign_key", space_opts_parse_foreign_key),
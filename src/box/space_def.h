@@ -112,6 +112,30 @@ struct space_opts {
 	 * which should speed up writes, but may also slow down reads.
 	 */
 	bool defer_deletes;
+	/**
+	 * If set, a zstd dictionary is trained in background on the
+	 * space data and used for compression of memtx tuple fields
+	 * and vinyl run pages, see compression_dict.h.
+	 */
+	bool compression_dict;
+	/**
+	 * If set, selects from this space sent over iproto may be served
+	 * by iproto threads from a periodically refreshed read view, see
+	 * the iproto_read_view_staleness configuration option.
+	 */
+	bool iproto_read_view;
+	/**
+	 * Time to live of space tuples, in seconds, or 0 if tuples
+	 * never expire. A tuple expires when ttl seconds have passed
+	 * since the time stored in its ttl_field, see space_ttl.h.
+	 */
+	double ttl;
+	/**
+	 * Number (zero-based) of the field that stores the time of
+	 * the last update of a tuple, in seconds since the Epoch.
+	 * UINT32_MAX if not set.
+	 */
+	uint32_t ttl_field;
 	/** SQL statement that produced this space. */
 	char *sql;
 	/** Array of constraints. Can be NULL if constraints_count == 0. */
@@ -0,0 +1,323 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "space_ttl.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "box.h"
+#include "clock.h"
+#include "diag.h"
+#include "fiber.h"
+#include "index.h"
+#include "key_def.h"
+#include "msgpuck.h"
+#include "session.h"
+#include "small/region.h"
+#include "space.h"
+#include "space_cache.h"
+#include "trivia/util.h"
+#include "txn.h"
+
+enum {
+	/** Max number of tuples deleted in one transaction. */
+	SPACE_TTL_BATCH_SIZE = 100,
+	/** Max number of tuples checked before yielding. */
+	SPACE_TTL_SCAN_SIZE = 1000,
+};
+
+/** How often the expiration fiber checks spaces, in seconds. */
+static const double SPACE_TTL_CHECK_PERIOD = 1;
+
+/** Fiber that deletes expired memtx tuples in background. */
+static struct fiber *space_ttl_fiber;
+
+/** Check if expired tuples should be deleted from a space. */
+static bool
+space_ttl_is_enabled(struct space *space)
+{
+	return space->def->opts.ttl > 0 && space_is_memtx(space) &&
+	       space_index(space, 0) != NULL;
+}
+
+/**
+ * Look up an index that can be used to find expired tuples of
+ * a space: a TREE index that has the ttl field as its first key
+ * part. Returns NULL if there's no such index.
+ */
+static struct index *
+space_ttl_find_index(struct space *space)
+{
+	uint32_t fieldno = space->def->opts.ttl_field;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct index *index = space->index[i];
+		struct key_def *key_def = index->def->key_def;
+		if (index->def->type == TREE && !key_def->is_multikey &&
+		    !key_def->for_func_index && key_def->parts[0].path == NULL &&
+		    key_def->parts[0].fieldno == fieldno)
+			return index;
+	}
+	return NULL;
+}
+
+/**
+ * Collect primary keys of expired tuples of a space, up to
+ * SPACE_TTL_BATCH_SIZE keys. The keys are allocated on the fiber
+ * region and encoded as a MsgPack array.
+ *
+ * If the index used for the lookup is ordered by the ttl field,
+ * the lookup stops at the first tuple that hasn't expired yet.
+ * Otherwise, tuples are checked in the primary key order starting
+ * after the key stored in @a pos, which is updated to point to
+ * the last checked key or set to NULL if all tuples were checked.
+ *
+ * Returns the number of collected keys or -1 on error.
+ */
+static int
+space_ttl_collect(struct space *space, double deadline, char **pos,
+		  const char **keys, const char **keys_end)
+{
+	struct region *region = &fiber()->gc;
+	uint32_t fieldno = space->def->opts.ttl_field;
+	struct index *pk = space_index(space, 0);
+	struct index *index = space_ttl_find_index(space);
+	bool is_ordered = index != NULL;
+	if (index == NULL)
+		index = pk;
+	char buf[16];
+	const char *key = buf;
+	const char *key_end;
+	enum iterator_type type;
+	if (is_ordered) {
+		struct key_part *part = &index->def->key_def->parts[0];
+		if (part->type == FIELD_TYPE_DOUBLE ||
+		    part->type == FIELD_TYPE_NUMBER ||
+		    part->type == FIELD_TYPE_SCALAR) {
+			/*
+			 * Start from the least number to skip values
+			 * that never expire and sort before numbers:
+			 * nil, booleans, NaN.
+			 */
+			key_end = mp_encode_array(buf, 1);
+			key_end = mp_encode_double((char *)key_end, -INFINITY);
+			type = ITER_GE;
+		} else if (key_part_is_nullable(part)) {
+			/* Tuples with nil in the ttl field never expire. */
+			key_end = mp_encode_array(buf, 1);
+			key_end = mp_encode_nil((char *)key_end);
+			type = ITER_GT;
+		} else {
+			key_end = mp_encode_array(buf, 0);
+			type = ITER_GE;
+		}
+	} else if (*pos != NULL) {
+		key = *pos;
+		key_end = key;
+		mp_next(&key_end);
+		type = ITER_GT;
+	} else {
+		key_end = mp_encode_array(buf, 0);
+		type = ITER_ALL;
+	}
+	struct iterator *it = box_index_iterator(space_id(space),
+						 index->def->iid, type,
+						 key, key_end);
+	if (it == NULL)
+		return -1;
+	char *data = NULL;
+	size_t size = 0;
+	int count = 0;
+	struct tuple *last = NULL;
+	struct tuple *tuple;
+	for (int i = 0; i < SPACE_TTL_SCAN_SIZE &&
+			count < SPACE_TTL_BATCH_SIZE; i++) {
+		if (box_iterator_next(it, &tuple) != 0)
+			goto fail;
+		if (tuple == NULL) {
+			last = NULL;
+			break;
+		}
+		last = tuple;
+		if (!space_ttl_tuple_is_expired(tuple, fieldno, deadline)) {
+			if (is_ordered)
+				break;
+			continue;
+		}
+		uint32_t key_size;
+		const char *pk_key = tuple_extract_key(
+			tuple, pk->def->key_def, MULTIKEY_NONE, &key_size);
+		if (pk_key == NULL)
+			goto fail;
+		data = xrealloc(data, size + key_size);
+		memcpy(data + size, pk_key, key_size);
+		size += key_size;
+		count++;
+	}
+	if (!is_ordered) {
+		free(*pos);
+		*pos = NULL;
+		if (last != NULL) {
+			uint32_t key_size;
+			const char *pk_key = tuple_extract_key(
+				last, pk->def->key_def, MULTIKEY_NONE,
+				&key_size);
+			if (pk_key == NULL)
+				goto fail;
+			*pos = xmalloc(key_size);
+			memcpy(*pos, pk_key, key_size);
+		}
+	}
+	box_iterator_free(it);
+	char *result = xregion_alloc(region, mp_sizeof_array(count) + size);
+	char *result_end = mp_encode_array(result, count);
+	if (size > 0)
+		memcpy(result_end, data, size);
+	free(data);
+	*keys = result;
+	*keys_end = result_end + size;
+	return count;
+fail:
+	box_iterator_free(it);
+	free(data);
+	return -1;
+}
+
+/**
+ * Delete tuples with the given primary keys from a space in one
+ * transaction. A tuple may have been updated since its key was
+ * collected so it's deleted only if it's still expired.
+ */
+static int
+space_ttl_delete(uint32_t space_id, uint32_t fieldno, double deadline,
+		 const char *keys)
+{
+	struct credentials *orig_credentials = effective_user();
+	fiber_set_user(fiber(), &admin_credentials);
+	if (box_txn_begin() != 0)
+		goto fail;
+	uint32_t count = mp_decode_array(&keys);
+	for (uint32_t i = 0; i < count; i++) {
+		const char *key = keys;
+		mp_next(&keys);
+		struct tuple *tuple;
+		if (box_index_get(space_id, 0, key, keys, &tuple) != 0)
+			goto rollback;
+		if (tuple == NULL ||
+		    !space_ttl_tuple_is_expired(tuple, fieldno, deadline))
+			continue;
+		if (box_delete(space_id, 0, key, keys, NULL) != 0)
+			goto rollback;
+	}
+	if (box_txn_commit() != 0)
+		goto fail;
+	fiber_set_user(fiber(), orig_credentials);
+	return 0;
+rollback:
+	box_txn_rollback();
+fail:
+	fiber_set_user(fiber(), orig_credentials);
+	return -1;
+}
+
+/**
+ * Delete expired tuples from a space. Yields between batches.
+ * Returns 0 on success, -1 on failure, in which case diag is set.
+ */
+static int
+space_ttl_expire(uint32_t space_id)
+{
+	struct region *region = &fiber()->gc;
+	char *pos = NULL;
+	int rc = 0;
+	do {
+		/* The space may be dropped or altered while we yield. */
+		struct space *space = space_by_id(space_id);
+		if (space == NULL || box_is_ro() ||
+		    !space_ttl_is_enabled(space))
+			break;
+		double deadline = clock_realtime() - space->def->opts.ttl;
+		uint32_t fieldno = space->def->opts.ttl_field;
+		size_t region_svp = region_used(region);
+		const char *keys, *keys_end;
+		int count = space_ttl_collect(space, deadline, &pos,
+					      &keys, &keys_end);
+		if (count > 0)
+			rc = space_ttl_delete(space_id, fieldno, deadline,
+					      keys);
+		else if (count < 0)
+			rc = -1;
+		region_truncate(region, region_svp);
+		if (rc != 0 || (count < SPACE_TTL_BATCH_SIZE && pos == NULL))
+			break;
+		fiber_sleep(0);
+	} while (!fiber_is_cancelled());
+	free(pos);
+	return rc;
+}
+
+/** Ids of spaces that may contain expired tuples. */
+struct space_ttl_queue {
+	uint32_t *space_ids;
+	int count;
+	int capacity;
+};
+
+static int
+space_ttl_queue_add(struct space *space, void *arg)
+{
+	struct space_ttl_queue *queue = arg;
+	if (!space_ttl_is_enabled(space))
+		return 0;
+	if (queue->count == queue->capacity) {
+		queue->capacity = MAX(queue->capacity * 2, 16);
+		queue->space_ids = xrealloc(
+			queue->space_ids,
+			queue->capacity * sizeof(*queue->space_ids));
+	}
+	queue->space_ids[queue->count++] = space_id(space);
+	return 0;
+}
+
+static int
+space_ttl_fiber_f(va_list ap)
+{
+	(void)ap;
+	struct space_ttl_queue queue = {NULL, 0, 0};
+	while (!fiber_is_cancelled()) {
+		fiber_sleep(SPACE_TTL_CHECK_PERIOD);
+		fiber_check_gc();
+		if (!box_is_configured() || box_is_ro())
+			continue;
+		queue.count = 0;
+		space_foreach(space_ttl_queue_add, &queue);
+		for (int i = 0; i < queue.count; i++) {
+			if (space_ttl_expire(queue.space_ids[i]) != 0)
+				diag_log();
+		}
+	}
+	free(queue.space_ids);
+	return 0;
+}
+
+void
+space_ttl_init(void)
+{
+	space_ttl_fiber = fiber_new_system("space_ttl", space_ttl_fiber_f);
+	if (space_ttl_fiber == NULL)
+		panic("failed to start tuple expiration fiber");
+	fiber_start(space_ttl_fiber);
+}
+
+void
+space_ttl_free(void)
+{
+	/*
+	 * Can't stop the expiration fiber as the event loop isn't
+	 * running when this function is called.
+	 */
+}
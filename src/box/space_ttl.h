@@ -0,0 +1,62 @@
+#pragma once
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+/*
+ * Per-space tuple expiration.
+ *
+ * A space with the ttl option set stores the time of the last update
+ * of each tuple, in seconds since the Epoch, in the field specified
+ * by the ttl_field option. A tuple expires ttl seconds after that
+ * time. Tuples that don't have a numeric value in the field never
+ * expire.
+ *
+ * Expired memtx tuples are deleted by a background fiber in small
+ * batches. If the space has a TREE index with the ttl field as the
+ * first key part, the fiber uses it to find expired tuples, otherwise
+ * it scans the primary index. Deletions are regular DELETE requests
+ * so they are written to WAL and replicated.
+ *
+ * Expired vinyl tuples aren't deleted explicitly. Instead, they are
+ * dropped by compaction to the last LSM tree level, which doesn't
+ * generate any DELETE statements, see vy_write_iterator.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "msgpuck.h"
+#include "tuple.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Return true if a tuple has a number not greater than @a deadline
+ * stored in the field @a fieldno.
+ */
+static inline bool
+space_ttl_tuple_is_expired(struct tuple *tuple, uint32_t fieldno,
+			   double deadline)
+{
+	const char *field = tuple_field(tuple, fieldno);
+	double value;
+	if (field == NULL || mp_read_double(&field, &value) != 0)
+		return false;
+	return value <= deadline;
+}
+
+/** Initialize the module and start the expiration fiber. */
+void
+space_ttl_init(void);
+
+/** Free the module. */
+void
+space_ttl_free(void);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
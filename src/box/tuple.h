@@ -368,6 +368,12 @@ enum tuple_flag {
 	 * immediately while a snapshot is in progress.
 	 */
 	TUPLE_IS_TEMPORARY = 2,
+	/**
+	 * Some fields of the tuple are stored compressed, see
+	 * memtx_tuple_compress(). The tuple must be decompressed
+	 * before it's returned to the user.
+	 */
+	TUPLE_IS_COMPRESSED = 3,
 	tuple_flag_MAX,
 };
 
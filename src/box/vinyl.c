@@ -297,11 +297,38 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "tx", vy_tx_manager_mem_used(env->xm));
 	info_append_int(h, "level0", lsregion_used(&env->mem_env.allocator));
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
+	info_append_int(h, "page_cache", env->run_env.page_cache.mem_used);
+	info_append_int(h, "page_index_cache",
+			env->run_env.page_index_cache.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
 	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
 	info_table_end(h); /* memory */
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache_stat *stat = &env->run_env.page_cache.stat;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "lookup", stat->lookup);
+	info_append_int(h, "hit", stat->hit);
+	info_append_int(h, "put", stat->put);
+	info_append_int(h, "evict", stat->evict);
+	info_table_end(h); /* page_cache */
+}
+
+static void
+vy_info_append_page_index_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache_stat *stat = &env->run_env.page_index_cache.stat;
+	info_table_begin(h, "page_index_cache");
+	info_append_int(h, "lookup", stat->lookup);
+	info_append_int(h, "hit", stat->hit);
+	info_append_int(h, "put", stat->put);
+	info_append_int(h, "evict", stat->evict);
+	info_table_end(h); /* page_index_cache */
+}
+
 static void
 vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 {
@@ -320,6 +347,8 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *h)
 	info_begin(h);
 	vy_info_append_tx(env, h);
 	vy_info_append_memory(env, h);
+	vy_info_append_page_cache(env, h);
+	vy_info_append_page_index_cache(env, h);
 	vy_info_append_disk(env, h);
 	vy_info_append_scheduler(env, h);
 	vy_info_append_regulator(env, h);
@@ -411,6 +440,7 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_append_int(h, "hit", stat->disk.iterator.bloom_hit);
 	info_append_int(h, "miss", stat->disk.iterator.bloom_miss);
 	info_table_end(h); /* bloom */
+	info_append_int(h, "skip", stat->disk.iterator.skip);
 	info_table_end(h); /* iterator */
 	info_table_begin(h, "dump");
 	info_append_int(h, "count", stat->disk.dump.count);
@@ -457,6 +487,12 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_append_int(h, "dumps_per_compaction",
 			vy_lsm_dumps_per_compaction(lsm));
 
+	info_table_begin(h, "amplification");
+	info_append_double(h, "write", vy_lsm_write_amplification(lsm));
+	info_append_double(h, "read", vy_lsm_read_amplification(lsm));
+	info_append_double(h, "space", vy_lsm_space_amplification(lsm));
+	info_table_end(h); /* amplification */
+
 	info_end(h);
 }
 
@@ -510,7 +546,9 @@ vinyl_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 	stat->index += env->mem_env.tree_extent_size;
 	stat->index += env->lsm_env.bloom_size;
 	stat->index += env->lsm_env.page_index_size;
+	stat->index += env->run_env.page_index_cache.mem_used;
 	stat->cache += env->cache_env.mem_used;
+	stat->cache += env->run_env.page_cache.mem_used;
 	stat->tx += vy_tx_manager_mem_used(env->xm);
 }
 
@@ -521,6 +559,10 @@ vinyl_engine_reset_stat(struct engine *engine)
 
 	struct vy_tx_manager *xm = env->xm;
 	memset(&xm->stat, 0, sizeof(xm->stat));
+	memset(&env->run_env.page_cache.stat, 0,
+	       sizeof(env->run_env.page_cache.stat));
+	memset(&env->run_env.page_index_cache.stat, 0,
+	       sizeof(env->run_env.page_index_cache.stat));
 
 	vy_scheduler_reset_stat(&env->scheduler);
 	vy_regulator_reset_stat(&env->regulator);
@@ -592,6 +634,11 @@ vinyl_engine_check_space_def(struct space_def *def)
 			 "engine does not support data-temporary spaces");
 		return -1;
 	}
+	if (def->opts.iproto_read_view) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "iproto read view");
+		return -1;
+	}
 	return 0;
 }
 
@@ -677,6 +724,26 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "hint is only reasonable with memtx tree index");
 		return -1;
 	}
+	if (index_def->opts.fast_offset) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "fast_offset is only reasonable with memtx tree index");
+		return -1;
+	}
+	if (index_def->opts.covering) {
+		const char *reason = NULL;
+		if (index_def->iid == 0)
+			reason = "primary index can't be covering";
+		else if (index_def->key_def->is_multikey)
+			reason = "multikey index can't be covering";
+		else if (index_def->key_def->for_func_index)
+			reason = "functional index can't be covering";
+		if (reason != NULL) {
+			diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+				 space_name(space), reason);
+			return -1;
+		}
+	}
 
 	struct key_def *key_def = index_def->key_def;
 
@@ -959,6 +1026,8 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.func_id != new_def->opts.func_id)
 		return true;
+	if (old_def->opts.covering != new_def->opts.covering)
+		return true;
 
 	assert(index_depends_on_pk(index));
 	const struct key_def *old_cmp_def = old_def->cmp_def;
@@ -1001,12 +1070,34 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 static int
 vinyl_space_prepare_alter(struct space *old_space, struct space *new_space)
 {
-	(void)new_space;
 	struct vy_env *env = vy_env(old_space->engine);
 
 	if (vinyl_check_wal(env, "DDL") != 0)
 		return -1;
 
+	/*
+	 * Reads from a covering index rely on the index being
+	 * consistent with the primary index, which isn't true if
+	 * DELETEs are deferred or tuples expire, because expired
+	 * tuples are only dropped by primary index compaction.
+	 */
+	const char *option;
+	if (new_space->def->opts.defer_deletes)
+		option = "defer_deletes";
+	else if (new_space->def->opts.ttl > 0)
+		option = "ttl";
+	else
+		return 0;
+	for (uint32_t i = 0; i < new_space->index_count; i++) {
+		struct index_def *index_def = new_space->index[i]->def;
+		if (index_def->opts.covering) {
+			diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+				 space_name(new_space),
+				 tt_sprintf("covering index can't be used in "
+					    "a space with %s", option));
+			return -1;
+		}
+	}
 	return 0;
 }
 
@@ -1297,6 +1388,21 @@ vy_get_by_secondary_tuple(struct vy_lsm *lsm, struct vy_tx *tx,
 	int rc = 0;
 	assert(lsm->index_id > 0);
 
+	if (lsm->opts.covering) {
+		/*
+		 * A covering index stores full tuples and is kept
+		 * consistent with the primary index, because DELETEs
+		 * can't be deferred, see vinyl_space_prepare_alter().
+		 * Concurrent changes are tracked by the secondary
+		 * index read set so there's no need to look up the
+		 * primary index.
+		 */
+		assert(!vy_stmt_is_key(entry.stmt));
+		tuple_ref(entry.stmt);
+		*result = entry;
+		return 0;
+	}
+
 	/*
 	 * Lookup the full tuple by a secondary statement.
 	 * There are two cases: the secondary statement may be
@@ -1506,6 +1612,100 @@ vy_get_by_raw_key(struct vy_lsm *lsm, struct vy_tx *tx,
 	return rc;
 }
 
+/**
+ * Get tuples from a vinyl space by a batch of raw keys.
+ * @param lsm         LSM tree in which search.
+ * @param tx          Current transaction.
+ * @param rv          Read view.
+ * @param keys        Keys, @a key_count consecutive MsgPack arrays.
+ * @param key_count   Number of keys.
+ * @param[out] result Found tuples are stored here. Must be
+ *                    unreferenced after usage.
+ *
+ * Lookups in the primary index are done with vy_point_lookup_batch()
+ * so that disk reads for different keys are issued concurrently.
+ * Keys of a secondary index aren't full (they lack primary key
+ * parts) so they are looked up one by one.
+ *
+ * @param  0 Success.
+ * @param -1 Memory error or read error.
+ */
+static int
+vy_get_many(struct vy_lsm *lsm, struct vy_tx *tx,
+	    const struct vy_read_view **rv, const char *keys,
+	    uint32_t key_count, struct tuple **result)
+{
+	memset(result, 0, key_count * sizeof(*result));
+	uint32_t i;
+	if (lsm->index_id > 0) {
+		for (i = 0; i < key_count; i++) {
+			uint32_t part_count = mp_decode_array(&keys);
+			if (vy_get_by_raw_key(lsm, tx, rv, keys, part_count,
+					      &result[i]) != 0) {
+				while (i-- > 0) {
+					if (result[i] != NULL)
+						tuple_unref(result[i]);
+					result[i] = NULL;
+				}
+				return -1;
+			}
+			for (uint32_t j = 0; j < part_count; j++)
+				mp_next(&keys);
+		}
+		return 0;
+	}
+
+	double start_time = ev_monotonic_now(loop());
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct vy_entry *key_entries = xregion_alloc_array(
+			region, typeof(key_entries[0]), key_count);
+	struct vy_entry *found = xregion_alloc_array(
+			region, typeof(found[0]), key_count);
+	int rc = -1;
+	for (i = 0; i < key_count; i++) {
+		uint32_t part_count = mp_decode_array(&keys);
+		struct vy_entry *key = &key_entries[i];
+		key->stmt = vy_key_new(lsm->env->key_format, keys, part_count);
+		if (key->stmt == NULL)
+			goto out;
+		key->hint = vy_stmt_hint(key->stmt, lsm->cmp_def);
+		for (uint32_t j = 0; j < part_count; j++)
+			mp_next(&keys);
+		if (tx != NULL && vy_tx_track_point(tx, lsm, *key) != 0) {
+			i++;
+			goto out;
+		}
+	}
+	lsm->stat.lookup += key_count;
+	if (vy_point_lookup_batch(lsm, tx, rv, key_entries, key_count,
+				  found) != 0)
+		goto out;
+	for (uint32_t j = 0; j < key_count; j++) {
+		if ((*rv)->vlsn == INT64_MAX)
+			vy_cache_add_point(&lsm->cache, found[j],
+					   key_entries[j]);
+		result[j] = found[j].stmt;
+		if (result[j] != NULL)
+			vy_stmt_counter_acct_tuple(&lsm->stat.get, result[j]);
+	}
+	rc = 0;
+
+	double latency = ev_monotonic_now(loop()) - start_time;
+	latency_collect(&lsm->stat.latency, latency);
+	if (latency > lsm->env->too_long_threshold) {
+		say_warn_ratelimited("%s: get_many(%u keys) "
+				     "took too long: %.3f sec",
+				     vy_lsm_name(lsm), (unsigned)key_count,
+				     latency);
+	}
+out:
+	for (uint32_t j = 0; j < i; j++)
+		tuple_unref(key_entries[j].stmt);
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 /**
  * Check if insertion of a new tuple violates unique constraint
  * of the primary index.
@@ -2428,6 +2628,64 @@ vinyl_space_execute_upsert(struct space *space, struct txn *txn,
 	return vy_upsert(env, tx, stmt, space, request);
 }
 
+/**
+ * Delete all tuples with primary keys in the range [begin, end).
+ * The deletion is written as a single range delete statement
+ * that is applied on read and compaction. Neither old tuples are
+ * looked up nor triggers are run so range deletes are supported
+ * only in spaces without secondary indexes.
+ */
+static int
+vinyl_space_execute_delete_range(struct space *space, struct txn *txn,
+				 struct request *request)
+{
+	struct vy_env *env = vy_env(space->engine);
+	struct vy_tx *tx = txn->engine_tx;
+	if (txn_check_singlestatement(txn, "range delete") != 0)
+		return -1;
+	if (space->index_count > 1) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "range delete in spaces with secondary indexes");
+		return -1;
+	}
+	struct vy_lsm *pk = vy_lsm_find(space, 0);
+	if (pk == NULL)
+		return -1;
+	const char *begin = request->key;
+	uint32_t begin_part_count = mp_decode_array(&begin);
+	if (key_validate(pk->base.def, ITER_GE, begin, begin_part_count) != 0)
+		return -1;
+	const char *end = request->tuple;
+	uint32_t end_part_count = 0;
+	if (end != NULL) {
+		end_part_count = mp_decode_array(&end);
+		if (key_validate(pk->base.def, ITER_LT, end,
+				 end_part_count) != 0)
+			return -1;
+	}
+	if (vy_is_committed(env, pk))
+		return 0;
+	struct vy_entry begin_key = vy_entry_key_new(pk->env->key_format,
+						     pk->cmp_def, begin,
+						     begin_part_count);
+	if (begin_key.stmt == NULL)
+		return -1;
+	struct vy_entry end_key = vy_entry_none();
+	if (end_part_count > 0) {
+		end_key = vy_entry_key_new(pk->env->key_format,
+					   pk->cmp_def, end, end_part_count);
+		if (end_key.stmt == NULL) {
+			tuple_unref(begin_key.stmt);
+			return -1;
+		}
+	}
+	int rc = vy_tx_delete_range(tx, pk, begin_key, end_key);
+	tuple_unref(begin_key.stmt);
+	if (end_key.stmt != NULL)
+		tuple_unref(end_key.stmt);
+	return rc;
+}
+
 static int
 vinyl_engine_begin(struct engine *engine, struct txn *txn)
 {
@@ -2738,6 +2996,27 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_page_cache_quota(&env->run_env, quota);
+}
+
+void
+vinyl_engine_set_page_index_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_page_index_cache_quota(&env->run_env, quota);
+}
+
+void
+vinyl_engine_set_partition_page_index(struct engine *engine, bool value)
+{
+	struct vy_env *env = vy_env(engine);
+	env->run_env.partition_page_index = value;
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -2783,6 +3062,14 @@ vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit)
 	vy_regulator_reset_dump_bandwidth(&env->regulator, limit_in_bytes);
 }
 
+void
+vinyl_engine_set_compaction_io_rate_limit(struct engine *engine,
+					  double limit)
+{
+	struct vy_env *env = vy_env(engine);
+	env->run_env.compaction_io_rate_limit = limit * 1024 * 1024;
+}
+
 /** }}} Environment */
 
 /* {{{ Checkpoint */
@@ -3880,6 +4167,38 @@ vinyl_index_get(struct index *index, const char *key,
 	return 0;
 }
 
+static int
+vinyl_index_get_many(struct index *index, const char *keys,
+		     uint32_t key_count, struct tuple **result)
+{
+	assert(index->def->opts.is_unique);
+
+	struct vy_lsm *lsm = vy_lsm(index);
+	struct vy_env *env = vy_env(index->engine);
+	struct vy_tx *tx = in_txn() ? in_txn()->engine_tx : NULL;
+	if (tx != NULL && tx->state == VINYL_TX_ABORT) {
+		memset(result, 0, key_count * sizeof(*result));
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		return -1;
+	}
+	struct vy_tx tx_autocommit;
+	if (tx == NULL) {
+		tx = &tx_autocommit;
+		vy_tx_create(env->xm, tx);
+	}
+	/*
+	 * Make sure the LSM tree isn't deleted while we are
+	 * reading from it.
+	 */
+	vy_lsm_ref(lsm);
+	int rc = vy_get_many(lsm, tx, vy_tx_read_view(tx),
+			     keys, key_count, result);
+	vy_lsm_unref(lsm);
+	if (tx == &tx_autocommit)
+		vy_tx_destroy(tx);
+	return rc;
+}
+
 /*** }}} Cursor */
 
 /* {{{ Index build */
@@ -4624,6 +4943,7 @@ static const struct space_vtab vinyl_space_vtab = {
 	/* .execute_delete = */ vinyl_space_execute_delete,
 	/* .execute_update = */ vinyl_space_execute_update,
 	/* .execute_upsert = */ vinyl_space_execute_upsert,
+	/* .execute_delete_range = */ vinyl_space_execute_delete_range,
 	/* .ephemeral_replace = */ generic_space_ephemeral_replace,
 	/* .ephemeral_delete = */ generic_space_ephemeral_delete,
 	/* .ephemeral_rowid_next = */ generic_space_ephemeral_rowid_next,
@@ -4660,8 +4980,11 @@ static const struct index_vtab vinyl_index_vtab = {
 	/* .count = */ generic_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ vinyl_index_get,
+	/* .get_many = */ vinyl_index_get_many,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ vinyl_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ vinyl_index_stat,
 	/* .compact = */ vinyl_index_compact,
@@ -57,6 +57,24 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Update vinyl page cache size.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
+/**
+ * Update vinyl page index cache size.
+ */
+void
+vinyl_engine_set_page_index_cache(struct engine *engine, size_t quota);
+
+/**
+ * Enable or disable writing large runs with partitioned page index.
+ */
+void
+vinyl_engine_set_partition_page_index(struct engine *engine, bool value);
+
 /**
  * Update vinyl memory size.
  */
@@ -88,6 +106,13 @@ vinyl_engine_set_too_long_threshold(struct engine *engine,
 void
 vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit);
 
+/**
+ * Update vinyl_compaction_io_rate_limit.
+ */
+void
+vinyl_engine_set_compaction_io_rate_limit(struct engine *engine,
+					  double limit);
+
 #ifdef __cplusplus
 } /* extern "C" */
 
@@ -511,6 +511,50 @@ vy_cache_on_write(struct vy_cache *cache, struct vy_entry entry,
 	}
 }
 
+void
+vy_cache_on_write_range(struct vy_cache *cache, struct vy_entry begin,
+			struct vy_entry end)
+{
+	vy_cache_gc(cache->env);
+	struct key_def *cmp_def = cache->cmp_def;
+	struct vy_cache_tree *tree = &cache->cache_tree;
+	struct vy_cache_tree_iterator itr;
+	struct vy_cache_node **node;
+	/*
+	 * Delete all cached statements falling in the range.
+	 * Deletion invalidates the tree iterator so we have
+	 * to look up the next statement from scratch.
+	 */
+	while (true) {
+		bool exact;
+		itr = vy_cache_tree_lower_bound(tree, begin, &exact);
+		node = vy_cache_tree_iterator_get_elem(tree, &itr);
+		if (node == NULL || (end.stmt != NULL &&
+				     vy_entry_compare((*node)->entry, end,
+						      cmp_def) >= 0))
+			break;
+		struct vy_cache_node *to_delete = *node;
+		vy_stmt_counter_acct_tuple(&cache->stat.invalidate,
+					   to_delete->entry.stmt);
+		vy_cache_tree_delete(tree, to_delete);
+		vy_cache_node_delete(cache->env, to_delete);
+	}
+	cache->version++;
+	/* Break the chain that went through the deleted range. */
+	if (node != NULL) {
+		(*node)->flags &= ~VY_CACHE_LEFT_LINKED;
+		(*node)->left_boundary_level = cmp_def->part_count;
+	}
+	struct vy_cache_tree_iterator prev = itr;
+	vy_cache_tree_iterator_prev(tree, &prev);
+	struct vy_cache_node **prev_node =
+		vy_cache_tree_iterator_get_elem(tree, &prev);
+	if (prev_node != NULL) {
+		(*prev_node)->flags &= ~VY_CACHE_RIGHT_LINKED;
+		(*prev_node)->right_boundary_level = cmp_def->part_count;
+	}
+}
+
 /**
  * Get a stmt by current position
  */
@@ -233,6 +233,18 @@ void
 vy_cache_on_write(struct vy_cache *cache, struct vy_entry entry,
 		  struct vy_entry *deleted);
 
+/**
+ * Invalidate all cached values in the range [begin, end) due to
+ * a range delete.
+ * @param cache - pointer to tuple cache.
+ * @param begin - begin of the deleted range (key).
+ * @param end - end of the deleted range (key) or none if the
+ *              range is unbounded.
+ */
+void
+vy_cache_on_write_range(struct vy_cache *cache, struct vy_entry begin,
+			struct vy_entry end);
+
 
 /**
  * Cache iterator
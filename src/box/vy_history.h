@@ -131,6 +131,13 @@ vy_history_append_stmt(struct vy_history *history, struct vy_entry entry);
 void
 vy_history_cleanup(struct vy_history *history);
 
+/**
+ * Remove all statements with LSN less than @a lsn from the given
+ * history. Used to drop statements deleted by a range delete.
+ */
+void
+vy_history_truncate(struct vy_history *history, int64_t lsn);
+
 /**
  * Get a resultant statement from collected history.
  * If the resultant statement is a DELETE, the function
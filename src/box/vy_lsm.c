@@ -54,6 +54,7 @@
 #include "vy_stmt.h"
 #include "vy_upsert.h"
 #include "vy_history.h"
+#include "vy_range_delete.h"
 #include "vy_read_set.h"
 
 /*
@@ -155,12 +156,14 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 	} else {
 		/*
 		 * To save disk space, we do not store full tuples
-		 * in secondary index runs. Instead we only store
-		 * extended keys (i.e. keys consisting of secondary
-		 * and primary index parts). This is enough to look
-		 * up a full tuple in the primary index.
+		 * in secondary index runs unless the index is
+		 * covering. Instead we only store extended keys
+		 * (i.e. keys consisting of secondary and primary
+		 * index parts). This is enough to look up a full
+		 * tuple in the primary index.
 		 */
-		lsm->disk_format = lsm_env->key_format;
+		lsm->disk_format = index_def->opts.covering ?
+				   format : lsm_env->key_format;
 
 		lsm->pk_in_cmp_def = key_def_find_pk_in_cmp_def(lsm->cmp_def,
 								pk->key_def,
@@ -676,6 +679,15 @@ vy_lsm_compaction_priority(struct vy_lsm *lsm)
 	return range->compaction_priority;
 }
 
+double
+vy_lsm_compaction_score(struct vy_lsm *lsm)
+{
+	struct vy_range *range = vy_range_heap_top(&lsm->range_heap);
+	if (range == NULL || lsm->is_dropped)
+		return 0;
+	return vy_range_compaction_score(range);
+}
+
 int64_t
 vy_lsm_range_size(struct vy_lsm *lsm)
 {
@@ -711,6 +723,7 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run)
 	assert(rlist_empty(&run->in_lsm));
 	rlist_add_entry(&lsm->runs, run, in_lsm);
 	lsm->run_count++;
+	lsm->range_delete_count += run->info.range_delete_count;
 	vy_disk_stmt_counter_add(&lsm->stat.disk.count, &run->count);
 	vy_stmt_stat_add(&lsm->stat.disk.stmt, &run->info.stmt_stat);
 
@@ -740,6 +753,8 @@ vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run)
 	assert(!rlist_empty(&run->in_lsm));
 	rlist_del_entry(run, in_lsm);
 	lsm->run_count--;
+	assert(lsm->range_delete_count >= run->info.range_delete_count);
+	lsm->range_delete_count -= run->info.range_delete_count;
 	vy_disk_stmt_counter_sub(&lsm->stat.disk.count, &run->count);
 	vy_stmt_stat_sub(&lsm->stat.disk.stmt, &run->info.stmt_stat);
 
@@ -781,6 +796,7 @@ vy_lsm_acct_range(struct vy_lsm *lsm, struct vy_range *range)
 {
 	histogram_collect(lsm->run_hist, range->slice_count);
 	lsm->sum_dumps_per_compaction += range->dumps_per_compaction;
+	lsm->sum_slice_count += range->slice_count;
 	vy_disk_stmt_counter_add(&lsm->stat.disk.compaction.queue,
 				 &range->compaction_queue);
 	lsm->env->compaction_queue_size += range->compaction_queue.bytes;
@@ -799,6 +815,7 @@ vy_lsm_unacct_range(struct vy_lsm *lsm, struct vy_range *range)
 {
 	histogram_discard(lsm->run_hist, range->slice_count);
 	lsm->sum_dumps_per_compaction -= range->dumps_per_compaction;
+	lsm->sum_slice_count -= range->slice_count;
 	vy_disk_stmt_counter_sub(&lsm->stat.disk.compaction.queue,
 				 &range->compaction_queue);
 	lsm->env->compaction_queue_size -= range->compaction_queue.bytes;
@@ -868,6 +885,8 @@ vy_lsm_delete_mem(struct vy_lsm *lsm, struct vy_mem *mem)
 	assert(!rlist_empty(&mem->in_sealed));
 	rlist_del_entry(mem, in_sealed);
 	vy_stmt_counter_sub(&lsm->stat.memory.count, &mem->count);
+	assert(lsm->range_delete_count >= mem->range_delete_count);
+	lsm->range_delete_count -= mem->range_delete_count;
 	vy_mem_delete(mem);
 	lsm->mem_list_version++;
 }
@@ -1015,6 +1034,97 @@ vy_lsm_rollback_stmt(struct vy_lsm *lsm, struct vy_mem *mem,
 	vy_cache_on_write(&lsm->cache, entry, NULL);
 }
 
+struct vy_range_delete *
+vy_lsm_set_range_delete(struct vy_lsm *lsm, struct vy_mem *mem,
+			struct vy_entry begin, struct vy_entry end,
+			int64_t lsn)
+{
+	assert(vy_stmt_is_key(begin.stmt));
+	assert(end.stmt == NULL || vy_stmt_is_key(end.stmt));
+	struct vy_range_delete *rd = vy_mem_insert_range_delete(
+			mem, tuple_data(begin.stmt),
+			tuple_data_or_null(end.stmt), lsn);
+	if (rd == NULL)
+		return NULL;
+	lsm->range_delete_count++;
+	vy_cache_on_write_range(&lsm->cache, begin, end);
+	return rd;
+}
+
+/**
+ * Invalidate the range deleted by a range delete in the cache.
+ */
+static void
+vy_lsm_invalidate_range_delete(struct vy_lsm *lsm, struct vy_range_delete *rd)
+{
+	struct tuple_format *key_format = lsm->env->key_format;
+	struct vy_entry begin, end = vy_entry_none();
+	begin = vy_entry_key_from_msgpack(key_format, lsm->cmp_def, rd->begin);
+	if (rd->end != NULL) {
+		end = vy_entry_key_from_msgpack(key_format, lsm->cmp_def,
+						rd->end);
+	}
+	if (begin.stmt == NULL || (rd->end != NULL && end.stmt == NULL)) {
+		/*
+		 * Can't allocate keys to invalidate the range so
+		 * drop the whole cache.
+		 */
+		vy_cache_on_write_range(&lsm->cache, lsm->env->empty_key,
+					vy_entry_none());
+	} else {
+		vy_cache_on_write_range(&lsm->cache, begin, end);
+	}
+	if (begin.stmt != NULL)
+		tuple_unref(begin.stmt);
+	if (end.stmt != NULL)
+		tuple_unref(end.stmt);
+}
+
+void
+vy_lsm_commit_range_delete(struct vy_lsm *lsm, struct vy_mem *mem,
+			   struct vy_range_delete *rd)
+{
+	vy_mem_commit_range_delete(mem, rd);
+	vy_lsm_invalidate_range_delete(lsm, rd);
+}
+
+void
+vy_lsm_rollback_range_delete(struct vy_lsm *lsm, struct vy_mem *mem,
+			     struct vy_range_delete *rd)
+{
+	vy_lsm_invalidate_range_delete(lsm, rd);
+	vy_mem_rollback_range_delete(mem, rd);
+	assert(lsm->range_delete_count > 0);
+	lsm->range_delete_count--;
+}
+
+void
+vy_lsm_apply_range_deletes(struct vy_lsm *lsm, const struct vy_read_view *rv,
+			   bool is_prepared_ok, struct vy_history *history,
+			   int64_t *min_skipped_plsn)
+{
+	if (lsm->range_delete_count == 0)
+		return;
+	struct vy_entry entry = vy_history_last_stmt(history);
+	if (entry.stmt == NULL)
+		return;
+	int64_t lsn = vy_mem_range_delete_lsn(lsm->mem, rv, is_prepared_ok,
+					      entry, min_skipped_plsn);
+	struct vy_mem *mem;
+	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
+		lsn = MAX(lsn, vy_mem_range_delete_lsn(mem, rv, is_prepared_ok,
+						       entry,
+						       min_skipped_plsn));
+	}
+	struct vy_run *run;
+	rlist_foreach_entry(run, &lsm->runs, in_lsm) {
+		lsn = MAX(lsn, vy_run_range_delete_lsn(run, rv, entry,
+						       lsm->cmp_def));
+	}
+	if (lsn >= 0)
+		vy_history_truncate(history, lsn);
+}
+
 int
 vy_lsm_find_range_intersection(struct vy_lsm *lsm,
 		const char *min_key, const char *max_key,
@@ -1246,3 +1356,19 @@ vy_lsm_force_compaction(struct vy_lsm *lsm)
 
 	vy_range_heap_update_all(&lsm->range_heap);
 }
+
+void
+vy_lsm_update_compaction_priority(struct vy_lsm *lsm)
+{
+	struct vy_range *range;
+	struct vy_range_tree_iterator it;
+
+	vy_range_tree_ifirst(&lsm->range_tree, &it);
+	while ((range = vy_range_tree_inext(&it)) != NULL) {
+		vy_lsm_unacct_range(lsm, range);
+		vy_range_update_compaction_priority(range, &lsm->opts);
+		vy_lsm_acct_range(lsm, range);
+	}
+
+	vy_range_heap_update_all(&lsm->range_heap);
+}
@@ -57,6 +57,9 @@ struct tuple_format;
 struct vy_lsm;
 struct vy_mem;
 struct vy_mem_env;
+struct vy_range_delete;
+struct vy_read_view;
+struct vy_history;
 struct vy_recovery;
 struct vy_run;
 struct vy_run_env;
@@ -248,6 +251,8 @@ struct vy_lsm {
 	int range_count;
 	/** Sum dumps_per_compaction across all ranges. */
 	int sum_dumps_per_compaction;
+	/** Sum slice_count across all ranges. */
+	int sum_slice_count;
 	/** Heap of ranges, prioritized by compaction_priority. */
 	heap_t range_heap;
 	/**
@@ -266,6 +271,12 @@ struct vy_lsm {
 	size_t bloom_size;
 	/** Size of memory used for page index. */
 	size_t page_index_size;
+	/**
+	 * Number of range deletes stored in in-memory trees and
+	 * runs of this LSM tree. Lets readers skip range delete
+	 * lookups if there are none, which is the common case.
+	 */
+	uint32_t range_delete_count;
 	/**
 	 * Incremented for each change of the mem list,
 	 * to invalidate iterators.
@@ -381,6 +392,42 @@ vy_lsm_dumps_per_compaction(struct vy_lsm *lsm)
 	return lsm->sum_dumps_per_compaction / lsm->range_count;
 }
 
+/**
+ * Return the average number of runs that have to be checked to
+ * look up a key in this LSM tree.
+ */
+static inline double
+vy_lsm_read_amplification(struct vy_lsm *lsm)
+{
+	return (double)lsm->sum_slice_count / lsm->range_count;
+}
+
+/**
+ * Return the ratio of the number of bytes written to disk by dump
+ * and compaction to the number of bytes dumped from memory.
+ */
+static inline double
+vy_lsm_write_amplification(struct vy_lsm *lsm)
+{
+	int64_t input = lsm->stat.disk.dump.input.bytes;
+	int64_t output = lsm->stat.disk.dump.output.bytes +
+			 lsm->stat.disk.compaction.output.bytes;
+	return input > 0 ? (double)output / input : 0;
+}
+
+/**
+ * Return the ratio of the size of data stored on disk to the size
+ * of data stored at the last LSM tree level, which approximates
+ * the size of data after major compaction.
+ */
+static inline double
+vy_lsm_space_amplification(struct vy_lsm *lsm)
+{
+	int64_t last_level = lsm->stat.disk.last_level_count.bytes;
+	return last_level > 0 ?
+	       (double)lsm->stat.disk.count.bytes / last_level : 0;
+}
+
 /**
  * Increment the reference counter of an LSM tree.
  * An LSM tree cannot be deleted if its reference
@@ -466,6 +513,13 @@ vy_lsm_generation(struct vy_lsm *lsm);
 int
 vy_lsm_compaction_priority(struct vy_lsm *lsm);
 
+/**
+ * Return max compaction score among ranges of an LSM tree,
+ * see vy_range_compaction_score().
+ */
+double
+vy_lsm_compaction_score(struct vy_lsm *lsm);
+
 /** Return the target size of a range in an LSM tree. */
 int64_t
 vy_lsm_range_size(struct vy_lsm *lsm);
@@ -496,7 +550,8 @@ vy_lsm_remove_range(struct vy_lsm *lsm, struct vy_range *range);
  * Account a range in an LSM tree.
  *
  * This function updates the following LSM tree statistics:
- *  - vy_lsm::run_hist and vy_lsm::sum_dumps_per_compaction after
+ *  - vy_lsm::run_hist, vy_lsm::sum_dumps_per_compaction, and
+ *    vy_lsm::sum_slice_count after
  *    a slice is added to or removed from a range of the LSM tree.
  *  - vy_lsm::stat::disk::compaction::queue after compaction priority
  *    of a range is updated.
@@ -605,6 +660,13 @@ vy_lsm_coalesce_range(struct vy_lsm *lsm, struct vy_range *range);
 void
 vy_lsm_force_compaction(struct vy_lsm *lsm);
 
+/**
+ * Recalculate compaction priority of all ranges of an LSM tree.
+ * Used by compaction policies that depend on time.
+ */
+void
+vy_lsm_update_compaction_priority(struct vy_lsm *lsm);
+
 /**
  * Insert a statement into the in-memory index of an LSM tree. If
  * the region_stmt is NULL and the statement is successfully inserted
@@ -648,6 +710,55 @@ void
 vy_lsm_rollback_stmt(struct vy_lsm *lsm, struct vy_mem *mem,
 		     struct vy_entry entry);
 
+/**
+ * Insert a range delete into the given in-memory index of
+ * an LSM tree and invalidate the deleted range in the cache.
+ *
+ * @param lsm   LSM tree the range delete is for.
+ * @param mem   In-memory tree to insert the range delete to.
+ * @param begin Begin of the deleted range (key, inclusive).
+ * @param end   End of the deleted range (key, exclusive) or
+ *              none if the range is unbounded.
+ * @param lsn   LSN of the range delete.
+ *
+ * @retval not NULL The inserted range delete.
+ * @retval NULL     Memory error.
+ */
+struct vy_range_delete *
+vy_lsm_set_range_delete(struct vy_lsm *lsm, struct vy_mem *mem,
+			struct vy_entry begin, struct vy_entry end,
+			int64_t lsn);
+
+/**
+ * Confirm that a range delete stays in the in-memory index of
+ * an LSM tree. Must be called after the LSN is assigned.
+ */
+void
+vy_lsm_commit_range_delete(struct vy_lsm *lsm, struct vy_mem *mem,
+			   struct vy_range_delete *rd);
+
+/**
+ * Erase a range delete from the in-memory index of an LSM tree.
+ */
+void
+vy_lsm_rollback_range_delete(struct vy_lsm *lsm, struct vy_mem *mem,
+			     struct vy_range_delete *rd);
+
+/**
+ * Drop statements deleted by range deletes from a key history.
+ *
+ * A statement is deleted if there's a range delete covering
+ * its key that has a greater LSN and is visible from the given
+ * read view. If a prepared range delete is skipped, because
+ * @a is_prepared_ok is unset, its LSN is accounted in
+ * @a min_skipped_plsn so that the caller could send the reader
+ * to a read view.
+ */
+void
+vy_lsm_apply_range_deletes(struct vy_lsm *lsm, const struct vy_read_view *rv,
+			   bool is_prepared_ok, struct vy_history *history,
+			   int64_t *min_skipped_plsn);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -31,6 +31,7 @@
 #include "vy_mem.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <trivia/util.h>
 #include <small/lsregion.h>
@@ -40,6 +41,7 @@
 #include "diag.h"
 #include "tuple.h"
 #include "vy_history.h"
+#include "vy_range_delete.h"
 
 /** {{{ vy_mem_env */
 
@@ -119,6 +121,7 @@ vy_mem_new(struct vy_mem_env *env, struct key_def *cmp_def,
 			   vy_mem_tree_extent_free, index);
 	rlist_create(&index->in_sealed);
 	fiber_cond_create(&index->pin_cond);
+	rlist_create(&index->range_deletes);
 	return index;
 }
 
@@ -271,6 +274,81 @@ vy_mem_rollback_stmt(struct vy_mem *mem, struct vy_entry entry)
 	mem->version++;
 }
 
+struct vy_range_delete *
+vy_mem_insert_range_delete(struct vy_mem *mem, const char *begin,
+			   const char *end, int64_t lsn)
+{
+	const char *begin_end = begin;
+	mp_next(&begin_end);
+	size_t begin_size = begin_end - begin;
+	size_t end_size = 0;
+	if (end != NULL) {
+		const char *end_end = end;
+		mp_next(&end_end);
+		end_size = end_end - end;
+	}
+	size_t size = sizeof(struct vy_range_delete) + begin_size + end_size;
+	struct vy_range_delete *rd = lsregion_aligned_alloc(
+			&mem->env->allocator, size,
+			alignof(struct vy_range_delete), mem->generation);
+	if (rd == NULL) {
+		diag_set(OutOfMemory, size, "lsregion_aligned_alloc",
+			 "struct vy_range_delete");
+		return NULL;
+	}
+	char *data = (char *)(rd + 1);
+	memcpy(data, begin, begin_size);
+	rd->begin = data;
+	rd->end = NULL;
+	if (end != NULL) {
+		memcpy(data + begin_size, end, end_size);
+		rd->end = data + begin_size;
+	}
+	rd->lsn = lsn;
+	rlist_add_tail_entry(&mem->range_deletes, rd, in_mem);
+	mem->range_delete_count++;
+	/*
+	 * All iterators begin to see the new range delete, and
+	 * will be aborted in case of rollback.
+	 */
+	mem->version++;
+	return rd;
+}
+
+void
+vy_mem_commit_range_delete(struct vy_mem *mem, struct vy_range_delete *rd)
+{
+	mem->dump_lsn = MAX(mem->dump_lsn, rd->lsn);
+	/* See the comment in vy_mem_commit_stmt(). */
+	mem->version++;
+}
+
+void
+vy_mem_rollback_range_delete(struct vy_mem *mem, struct vy_range_delete *rd)
+{
+	assert(mem->range_delete_count > 0);
+	rlist_del_entry(rd, in_mem);
+	mem->range_delete_count--;
+	mem->version++;
+}
+
+int64_t
+vy_mem_range_delete_lsn(struct vy_mem *mem, const struct vy_read_view *rv,
+			bool is_prepared_ok, struct vy_entry entry,
+			int64_t *min_skipped_plsn)
+{
+	int64_t lsn = -1;
+	struct vy_range_delete *rd;
+	rlist_foreach_entry(rd, &mem->range_deletes, in_mem) {
+		if (rd->lsn > lsn &&
+		    vy_range_delete_covers(rd, entry, mem->cmp_def) &&
+		    vy_range_delete_is_visible(rd, rv, is_prepared_ok,
+					       min_skipped_plsn))
+			lsn = rd->lsn;
+	}
+	return lsn;
+}
+
 /* }}} vy_mem */
 
 /* {{{ vy_mem_iterator support functions */
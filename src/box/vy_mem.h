@@ -51,6 +51,7 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct vy_history;
+struct vy_range_delete;
 
 /** Vinyl memory environment. */
 struct vy_mem_env {
@@ -213,6 +214,14 @@ struct vy_mem {
 	 * if pin_count reaches 0.
 	 */
 	struct fiber_cond pin_cond;
+	/**
+	 * Range deletes written to this in-memory index, linked
+	 * by vy_range_delete::in_mem. Like statements, they are
+	 * allocated on lsregion.
+	 */
+	struct rlist range_deletes;
+	/** Number of entries in the range_deletes list. */
+	uint32_t range_delete_count;
 };
 
 /**
@@ -317,6 +326,56 @@ vy_mem_commit_stmt(struct vy_mem *mem, struct vy_entry entry);
 void
 vy_mem_rollback_stmt(struct vy_mem *mem, struct vy_entry entry);
 
+/**
+ * Insert a range delete into the in-memory level.
+ * @param mem   vy_mem.
+ * @param begin Begin of the deleted range (inclusive).
+ * @param end   End of the deleted range (exclusive) or NULL.
+ * @param lsn   LSN of the range delete.
+ *
+ * The range boundaries are copied to the mem.
+ *
+ * @retval not NULL The inserted range delete.
+ * @retval NULL     Memory error.
+ */
+struct vy_range_delete *
+vy_mem_insert_range_delete(struct vy_mem *mem, const char *begin,
+			   const char *end, int64_t lsn);
+
+/**
+ * Confirm insertion of a range delete into the in-memory level.
+ * Must be called after the LSN of the range delete is set.
+ */
+void
+vy_mem_commit_range_delete(struct vy_mem *mem, struct vy_range_delete *rd);
+
+/**
+ * Remove a range delete from the in-memory level.
+ */
+void
+vy_mem_rollback_range_delete(struct vy_mem *mem, struct vy_range_delete *rd);
+
+/**
+ * Return the max LSN of range deletes stored in the in-memory
+ * level that cover the given key and are visible from the given
+ * read view or -1 if there are no such range deletes.
+ * @sa vy_range_delete_is_visible() for @a min_skipped_plsn.
+ */
+int64_t
+vy_mem_range_delete_lsn(struct vy_mem *mem, const struct vy_read_view *rv,
+			bool is_prepared_ok, struct vy_entry entry,
+			int64_t *min_skipped_plsn);
+
+/**
+ * Return true if the in-memory level has nothing to dump.
+ */
+static inline bool
+vy_mem_is_empty(struct vy_mem *mem)
+{
+	return vy_mem_tree_size(&mem->tree) == 0 &&
+	       mem->range_delete_count == 0;
+}
+
 /**
  * Iterator for in-memory level.
  *
@@ -145,12 +145,39 @@ vy_point_lookup_scan_mems(struct vy_lsm *lsm, struct vy_tx *tx,
 	return 0;
 }
 
+/**
+ * Drop statements deleted by range deletes from the history.
+ * If a prepared range delete is skipped, send the transaction
+ * to a read view.
+ */
+static int
+vy_point_lookup_apply_range_deletes(struct vy_lsm *lsm, struct vy_tx *tx,
+				    const struct vy_read_view **rv,
+				    bool is_prepared_ok,
+				    struct vy_history *history)
+{
+	int64_t min_skipped_plsn = INT64_MAX;
+	vy_lsm_apply_range_deletes(lsm, *rv, is_prepared_ok, history,
+				   &min_skipped_plsn);
+	if (tx != NULL && min_skipped_plsn != INT64_MAX) {
+		if (vy_tx_send_to_read_view(tx, min_skipped_plsn) != 0)
+			return -1;
+		if (tx->state == VINYL_TX_ABORT) {
+			diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+			return -1;
+		}
+	}
+	return 0;
+}
+
 /**
  * Scan one particular slice.
  * Add found statements to the history list up to terminal statement.
  */
 static int
-vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
+vy_point_lookup_scan_slice(struct vy_lsm *lsm,
+			   struct vy_range_read_stat *read_stat,
+			   struct vy_slice *slice,
 			   const struct vy_read_view **rv, struct vy_entry key,
 			   struct vy_history *history)
 {
@@ -167,6 +194,9 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	vy_history_create(&slice_history, &lsm->env->history_node_pool);
 	int rc = vy_run_iterator_next(&run_itr, &slice_history);
 	vy_history_splice(history, &slice_history);
+	read_stat->runs++;
+	if (run_itr.is_bloom_hit)
+		read_stat->bloom_hit++;
 	vy_run_iterator_close(&run_itr);
 	return rc;
 }
@@ -198,13 +228,28 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		slices[i++] = slice;
 	}
 	assert(i == slice_count);
+	range->read_stat.lookup++;
+	/*
+	 * Reading a run may yield, and the range may be deleted
+	 * meanwhile by coalescing or compaction, because pinning
+	 * slices doesn't prevent that. So we accumulate the read
+	 * statistics locally and account them only if the range
+	 * tree hasn't changed.
+	 */
+	uint32_t range_tree_version = lsm->range_tree_version;
+	struct vy_range_read_stat read_stat = {0, 0, 0};
 	int rc = 0;
 	for (i = 0; i < slice_count; i++) {
 		if (rc == 0 && !vy_history_is_terminal(history))
-			rc = vy_point_lookup_scan_slice(lsm, slices[i],
-							rv, key, history);
+			rc = vy_point_lookup_scan_slice(lsm, &read_stat,
+							slices[i], rv, key,
+							history);
 		vy_slice_unpin(slices[i]);
 	}
+	if (range_tree_version == lsm->range_tree_version) {
+		range->read_stat.runs += read_stat.runs;
+		range->read_stat.bloom_hit += read_stat.bloom_hit;
+	}
 	region_truncate(&fiber()->gc, region_svp);
 	return rc;
 }
@@ -227,11 +272,11 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 	vy_history_create(&mem_history, &lsm->env->history_node_pool);
 	vy_history_create(&disk_history, &lsm->env->history_node_pool);
 
+	bool is_prepared_ok = tx != NULL ? vy_tx_is_prepared_ok(tx) : false;
 	rc = vy_point_lookup_scan_txw(lsm, tx, key, &history);
 	if (rc != 0 || vy_history_is_terminal(&history))
 		goto done;
 
-	bool is_prepared_ok = tx != NULL ? vy_tx_is_prepared_ok(tx) : false;
 	rc = vy_point_lookup_scan_cache(lsm, rv, is_prepared_ok, key, &history);
 	if (rc != 0 || vy_history_is_terminal(&history))
 		goto done;
@@ -302,6 +347,11 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 	vy_history_splice(&history, &mem_history);
 	vy_history_splice(&history, &disk_history);
 
+	if (rc == 0) {
+		rc = vy_point_lookup_apply_range_deletes(lsm, tx, rv,
+							 is_prepared_ok,
+							 &history);
+	}
 	if (rc == 0) {
 		int upserts_applied;
 		rc = vy_history_apply(&history, lsm->cmp_def,
@@ -316,6 +366,179 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 	return 0;
 }
 
+/**
+ * Look up a key of a batch in the transaction write set, cache,
+ * and memory level. Never yields.
+ *
+ * @retval  1 a terminal statement was found in memory, @a ret is set
+ * @retval  0 the key must be looked up on disk
+ * @retval -1 memory error
+ */
+static int
+vy_point_lookup_batch_mem(struct vy_lsm *lsm, struct vy_tx *tx,
+			  const struct vy_read_view **rv,
+			  struct vy_entry key, struct vy_entry *ret)
+{
+	assert(vy_stmt_is_full_key(key.stmt, lsm->cmp_def));
+	*ret = vy_entry_none();
+
+	struct vy_history history;
+	vy_history_create(&history, &lsm->env->history_node_pool);
+
+	bool is_prepared_ok = tx != NULL ? vy_tx_is_prepared_ok(tx) : false;
+	int rc = vy_point_lookup_scan_txw(lsm, tx, key, &history);
+	if (rc == 0 && !vy_history_is_terminal(&history))
+		rc = vy_point_lookup_scan_cache(lsm, rv, is_prepared_ok,
+						key, &history);
+	if (rc == 0 && !vy_history_is_terminal(&history))
+		rc = vy_point_lookup_scan_mems(lsm, tx, rv, is_prepared_ok,
+					       key, &history);
+	if (rc == 0 && vy_history_is_terminal(&history))
+		rc = vy_point_lookup_apply_range_deletes(lsm, tx, rv,
+							 is_prepared_ok,
+							 &history);
+	if (rc == 0 && vy_history_is_terminal(&history)) {
+		int upserts_applied;
+		rc = vy_history_apply(&history, lsm->cmp_def,
+				      false, &upserts_applied, ret);
+		lsm->stat.upsert.applied += upserts_applied;
+		if (rc == 0)
+			rc = 1;
+	}
+	vy_history_cleanup(&history);
+	return rc;
+}
+
+/** Keys of a batch that need to be looked up on disk. */
+struct vy_point_lookup_batch {
+	struct vy_lsm *lsm;
+	struct vy_tx *tx;
+	const struct vy_read_view **rv;
+	const struct vy_entry *keys;
+	struct vy_entry *ret;
+	/** Indexes of keys that weren't found in memory. */
+	uint32_t *pending;
+	/** Number of entries in the pending array. */
+	uint32_t pending_count;
+	/** Index of the next pending key to look up. */
+	uint32_t next;
+	/** Set if a lookup failed. */
+	bool is_failed;
+};
+
+/**
+ * Look up pending keys of a batch one by one until there are no
+ * more keys left. Run by a few fibers concurrently.
+ */
+static int
+vy_point_lookup_batch_f(va_list ap)
+{
+	struct vy_point_lookup_batch *batch =
+		va_arg(ap, struct vy_point_lookup_batch *);
+	while (!batch->is_failed && batch->next < batch->pending_count) {
+		uint32_t i = batch->pending[batch->next++];
+		if (vy_point_lookup(batch->lsm, batch->tx, batch->rv,
+				    batch->keys[i], &batch->ret[i]) != 0) {
+			batch->is_failed = true;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int
+vy_point_lookup_batch_call_f(struct vy_point_lookup_batch *batch, ...)
+{
+	va_list ap;
+	va_start(ap, batch);
+	int rc = vy_point_lookup_batch_f(ap);
+	va_end(ap);
+	return rc;
+}
+
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      const struct vy_entry *keys, uint32_t count,
+		      struct vy_entry *ret)
+{
+	assert(tx == NULL || tx->state == VINYL_TX_READY);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int rc = -1;
+
+	/*
+	 * First, look up all keys in memory, which doesn't yield,
+	 * and collect keys that need to be looked up on disk.
+	 */
+	struct vy_point_lookup_batch batch;
+	batch.lsm = lsm;
+	batch.tx = tx;
+	batch.rv = rv;
+	batch.keys = keys;
+	batch.ret = ret;
+	batch.pending = xregion_alloc_array(region, typeof(batch.pending[0]),
+					    count);
+	batch.pending_count = 0;
+	batch.next = 0;
+	batch.is_failed = false;
+	for (uint32_t i = 0; i < count; i++)
+		ret[i] = vy_entry_none();
+	for (uint32_t i = 0; i < count; i++) {
+		int found = vy_point_lookup_batch_mem(lsm, tx, rv,
+						      keys[i], &ret[i]);
+		if (found < 0)
+			goto out;
+		if (found == 0)
+			batch.pending[batch.pending_count++] = i;
+	}
+	if (batch.pending_count == 0) {
+		rc = 0;
+		goto out;
+	}
+
+	/*
+	 * Look up the remaining keys on disk. Each lookup blocks
+	 * the calling fiber on reads, so to read pages of different
+	 * keys concurrently we spread lookups among a few fibers.
+	 * The current fiber takes part in the lookup, too. Keys
+	 * rejected by bloom filters are looked up without yielding.
+	 */
+	uint32_t fiber_count = MIN(batch.pending_count,
+				   VY_POINT_LOOKUP_BATCH_FIBERS) - 1;
+	struct fiber **fibers = xregion_alloc_array(region,
+						    typeof(fibers[0]),
+						    fiber_count + 1);
+	uint32_t started = 0;
+	for (; started < fiber_count; started++) {
+		struct fiber *f = fiber_new("vinyl.point_lookup",
+					    vy_point_lookup_batch_f);
+		if (f == NULL) {
+			/* The remaining fibers will do the job. */
+			diag_clear(diag_get());
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fibers[started] = f;
+		fiber_start(f, &batch);
+	}
+	rc = vy_point_lookup_batch_call_f(&batch);
+	for (uint32_t i = 0; i < started; i++) {
+		if (fiber_join(fibers[i]) != 0)
+			rc = -1;
+	}
+out:
+	if (rc != 0) {
+		for (uint32_t i = 0; i < count; i++) {
+			if (ret[i].stmt != NULL)
+				tuple_unref(ret[i].stmt);
+			ret[i] = vy_entry_none();
+		}
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 int
 vy_point_lookup_mem(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		    struct vy_entry key, struct vy_entry *ret)
@@ -339,6 +562,11 @@ vy_point_lookup_mem(struct vy_lsm *lsm, const struct vy_read_view **rv,
 	*ret = vy_entry_none();
 	goto out;
 done:
+	if (rc == 0) {
+		rc = vy_point_lookup_apply_range_deletes(
+				lsm, /*tx=*/NULL, rv, /*is_prepared_ok=*/true,
+				&history);
+	}
 	if (rc == 0) {
 		int upserts_applied;
 		rc = vy_history_apply(&history, lsm->cmp_def,
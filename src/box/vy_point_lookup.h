@@ -70,6 +70,28 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 		const struct vy_read_view **rv,
 		struct vy_entry key, struct vy_entry *ret);
 
+enum {
+	/** Max number of fibers reading disk for a batch lookup. */
+	VY_POINT_LOOKUP_BATCH_FIBERS = 32,
+};
+
+/**
+ * Look up a batch of keys. Works exactly like vy_point_lookup()
+ * called for each key, but disk reads are performed concurrently:
+ * first all keys are looked up in memory, then keys that weren't
+ * found there are looked up on disk by a few fibers so that pages
+ * of different keys are read by reader threads in parallel.
+ *
+ * Found tuples are returned in @ret in the order of @keys, with
+ * their reference counters elevated. On failure, @ret is filled
+ * with empty entries.
+ */
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      const struct vy_entry *keys, uint32_t count,
+		      struct vy_entry *ret);
+
 /**
  * Look up a tuple by key in memory.
  *
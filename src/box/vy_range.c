@@ -36,11 +36,13 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define RB_COMPACT 1
 #include <small/rb.h>
 #include <small/rlist.h>
 
+#include "clock.h"
 #include "diag.h"
 #include "iterator_type.h"
 #include "key_def.h"
@@ -261,6 +263,44 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
 	range->version++;
 }
 
+/**
+ * Update compaction priority of a range that uses the time-window
+ * compaction policy.
+ *
+ * Each run belongs to the time window it was dumped in. Runs from
+ * different windows are never merged so only runs of the newest
+ * window may need compaction. While the window is open, i.e. new
+ * runs may be dumped to it, its runs are compacted as soon as their
+ * number exceeds run_count_per_level. Once the window is closed,
+ * its runs are merged into one, which is never compacted again.
+ */
+static void
+vy_range_update_compaction_priority_time_window(struct vy_range *range,
+						const struct index_opts *opts)
+{
+	struct vy_disk_stmt_counter window_stmt_count;
+	vy_disk_stmt_counter_reset(&window_stmt_count);
+	uint32_t window_run_count = 0;
+	uint64_t window = 0;
+	struct vy_slice *slice;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		uint64_t slice_window = slice->run->info.max_time /
+					opts->compaction_window;
+		if (window_run_count > 0 && slice_window != window)
+			break;
+		window = slice_window;
+		window_run_count++;
+		vy_disk_stmt_counter_add(&window_stmt_count, &slice->count);
+	}
+	uint64_t current_window = clock_realtime() / opts->compaction_window;
+	uint32_t max_run_count = current_window > window ?
+				 1 : opts->run_count_per_level;
+	if (window_run_count > max_run_count) {
+		range->compaction_priority = window_run_count;
+		range->compaction_queue = window_stmt_count;
+	}
+}
+
 /**
  * To reduce write amplification caused by compaction, we follow
  * the LSM tree design. Runs in each range are divided into groups
@@ -291,6 +331,11 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	assert(opts->run_count_per_level > 0);
 	assert(opts->run_size_ratio > 1);
 
+	struct vy_range_read_stat *read_stat = &range->read_stat;
+	range->read_heat = range->read_heat / 2 +
+			   (read_stat->runs - read_stat->bloom_hit);
+	memset(read_stat, 0, sizeof(*read_stat));
+
 	range->compaction_priority = 0;
 	vy_disk_stmt_counter_reset(&range->compaction_queue);
 
@@ -306,6 +351,11 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		return;
 	}
 
+	if (opts->compaction_policy == COMPACTION_POLICY_TIME_WINDOW) {
+		vy_range_update_compaction_priority_time_window(range, opts);
+		return;
+	}
+
 	/* Total number of statements in checked runs. */
 	struct vy_disk_stmt_counter total_stmt_count;
 	vy_disk_stmt_counter_reset(&total_stmt_count);
@@ -399,7 +449,9 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		 * scans all LSM tree levels. Instead we use the
 		 * value of rand() from the slice creation time.
 		 */
-		uint32_t max_run_count = opts->run_count_per_level;
+		uint32_t max_run_count =
+			opts->compaction_policy == COMPACTION_POLICY_LEVELED ?
+			1 : opts->run_count_per_level;
 		if (slice->seed < RAND_MAX / 10)
 			max_run_count++;
 		if (level_run_count > max_run_count) {
@@ -468,19 +520,24 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	if (slice->count.bytes < range_size * 4 / 3)
 		return false;
 
-	/* Find the median key in the oldest run (approximately). */
-	struct vy_page_info *mid_page;
-	mid_page = vy_run_page_info(slice->run, slice->first_page_no +
-				    (slice->last_page_no -
-				     slice->first_page_no) / 2);
+	/*
+	 * Find the median key in the oldest run (approximately).
+	 * If the page index of the run is partitioned, min keys of
+	 * partitions are used instead of min keys of pages.
+	 */
+	hint_t mid_key_hint;
+	const char *mid_key = vy_run_page_min_key(slice->run,
+			slice->first_page_no +
+			(slice->last_page_no - slice->first_page_no) / 2,
+			&mid_key_hint);
 
-	struct vy_page_info *first_page = vy_run_page_info(slice->run,
-						slice->first_page_no);
+	hint_t first_key_hint;
+	const char *first_key = vy_run_page_min_key(slice->run,
+			slice->first_page_no, &first_key_hint);
 
 	/* No point in splitting if a new range is going to be empty. */
-	if (vy_key_compare(first_page->min_key, first_page->min_key_hint,
-			   mid_page->min_key, mid_page->min_key_hint,
-			   range->cmp_def) == 0)
+	if (vy_key_compare(first_key, first_key_hint,
+			   mid_key, mid_key_hint, range->cmp_def) == 0)
 		return false;
 	/*
 	 * In extreme cases the median key can be < the beginning
@@ -494,24 +551,23 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	 * begin = [30], end = [70]
 	 * first_page_no = N, last_page_no = N + 1
 	 *
-	 * which makes mid_page_no = N and mid_page->min_key = [10].
+	 * which makes mid_page_no = N and mid_key = [10].
 	 *
 	 * In such cases there's no point in splitting the range.
 	 */
 	if (slice->begin.stmt != NULL &&
-	    vy_entry_compare_with_raw_key(slice->begin, mid_page->min_key,
-					  mid_page->min_key_hint,
-					  range->cmp_def) >= 0)
+	    vy_entry_compare_with_raw_key(slice->begin, mid_key,
+					  mid_key_hint, range->cmp_def) >= 0)
 		return false;
 	/*
 	 * The median key can't be >= the end of the slice as we
 	 * take the min key of a page for the median key.
 	 */
 	assert(slice->end.stmt == NULL ||
-	       vy_entry_compare_with_raw_key(slice->end, mid_page->min_key,
-					     mid_page->min_key_hint,
+	       vy_entry_compare_with_raw_key(slice->end, mid_key,
+					     mid_key_hint,
 					     range->cmp_def) > 0);
-	*p_split_key = mid_page->min_key;
+	*p_split_key = mid_key;
 	return true;
 }
 
@@ -31,6 +31,7 @@
  * SUCH DAMAGE.
  */
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -53,6 +54,19 @@ struct index_opts;
 struct key_def;
 struct vy_slice;
 
+/**
+ * Read statistics of a range. Used for prioritizing compaction
+ * of ranges that are hot for reads.
+ */
+struct vy_range_read_stat {
+	/** Number of lookups and scans that reached the range. */
+	int64_t lookup;
+	/** Number of runs touched by the lookups. */
+	int64_t runs;
+	/** Number of runs skipped thanks to bloom filters. */
+	int64_t bloom_hit;
+};
+
 /**
  * Range of keys in an LSM tree stored on disk.
  */
@@ -124,6 +138,19 @@ struct vy_range {
 	 * this range, see vy_run::dump_count for more details.
 	 */
 	int dumps_per_compaction;
+	/**
+	 * Read statistics accumulated since the last time
+	 * the compaction priority of the range was updated.
+	 */
+	struct vy_range_read_stat read_stat;
+	/**
+	 * Number of runs read by lookups in this range, not
+	 * counting runs skipped thanks to bloom filters. Read
+	 * statistics are added to it on each compaction priority
+	 * update while its old value is halved so that it mostly
+	 * reflects recent reads.
+	 */
+	double read_heat;
 	/** Link in vy_lsm->tree. */
 	rb_node(struct vy_range) tree_node;
 	/** Link in vy_lsm->range_heap. */
@@ -135,15 +162,31 @@ struct vy_range {
 	uint32_t version;
 };
 
+/**
+ * Return the compaction score of a range. Ranges are compacted
+ * in the order of decreasing score. The score equals compaction
+ * priority boosted by the read heat so that among ranges that
+ * need compaction those that are hot for reads are compacted
+ * first, because this reduces read amplification most. Ranges
+ * that don't need compaction score no more than 1.
+ */
+static inline double
+vy_range_compaction_score(const struct vy_range *range)
+{
+	if (range->compaction_priority <= 1)
+		return range->compaction_priority;
+	return range->compaction_priority * (1 + log2(1 + range->read_heat));
+}
+
 /**
  * Heap of all ranges of the same LSM tree, prioritized by
- * vy_range->compaction_priority.
+ * vy_range_compaction_score().
  */
 #define HEAP_NAME vy_range_heap
 static inline bool
 vy_range_heap_less(struct vy_range *r1, struct vy_range *r2)
 {
-	return r1->compaction_priority > r2->compaction_priority;
+	return vy_range_compaction_score(r1) > vy_range_compaction_score(r2);
 }
 #define HEAP_LESS(h, l, r) vy_range_heap_less(l, r)
 #define heap_value_t struct vy_range
@@ -0,0 +1,90 @@
+#ifndef INCLUDES_TARANTOOL_BOX_VY_RANGE_DELETE_H
+#define INCLUDES_TARANTOOL_BOX_VY_RANGE_DELETE_H
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <small/rlist.h>
+#include <trivia/util.h>
+
+#include "key_def.h"
+#include "vy_read_view.h"
+#include "vy_stmt.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Range delete (range tombstone) - a statement that deletes all
+ * keys in the range [begin, end) that were written before it.
+ *
+ * Unlike other statements, range deletes aren't stored in the
+ * in-memory tree or run pages, because they aren't bound to
+ * a particular key. Instead, each vy_mem keeps a list of range
+ * deletes written to it, and each run stores range deletes in
+ * its run info. Statements covered by a range delete are skipped
+ * on read and purged on compaction. A range delete is purged
+ * when it's compacted to the last LSM tree level.
+ */
+struct vy_range_delete {
+	/** Link in vy_mem::range_deletes. Unused for runs. */
+	struct rlist in_mem;
+	/**
+	 * Begin of the deleted range (inclusive), MsgPack array.
+	 * May be a partial key.
+	 */
+	const char *begin;
+	/**
+	 * End of the deleted range (exclusive), MsgPack array,
+	 * or NULL if the range is unbounded. May be a partial key.
+	 */
+	const char *end;
+	/** LSN of the range delete. */
+	int64_t lsn;
+};
+
+/**
+ * Return true if a range delete covers the key of the given
+ * statement. Note, LSNs aren't checked.
+ */
+static inline bool
+vy_range_delete_covers(const struct vy_range_delete *rd,
+		       struct vy_entry entry, struct key_def *cmp_def)
+{
+	if (vy_entry_compare_with_raw_key(entry, rd->begin, HINT_NONE,
+					  cmp_def) < 0)
+		return false;
+	return rd->end == NULL ||
+	       vy_entry_compare_with_raw_key(entry, rd->end, HINT_NONE,
+					     cmp_def) < 0;
+}
+
+/**
+ * Return true if a range delete is visible from a read view.
+ * If the range delete is skipped because it's prepared, its LSN
+ * is accounted in @a min_skipped_plsn, like vy_mem_iterator does.
+ */
+static inline bool
+vy_range_delete_is_visible(const struct vy_range_delete *rd,
+			   const struct vy_read_view *rv, bool is_prepared_ok,
+			   int64_t *min_skipped_plsn)
+{
+	if (rd->lsn > rv->vlsn)
+		return false;
+	if (!is_prepared_ok && rd->lsn >= MAX_LSN) {
+		*min_skipped_plsn = MIN(*min_skipped_plsn, rd->lsn);
+		return false;
+	}
+	return true;
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* INCLUDES_TARANTOOL_BOX_VY_RANGE_DELETE_H */
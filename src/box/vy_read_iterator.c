@@ -679,20 +679,21 @@ static void
 vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 {
 	assert(itr->curr_range != NULL);
-	enum iterator_type iterator_type = (itr->iterator_type != ITER_REQ ?
-					    itr->iterator_type : ITER_LE);
 	struct vy_lsm *lsm = itr->lsm;
+	struct vy_range *range = itr->curr_range;
 	struct vy_slice *slice;
+	range->read_stat.lookup++;
+	range->read_stat.runs += range->slice_count;
 	/*
 	 * The format of the statement must be exactly the space
 	 * format with the same identifier to fully match the
 	 * format in vy_mem.
 	 */
-	rlist_foreach_entry(slice, &itr->curr_range->slices, in_range) {
+	rlist_foreach_entry(slice, &range->slices, in_range) {
 		struct vy_read_src *sub_src = vy_read_iterator_add_src(itr);
 		vy_run_iterator_open(&sub_src->run_iterator,
 				     &lsm->stat.disk.iterator, slice,
-				     iterator_type, itr->key,
+				     itr->iterator_type, itr->key,
 				     itr->read_view, lsm->cmp_def,
 				     lsm->key_def, lsm->disk_format);
 	}
@@ -772,7 +773,9 @@ vy_read_iterator_open_after(struct vy_read_iterator *itr, struct vy_lsm *lsm,
 		/*
 		 * Source iterators cannot handle ITER_REQ and
 		 * use ITER_LE instead, so we need to enable EQ
-		 * check in this case.
+		 * check in this case. (Run iterators do the
+		 * conversion themselves so as to be able to
+		 * check bloom filters.)
 		 *
 		 * See vy_read_iterator_add_{tx,cache,mem,run}.
 		 */
@@ -882,12 +885,53 @@ vy_read_iterator_apply_history(struct vy_read_iterator *itr,
 		}
 	}
 
+	/*
+	 * The newest statement is remembered before dropping statements
+	 * deleted by range deletes, because the caller needs a statement
+	 * to position the iterator even if the key turns out deleted.
+	 */
+	struct vy_entry newest = vy_history_last_stmt(&history);
+	if (newest.stmt != NULL)
+		tuple_ref(newest.stmt);
+	int64_t min_skipped_plsn = INT64_MAX;
+	bool is_prepared_ok = itr->tx != NULL ?
+			      vy_tx_is_prepared_ok(itr->tx) : true;
+	vy_lsm_apply_range_deletes(lsm, *itr->read_view, is_prepared_ok,
+				   &history, &min_skipped_plsn);
+
 	int upserts_applied = 0;
 	int rc = vy_history_apply(&history, lsm->cmp_def,
 				  true, &upserts_applied, ret);
 
 	lsm->stat.upsert.applied += upserts_applied;
 	vy_history_cleanup(&history);
+	if (rc == 0 && ret->stmt == NULL && newest.stmt != NULL) {
+		/* The key was deleted by a range delete. */
+		if (vy_stmt_type(newest.stmt) == IPROTO_DELETE) {
+			*ret = newest;
+			tuple_ref(ret->stmt);
+		} else {
+			ret->stmt = vy_stmt_new_surrogate_delete(
+					lsm->mem_format, newest.stmt);
+			ret->hint = newest.hint;
+			if (ret->stmt == NULL)
+				rc = -1;
+		}
+	}
+	if (newest.stmt != NULL)
+		tuple_unref(newest.stmt);
+	if (rc == 0 && itr->tx != NULL && min_skipped_plsn != INT64_MAX) {
+		if (vy_tx_send_to_read_view(itr->tx, min_skipped_plsn) != 0) {
+			rc = -1;
+		} else if (itr->tx->state == VINYL_TX_ABORT) {
+			diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+			rc = -1;
+		}
+	}
+	if (rc != 0 && ret->stmt != NULL) {
+		tuple_unref(ret->stmt);
+		*ret = vy_entry_none();
+	}
 	return rc;
 }
 
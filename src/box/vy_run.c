@@ -44,6 +44,7 @@
 #include "xlog.h"
 #include "xrow.h"
 #include "vy_history.h"
+#include "vy_range_delete.h"
 
 static const uint64_t vy_page_info_key_map = (1 << VY_PAGE_INFO_OFFSET) |
 					     (1 << VY_PAGE_INFO_SIZE) |
@@ -52,6 +53,15 @@ static const uint64_t vy_page_info_key_map = (1 << VY_PAGE_INFO_OFFSET) |
 					     (1 << VY_PAGE_INFO_MIN_KEY) |
 					     (1 << VY_PAGE_INFO_ROW_INDEX_OFFSET);
 
+static const uint64_t vy_part_info_key_map = (1 << VY_PART_INFO_OFFSET) |
+					     (1 << VY_PART_INFO_SIZE) |
+					     (1 << VY_PART_INFO_UNPACKED_SIZE) |
+					     (1 << VY_PART_INFO_PAGE_COUNT) |
+					     (1 << VY_PART_INFO_MIN_KEY) |
+					     (1 << VY_PART_INFO_ROW_COUNT) |
+					     (1 << VY_PART_INFO_BYTES) |
+					     (1 << VY_PART_INFO_BYTES_COMPRESSED);
+
 static const uint64_t vy_run_info_key_map = (1 << VY_RUN_INFO_MIN_KEY) |
 					    (1 << VY_RUN_INFO_MAX_KEY) |
 					    (1 << VY_RUN_INFO_MIN_LSN) |
@@ -111,6 +121,20 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/** Cbus task for vinyl page index partition read. */
+struct vy_page_index_part_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** vy_run with fd - ref. counted */
+	struct vy_run *run;
+	/** number of the partition to read */
+	uint32_t part_no;
+	/** key definition (needed for decoding page info) */
+	struct key_def *cmp_def;
+	/** [out] resulting partition */
+	struct vy_page_index_part *part;
+};
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -171,6 +195,18 @@ vy_run_env_stop_readers(struct vy_run_env *env)
 	free(env->reader_pool);
 }
 
+static void
+vy_page_cache_create(struct vy_page_cache *cache);
+
+static void
+vy_page_cache_destroy(struct vy_page_cache *cache);
+
+static void
+vy_page_index_cache_create(struct vy_page_index_cache *cache);
+
+static void
+vy_page_index_cache_destroy(struct vy_page_index_cache *cache);
+
 /**
  * Initialize vinyl run environment
  */
@@ -183,6 +219,8 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
 	env->initial_join = false;
+	vy_page_cache_create(&env->page_cache);
+	vy_page_index_cache_create(&env->page_index_cache);
 }
 
 /**
@@ -193,6 +231,8 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	vy_page_cache_destroy(&env->page_cache);
+	vy_page_index_cache_destroy(&env->page_index_cache);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
@@ -285,18 +325,51 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	return run;
 }
 
+/** Free range deletes stored in run info. */
+static void
+vy_run_info_destroy_range_deletes(struct vy_run_info *run_info)
+{
+	for (uint32_t i = 0; i < run_info->range_delete_count; i++) {
+		struct vy_range_delete *rd = &run_info->range_deletes[i];
+		free((char *)rd->begin);
+		free((char *)rd->end);
+	}
+	free(run_info->range_deletes);
+	run_info->range_deletes = NULL;
+	run_info->range_delete_count = 0;
+}
+
 static void
 vy_run_clear(struct vy_run *run)
 {
 	if (run->page_info != NULL) {
+		/*
+		 * If the run is being written with a partitioned page
+		 * index, only pages that haven't been flushed to a
+		 * partition yet are stored in page_info.
+		 */
+		uint32_t page_count = run->info.page_count;
+		if (vy_run_is_partitioned(run)) {
+			struct vy_page_index_part_info *last =
+				&run->part_info[run->info.part_count - 1];
+			page_count -= last->first_page_no + last->page_count;
+		}
 		uint32_t page_no;
-		for (page_no = 0; page_no < run->info.page_count; ++page_no)
+		for (page_no = 0; page_no < page_count; ++page_no)
 			vy_page_info_destroy(run->page_info + page_no);
 		free(run->page_info);
 	}
 	run->page_info = NULL;
+	if (run->part_info != NULL) {
+		uint32_t part_no;
+		for (part_no = 0; part_no < run->info.part_count; ++part_no)
+			free(run->part_info[part_no].min_key);
+		free(run->part_info);
+	}
+	run->part_info = NULL;
 	run->page_index_size = 0;
 	run->info.page_count = 0;
+	run->info.part_count = 0;
 	if (run->info.bloom != NULL) {
 		tuple_bloom_delete(run->info.bloom);
 		run->info.bloom = NULL;
@@ -305,6 +378,7 @@ vy_run_clear(struct vy_run *run)
 	run->info.min_key = NULL;
 	free(run->info.max_key);
 	run->info.max_key = NULL;
+	vy_run_info_destroy_range_deletes(&run->info);
 }
 
 void
@@ -324,6 +398,112 @@ vy_run_bloom_size(struct vy_run *run)
 	return run->info.bloom == NULL ? 0 : tuple_bloom_size(run->info.bloom);
 }
 
+/**
+ * Binary search in page index. Depends on @a is_lower_bound:
+ *  true:  lowest page with min_key >= given key.
+ *  false: lowest page with min_key > given key.
+ * Returns @a page_count if there's no such page.
+ *
+ * Example: we are searching for a value 2 in the run of 10 pages:
+ * min_key:         [1   1   2   2   2   2   2   3   3   3]
+ * we want to find: [        LB                  UB       ]
+ * Let's set up a range with left page's min_key < key and
+ *  right page's min >= key (for lower bound) or left page's
+ *  min_key <= key and right page's min > key (for upper bound);
+ *  binary cut the range until it becomes of length 1 and then
+ *  the result is the right bound of the range.
+ *
+ * *equal_key is set to true if there is a page with min_key equal
+ * to the given key.
+ */
+static uint32_t
+vy_page_info_search(const struct vy_page_info *page_info, uint32_t page_count,
+		    struct vy_entry key, struct key_def *cmp_def,
+		    bool is_lower_bound, bool *equal_key)
+{
+	/* Initially the range is set with virtual positions */
+	int32_t range[2] = { -1, page_count };
+	while (range[1] - range[0] > 1) {
+		int32_t mid = range[0] + (range[1] - range[0]) / 2;
+		const struct vy_page_info *info = &page_info[mid];
+		int cmp = vy_entry_compare_with_raw_key(key, info->min_key,
+							info->min_key_hint,
+							cmp_def);
+		if (is_lower_bound)
+			range[cmp <= 0] = mid;
+		else
+			range[cmp < 0] = mid;
+		*equal_key = *equal_key || cmp == 0;
+	}
+	return range[1];
+}
+
+/**
+ * Same as vy_page_info_search(), but searches for a page index
+ * partition rather than a page.
+ */
+static uint32_t
+vy_page_index_part_search(struct vy_run *run, struct vy_entry key,
+			  struct key_def *cmp_def, bool is_lower_bound,
+			  bool *equal_key)
+{
+	int32_t range[2] = { -1, run->info.part_count };
+	while (range[1] - range[0] > 1) {
+		int32_t mid = range[0] + (range[1] - range[0]) / 2;
+		const struct vy_page_index_part_info *info =
+			&run->part_info[mid];
+		int cmp = vy_entry_compare_with_raw_key(key, info->min_key,
+							info->min_key_hint,
+							cmp_def);
+		if (is_lower_bound)
+			range[cmp <= 0] = mid;
+		else
+			range[cmp < 0] = mid;
+		*equal_key = *equal_key || cmp == 0;
+	}
+	return range[1];
+}
+
+/**
+ * Convert the result of vy_page_info_search() to the position
+ * the iteration must be started from, see vy_page_index_find_page().
+ */
+static inline uint32_t
+vy_page_index_search_result(uint32_t bound, uint32_t count, int dir)
+{
+	/*
+	 * For LT and LE we want the page preceding the bound.
+	 * Since page search uses only min_key of pages, for GE,
+	 * GT and EQ the previous page can contain the point where
+	 * iteration must be started, too.
+	 */
+	if (bound > 0)
+		return bound - 1;
+	return dir > 0 ? 0 : count;
+}
+
+/**
+ * Return true if a page index search for the given iterator
+ * type is a lower bound search, see vy_page_info_search().
+ */
+static inline bool
+vy_page_index_is_lower_bound(enum iterator_type itype)
+{
+	if (itype == ITER_EQ)
+		itype = ITER_GE; /* One day it'll become obsolete */
+	assert(itype == ITER_GE || itype == ITER_GT ||
+	       itype == ITER_LE || itype == ITER_LT);
+	return itype == ITER_LT || itype == ITER_GE;
+}
+
+/**
+ * Function that returns a page index partition given its number,
+ * loading it from disk if necessary. The partition is owned by
+ * the caller. Returns NULL and sets diag on error.
+ */
+typedef struct vy_page_index_part *
+(*vy_page_index_part_get_f)(void *arg, uint32_t part_no);
+
 /**
  * Find a page from which the iteration of a given key must be started.
  * LE and LT: the found page definitely contains the position
@@ -333,78 +513,200 @@ vy_run_bloom_size(struct vy_run *run)
  *  for iteration start. In this case it is certain that the iteration
  *  must be started from the beginning of the next page.
  *
+ * If the page index of the run is partitioned, the partition that
+ * may contain the page is looked up by min keys of partitions and
+ * loaded with @a get_part. Otherwise @a get_part isn't used.
+ *
  * @param run - run
  * @param key - key to find
  * @param key_def - key_def for comparison
  * @param itype - iterator type (see above)
- * @param equal_key: *equal_key is set to true if there is a page
+ * @param get_part - function used to load page index partitions
+ * @param arg - argument passed to @a get_part
+ * @param[out] page_no - offset of the page in page index OR
+ *  run->info.page_count if there no pages fulfilling the conditions.
+ * @param[out] equal_key: *equal_key is set to true if there is a page
  *  with min_key equal to the given key.
- * @return offset of the page in page index OR run->info.page_count if
- *  there no pages fulfilling the conditions.
+ * @retval 0 success
+ * @retval -1 error loading a page index partition
  */
-static uint32_t
+static NODISCARD int
 vy_page_index_find_page(struct vy_run *run, struct vy_entry key,
 			struct key_def *cmp_def, enum iterator_type itype,
-			bool *equal_key)
+			vy_page_index_part_get_f get_part, void *arg,
+			uint32_t *page_no, bool *equal_key)
 {
-	if (itype == ITER_EQ)
-		itype = ITER_GE; /* One day it'll become obsolete */
-	assert(itype == ITER_GE || itype == ITER_GT ||
-	       itype == ITER_LE || itype == ITER_LT);
+	bool is_lower_bound = vy_page_index_is_lower_bound(itype);
 	int dir = iterator_direction(itype);
 	*equal_key = false;
+	assert(run->info.page_count > 0);
 
-	/**
-	 * Binary search in page index. Depends on given iterator_type:
-	 *  ITER_GE: lowest page with min_key >= given key.
-	 *  ITER_GT: lowest page with min_key > given key.
-	 *  ITER_LE: highest page with min_key <= given key.
-	 *  ITER_LT: highest page with min_key < given key.
-	 *
-	 * Example: we are searching for a value 2 in the run of 10 pages:
-	 * min_key:         [1   1   2   2   2   2   2   3   3   3]
-	 * we want to find: [    LT  GE              LE  GT       ]
-	 * For LT and GE it's a classical lower_bound search.
-	 * Let's set up a range with left page's min_key < key and
-	 *  right page's min >= key; binary cut the range until it
-	 *  becomes of length 1 and then LT pos = left bound of the range
-	 *  and GE pos = right bound of the range.
-	 * For LE and GT it's a classical upper_bound search.
-	 * Let's set up a range with left page's min_key <= key and
-	 *  right page's min > key; binary cut the range until it
-	 *  becomes of length 1 and then LE pos = left bound of the range
-	 *  and GT pos = right bound of the range.
-	 */
-	bool is_lower_bound = itype == ITER_LT || itype == ITER_GE;
+	uint32_t bound;
+	if (!vy_run_is_partitioned(run)) {
+		bound = vy_page_info_search(run->page_info,
+					    run->info.page_count, key, cmp_def,
+					    is_lower_bound, equal_key);
+	} else {
+		/*
+		 * The bound is either in the partition preceding
+		 * the bound partition or it's the first page of
+		 * the bound partition.
+		 */
+		uint32_t part_no = vy_page_index_part_search(run, key, cmp_def,
+							     is_lower_bound,
+							     equal_key);
+		if (part_no == 0) {
+			bound = 0;
+		} else {
+			part_no--;
+			struct vy_page_index_part *part = get_part(arg,
+								   part_no);
+			if (part == NULL)
+				return -1;
+			bound = run->part_info[part_no].first_page_no +
+				vy_page_info_search(part->page_info,
+						    part->page_count, key,
+						    cmp_def, is_lower_bound,
+						    equal_key);
+		}
+	}
+	*page_no = vy_page_index_search_result(bound, run->info.page_count,
+					       dir);
+	return 0;
+}
 
-	assert(run->info.page_count > 0);
-	/* Initially the range is set with virtual positions */
-	int32_t range[2] = { -1, run->info.page_count };
-	assert(run->info.page_count > 0);
-	do {
-		int32_t mid = range[0] + (range[1] - range[0]) / 2;
-		struct vy_page_info *info = vy_run_page_info(run, mid);
-		int cmp = vy_entry_compare_with_raw_key(key, info->min_key,
-							info->min_key_hint,
-							cmp_def);
-		if (is_lower_bound)
-			range[cmp <= 0] = mid;
+/**
+ * Same as vy_page_index_find_page(), but looks up a page index
+ * partition rather than a page, using only min keys of partitions.
+ * Returns the partition number or run->info.part_count.
+ */
+static uint32_t
+vy_page_index_find_part(struct vy_run *run, struct vy_entry key,
+			struct key_def *cmp_def, enum iterator_type itype)
+{
+	assert(vy_run_is_partitioned(run));
+	bool unused = false;
+	uint32_t bound = vy_page_index_part_search(
+		run, key, cmp_def, vy_page_index_is_lower_bound(itype),
+		&unused);
+	return vy_page_index_search_result(bound, run->info.part_count,
+					   iterator_direction(itype));
+}
+
+/**
+ * Return the number of the page index partition that contains
+ * the given page.
+ */
+static uint32_t
+vy_run_page_part_no(struct vy_run *run, uint32_t page_no)
+{
+	assert(vy_run_is_partitioned(run));
+	assert(page_no < run->info.page_count);
+	uint32_t lo = 0, hi = run->info.part_count;
+	while (hi - lo > 1) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (run->part_info[mid].first_page_no <= page_no)
+			lo = mid;
 		else
-			range[cmp < 0] = mid;
-		*equal_key = *equal_key || cmp == 0;
-	} while (range[1] - range[0] > 1);
-	if (range[0] < 0)
-		range[0] = run->info.page_count;
-	uint32_t page = range[dir > 0];
-
-	/**
-	 * Since page search uses only min_key of pages,
-	 *  for GE, GT and EQ the previous page can contain
-	 *  the point where iteration must be started.
-	 */
-	if (page > 0 && dir > 0)
-		return page - 1;
-	return page;
+			hi = mid;
+	}
+	return lo;
+}
+
+const char *
+vy_run_page_min_key(struct vy_run *run, uint32_t page_no, hint_t *hint)
+{
+	if (!vy_run_is_partitioned(run)) {
+		struct vy_page_info *info = vy_run_page_info(run, page_no);
+		*hint = info->min_key_hint;
+		return info->min_key;
+	}
+	struct vy_page_index_part_info *info =
+		&run->part_info[vy_run_page_part_no(run, page_no)];
+	*hint = info->min_key_hint;
+	return info->min_key;
+}
+
+/**
+ * Lookup the first and the last pages spanned by a slice.
+ * Returns 0 on success, 1 if the slice is empty.
+ */
+static int
+vy_slice_find_pages(struct vy_slice *slice, struct key_def *cmp_def)
+{
+	struct vy_run *run = slice->run;
+	bool unused;
+	if (slice->begin.stmt == NULL) {
+		slice->first_page_no = 0;
+	} else {
+		VERIFY(vy_page_index_find_page(run, slice->begin, cmp_def,
+					       ITER_GE, NULL, NULL,
+					       &slice->first_page_no,
+					       &unused) == 0);
+		assert(slice->first_page_no < run->info.page_count);
+	}
+	if (slice->end.stmt == NULL) {
+		slice->last_page_no = run->info.page_count - 1;
+	} else {
+		VERIFY(vy_page_index_find_page(run, slice->end, cmp_def,
+					       ITER_LT, NULL, NULL,
+					       &slice->last_page_no,
+					       &unused) == 0);
+		if (slice->last_page_no == run->info.page_count) {
+			slice->first_page_no = 0;
+			slice->last_page_no = 0;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Same as vy_slice_find_pages(), but for a run with a partitioned
+ * page index. We don't want to load partitions
+ * here so the slice boundaries are rounded to partition boundaries.
+ * Returns 0 on success, 1 if the slice is empty.
+ */
+static int
+vy_slice_find_parts(struct vy_slice *slice, struct key_def *cmp_def)
+{
+	struct vy_run *run = slice->run;
+	uint32_t first_part_no = 0;
+	uint32_t last_part_no = run->info.part_count - 1;
+	if (slice->begin.stmt != NULL) {
+		first_part_no = vy_page_index_find_part(run, slice->begin,
+							cmp_def, ITER_GE);
+		assert(first_part_no < run->info.part_count);
+	}
+	if (slice->end.stmt != NULL) {
+		last_part_no = vy_page_index_find_part(run, slice->end,
+						       cmp_def, ITER_LT);
+		if (last_part_no == run->info.part_count) {
+			slice->first_page_no = 0;
+			slice->last_page_no = 0;
+			return 1;
+		}
+	}
+	assert(last_part_no >= first_part_no);
+	struct vy_page_index_part_info *first = &run->part_info[first_part_no];
+	struct vy_page_index_part_info *last = &run->part_info[last_part_no];
+	slice->first_page_no = first->first_page_no;
+	slice->last_page_no = last->first_page_no + last->page_count - 1;
+	return 0;
+}
+
+int64_t
+vy_run_range_delete_lsn(struct vy_run *run, const struct vy_read_view *rv,
+			struct vy_entry entry, struct key_def *cmp_def)
+{
+	int64_t lsn = -1;
+	for (uint32_t i = 0; i < run->info.range_delete_count; i++) {
+		const struct vy_range_delete *rd = &run->info.range_deletes[i];
+		if (rd->lsn > lsn && rd->lsn <= rv->vlsn &&
+		    vy_range_delete_covers(rd, entry, cmp_def))
+			lsn = rd->lsn;
+	}
+	return lsn;
 }
 
 struct vy_slice *
@@ -436,27 +738,12 @@ vy_slice_new(int64_t id, struct vy_run *run, struct vy_entry begin,
 		return slice;
 	}
 	/** Lookup the first and the last pages spanned by the slice. */
-	bool unused;
-	if (slice->begin.stmt == NULL) {
-		slice->first_page_no = 0;
-	} else {
-		slice->first_page_no =
-			vy_page_index_find_page(run, slice->begin, cmp_def,
-						ITER_GE, &unused);
-		assert(slice->first_page_no < run->info.page_count);
-	}
-	if (slice->end.stmt == NULL) {
-		slice->last_page_no = run->info.page_count - 1;
-	} else {
-		slice->last_page_no =
-			vy_page_index_find_page(run, slice->end, cmp_def,
-						ITER_LT, &unused);
-		if (slice->last_page_no == run->info.page_count) {
-			/* It's an empty slice */
-			slice->first_page_no = 0;
-			slice->last_page_no = 0;
-			return slice;
-		}
+	int rc = vy_run_is_partitioned(run) ?
+		 vy_slice_find_parts(slice, cmp_def) :
+		 vy_slice_find_pages(slice, cmp_def);
+	if (rc != 0) {
+		/* It's an empty slice */
+		return slice;
 	}
 	assert(slice->last_page_no >= slice->first_page_no);
 	/** Estimate the number of statements in the slice. */
@@ -591,6 +878,86 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 	return 0;
 }
 
+/**
+ * Decode page index partition information from xrow.
+ *
+ * @param[out] part Partition information.
+ * @param xrow      Xrow to decode.
+ * @param cmp_def   Definition of keys stored in the partition.
+ * @param filename  Filename for error reporting.
+ *
+ * @retval  0 Success.
+ * @retval -1 Error.
+ */
+static int
+vy_page_index_part_info_decode(struct vy_page_index_part_info *part,
+			       const struct xrow_header *xrow,
+			       struct key_def *cmp_def, const char *filename)
+{
+	assert(xrow->type == VY_INDEX_PART_INFO);
+	const char *pos = xrow->body->iov_base;
+	memset(part, 0, sizeof(*part));
+	uint64_t key_map = vy_part_info_key_map;
+	uint32_t map_size = mp_decode_map(&pos);
+	uint32_t map_item;
+	const char *key_beg;
+	uint32_t part_count;
+	for (map_item = 0; map_item < map_size; ++map_item) {
+		uint32_t key = mp_decode_uint(&pos);
+		key_map &= ~(1ULL << key);
+		switch (key) {
+		case VY_PART_INFO_OFFSET:
+			part->offset = mp_decode_uint(&pos);
+			break;
+		case VY_PART_INFO_SIZE:
+			part->size = mp_decode_uint(&pos);
+			break;
+		case VY_PART_INFO_UNPACKED_SIZE:
+			part->unpacked_size = mp_decode_uint(&pos);
+			break;
+		case VY_PART_INFO_PAGE_COUNT:
+			part->page_count = mp_decode_uint(&pos);
+			break;
+		case VY_PART_INFO_MIN_KEY:
+			key_beg = pos;
+			mp_next(&pos);
+			part->min_key = vy_key_dup(key_beg);
+			if (part->min_key == NULL)
+				return -1;
+			part_count = mp_decode_array(&key_beg);
+			part->min_key_hint = key_hint(key_beg, part_count,
+						      cmp_def);
+			break;
+		case VY_PART_INFO_ROW_COUNT:
+			part->row_count = mp_decode_uint(&pos);
+			break;
+		case VY_PART_INFO_BYTES:
+			part->bytes = mp_decode_uint(&pos);
+			break;
+		case VY_PART_INFO_BYTES_COMPRESSED:
+			part->bytes_compressed = mp_decode_uint(&pos);
+			break;
+		default:
+			mp_next(&pos); /* unknown key, ignore */
+			break;
+		}
+	}
+	if (key_map) {
+		enum vy_part_info_key key = bit_ctz_u64(key_map);
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 tt_sprintf("Can't decode partition info: "
+				    "missing mandatory key %s",
+				    vy_part_info_key_name(key)));
+		return -1;
+	}
+	if (part->page_count == 0) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 "Can't decode partition info: no pages");
+		return -1;
+	}
+	return 0;
+}
+
 /** Decode statement statistics from @data and advance @data. */
 static void
 vy_stmt_stat_decode(struct vy_stmt_stat *stat, const char **data)
@@ -618,6 +985,64 @@ vy_stmt_stat_decode(struct vy_stmt_stat *stat, const char **data)
 	}
 }
 
+/**
+ * Decode range deletes stored in the run metadata.
+ * See also vy_run_info_encode_range_deletes().
+ *
+ * @retval  0 success
+ * @retval -1 error (check diag)
+ */
+static int
+vy_run_info_decode_range_deletes(struct vy_run_info *run_info,
+				 const char **data, const char *filename)
+{
+	assert(run_info->range_deletes == NULL);
+	if (mp_typeof(**data) != MP_ARRAY)
+		goto error;
+	uint32_t count = mp_decode_array(data);
+	if (count == 0)
+		return 0;
+	size_t size = count * sizeof(*run_info->range_deletes);
+	run_info->range_deletes = calloc(1, size);
+	if (run_info->range_deletes == NULL) {
+		diag_set(OutOfMemory, size, "malloc",
+			 "struct vy_range_delete");
+		return -1;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		struct vy_range_delete *rd = &run_info->range_deletes[i];
+		rlist_create(&rd->in_mem);
+		if (mp_typeof(**data) != MP_ARRAY ||
+		    mp_decode_array(data) != 3 ||
+		    mp_typeof(**data) != MP_ARRAY)
+			goto error;
+		/* Account the entry so that it's freed on error. */
+		run_info->range_delete_count++;
+		rd->begin = vy_key_dup(*data);
+		if (rd->begin == NULL)
+			return -1;
+		mp_next(data);
+		if (mp_typeof(**data) == MP_ARRAY) {
+			rd->end = vy_key_dup(*data);
+			if (rd->end == NULL)
+				return -1;
+			mp_next(data);
+		} else if (mp_typeof(**data) == MP_NIL) {
+			mp_decode_nil(data);
+		} else {
+			goto error;
+		}
+		if (mp_typeof(**data) != MP_UINT)
+			goto error;
+		rd->lsn = mp_decode_uint(data);
+	}
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+		 "Can't decode run info: invalid range deletes");
+	return -1;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -682,6 +1107,17 @@ vy_run_info_decode(struct vy_run_info *run_info,
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_PART_COUNT:
+			run_info->part_count = mp_decode_uint(&pos);
+			break;
+		case VY_RUN_INFO_RANGE_DELETES:
+			if (vy_run_info_decode_range_deletes(run_info, &pos,
+							     filename) != 0)
+				return -1;
+			break;
+		case VY_RUN_INFO_MAX_TIME:
+			run_info->max_time = mp_decode_uint(&pos);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -707,6 +1143,8 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->refs = 1;
+	page->is_cached = false;
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
@@ -743,6 +1181,215 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** Size of memory used by a page. */
+static inline size_t
+vy_page_mem_used(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(*page->row_index);
+}
+
+/** Allocate a page index partition with the given number of pages. */
+static struct vy_page_index_part *
+vy_page_index_part_new(uint32_t page_count)
+{
+	struct vy_page_index_part *part = calloc(1, sizeof(*part));
+	if (part == NULL) {
+		diag_set(OutOfMemory, sizeof(*part), "malloc",
+			 "struct vy_page_index_part");
+		return NULL;
+	}
+	part->page_info = calloc(page_count, sizeof(*part->page_info));
+	if (part->page_info == NULL) {
+		diag_set(OutOfMemory, page_count * sizeof(*part->page_info),
+			 "malloc", "struct vy_page_info");
+		free(part);
+		return NULL;
+	}
+	part->page_count = page_count;
+	part->refs = 1;
+	part->mem_used = sizeof(*part) +
+			 page_count * sizeof(*part->page_info);
+	rlist_create(&part->in_lru);
+	return part;
+}
+
+static void
+vy_page_index_part_delete(struct vy_page_index_part *part)
+{
+	assert(part->refs == 0);
+	assert(!part->is_cached);
+	for (uint32_t i = 0; i < part->page_count; i++)
+		vy_page_info_destroy(&part->page_info[i]);
+	free(part->page_info);
+	if (part->bloom != NULL)
+		tuple_bloom_delete(part->bloom);
+	TRASH(part);
+	free(part);
+}
+
+static inline void
+vy_page_index_part_ref(struct vy_page_index_part *part)
+{
+	assert(part->refs > 0);
+	part->refs++;
+}
+
+static inline void
+vy_page_index_part_unref(struct vy_page_index_part *part)
+{
+	assert(part->refs > 0);
+	if (--part->refs == 0)
+		vy_page_index_part_delete(part);
+}
+
+/* {{{ Page cache */
+
+struct vy_page_cache_key {
+	int64_t run_id;
+	uint32_t page_no;
+};
+
+static inline uint32_t
+vy_page_cache_hash(int64_t run_id, uint32_t page_no)
+{
+	uint64_t h = (uint64_t)run_id * 0x9E3779B97F4A7C15ULL + page_no;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+#define mh_name _vy_page_cache
+#define mh_key_t const struct vy_page_cache_key *
+#define mh_node_t struct vy_page *
+#define mh_arg_t void *
+#define mh_hash(a, arg) vy_page_cache_hash((*(a))->run_id, (*(a))->page_no)
+#define mh_hash_key(a, arg) vy_page_cache_hash((a)->run_id, (a)->page_no)
+#define mh_cmp(a, b, arg) ((*(a))->run_id != (*(b))->run_id || \
+			   (*(a))->page_no != (*(b))->page_no)
+#define mh_cmp_key(a, b, arg) ((a)->run_id != (*(b))->run_id || \
+			       (a)->page_no != (*(b))->page_no)
+#define MH_SOURCE
+#include "salad/mhash.h"
+
+static void
+vy_page_cache_create(struct vy_page_cache *cache)
+{
+	cache->pages = mh_vy_page_cache_new();
+	rlist_create(&cache->lru);
+	cache->mem_used = 0;
+	cache->mem_quota = 0;
+	memset(&cache->stat, 0, sizeof(cache->stat));
+}
+
+/** Remove a page from the cache and drop the cache reference. */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache, struct vy_page *page)
+{
+	assert(page->is_cached);
+	const struct vy_page_cache_key key = { page->run_id, page->page_no };
+	mh_int_t k = mh_vy_page_cache_find(cache->pages, &key, NULL);
+	assert(k != mh_end(cache->pages));
+	mh_vy_page_cache_del(cache->pages, k, NULL);
+	rlist_del_entry(page, in_lru);
+	assert(cache->mem_used >= vy_page_mem_used(page));
+	cache->mem_used -= vy_page_mem_used(page);
+	page->is_cached = false;
+	vy_page_unref(page);
+}
+
+/** Evict the oldest pages until the cache fits in the quota. */
+static void
+vy_page_cache_gc(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page,
+							in_lru);
+		vy_page_cache_evict(cache, page);
+		cache->stat.evict++;
+	}
+}
+
+static void
+vy_page_cache_destroy(struct vy_page_cache *cache)
+{
+	cache->mem_quota = 0;
+	vy_page_cache_gc(cache);
+	mh_vy_page_cache_delete(cache->pages);
+}
+
+/**
+ * Look up a page in the cache. Returns NULL if not found. The page
+ * isn't referenced.
+ */
+static struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no)
+{
+	if (cache->mem_quota == 0)
+		return NULL;
+	cache->stat.lookup++;
+	const struct vy_page_cache_key key = { run_id, page_no };
+	mh_int_t k = mh_vy_page_cache_find(cache->pages, &key, NULL);
+	if (k == mh_end(cache->pages))
+		return NULL;
+	struct vy_page *page = *mh_vy_page_cache_node(cache->pages, k);
+	/* Move the page to the head of the LRU list. */
+	rlist_move_entry(&cache->lru, page, in_lru);
+	cache->stat.hit++;
+	return page;
+}
+
+/** Add a page that has just been read from disk to the cache. */
+static void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_page *page)
+{
+	assert(!page->is_cached);
+	size_t size = vy_page_mem_used(page);
+	if (size > cache->mem_quota / 2)
+		return;
+	/*
+	 * The same page may have been read by another fiber while
+	 * we were waiting for the reader thread.
+	 */
+	const struct vy_page_cache_key key = { page->run_id, page->page_no };
+	if (mh_vy_page_cache_find(cache->pages, &key, NULL) !=
+	    mh_end(cache->pages))
+		return;
+	mh_vy_page_cache_put(cache->pages, (const struct vy_page **)&page,
+			     NULL, NULL);
+	rlist_add_entry(&cache->lru, page, in_lru);
+	page->is_cached = true;
+	vy_page_ref(page);
+	cache->mem_used += size;
+	cache->stat.put++;
+	vy_page_cache_gc(cache);
+}
+
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	env->page_cache.mem_quota = quota;
+	vy_page_cache_gc(&env->page_cache);
+}
+
+/* }}} Page cache */
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -829,11 +1476,15 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
+	if (itr->curr_part != NULL) {
+		vy_page_index_part_unref(itr->curr_part);
+		itr->curr_part = NULL;
+	}
 }
 
 static int
@@ -991,9 +1642,360 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/* {{{ Page index partition */
+
+/**
+ * Read a page index partition from a run file.
+ * Returns a new partition or NULL on error.
+ */
+static struct vy_page_index_part *
+vy_page_index_part_read(struct vy_run *run, uint32_t part_no,
+			struct key_def *cmp_def, ZSTD_DStream *zdctx)
+{
+	assert(part_no < run->info.part_count);
+	const struct vy_page_index_part_info *info = &run->part_info[part_no];
+	const char *filename = vy_run_filename(run);
+	struct vy_page_index_part *part = NULL;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *data = region_alloc(region, info->size + info->unpacked_size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, info->size + info->unpacked_size,
+			 "region gc", "page index partition");
+		goto error;
+	}
+	ssize_t readen = fio_pread(run->fd, data, info->size, info->offset);
+	if (readen < 0) {
+		diag_set(SystemError, "failed to read from file");
+		goto error;
+	}
+	if (readen != (ssize_t)info->size) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Unexpected end of file");
+		goto error;
+	}
+	char *rows = data + info->size;
+	char *rows_end = rows + info->unpacked_size;
+	if (xlog_tx_decode(data, data + info->size, rows, rows_end,
+			   zdctx) != 0)
+		goto error;
+
+	part = vy_page_index_part_new(info->page_count);
+	if (part == NULL)
+		goto error;
+	part->run_id = run->id;
+	part->part_no = part_no;
+
+	const char *pos = rows;
+	struct xrow_header xrow;
+	for (uint32_t i = 0; i < info->page_count; i++) {
+		if (xrow_header_decode(&xrow, &pos, rows_end, true) != 0)
+			goto error;
+		if (xrow.type != VY_INDEX_PAGE_INFO) {
+			diag_set(ClientError, ER_INVALID_RUN_FILE,
+				 tt_sprintf("Wrong xrow type "
+					    "(expected %d, got %u)",
+					    VY_INDEX_PAGE_INFO,
+					    (unsigned)xrow.type));
+			goto error;
+		}
+		struct vy_page_info *page = &part->page_info[i];
+		if (vy_page_info_decode(page, &xrow, cmp_def, filename) != 0)
+			goto error;
+		const char *min_key_end = page->min_key;
+		mp_next(&min_key_end);
+		part->mem_used += min_key_end - page->min_key;
+	}
+	if (pos < rows_end) {
+		if (xrow_header_decode(&xrow, &pos, rows_end, true) != 0)
+			goto error;
+		if (xrow.type != VY_RUN_PART_BLOOM) {
+			diag_set(ClientError, ER_INVALID_RUN_FILE,
+				 tt_sprintf("Wrong xrow type "
+					    "(expected %d, got %u)",
+					    VY_RUN_PART_BLOOM,
+					    (unsigned)xrow.type));
+			goto error;
+		}
+		const char *body = xrow.body->iov_base;
+		uint32_t map_size = mp_decode_map(&body);
+		for (uint32_t i = 0; i < map_size; i++) {
+			uint32_t key = mp_decode_uint(&body);
+			if (key != VY_RUN_INFO_BLOOM_FILTER ||
+			    part->bloom != NULL) {
+				mp_next(&body); /* unknown key, ignore */
+				continue;
+			}
+			part->bloom = tuple_bloom_decode(&body);
+			if (part->bloom == NULL)
+				goto error;
+			part->mem_used += tuple_bloom_size(part->bloom);
+		}
+	}
+	region_truncate(region, region_svp);
+	return part;
+error:
+	region_truncate(region, region_svp);
+	if (part != NULL)
+		vy_page_index_part_unref(part);
+	diag_log();
+	say_error("error reading %s@%llu:%u", filename,
+		  (unsigned long long)info->offset, (unsigned)info->size);
+	return NULL;
+}
+
+/**
+ * Read a page index partition from a run file in a reader thread.
+ */
+static int
+vy_page_index_part_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_page_index_part_read_task *task =
+		(struct vy_page_index_part_read_task *)base;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(task->run->env);
+	if (zdctx == NULL)
+		return -1;
+	task->part = vy_page_index_part_read(task->run, task->part_no,
+					     task->cmp_def, zdctx);
+	return task->part != NULL ? 0 : -1;
+}
+
+/* }}} Page index partition */
+
+/* {{{ Page index cache */
+
+struct vy_page_index_cache_key {
+	int64_t run_id;
+	uint32_t part_no;
+};
+
+#define mh_name _vy_page_index_cache
+#define mh_key_t const struct vy_page_index_cache_key *
+#define mh_node_t struct vy_page_index_part *
+#define mh_arg_t void *
+#define mh_hash(a, arg) vy_page_cache_hash((*(a))->run_id, (*(a))->part_no)
+#define mh_hash_key(a, arg) vy_page_cache_hash((a)->run_id, (a)->part_no)
+#define mh_cmp(a, b, arg) ((*(a))->run_id != (*(b))->run_id || \
+			   (*(a))->part_no != (*(b))->part_no)
+#define mh_cmp_key(a, b, arg) ((a)->run_id != (*(b))->run_id || \
+			       (a)->part_no != (*(b))->part_no)
+#define MH_SOURCE
+#include "salad/mhash.h"
+
+static void
+vy_page_index_cache_create(struct vy_page_index_cache *cache)
+{
+	cache->parts = mh_vy_page_index_cache_new();
+	rlist_create(&cache->lru);
+	cache->mem_used = 0;
+	cache->mem_quota = 0;
+	memset(&cache->stat, 0, sizeof(cache->stat));
+}
+
+/** Remove a partition from the cache and drop the cache reference. */
+static void
+vy_page_index_cache_evict(struct vy_page_index_cache *cache,
+			  struct vy_page_index_part *part)
+{
+	assert(part->is_cached);
+	const struct vy_page_index_cache_key key = {
+		part->run_id, part->part_no
+	};
+	mh_int_t k = mh_vy_page_index_cache_find(cache->parts, &key, NULL);
+	assert(k != mh_end(cache->parts));
+	mh_vy_page_index_cache_del(cache->parts, k, NULL);
+	rlist_del_entry(part, in_lru);
+	assert(cache->mem_used >= part->mem_used);
+	cache->mem_used -= part->mem_used;
+	part->is_cached = false;
+	vy_page_index_part_unref(part);
+}
+
+/** Evict the oldest partitions until the cache fits in the quota. */
+static void
+vy_page_index_cache_gc(struct vy_page_index_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page_index_part *part =
+			rlist_last_entry(&cache->lru,
+					 struct vy_page_index_part, in_lru);
+		vy_page_index_cache_evict(cache, part);
+		cache->stat.evict++;
+	}
+}
+
+static void
+vy_page_index_cache_destroy(struct vy_page_index_cache *cache)
+{
+	cache->mem_quota = 0;
+	vy_page_index_cache_gc(cache);
+	mh_vy_page_index_cache_delete(cache->parts);
+}
+
+/**
+ * Look up a partition in the cache. Returns NULL if not found.
+ * The partition isn't referenced.
+ */
+static struct vy_page_index_part *
+vy_page_index_cache_get(struct vy_page_index_cache *cache, int64_t run_id,
+			uint32_t part_no)
+{
+	cache->stat.lookup++;
+	const struct vy_page_index_cache_key key = { run_id, part_no };
+	mh_int_t k = mh_vy_page_index_cache_find(cache->parts, &key, NULL);
+	if (k == mh_end(cache->parts))
+		return NULL;
+	struct vy_page_index_part *part =
+		*mh_vy_page_index_cache_node(cache->parts, k);
+	/* Move the partition to the head of the LRU list. */
+	rlist_move_entry(&cache->lru, part, in_lru);
+	cache->stat.hit++;
+	return part;
+}
+
+/** Add a partition that has just been read from disk to the cache. */
+static void
+vy_page_index_cache_put(struct vy_page_index_cache *cache,
+			struct vy_page_index_part *part)
+{
+	assert(!part->is_cached);
+	if (part->mem_used > cache->mem_quota)
+		return;
+	/*
+	 * The same partition may have been read by another fiber
+	 * while we were waiting for the reader thread.
+	 */
+	const struct vy_page_index_cache_key key = {
+		part->run_id, part->part_no
+	};
+	if (mh_vy_page_index_cache_find(cache->parts, &key, NULL) !=
+	    mh_end(cache->parts))
+		return;
+	mh_vy_page_index_cache_put(cache->parts,
+				   (const struct vy_page_index_part **)&part,
+				   NULL, NULL);
+	rlist_add_entry(&cache->lru, part, in_lru);
+	part->is_cached = true;
+	vy_page_index_part_ref(part);
+	cache->mem_used += part->mem_used;
+	cache->stat.put++;
+	vy_page_index_cache_gc(cache);
+}
+
+void
+vy_run_env_set_page_index_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	env->page_index_cache.mem_quota = quota;
+	vy_page_index_cache_gc(&env->page_index_cache);
+}
+
+/**
+ * Get a page index partition of a run from the page index cache
+ * or read it from disk and add it to the cache. Returns a referenced
+ * partition or NULL on error. May yield.
+ */
+static struct vy_page_index_part *
+vy_run_load_part(struct vy_run *run, uint32_t part_no,
+		 struct key_def *cmp_def)
+{
+	struct vy_run_env *env = run->env;
+	struct vy_page_index_part *part =
+		vy_page_index_cache_get(&env->page_index_cache,
+					run->id, part_no);
+	if (part != NULL) {
+		vy_page_index_part_ref(part);
+		return part;
+	}
+	struct vy_page_index_part_read_task task;
+	task.run = run;
+	task.part_no = part_no;
+	task.cmp_def = cmp_def;
+	task.part = NULL;
+	if (vy_run_env_coio_call(env, &task.base,
+				 vy_page_index_part_read_cb) != 0) {
+		if (task.part != NULL)
+			vy_page_index_part_unref(task.part);
+		return NULL;
+	}
+	part = task.part;
+	vy_page_index_cache_put(&env->page_index_cache, part);
+	return part;
+}
+
+/* }}} Page index cache */
+
+/**
+ * Make a page index partition the current partition of a run
+ * iterator, loading it if necessary. Returns the partition or
+ * NULL on error. May yield.
+ */
+static struct vy_page_index_part *
+vy_run_iterator_load_part(struct vy_run_iterator *itr, uint32_t part_no)
+{
+	if (itr->curr_part != NULL && itr->curr_part->part_no == part_no)
+		return itr->curr_part;
+	struct vy_page_index_part *part =
+		vy_run_load_part(itr->slice->run, part_no, itr->cmp_def);
+	if (part == NULL)
+		return NULL;
+	if (itr->curr_part != NULL)
+		vy_page_index_part_unref(itr->curr_part);
+	itr->curr_part = part;
+	return part;
+}
+
+/** vy_page_index_part_get_f callback for run iterator. */
+static struct vy_page_index_part *
+vy_run_iterator_get_part_cb(void *arg, uint32_t part_no)
+{
+	return vy_run_iterator_load_part(arg, part_no);
+}
+
+/**
+ * Return info about a page of the run read by an iterator. If the
+ * page index of the run is partitioned, the partition containing
+ * the page is loaded. Returns NULL on error. May yield.
+ */
+static struct vy_page_info *
+vy_run_iterator_page_info(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_run *run = itr->slice->run;
+	if (!vy_run_is_partitioned(run))
+		return vy_run_page_info(run, page_no);
+	struct vy_page_index_part *part = itr->curr_part;
+	const struct vy_page_index_part_info *info;
+	if (part != NULL) {
+		info = &run->part_info[part->part_no];
+		if (page_no >= info->first_page_no &&
+		    page_no < info->first_page_no + info->page_count)
+			return &part->page_info[page_no - info->first_page_no];
+	}
+	uint32_t part_no = vy_run_page_part_no(run, page_no);
+	part = vy_run_iterator_load_part(itr, part_no);
+	if (part == NULL)
+		return NULL;
+	info = &run->part_info[part_no];
+	return &part->page_info[page_no - info->first_page_no];
+}
+
+/**
+ * Make a page the current page of a run iterator. The iterator
+ * takes over the page reference.
+ */
+static void
+vy_run_iterator_cache_page(struct vy_run_iterator *itr, struct vy_page *page)
+{
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+}
+
 /**
  * Read a page from disk given its number.
- * The function caches two most recently read pages.
+ * The function caches two most recently read pages. Pages are
+ * also looked up in and added to the shared page cache.
  *
  * @retval 0 success
  * @retval -1 critical error
@@ -1017,6 +2019,14 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		SWAP(itr->prev_page, itr->curr_page);
 		page = itr->curr_page;
 	}
+	if (page == NULL) {
+		page = vy_page_cache_get(&env->page_cache, slice->run->id,
+					 page_no);
+		if (page != NULL) {
+			vy_page_ref(page);
+			vy_run_iterator_cache_page(itr, page);
+		}
+	}
 	if (page != NULL) {
 		if (key.stmt != NULL)
 			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
@@ -1027,10 +2037,15 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	}
 
 	/* Allocate buffers */
-	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
+	struct vy_page_info *page_info = vy_run_iterator_page_info(itr,
+								   page_no);
+	if (page_info == NULL)
+		return -1;
 	page = vy_page_new(page_info);
 	if (page == NULL)
 		return -1;
+	page->run_id = slice->run->id;
+	page->page_no = page_no;
 
 	/* Read page data from the disk */
 	struct vy_page_read_task *task = mempool_alloc(&env->read_task_pool);
@@ -1062,11 +2077,8 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	}
 
 	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
-	page->page_no = page_no;
+	vy_run_iterator_cache_page(itr, page);
+	vy_page_cache_put(&env->page_cache, page);
 
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
@@ -1121,9 +2133,10 @@ vy_run_iterator_search(struct vy_run_iterator *itr,
 		       enum iterator_type iterator_type, struct vy_entry key,
 		       struct vy_run_iterator_pos *pos, bool *equal_key)
 {
-	pos->page_no = vy_page_index_find_page(itr->slice->run, key,
-					       itr->cmp_def, iterator_type,
-					       equal_key);
+	if (vy_page_index_find_page(itr->slice->run, key, itr->cmp_def,
+				    iterator_type, vy_run_iterator_get_part_cb,
+				    itr, &pos->page_no, equal_key) != 0)
+		return -1;
 	if (pos->page_no == itr->slice->run->info.page_count)
 		return 1;
 	bool equal_in_page;
@@ -1147,6 +2160,7 @@ vy_run_iterator_search(struct vy_run_iterator *itr,
  * wide position.
  * @retval 0 success, set *pos to new value
  * @retval 1 EOF
+ * @retval -1 error loading a page index partition
  * Affects: curr_loaded_page
  */
 static NODISCARD int
@@ -1165,7 +2179,9 @@ vy_run_iterator_next_pos(struct vy_run_iterator *itr,
 				return 1;
 			pos->page_no--;
 			struct vy_page_info *page_info =
-				vy_run_page_info(run, pos->page_no);
+				vy_run_iterator_page_info(itr, pos->page_no);
+			if (page_info == NULL)
+				return -1;
 			assert(page_info->row_count > 0);
 			pos->pos_in_page = page_info->row_count - 1;
 		}
@@ -1174,7 +2190,9 @@ vy_run_iterator_next_pos(struct vy_run_iterator *itr,
 		       iterator_type == ITER_EQ);
 		assert(pos->page_no < run->info.page_count);
 		struct vy_page_info *page_info =
-			vy_run_page_info(run, pos->page_no);
+			vy_run_iterator_page_info(itr, pos->page_no);
+		if (page_info == NULL)
+			return -1;
 		assert(page_info->row_count > 0);
 		pos->pos_in_page++;
 		if (pos->pos_in_page >= page_info->row_count) {
@@ -1208,10 +2226,14 @@ vy_run_iterator_find_lsn(struct vy_run_iterator *itr, struct vy_entry *ret)
 	assert(itr->curr.stmt != NULL);
 	assert(itr->curr_pos.page_no < slice->run->info.page_count);
 
+	int rc;
 	while (vy_stmt_lsn(itr->curr.stmt) > (**itr->read_view).vlsn ||
 	       vy_stmt_flags(itr->curr.stmt) & VY_STMT_SKIP_READ) {
-		if (vy_run_iterator_next_pos(itr, itr->iterator_type,
-					     &itr->curr_pos) != 0) {
+		rc = vy_run_iterator_next_pos(itr, itr->iterator_type,
+					      &itr->curr_pos);
+		if (rc < 0)
+			return -1;
+		if (rc > 0) {
 			vy_run_iterator_stop(itr);
 			return 0;
 		}
@@ -1227,8 +2249,8 @@ vy_run_iterator_find_lsn(struct vy_run_iterator *itr, struct vy_entry *ret)
 	}
 	if (itr->iterator_type == ITER_LE || itr->iterator_type == ITER_LT) {
 		struct vy_run_iterator_pos test_pos;
-		while (vy_run_iterator_next_pos(itr, itr->iterator_type,
-						&test_pos) == 0) {
+		while ((rc = vy_run_iterator_next_pos(itr, itr->iterator_type,
+						      &test_pos)) == 0) {
 			struct vy_entry test;
 			if (vy_run_iterator_read(itr, test_pos, &test) != 0)
 				return -1;
@@ -1242,6 +2264,8 @@ vy_run_iterator_find_lsn(struct vy_run_iterator *itr, struct vy_entry *ret)
 			itr->curr = test;
 			itr->curr_pos = test_pos;
 		}
+		if (rc < 0)
+			return -1;
 	}
 	/* Check if the result is within the slice boundaries. */
 	if (itr->iterator_type == ITER_LE || itr->iterator_type == ITER_LT) {
@@ -1326,6 +2350,105 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 	}
 }
 
+/**
+ * Check if the run may store the key an iterator is looking for
+ * using bloom filters. If the page index of the run is partitioned,
+ * bloom filters of all partitions that may store the key are
+ * checked, which may require loading them from disk.
+ *
+ * @param[out] has_bloom set if a bloom filter was checked.
+ * @param[out] maybe_has cleared if the key is definitely absent.
+ * @retval 0 success
+ * @retval -1 error loading a page index partition
+ */
+static NODISCARD int
+vy_run_iterator_check_bloom(struct vy_run_iterator *itr, bool *has_bloom,
+			    bool *maybe_has)
+{
+	struct vy_run *run = itr->slice->run;
+	*has_bloom = false;
+	*maybe_has = true;
+	if (!vy_run_is_partitioned(run)) {
+		if (run->info.bloom != NULL) {
+			*has_bloom = true;
+			*maybe_has = vy_bloom_maybe_has(run->info.bloom,
+							itr->key,
+							itr->key_def);
+		}
+		return 0;
+	}
+	/*
+	 * Statements matching the key may be stored starting from
+	 * the partition preceding the first partition with min key
+	 * >= the key up to the partition preceding the first
+	 * partition with min key > the key.
+	 */
+	bool unused = false;
+	uint32_t first = vy_page_index_part_search(run, itr->key,
+						   itr->cmp_def, true,
+						   &unused);
+	uint32_t last = vy_page_index_part_search(run, itr->key,
+						  itr->cmp_def, false,
+						  &unused);
+	if (last == 0) {
+		/* The key is less than the min key of the run. */
+		*maybe_has = false;
+		return 0;
+	}
+	first = first > 0 ? first - 1 : 0;
+	last = last - 1;
+	for (uint32_t part_no = first; part_no <= last; part_no++) {
+		struct vy_page_index_part *part =
+			vy_run_iterator_load_part(itr, part_no);
+		if (part == NULL)
+			return -1;
+		if (part->bloom == NULL) {
+			*has_bloom = false;
+			return 0;
+		}
+		*has_bloom = true;
+		if (vy_bloom_maybe_has(part->bloom, itr->key, itr->key_def))
+			return 0;
+	}
+	*maybe_has = false;
+	return 0;
+}
+
+/**
+ * Check if the run may store keys an iterator is looking for
+ * by comparing the search key against the min and max keys of
+ * the run. Since the search key may be partial, this works for
+ * prefix scans as well. Returns false if the run can be skipped.
+ */
+static bool
+vy_run_iterator_check_key_range(struct vy_run_iterator *itr)
+{
+	struct vy_run_info *info = &itr->slice->run->info;
+	struct vy_entry key = itr->key;
+	if (vy_stmt_is_empty_key(key.stmt) ||
+	    info->min_key == NULL || info->max_key == NULL)
+		return true;
+	int cmp_min = vy_entry_compare_with_raw_key(key, info->min_key,
+						    HINT_NONE, itr->cmp_def);
+	int cmp_max = vy_entry_compare_with_raw_key(key, info->max_key,
+						    HINT_NONE, itr->cmp_def);
+	switch (itr->iterator_type) {
+	case ITER_EQ:
+		return cmp_min >= 0 && cmp_max <= 0;
+	case ITER_GE:
+		return cmp_max <= 0;
+	case ITER_GT:
+		return cmp_max < 0;
+	case ITER_LE:
+		return cmp_min >= 0 && (!itr->is_eq || cmp_max <= 0);
+	case ITER_LT:
+		return cmp_min > 0;
+	default:
+		unreachable();
+		return true;
+	}
+}
+
 /**
  * Position the iterator to the first statement satisfying
  * the iterator search criteria and following the given key
@@ -1337,22 +2460,46 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 {
 	struct key_def *cmp_def = itr->cmp_def;
 	struct vy_slice *slice = itr->slice;
-	struct tuple_bloom *bloom = slice->run->info.bloom;
 	struct vy_entry key = itr->key;
 	enum iterator_type iterator_type = itr->iterator_type;
 
 	*ret = vy_entry_none();
 	assert(itr->search_started);
 
-	/* Check the bloom filter on the first iteration. */
-	bool check_bloom = (itr->iterator_type == ITER_EQ &&
-			    itr->curr.stmt == NULL && bloom != NULL);
-	if (check_bloom && !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
+	if (slice->run->info.page_count == 0) {
+		/* The run stores only range deletes. */
+		vy_run_iterator_stop(itr);
+		return 0;
+	}
+
+	/*
+	 * Skip the run if the key is out of its range. Since the
+	 * run may only shrink, it's enough to check this on the
+	 * first iteration.
+	 */
+	if (itr->curr.stmt == NULL && !vy_run_iterator_check_key_range(itr)) {
 		vy_run_iterator_stop(itr);
-		itr->stat->bloom_hit++;
+		itr->stat->skip++;
 		return 0;
 	}
 
+	/* Check the bloom filter on the first iteration. */
+	bool check_bloom = false;
+	if (itr->is_eq && itr->curr.stmt == NULL) {
+		bool maybe_has;
+		if (vy_run_iterator_check_bloom(itr, &check_bloom,
+						&maybe_has) != 0)
+			return -1;
+		if (!maybe_has) {
+			vy_run_iterator_stop(itr);
+			if (check_bloom) {
+				itr->stat->bloom_hit++;
+				itr->is_bloom_hit = true;
+			}
+			return 0;
+		}
+	}
+
 	/*
 	 * vy_run_iterator_do_seek() implements its own EQ check.
 	 * We only need to check EQ here if iterator type and key
@@ -1470,6 +2617,9 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->format = format;
 	itr->slice = slice;
 
+	itr->is_eq = iterator_type == ITER_EQ || iterator_type == ITER_REQ;
+	if (iterator_type == ITER_REQ)
+		iterator_type = ITER_LE;
 	itr->iterator_type = iterator_type;
 	itr->key = key;
 	itr->read_view = rv;
@@ -1478,7 +2628,9 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_pos.page_no = slice->run->info.page_count;
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
+	itr->curr_part = NULL;
 	itr->search_started = false;
+	itr->is_bloom_hit = false;
 
 	/*
 	 * Make sure the format we use to create tuples won't
@@ -1514,8 +2666,11 @@ vy_run_iterator_next_key(struct vy_run_iterator *itr, struct vy_entry *ret)
 	do {
 		if (next.stmt != NULL)
 			tuple_unref(next.stmt);
-		if (vy_run_iterator_next_pos(itr, itr->iterator_type,
-					     &itr->curr_pos) != 0) {
+		int rc = vy_run_iterator_next_pos(itr, itr->iterator_type,
+						  &itr->curr_pos);
+		if (rc < 0)
+			return -1;
+		if (rc > 0) {
 			vy_run_iterator_stop(itr);
 			return 0;
 		}
@@ -1550,8 +2705,12 @@ vy_run_iterator_next_lsn(struct vy_run_iterator *itr, struct vy_entry *ret)
 	assert(itr->curr_pos.page_no < itr->slice->run->info.page_count);
 
 	struct vy_run_iterator_pos next_pos;
+	int rc;
 next:
-	if (vy_run_iterator_next_pos(itr, ITER_GE, &next_pos) != 0) {
+	rc = vy_run_iterator_next_pos(itr, ITER_GE, &next_pos);
+	if (rc < 0)
+		return -1;
+	if (rc > 0) {
 		vy_run_iterator_stop(itr);
 		return 0;
 	}
@@ -1651,6 +2810,130 @@ vy_run_acct_page(struct vy_run *run, struct vy_page_info *page)
 	run->count.pages++;
 }
 
+/** Account a page index partition to run statistics. */
+static void
+vy_run_acct_part(struct vy_run *run, struct vy_page_index_part_info *part)
+{
+	const char *min_key_end = part->min_key;
+	mp_next(&min_key_end);
+	run->page_index_size += sizeof(struct vy_page_index_part_info);
+	run->page_index_size += min_key_end - part->min_key;
+	run->count.rows += part->row_count;
+	run->count.bytes += part->bytes;
+	run->count.bytes_compressed += part->bytes_compressed;
+	run->count.pages += part->page_count;
+}
+
+/**
+ * Read page info of a classic (not partitioned) run from an index
+ * file cursor positioned after the run info.
+ */
+static int
+vy_run_recover_page_info(struct vy_run *run, struct xlog_cursor *cursor,
+			 struct key_def *cmp_def, const char *path)
+{
+	/* Allocate buffer for page info. */
+	run->page_info = calloc(run->info.page_count,
+				      sizeof(struct vy_page_info));
+	if (run->page_info == NULL && run->info.page_count > 0) {
+		diag_set(OutOfMemory,
+			 run->info.page_count * sizeof(struct vy_page_info),
+			 "malloc", "struct vy_page_info");
+		return -1;
+	}
+
+	struct xrow_header xrow;
+	for (uint32_t page_no = 0; page_no < run->info.page_count; page_no++) {
+		int rc = xlog_cursor_next_row(cursor, &xrow);
+		if (rc != 0) {
+			if (rc > 0) {
+				/** To few pages in file */
+				diag_set(ClientError, ER_INVALID_INDEX_FILE,
+					 path, "Unexpected end of file");
+			}
+			/*
+			 * Limit the count of pages to
+			 * successfully created pages.
+			 */
+			run->info.page_count = page_no;
+			return -1;
+		}
+		if (xrow.type != VY_INDEX_PAGE_INFO) {
+			diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
+				 tt_sprintf("Wrong xrow type "
+					    "(expected %d, got %u)",
+					    VY_INDEX_PAGE_INFO,
+					    (unsigned)xrow.type));
+			run->info.page_count = page_no;
+			return -1;
+		}
+		struct vy_page_info *page = run->page_info + page_no;
+		if (vy_page_info_decode(page, &xrow, cmp_def, path) < 0) {
+			/**
+			 * Limit the count of pages to successfully
+			 * created pages
+			 */
+			run->info.page_count = page_no;
+			return -1;
+		}
+		vy_run_acct_page(run, page);
+	}
+	return 0;
+}
+
+/**
+ * Read page index partition info of a partitioned run from an index
+ * file cursor positioned after the run info. The partitions
+ * themselves are stored in the data file and loaded on demand.
+ */
+static int
+vy_run_recover_part_info(struct vy_run *run, struct xlog_cursor *cursor,
+			 struct key_def *cmp_def, const char *path)
+{
+	run->part_info = calloc(run->info.part_count,
+				sizeof(struct vy_page_index_part_info));
+	if (run->part_info == NULL) {
+		diag_set(OutOfMemory, run->info.part_count *
+			 sizeof(struct vy_page_index_part_info),
+			 "malloc", "struct vy_page_index_part_info");
+		return -1;
+	}
+
+	struct xrow_header xrow;
+	uint32_t page_count = 0;
+	for (uint32_t part_no = 0; part_no < run->info.part_count; part_no++) {
+		int rc = xlog_cursor_next_row(cursor, &xrow);
+		if (rc != 0) {
+			if (rc > 0) {
+				diag_set(ClientError, ER_INVALID_INDEX_FILE,
+					 path, "Unexpected end of file");
+			}
+			return -1;
+		}
+		if (xrow.type != VY_INDEX_PART_INFO) {
+			diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
+				 tt_sprintf("Wrong xrow type "
+					    "(expected %d, got %u)",
+					    VY_INDEX_PART_INFO,
+					    (unsigned)xrow.type));
+			return -1;
+		}
+		struct vy_page_index_part_info *part = run->part_info + part_no;
+		if (vy_page_index_part_info_decode(part, &xrow, cmp_def,
+						   path) != 0)
+			return -1;
+		part->first_page_no = page_count;
+		page_count += part->page_count;
+		vy_run_acct_part(run, part);
+	}
+	if (page_count != run->info.page_count) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
+			 "Page count mismatch");
+		return -1;
+	}
+	return 0;
+}
+
 int
 vy_run_recover(struct vy_run *run, const char *dir,
 	       uint32_t space_id, uint32_t iid, struct key_def *cmp_def)
@@ -1703,49 +2986,12 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	if (vy_run_info_decode(&run->info, &xrow, path) != 0)
 		goto fail_close;
 
-	/* Allocate buffer for page info. */
-	run->page_info = calloc(run->info.page_count,
-				      sizeof(struct vy_page_info));
-	if (run->page_info == NULL) {
-		diag_set(OutOfMemory,
-			 run->info.page_count * sizeof(struct vy_page_info),
-			 "malloc", "struct vy_page_info");
-		goto fail_close;
-	}
-
-	for (uint32_t page_no = 0; page_no < run->info.page_count; page_no++) {
-		int rc = xlog_cursor_next_row(&cursor, &xrow);
-		if (rc != 0) {
-			if (rc > 0) {
-				/** To few pages in file */
-				diag_set(ClientError, ER_INVALID_INDEX_FILE,
-					 path, "Unexpected end of file");
-			}
-			/*
-			 * Limit the count of pages to
-			 * successfully created pages.
-			 */
-			run->info.page_count = page_no;
-			goto fail_close;
-		}
-		if (xrow.type != VY_INDEX_PAGE_INFO) {
-			diag_set(ClientError, ER_INVALID_INDEX_FILE,
-				 tt_sprintf("Wrong xrow type "
-					    "(expected %d, got %u)",
-					    VY_INDEX_PAGE_INFO,
-					    (unsigned)xrow.type));
+	if (vy_run_is_partitioned(run)) {
+		if (vy_run_recover_part_info(run, &cursor, cmp_def, path) != 0)
 			goto fail_close;
-		}
-		struct vy_page_info *page = run->page_info + page_no;
-		if (vy_page_info_decode(page, &xrow, cmp_def, path) < 0) {
-			/**
-			 * Limit the count of pages to successfully
-			 * created pages
-			 */
-			run->info.page_count = page_no;
+	} else {
+		if (vy_run_recover_page_info(run, &cursor, cmp_def, path) != 0)
 			goto fail_close;
-		}
-		vy_run_acct_page(run, page);
 	}
 
 	/* We don't need to keep metadata file open any longer. */
@@ -1775,14 +3021,17 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	return -1;
 }
 
-/* dump statement to the run page buffers (stmt header and data) */
+/*
+ * dump statement to the run page buffers (stmt header and data),
+ * full tuples are stored only in primary and covering indexes
+ */
 static int
 vy_run_dump_stmt(struct vy_entry entry, struct xlog *data_xlog,
 		 struct vy_page_info *info, struct key_def *key_def,
-		 bool is_primary)
+		 bool is_full)
 {
 	struct xrow_header xrow;
-	int rc = (is_primary ?
+	int rc = (is_full ?
 		  vy_stmt_encode_primary(entry.stmt, key_def, 0, &xrow) :
 		  vy_stmt_encode_secondary(entry.stmt, key_def,
 					   vy_entry_multikey_idx(entry, key_def),
@@ -1855,6 +3104,27 @@ vy_run_alloc_page_info(struct vy_run *run, uint32_t *page_info_capacity)
 	return 0;
 }
 
+/**
+ * Allocate page index partition info for a run being written.
+ * Similar to vy_run_alloc_page_info().
+ */
+static int
+vy_run_alloc_part_info(struct vy_run *run, uint32_t *part_info_capacity)
+{
+	uint32_t cap = *part_info_capacity > 0 ?
+		       *part_info_capacity * 2 : 16;
+	struct vy_page_index_part_info *part_info = realloc(run->part_info,
+					cap * sizeof(*part_info));
+	if (part_info == NULL) {
+		diag_set(OutOfMemory, cap * sizeof(*part_info),
+			 "realloc", "struct vy_page_index_part_info");
+		return -1;
+	}
+	run->part_info = part_info;
+	*part_info_capacity = cap;
+	return 0;
+}
+
 /** {{{ vy_page_info */
 
 /**
@@ -1926,6 +3196,73 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	return 0;
 }
 
+/**
+ * Encode vy_page_index_part_info as xrow.
+ * Allocates using region_alloc.
+ *
+ * @param part  Partition information.
+ * @param xrow  Xrow to fill.
+ *
+ * @retval  0 Success.
+ * @retval -1 Error.
+ */
+static int
+vy_page_index_part_info_encode(const struct vy_page_index_part_info *part,
+			       struct xrow_header *xrow)
+{
+	const char *tmp = part->min_key;
+	assert(mp_typeof(*tmp) == MP_ARRAY);
+	mp_next(&tmp);
+	uint32_t min_key_size = tmp - part->min_key;
+
+	size_t size = mp_sizeof_map(8) +
+		mp_sizeof_uint(VY_PART_INFO_OFFSET) +
+		mp_sizeof_uint(part->offset) +
+		mp_sizeof_uint(VY_PART_INFO_SIZE) +
+		mp_sizeof_uint(part->size) +
+		mp_sizeof_uint(VY_PART_INFO_UNPACKED_SIZE) +
+		mp_sizeof_uint(part->unpacked_size) +
+		mp_sizeof_uint(VY_PART_INFO_PAGE_COUNT) +
+		mp_sizeof_uint(part->page_count) +
+		mp_sizeof_uint(VY_PART_INFO_MIN_KEY) + min_key_size +
+		mp_sizeof_uint(VY_PART_INFO_ROW_COUNT) +
+		mp_sizeof_uint(part->row_count) +
+		mp_sizeof_uint(VY_PART_INFO_BYTES) +
+		mp_sizeof_uint(part->bytes) +
+		mp_sizeof_uint(VY_PART_INFO_BYTES_COMPRESSED) +
+		mp_sizeof_uint(part->bytes_compressed);
+
+	char *pos = region_alloc(&fiber()->gc, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "region", "partition encode");
+		return -1;
+	}
+	memset(xrow, 0, sizeof(*xrow));
+	xrow->body->iov_base = pos;
+	pos = mp_encode_map(pos, 8);
+	pos = mp_encode_uint(pos, VY_PART_INFO_OFFSET);
+	pos = mp_encode_uint(pos, part->offset);
+	pos = mp_encode_uint(pos, VY_PART_INFO_SIZE);
+	pos = mp_encode_uint(pos, part->size);
+	pos = mp_encode_uint(pos, VY_PART_INFO_UNPACKED_SIZE);
+	pos = mp_encode_uint(pos, part->unpacked_size);
+	pos = mp_encode_uint(pos, VY_PART_INFO_PAGE_COUNT);
+	pos = mp_encode_uint(pos, part->page_count);
+	pos = mp_encode_uint(pos, VY_PART_INFO_MIN_KEY);
+	memcpy(pos, part->min_key, min_key_size);
+	pos += min_key_size;
+	pos = mp_encode_uint(pos, VY_PART_INFO_ROW_COUNT);
+	pos = mp_encode_uint(pos, part->row_count);
+	pos = mp_encode_uint(pos, VY_PART_INFO_BYTES);
+	pos = mp_encode_uint(pos, part->bytes);
+	pos = mp_encode_uint(pos, VY_PART_INFO_BYTES_COMPRESSED);
+	pos = mp_encode_uint(pos, part->bytes_compressed);
+	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
+	xrow->bodycnt = 1;
+	xrow->type = VY_INDEX_PART_INFO;
+	return 0;
+}
+
 /** vy_page_info }}} */
 
 /** {{{ vy_run_info */
@@ -1961,6 +3298,57 @@ vy_stmt_stat_encode(const struct vy_stmt_stat *stat, char *buf)
 	return buf;
 }
 
+/** Return the size of range deletes encoded in the run metadata. */
+static size_t
+vy_run_info_sizeof_range_deletes(const struct vy_run_info *run_info)
+{
+	size_t size = mp_sizeof_array(run_info->range_delete_count);
+	for (uint32_t i = 0; i < run_info->range_delete_count; i++) {
+		const struct vy_range_delete *rd = &run_info->range_deletes[i];
+		const char *tmp = rd->begin;
+		mp_next(&tmp);
+		size += mp_sizeof_array(3) + (tmp - rd->begin);
+		if (rd->end != NULL) {
+			tmp = rd->end;
+			mp_next(&tmp);
+			size += tmp - rd->end;
+		} else {
+			size += mp_sizeof_nil();
+		}
+		size += mp_sizeof_uint(rd->lsn);
+	}
+	return size;
+}
+
+/**
+ * Encode range deletes stored in the run metadata as an array
+ * of [begin, end, lsn] where end is nil for an unbounded range.
+ */
+static char *
+vy_run_info_encode_range_deletes(const struct vy_run_info *run_info,
+				 char *pos)
+{
+	pos = mp_encode_array(pos, run_info->range_delete_count);
+	for (uint32_t i = 0; i < run_info->range_delete_count; i++) {
+		const struct vy_range_delete *rd = &run_info->range_deletes[i];
+		pos = mp_encode_array(pos, 3);
+		const char *tmp = rd->begin;
+		mp_next(&tmp);
+		memcpy(pos, rd->begin, tmp - rd->begin);
+		pos += tmp - rd->begin;
+		if (rd->end != NULL) {
+			tmp = rd->end;
+			mp_next(&tmp);
+			memcpy(pos, rd->end, tmp - rd->end);
+			pos += tmp - rd->end;
+		} else {
+			pos = mp_encode_nil(pos);
+		}
+		pos = mp_encode_uint(pos, rd->lsn);
+	}
+	return pos;
+}
+
 /**
  * Encode vy_run_info as xrow
  * Allocates using region alloc
@@ -1986,6 +3374,12 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 6;
 	if (run_info->bloom != NULL)
 		key_count++;
+	if (run_info->part_count > 0)
+		key_count++;
+	if (run_info->range_delete_count > 0)
+		key_count++;
+	if (run_info->max_time > 0)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2001,6 +3395,15 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 			tuple_bloom_size(run_info->bloom);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
+	if (run_info->part_count > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_PART_COUNT) +
+			mp_sizeof_uint(run_info->part_count);
+	if (run_info->range_delete_count > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_RANGE_DELETES) +
+			vy_run_info_sizeof_range_deletes(run_info);
+	if (run_info->max_time > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_MAX_TIME) +
+			mp_sizeof_uint(run_info->max_time);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2029,6 +3432,18 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
+	if (run_info->part_count > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_PART_COUNT);
+		pos = mp_encode_uint(pos, run_info->part_count);
+	}
+	if (run_info->range_delete_count > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_RANGE_DELETES);
+		pos = vy_run_info_encode_range_deletes(run_info, pos);
+	}
+	if (run_info->max_time > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_MAX_TIME);
+		pos = mp_encode_uint(pos, run_info->max_time);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2069,7 +3484,19 @@ vy_run_write_index(struct vy_run *run, const char *dirpath,
 	    xlog_write_row(&index_xlog, &xrow) < 0)
 		goto fail_rollback;
 
-	for (uint32_t page_no = 0; page_no < run->info.page_count; ++page_no) {
+	/*
+	 * Page info of a partitioned run is stored in the data
+	 * file so only partition info is written to the index.
+	 */
+	for (uint32_t part_no = 0; part_no < run->info.part_count; ++part_no) {
+		if (vy_page_index_part_info_encode(&run->part_info[part_no],
+						   &xrow) < 0)
+			goto fail_rollback;
+		if (xlog_write_row(&index_xlog, &xrow) < 0)
+			goto fail_rollback;
+	}
+	for (uint32_t page_no = 0; !vy_run_is_partitioned(run) &&
+	     page_no < run->info.page_count; ++page_no) {
 		struct vy_page_info *page_info = vy_run_page_info(run, page_no);
 		if (vy_page_info_encode(page_info, &xrow) < 0) {
 			goto fail_rollback;
@@ -2108,7 +3535,8 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     uint64_t page_size, double bloom_fpr, bool no_compression,
+		     struct tt_compression_dict *compression_dict)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
@@ -2120,6 +3548,9 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	writer->page_size = page_size;
 	writer->bloom_fpr = bloom_fpr;
 	writer->no_compression = no_compression;
+	writer->compression_dict = compression_dict;
+	writer->rate_limit = run->env->snap_io_rate_limit;
+	writer->partition_page_index = run->env->partition_page_index;
 	if (bloom_fpr < 1) {
 		writer->bloom = tuple_bloom_builder_new(key_def->part_count);
 		if (writer->bloom == NULL)
@@ -2153,14 +3584,160 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	xlog_meta_create(&meta, XLOG_META_TYPE_RUN, &INSTANCE_UUID,
 			 NULL, NULL);
 	struct xlog_opts opts = xlog_opts_default;
-	opts.rate_limit = writer->run->env->snap_io_rate_limit;
+	opts.rate_limit = writer->rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
 	opts.no_compression = writer->no_compression;
+	opts.compression_dict = writer->compression_dict;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
 	return 0;
 }
 
+/**
+ * Return the info of the page that is currently being written.
+ * Only pages of the current page index partition are stored in
+ * vy_run::page_info while the run is being written.
+ */
+static inline struct vy_page_info *
+vy_run_writer_curr_page(struct vy_run_writer *writer)
+{
+	struct vy_run *run = writer->run;
+	return run->page_info + run->info.page_count -
+	       writer->part_first_page_no;
+}
+
+/**
+ * Write the bloom filter of the current page index partition.
+ * Allocates using region_alloc.
+ * @param writer Run writer.
+ * @param[out] written Number of bytes written to the xlog buffer.
+ *
+ * @retval -1 Memory or IO error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_write_part_bloom(struct vy_run_writer *writer, ssize_t *written)
+{
+	struct tuple_bloom *bloom = tuple_bloom_new(writer->bloom,
+						    writer->bloom_fpr);
+	if (bloom == NULL)
+		return -1;
+	int rc = -1;
+	size_t size = mp_sizeof_map(1) +
+		      mp_sizeof_uint(VY_RUN_INFO_BLOOM_FILTER) +
+		      tuple_bloom_size(bloom);
+	char *pos = region_alloc(&fiber()->gc, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "region", "partition bloom");
+		goto out;
+	}
+	struct xrow_header xrow;
+	memset(&xrow, 0, sizeof(xrow));
+	xrow.type = VY_RUN_PART_BLOOM;
+	xrow.body->iov_base = pos;
+	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM_FILTER);
+	pos = tuple_bloom_encode(bloom, pos);
+	xrow.body->iov_len = (void *)pos - xrow.body->iov_base;
+	xrow.bodycnt = 1;
+	*written = xlog_write_row(&writer->data_xlog, &xrow);
+	if (*written < 0)
+		goto out;
+	/* Start a new bloom filter for the next partition. */
+	struct tuple_bloom_builder *builder =
+		tuple_bloom_builder_new(writer->key_def->part_count);
+	if (builder == NULL)
+		goto out;
+	tuple_bloom_builder_delete(writer->bloom);
+	writer->bloom = builder;
+	rc = 0;
+out:
+	tuple_bloom_delete(bloom);
+	return rc;
+}
+
+/**
+ * Finish the current page index partition: write info of its pages
+ * and its bloom filter to the data file in a separate transaction
+ * and release the memory they occupy.
+ * See also struct vy_page_index_part_info.
+ * @param writer Run writer.
+ *
+ * @retval -1 Memory or IO error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_end_part(struct vy_run_writer *writer)
+{
+	struct vy_run *run = writer->run;
+	uint32_t page_count = run->info.page_count -
+			      writer->part_first_page_no;
+	assert(page_count > 0);
+	if (run->info.part_count >= writer->part_info_capacity &&
+	    vy_run_alloc_part_info(run, &writer->part_info_capacity) != 0)
+		return -1;
+	struct vy_page_index_part_info *part =
+		&run->part_info[run->info.part_count];
+	memset(part, 0, sizeof(*part));
+	part->offset = writer->data_xlog.offset;
+	part->first_page_no = writer->part_first_page_no;
+	part->page_count = page_count;
+	part->min_key = vy_key_dup(run->page_info[0].min_key);
+	if (part->min_key == NULL)
+		return -1;
+	part->min_key_hint = run->page_info[0].min_key_hint;
+
+	xlog_tx_begin(&writer->data_xlog);
+	struct xrow_header xrow;
+	ssize_t written;
+	for (uint32_t i = 0; i < page_count; i++) {
+		struct vy_page_info *page = &run->page_info[i];
+		if (vy_page_info_encode(page, &xrow) != 0)
+			goto fail_rollback;
+		written = xlog_write_row(&writer->data_xlog, &xrow);
+		if (written < 0)
+			goto fail_rollback;
+		part->unpacked_size += written;
+		part->row_count += page->row_count;
+		part->bytes += page->unpacked_size;
+		part->bytes_compressed += page->size;
+	}
+	if (writer->bloom != NULL) {
+		if (vy_run_writer_write_part_bloom(writer, &written) != 0)
+			goto fail_rollback;
+		part->unpacked_size += written;
+	}
+	written = xlog_tx_commit(&writer->data_xlog);
+	if (written == 0)
+		written = xlog_flush(&writer->data_xlog);
+	if (written < 0)
+		goto fail;
+	part->size = written;
+
+	for (uint32_t i = 0; i < page_count; i++) {
+		struct vy_page_info *page = &run->page_info[i];
+		const char *min_key_end = page->min_key;
+		mp_next(&min_key_end);
+		run->page_index_size -= sizeof(struct vy_page_info);
+		run->page_index_size -= min_key_end - page->min_key;
+		vy_page_info_destroy(page);
+	}
+	const char *min_key_end = part->min_key;
+	mp_next(&min_key_end);
+	run->page_index_size += sizeof(struct vy_page_index_part_info);
+	run->page_index_size += min_key_end - part->min_key;
+	run->info.part_count++;
+	writer->part_first_page_no = run->info.page_count;
+	return 0;
+
+fail_rollback:
+	xlog_tx_rollback(&writer->data_xlog);
+fail:
+	free(part->min_key);
+	part->min_key = NULL;
+	return -1;
+}
+
 /**
  * Start a new page with a min_key stored in @a first_entry.
  * @param writer Run writer.
@@ -2174,7 +3751,16 @@ vy_run_writer_start_page(struct vy_run_writer *writer,
 			 struct vy_entry first_entry)
 {
 	struct vy_run *run = writer->run;
-	if (run->info.page_count >= writer->page_info_capacity &&
+	/*
+	 * Switch to the partitioned page index format once the run
+	 * is too big to keep all its page info in memory.
+	 */
+	if (writer->partition_page_index &&
+	    run->info.page_count - writer->part_first_page_no >=
+	    VY_PAGE_INDEX_PART_SIZE && vy_run_writer_end_part(writer) != 0)
+		return -1;
+	if (run->info.page_count - writer->part_first_page_no >=
+	    writer->page_info_capacity &&
 	    vy_run_alloc_page_info(run, &writer->page_info_capacity) != 0)
 		return -1;
 	const char *key = vy_stmt_is_key(first_entry.stmt) ?
@@ -2191,7 +3777,7 @@ vy_run_writer_start_page(struct vy_run_writer *writer,
 		if (run->info.min_key == NULL)
 			return -1;
 	}
-	struct vy_page_info *page = run->page_info + run->info.page_count;
+	struct vy_page_info *page = vy_run_writer_curr_page(writer);
 	if (vy_page_info_create(page, writer->data_xlog.offset,
 				key, writer->cmp_def) != 0)
 		return -1;
@@ -2218,7 +3804,7 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	writer->last = entry;
 	vy_stmt_ref_if_possible(entry.stmt);
 	struct vy_run *run = writer->run;
-	struct vy_page_info *page = run->page_info + run->info.page_count;
+	struct vy_page_info *page = vy_run_writer_curr_page(writer);
 	uint32_t *offset = (uint32_t *)ibuf_alloc(&writer->row_index_buf,
 						  sizeof(uint32_t));
 	if (offset == NULL) {
@@ -2227,7 +3813,8 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	}
 	*offset = page->unpacked_size;
 	if (vy_run_dump_stmt(entry, &writer->data_xlog, page,
-			     writer->cmp_def, writer->iid == 0) != 0)
+			     writer->cmp_def,
+			     writer->iid == 0 || writer->is_covering) != 0)
 		return -1;
 	int64_t lsn = vy_stmt_lsn(entry.stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
@@ -2246,7 +3833,7 @@ static int
 vy_run_writer_end_page(struct vy_run_writer *writer)
 {
 	struct vy_run *run = writer->run;
-	struct vy_page_info *page = run->page_info + run->info.page_count;
+	struct vy_page_info *page = vy_run_writer_curr_page(writer);
 
 	assert(page->row_count > 0);
 	assert(ibuf_used(&writer->row_index_buf) ==
@@ -2296,6 +3883,41 @@ vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry)
 	return rc;
 }
 
+int
+vy_run_writer_append_range_delete(struct vy_run_writer *writer,
+				  const struct vy_range_delete *rd)
+{
+	struct vy_run_info *info = &writer->run->info;
+	size_t size = (info->range_delete_count + 1) *
+		      sizeof(*info->range_deletes);
+	struct vy_range_delete *range_deletes = realloc(info->range_deletes,
+							size);
+	if (range_deletes == NULL) {
+		diag_set(OutOfMemory, size, "realloc",
+			 "struct vy_range_delete");
+		return -1;
+	}
+	info->range_deletes = range_deletes;
+	struct vy_range_delete *copy = &range_deletes[info->range_delete_count];
+	rlist_create(&copy->in_mem);
+	copy->begin = vy_key_dup(rd->begin);
+	if (copy->begin == NULL)
+		return -1;
+	copy->end = NULL;
+	if (rd->end != NULL) {
+		copy->end = vy_key_dup(rd->end);
+		if (copy->end == NULL) {
+			free((char *)copy->begin);
+			return -1;
+		}
+	}
+	copy->lsn = rd->lsn;
+	info->range_delete_count++;
+	info->min_lsn = MIN(info->min_lsn, rd->lsn);
+	info->max_lsn = MAX(info->max_lsn, rd->lsn);
+	return 0;
+}
+
 /**
  * Destroy a run writer.
  * @param writer Writer to destroy.
@@ -2325,21 +3947,45 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 		goto out;
 
 	struct vy_run *run = writer->run;
+	if (vy_run_is_partitioned(run)) {
+		/* Flush the remaining pages to the last partition. */
+		if (vy_run_writer_end_part(writer) != 0)
+			goto out;
+		free(run->page_info);
+		run->page_info = NULL;
+	}
 	if (vy_run_is_empty(run)) {
 		vy_run_writer_destroy(writer, false);
 		rc = 0;
 		goto out;
 	}
 
-	assert(writer->last.stmt != NULL);
-	const char *key = vy_stmt_is_key(writer->last.stmt) ?
-		          tuple_data(writer->last.stmt) :
-			  tuple_extract_key(writer->last.stmt, writer->cmp_def,
-					    vy_entry_multikey_idx(writer->last,
-								  writer->cmp_def),
-					    NULL);
-	if (key == NULL)
-		goto out;
+	const char *key;
+	if (run->info.page_count == 0) {
+		/*
+		 * The run stores only range deletes. It doesn't have
+		 * a data page so use empty keys for its boundaries.
+		 */
+		static const char empty_key[] = { (char)0x90 };
+		if (!xlog_is_open(&writer->data_xlog) &&
+		    vy_run_writer_create_xlog(writer) != 0)
+			goto out;
+		assert(run->info.min_key == NULL);
+		run->info.min_key = vy_key_dup(empty_key);
+		if (run->info.min_key == NULL)
+			goto out;
+		key = empty_key;
+	} else {
+		assert(writer->last.stmt != NULL);
+		key = vy_stmt_is_key(writer->last.stmt) ?
+		      tuple_data(writer->last.stmt) :
+		      tuple_extract_key(writer->last.stmt, writer->cmp_def,
+					vy_entry_multikey_idx(writer->last,
+							      writer->cmp_def),
+					NULL);
+		if (key == NULL)
+			goto out;
+	}
 
 	assert(run->info.max_key == NULL);
 	run->info.max_key = vy_key_dup(key);
@@ -2356,7 +4002,8 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	    xlog_rename(&writer->data_xlog) < 0)
 		goto out;
 
-	if (writer->bloom != NULL) {
+	if (writer->bloom != NULL && !vy_run_is_partitioned(run) &&
+	    run->info.page_count > 0) {
 		run->info.bloom = tuple_bloom_new(writer->bloom,
 						  writer->bloom_fpr);
 		if (run->info.bloom == NULL)
@@ -2428,9 +4075,19 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		uint32_t page_row_count = 0;
 		uint64_t page_row_index_offset = 0;
 		uint64_t row_offset = xlog_cursor_tx_pos(&cursor);
+		bool is_page_index_part = false;
 
 		struct xrow_header xrow;
 		while ((rc = xlog_cursor_next_row(&cursor, &xrow)) == 0) {
+			/*
+			 * Skip page index partitions, the index is
+			 * rebuilt in the classic format.
+			 */
+			if (xrow.type == VY_INDEX_PAGE_INFO ||
+			    xrow.type == VY_RUN_PART_BLOOM) {
+				is_page_index_part = true;
+				continue;
+			}
 			if (xrow.type == VY_RUN_ROW_INDEX) {
 				page_row_index_offset = row_offset;
 				row_offset = xlog_cursor_tx_pos(&cursor);
@@ -2472,6 +4129,8 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 				min_lsn = xrow.lsn;
 			row_offset = xlog_cursor_tx_pos(&cursor);
 		}
+		if (is_page_index_part)
+			continue;
 		struct vy_page_info *info;
 		info = run->page_info + run->info.page_count;
 		if (vy_page_info_create(info, page_offset,
@@ -2580,6 +4239,56 @@ vy_run_remove_files(const char *dir, uint32_t space_id,
 	return ret;
 }
 
+/**
+ * Load a page index partition of the run read by a slice stream.
+ * Slice streams are used by dump and compaction tasks, which run
+ * in worker threads, so partitions are read synchronously and
+ * bypass the page index cache.
+ */
+static struct vy_page_index_part *
+vy_slice_stream_load_part(struct vy_slice_stream *stream, uint32_t part_no)
+{
+	if (stream->part != NULL && stream->part->part_no == part_no)
+		return stream->part;
+	struct vy_run *run = stream->slice->run;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(run->env);
+	if (zdctx == NULL)
+		return NULL;
+	struct vy_page_index_part *part =
+		vy_page_index_part_read(run, part_no, stream->cmp_def, zdctx);
+	if (part == NULL)
+		return NULL;
+	if (stream->part != NULL)
+		vy_page_index_part_unref(stream->part);
+	stream->part = part;
+	return part;
+}
+
+/** vy_page_index_part_get_f callback for slice stream. */
+static struct vy_page_index_part *
+vy_slice_stream_get_part_cb(void *arg, uint32_t part_no)
+{
+	return vy_slice_stream_load_part(arg, part_no);
+}
+
+/**
+ * Return info about a page of the run read by a slice stream.
+ * Returns NULL on error.
+ */
+static struct vy_page_info *
+vy_slice_stream_page_info(struct vy_slice_stream *stream, uint32_t page_no)
+{
+	struct vy_run *run = stream->slice->run;
+	if (!vy_run_is_partitioned(run))
+		return vy_run_page_info(run, page_no);
+	uint32_t part_no = vy_run_page_part_no(run, page_no);
+	struct vy_page_index_part *part =
+		vy_slice_stream_load_part(stream, part_no);
+	if (part == NULL)
+		return NULL;
+	return &part->page_info[page_no - run->part_info[part_no].first_page_no];
+}
+
 /**
  * Read a page with stream->page_no from the run and save it in stream->page.
  * Support function of slice stream.
@@ -2596,7 +4305,10 @@ vy_slice_stream_read_page(struct vy_slice_stream *stream)
 	if (zdctx == NULL)
 		return -1;
 
-	struct vy_page_info *page_info = vy_run_page_info(run, stream->page_no);
+	struct vy_page_info *page_info = vy_slice_stream_page_info(stream,
+							stream->page_no);
+	if (page_info == NULL)
+		return -1;
 	stream->page = vy_page_new(page_info);
 	if (stream->page == NULL)
 		return -1;
@@ -2621,6 +4333,11 @@ vy_slice_stream_search(struct vy_stmt_stream *virt_stream)
 	assert(virt_stream->iface->start == vy_slice_stream_search);
 	struct vy_slice_stream *stream = (struct vy_slice_stream *)virt_stream;
 	assert(stream->page == NULL);
+	if (stream->slice->run->info.page_count == 0) {
+		/* The run stores only range deletes. */
+		stream->page_no = stream->slice->last_page_no + 1;
+		return 0;
+	}
 	if (stream->slice->begin.stmt == NULL) {
 		/* Already at the beginning */
 		assert(stream->page_no == 0);
@@ -2628,6 +4345,27 @@ vy_slice_stream_search(struct vy_stmt_stream *virt_stream)
 		return 0;
 	}
 
+	struct vy_run *run = stream->slice->run;
+	if (vy_run_is_partitioned(run)) {
+		/*
+		 * Boundaries of a slice of a partitioned run are
+		 * rounded to partitions, see vy_slice_new(), so look
+		 * up the first page of the slice.
+		 */
+		bool equal_key;
+		if (vy_page_index_find_page(run, stream->slice->begin,
+					    stream->cmp_def, ITER_GE,
+					    vy_slice_stream_get_part_cb,
+					    stream, &stream->page_no,
+					    &equal_key) != 0)
+			return -1;
+		if (stream->page_no >= run->info.page_count) {
+			/* The slice is empty. */
+			stream->page_no = stream->slice->last_page_no + 1;
+			return 0;
+		}
+	}
+
 	if (vy_slice_stream_read_page(stream) != 0)
 		return -1;
 
@@ -2676,9 +4414,14 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct vy_entry *ret)
 	if (entry.stmt == NULL) /* Read or memory error */
 		return -1;
 
-	/* Check that the tuple is not out of slice bounds = */
+	/*
+	 * Check that the tuple is not out of slice bounds. The last
+	 * page of a slice of a partitioned run is rounded up to the
+	 * partition boundary so the check is needed for all pages.
+	 */
 	if (stream->slice->end.stmt != NULL &&
-	    stream->page_no >= stream->slice->last_page_no &&
+	    (stream->page_no >= stream->slice->last_page_no ||
+	     vy_run_is_partitioned(stream->slice->run)) &&
 	    vy_entry_compare(entry, stream->slice->end, stream->cmp_def) >= 0) {
 		tuple_unref(entry.stmt);
 		return 0;
@@ -2694,9 +4437,7 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct vy_entry *ret)
 	stream->pos_in_page++;
 
 	/* Check whether the position is out of page */
-	struct vy_page_info *page_info = vy_run_page_info(stream->slice->run,
-							  stream->page_no);
-	if (stream->pos_in_page >= page_info->row_count) {
+	if (stream->pos_in_page >= stream->page->row_count) {
 		/**
 		 * Out of page. Free page, move the position to the next page
 		 * and * nullify page pointer to read it on the next iteration.
@@ -2722,6 +4463,10 @@ vy_slice_stream_stop(struct vy_stmt_stream *virt_stream)
 		vy_page_delete(stream->page);
 		stream->page = NULL;
 	}
+	if (stream->part != NULL) {
+		vy_page_index_part_unref(stream->part);
+		stream->part = NULL;
+	}
 	if (stream->entry.stmt != NULL) {
 		tuple_unref(stream->entry.stmt);
 		stream->entry = vy_entry_none();
@@ -2752,6 +4497,7 @@ vy_slice_stream_open(struct vy_slice_stream *stream, struct vy_slice *slice,
 	stream->page_no = slice->first_page_no;
 	stream->pos_in_page = 0; /* We'll find it later */
 	stream->page = NULL;
+	stream->part = NULL;
 	stream->entry = vy_entry_none();
 
 	stream->slice = slice;
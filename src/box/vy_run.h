@@ -50,12 +50,88 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct vy_history;
+struct vy_range_delete;
 struct vy_run_reader;
+struct mh_vy_page_cache_t;
+struct mh_vy_page_index_cache_t;
+
+/**
+ * Max number of pages in a page index partition. Runs that have
+ * more pages are written with a partitioned page index, see
+ * struct vy_page_index_part_info.
+ */
+enum { VY_PAGE_INDEX_PART_SIZE = 128 };
+
+/** Page cache and page index cache statistics. */
+struct vy_page_cache_stat {
+	/** Number of lookups. */
+	int64_t lookup;
+	/** Number of lookups that found an entry in the cache. */
+	int64_t hit;
+	/** Number of entries added to the cache. */
+	int64_t put;
+	/** Number of entries evicted from the cache. */
+	int64_t evict;
+};
+
+/**
+ * Cache of pages read from run files, shared by all runs.
+ *
+ * Pages are stored decompressed, along with their row index, so
+ * a cache hit saves not only disk IO, but also decompression.
+ * Pages are keyed by run id and page number. Since run ids are
+ * never reused, pages of deleted runs aren't removed from the cache
+ * explicitly - they just go to the end of the LRU list and get
+ * evicted. The cache is only accessed from the tx thread.
+ */
+struct vy_page_cache {
+	/** (run id, page number) -> struct vy_page. */
+	struct mh_vy_page_cache_t *pages;
+	/** LRU list of cached pages. The first element is the newest. */
+	struct rlist lru;
+	/** Size of memory occupied by cached pages. */
+	size_t mem_used;
+	/** Max memory size that can be used for cache. */
+	size_t mem_quota;
+	/** Cache statistics. */
+	struct vy_page_cache_stat stat;
+};
+
+/**
+ * Cache of page index partitions read from run files, shared by
+ * all runs. Works exactly like the page cache, but stores
+ * struct vy_page_index_part keyed by run id and partition number.
+ */
+struct vy_page_index_cache {
+	/** (run id, partition number) -> struct vy_page_index_part. */
+	struct mh_vy_page_index_cache_t *parts;
+	/** LRU list of cached partitions. The first one is the newest. */
+	struct rlist lru;
+	/** Size of memory occupied by cached partitions. */
+	size_t mem_used;
+	/** Max memory size that can be used for cache. */
+	size_t mem_quota;
+	/** Cache statistics. */
+	struct vy_page_cache_stat stat;
+};
 
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
 	/** Write rate limit, in bytes per second. */
 	uint64_t snap_io_rate_limit;
+	/**
+	 * Total write rate limit of compaction tasks, in bytes per
+	 * second, shared evenly among compaction threads. Zero if
+	 * compaction isn't limited (apart from snap_io_rate_limit).
+	 */
+	uint64_t compaction_io_rate_limit;
+	/**
+	 * If set, page index of runs that have more than
+	 * VY_PAGE_INDEX_PART_SIZE pages is written partitioned.
+	 * Disabled by default, because older versions can't read
+	 * such runs.
+	 */
+	bool partition_page_index;
 	/** Mempool for struct vy_page_read_task */
 	struct mempool read_task_pool;
 	/** Key for thread-local ZSTD context */
@@ -74,6 +150,10 @@ struct vy_run_env {
 	 * unconditionally remove unused runs' files in-place.
 	 */
 	bool initial_join;
+	/** Cache of decompressed pages. */
+	struct vy_page_cache page_cache;
+	/** Cache of page index partitions. */
+	struct vy_page_index_cache page_index_cache;
 };
 
 /**
@@ -90,10 +170,34 @@ struct vy_run_info {
 	int64_t max_lsn;
 	/** Number of pages in the run. */
 	uint32_t page_count;
-	/** Bloom filter of all tuples in run */
+	/**
+	 * Number of page index partitions in the run or 0 if
+	 * the page index isn't partitioned.
+	 */
+	uint32_t part_count;
+	/**
+	 * Bloom filter of all tuples in run. NULL if the page
+	 * index is partitioned, because in this case each
+	 * partition has its own bloom filter.
+	 */
 	struct tuple_bloom *bloom;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
+	/**
+	 * Range deletes stored in the run. Range boundaries are
+	 * allocated with malloc(). Note, a run may store range
+	 * deletes without any statements (page_count is 0).
+	 */
+	struct vy_range_delete *range_deletes;
+	/** Number of entries in the range_deletes array. */
+	uint32_t range_delete_count;
+	/**
+	 * Time when the newest data stored in the run was dumped,
+	 * in seconds since the Epoch, or 0 if unknown (the run was
+	 * created by an older version). Used by the time-window
+	 * compaction policy.
+	 */
+	uint64_t max_time;
 };
 
 /**
@@ -116,6 +220,42 @@ struct vy_page_info {
 	uint32_t row_index_offset;
 };
 
+/**
+ * Page index partition metadata.
+ *
+ * Keeping the whole page index and bloom filter of a huge run in
+ * memory is expensive so if a run has more than
+ * VY_PAGE_INDEX_PART_SIZE pages, its page index is partitioned:
+ * info about each VY_PAGE_INDEX_PART_SIZE pages, along with the
+ * bloom filter of keys stored in them, is written to the run file
+ * as a separate xlog tx right after the pages. The index file only
+ * stores info about partitions, which is small enough to be kept
+ * in memory. Partitions are loaded on demand and stored in the page
+ * index cache, see struct vy_page_index_cache.
+ */
+struct vy_page_index_part_info {
+	/** Offset of partition data in the run file. */
+	uint64_t offset;
+	/** Size of partition data in the run file. */
+	uint32_t size;
+	/** Size of partition data in memory, i.e. unpacked. */
+	uint32_t unpacked_size;
+	/** Number of the first page in the partition. */
+	uint32_t first_page_no;
+	/** Number of pages in the partition. */
+	uint32_t page_count;
+	/** Min key of the first page in the partition. */
+	char *min_key;
+	/** Comparison hint of the min key. */
+	hint_t min_key_hint;
+	/** Number of statements in the partition pages. */
+	uint64_t row_count;
+	/** Size of the partition pages in memory. */
+	uint64_t bytes;
+	/** Size of the partition pages in the run file. */
+	uint64_t bytes_compressed;
+};
+
 /**
  * Logical unit of vinyl index - a sorted file with data.
  */
@@ -124,8 +264,16 @@ struct vy_run {
 	struct vy_run_env *env;
 	/** Info about the run stored in the index file. */
 	struct vy_run_info info;
-	/** Info about the run pages stored in the index file. */
+	/**
+	 * Info about the run pages stored in the index file.
+	 * NULL if the page index is partitioned.
+	 */
 	struct vy_page_info *page_info;
+	/**
+	 * Info about the run page index partitions stored in
+	 * the index file. NULL if the page index isn't partitioned.
+	 */
+	struct vy_page_index_part_info *part_info;
 	/** Run data file. */
 	int fd;
 	/** Unique ID of this run. */
@@ -216,7 +364,10 @@ struct vy_slice {
 	};
 	/**
 	 * Indexes of the first and the last page in the run
-	 * that belong to this slice.
+	 * that belong to this slice. If the page index of the run
+	 * is partitioned, they are rounded to partition boundaries
+	 * so the slice may actually start after the first page and
+	 * end before the last page.
 	 */
 	uint32_t first_page_no;
 	uint32_t last_page_no;
@@ -265,6 +416,13 @@ struct vy_run_iterator {
 	 * GE, LT to LE for beauty.
 	 */
 	enum iterator_type iterator_type;
+	/**
+	 * Set if the iterator was requested to return only keys
+	 * equal to the search key (ITER_EQ or ITER_REQ). Used for
+	 * checking bloom filters, because ITER_REQ is converted to
+	 * ITER_LE on open.
+	 */
+	bool is_eq;
 	/** Key to search. */
 	struct vy_entry key;
 	/* LSN visibility, iterator shows values with lsn <= vlsn */
@@ -284,16 +442,34 @@ struct vy_run_iterator {
 	 */
 	struct vy_page *curr_page;
 	struct vy_page *prev_page;
+	/**
+	 * Page index partition that was accessed last if the page
+	 * index of the run is partitioned.
+	 */
+	struct vy_page_index_part *curr_part;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
+	/** Set if the bloom filter allowed to skip the lookup. */
+	bool is_bloom_hit;
 };
 
 /**
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/** ID of the run the page belongs to. */
+	int64_t run_id;
 	/** Page position in the run file. */
 	uint32_t page_no;
+	/**
+	 * Reference counter. A page is referenced by run iterators
+	 * that use it and by the page cache.
+	 */
+	int refs;
+	/** Set if the page is stored in the page cache. */
+	bool is_cached;
+	/** Link in vy_page_cache::lru. */
+	struct rlist in_lru;
 	/** Size of page data in memory, i.e. unpacked. */
 	uint32_t unpacked_size;
 	/** Number of statements in the page. */
@@ -304,6 +480,34 @@ struct vy_page {
 	char *data;
 };
 
+/**
+ * Page index partition loaded from a run file.
+ */
+struct vy_page_index_part {
+	/** ID of the run the partition belongs to. */
+	int64_t run_id;
+	/** Partition number in the run. */
+	uint32_t part_no;
+	/**
+	 * Reference counter. A partition is referenced by run
+	 * iterators and slice streams that use it and by the page
+	 * index cache.
+	 */
+	int refs;
+	/** Set if the partition is stored in the page index cache. */
+	bool is_cached;
+	/** Link in vy_page_index_cache::lru. */
+	struct rlist in_lru;
+	/** Size of memory used by the partition. */
+	size_t mem_used;
+	/** Number of pages in the partition. */
+	uint32_t page_count;
+	/** Info about the partition pages. */
+	struct vy_page_info *page_info;
+	/** Bloom filter of keys stored in the partition or NULL. */
+	struct tuple_bloom *bloom;
+};
+
 /**
  * Initialize vinyl run environment
  *
@@ -320,6 +524,20 @@ vy_run_env_create(struct vy_run_env *env, int read_threads);
 void
 vy_run_env_destroy(struct vy_run_env *env);
 
+/**
+ * Set memory limit for the page cache. Pages are evicted until
+ * the cache fits in the new limit. Zero disables the cache.
+ */
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota);
+
+/**
+ * Set memory limit for the page index cache. Partitions are evicted
+ * until the cache fits in the new limit.
+ */
+void
+vy_run_env_set_page_index_cache_quota(struct vy_run_env *env, size_t quota);
+
 /**
  * Enable coio reads for a vinyl run environment.
  *
@@ -341,19 +559,52 @@ vy_run_env_enable_coio(struct vy_run_env *env);
 size_t
 vy_run_bloom_size(struct vy_run *run);
 
+/** Return true if the page index of a run is partitioned. */
+static inline bool
+vy_run_is_partitioned(struct vy_run *run)
+{
+	return run->info.part_count > 0;
+}
+
+/**
+ * Return info about a run page. Must not be called if the page
+ * index of the run is partitioned.
+ */
 static inline struct vy_page_info *
 vy_run_page_info(struct vy_run *run, uint32_t pos)
 {
+	assert(!vy_run_is_partitioned(run));
 	assert(pos < run->info.page_count);
 	return &run->page_info[pos];
 }
 
+/**
+ * Return the min key of a run page. If the page index of the run
+ * is partitioned, return the min key of the partition containing
+ * the page instead, which doesn't require loading the partition.
+ */
+const char *
+vy_run_page_min_key(struct vy_run *run, uint32_t page_no, hint_t *hint);
+
+/**
+ * Return true if the run stores neither statements nor range
+ * deletes and hence may be discarded.
+ */
 static inline bool
 vy_run_is_empty(struct vy_run *run)
 {
-	return run->info.page_count == 0;
+	return run->info.page_count == 0 && run->info.range_delete_count == 0;
 }
 
+/**
+ * Return the max LSN of range deletes stored in the run that
+ * cover the given key and are visible from the given read view
+ * or -1 if there are no such range deletes.
+ */
+int64_t
+vy_run_range_delete_lsn(struct vy_run *run, const struct vy_read_view *rv,
+			struct vy_entry entry, struct key_def *cmp_def);
+
 struct vy_run *
 vy_run_new(struct vy_run_env *env, int64_t id);
 
@@ -575,6 +826,8 @@ struct vy_slice_stream {
 	uint32_t pos_in_page;
 	/** Last page read */
 	struct vy_page *page;
+	/** Last page index partition read or NULL. */
+	struct vy_page_index_part *part;
 	/** The last tuple returned to user */
 	struct vy_entry entry;
 
@@ -627,13 +880,42 @@ struct vy_run_writer {
 	 * Current page info capacity. Can grow with page number.
 	 */
 	uint32_t page_info_capacity;
+	/** Current page index partition info capacity. */
+	uint32_t part_info_capacity;
+	/**
+	 * Number of the first page of the current page index
+	 * partition. Only pages of the current partition are
+	 * stored in vy_run::page_info.
+	 */
+	uint32_t part_first_page_no;
 	/** Don't use compression while writing xlog files. */
 	bool no_compression;
+	/**
+	 * Write the partitioned page index format if the run is
+	 * large enough. Set to vy_run_env::partition_page_index.
+	 */
+	bool partition_page_index;
+	/** Dictionary used for compression of pages or NULL. */
+	struct tt_compression_dict *compression_dict;
+	/**
+	 * Rate limit for writing the run data file, in bytes per
+	 * second, 0 if unlimited. Set to vy_run_env::snap_io_rate_limit
+	 * by default.
+	 */
+	uint64_t rate_limit;
+	/**
+	 * Set if the run belongs to a covering secondary index
+	 * and so stores full tuples rather than extended keys.
+	 */
+	bool is_covering;
 	/** Xlog to write data. */
 	struct xlog data_xlog;
 	/** Bloom filter false positive rate. */
 	double bloom_fpr;
-	/** Bloom filter. */
+	/**
+	 * Bloom filter of the run or, if the page index is
+	 * partitioned, of the current partition.
+	 */
 	struct tuple_bloom_builder *bloom;
 	/** Buffer of a current page row offsets. */
 	struct ibuf row_index_buf;
@@ -644,12 +926,17 @@ struct vy_run_writer {
 	struct vy_entry last;
 };
 
-/** Create a run writer to fill a run with statements. */
+/**
+ * Create a run writer to fill a run with statements. If
+ * @a compression_dict isn't NULL, it's used for compression of
+ * pages unless @a no_compression is set.
+ */
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     uint64_t page_size, double bloom_fpr, bool no_compression,
+		     struct tt_compression_dict *compression_dict);
 
 /**
  * Write a specified statement into a run.
@@ -662,6 +949,20 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 int
 vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry);
 
+/**
+ * Write a range delete into a run. Range deletes are stored in
+ * the run info so they can be appended in any order relative to
+ * statements.
+ * @param writer Writer to write a range delete.
+ * @param rd Range delete to write.
+ *
+ * @retval -1 Memory error.
+ * @retval  0 Success.
+ */
+int
+vy_run_writer_append_range_delete(struct vy_run_writer *writer,
+				  const struct vy_range_delete *rd);
+
 /**
  * Finalize run writing by writing run index into file. The writer
  * is deleted after call.
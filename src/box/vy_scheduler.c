@@ -45,6 +45,8 @@
 #include "fiber.h"
 #include "fiber_cond.h"
 #include "cbus.h"
+#include "clock.h"
+#include "compression_dict.h"
 #include "salad/stailq.h"
 #include "say.h"
 #include "txn.h"
@@ -198,6 +200,35 @@ struct vy_task {
 	 * need to remember the slices we are compacting.
 	 */
 	struct vy_slice *first_slice, *last_slice;
+	/**
+	 * Compaction of a big range may be split in parts by key
+	 * so that it can be executed by several worker threads in
+	 * parallel (subcompaction). In this case the task compacts
+	 * the first part while the rest of the parts are compacted
+	 * by subtasks. The result of all parts is committed by the
+	 * parent task, see vy_task_subcompaction_complete().
+	 */
+	struct vy_task **subtasks;
+	/** Number of entries in the subtasks array. */
+	int subtask_count;
+	/** Number of subtasks that haven't been executed yet. */
+	int subtasks_in_progress;
+	/** Task this task is a subtask of or NULL. */
+	struct vy_task *parent;
+	/** Set when the task has been executed by a worker. */
+	bool is_executed;
+	/**
+	 * Boundaries of the part of the range compacted by this
+	 * task in case of subcompaction, none otherwise.
+	 */
+	struct vy_entry part_begin, part_end;
+	/**
+	 * Slices of the compacted runs cut to the part boundaries
+	 * in case of subcompaction, linked by vy_slice::in_range.
+	 * They are only used by the write iterator so they are
+	 * never committed to vylog.
+	 */
+	struct rlist part_slices;
 	/**
 	 * Index options may be modified while a task is in
 	 * progress so we save them here to safely access them
@@ -205,6 +236,18 @@ struct vy_task {
 	 */
 	double bloom_fpr;
 	int64_t page_size;
+	bool is_covering;
+	/**
+	 * Max rate at which the task may write the new run, in bytes
+	 * per second, 0 if unlimited (apart from snap_io_rate_limit).
+	 */
+	uint64_t rate_limit;
+	/**
+	 * Dictionary used for compression of the new run or NULL.
+	 * Dictionaries are never freed so it's safe to access it
+	 * from another thread.
+	 */
+	struct tt_compression_dict *compression_dict;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -250,9 +293,13 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->lsm = lsm;
 	task->cmp_def = key_def_dup(lsm->cmp_def);
 	task->key_def = key_def_dup(lsm->key_def);
+	task->compression_dict = compression_dict_get(lsm->space_id);
 	vy_lsm_ref(lsm);
 	diag_create(&task->diag);
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
+	task->part_begin = vy_entry_none();
+	task->part_end = vy_entry_none();
+	rlist_create(&task->part_slices);
 	return task;
 }
 
@@ -262,6 +309,14 @@ vy_task_delete(struct vy_task *task)
 {
 	assert(task->deferred_delete_batch == NULL);
 	assert(task->deferred_delete_in_progress == 0);
+	assert(rlist_empty(&task->part_slices));
+	for (int i = 0; i < task->subtask_count; i++)
+		vy_task_delete(task->subtasks[i]);
+	free(task->subtasks);
+	if (task->part_begin.stmt != NULL)
+		tuple_unref(task->part_begin.stmt);
+	if (task->part_end.stmt != NULL)
+		tuple_unref(task->part_end.stmt);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	vy_lsm_unref(task->lsm);
@@ -310,9 +365,10 @@ vy_compaction_heap_less(struct vy_lsm *i1, struct vy_lsm *i2)
 {
 	/*
 	 * Prefer LSM trees whose read amplification will be reduced
-	 * most as a result of compaction.
+	 * most as a result of compaction, taking into account how
+	 * hot they are for reads.
 	 */
-	return vy_lsm_compaction_priority(i1) > vy_lsm_compaction_priority(i2);
+	return vy_lsm_compaction_score(i1) > vy_lsm_compaction_score(i2);
 }
 
 #define HEAP_NAME vy_compaction_heap
@@ -1068,8 +1124,12 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 lsm->space_id, lsm->index_id,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
-				 no_compression) != 0)
+				 no_compression, task->compression_dict) != 0)
 		goto fail;
+	if (task->rate_limit > 0 &&
+	    (writer.rate_limit == 0 || writer.rate_limit > task->rate_limit))
+		writer.rate_limit = task->rate_limit;
+	writer.is_covering = task->is_covering;
 
 	if (wi->iface->start(wi) != 0)
 		goto fail_abort_writer;
@@ -1094,6 +1154,10 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 			break;
 		}
 	}
+	const struct vy_range_delete *rd;
+	while (rc == 0 &&
+	       (rd = vy_write_iterator_next_range_delete(wi)) != NULL)
+		rc = vy_run_writer_append_range_delete(&writer, rd);
 	wi->iface->stop(wi);
 
 	if (rc == 0)
@@ -1157,11 +1221,18 @@ vy_task_dump_complete(struct vy_task *task)
 
 	/*
 	 * Figure out which ranges intersect the new run.
+	 * Range deletes may cover keys of any range so a run
+	 * storing them is added to all ranges.
 	 */
-	if (vy_lsm_find_range_intersection(lsm, new_run->info.min_key,
-					   new_run->info.max_key,
-					   &begin_range, &end_range) != 0)
+	if (new_run->info.range_delete_count > 0) {
+		begin_range = vy_range_tree_first(&lsm->range_tree);
+		end_range = NULL;
+	} else if (vy_lsm_find_range_intersection(lsm, new_run->info.min_key,
+						  new_run->info.max_key,
+						  &begin_range,
+						  &end_range) != 0) {
 		goto fail;
+	}
 
 	/*
 	 * For each intersected range allocate a slice of the new run.
@@ -1345,9 +1416,9 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		if (mem->generation > scheduler->dump_generation)
 			continue;
 		vy_mem_wait_pinned(mem);
-		if (vy_mem_tree_size(&mem->tree) == 0) {
+		if (vy_mem_is_empty(mem)) {
 			/*
-			 * The tree is empty so we can delete it
+			 * The mem is empty so we can delete it
 			 * right away, without involving a worker.
 			 */
 			vy_lsm_delete_mem(lsm, mem);
@@ -1373,6 +1444,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 
 	new_run->dump_count = 1;
 	new_run->dump_lsn = dump_lsn;
+	new_run->info.max_time = clock_realtime();
 
 	/*
 	 * Note, since deferred DELETE are generated on tx commit
@@ -1397,6 +1469,16 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->is_covering = lsm->opts.covering;
+
+	if (lsm->opts.compaction_policy == COMPACTION_POLICY_TIME_WINDOW) {
+		/*
+		 * The new run may start a new time window, after which
+		 * runs of the previous window can't be compacted apart
+		 * from it. Let them be compacted along with the dump.
+		 */
+		vy_lsm_update_compaction_priority(lsm);
+	}
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1431,6 +1513,48 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	return -1;
 }
 
+/**
+ * Max number of parts compaction of a range may be split in,
+ * see vy_task_subcompaction_new().
+ */
+enum { VY_SUBCOMPACTION_MAX_PARTS = 8 };
+
+/** Set the boundaries of the range part compacted by a task. */
+static void
+vy_task_set_part(struct vy_task *task, struct vy_entry begin,
+		 struct vy_entry end)
+{
+	assert(task->part_begin.stmt == NULL);
+	assert(task->part_end.stmt == NULL);
+	if (begin.stmt != NULL)
+		tuple_ref(begin.stmt);
+	if (end.stmt != NULL)
+		tuple_ref(end.stmt);
+	task->part_begin = begin;
+	task->part_end = end;
+}
+
+/**
+ * Close the write iterators of a compaction task and its subtasks
+ * and delete the slices created for them. Note, the iterators
+ * have already been cleaned up in workers.
+ */
+static void
+vy_task_compaction_close_wi(struct vy_task *task)
+{
+	if (task->wi != NULL) {
+		task->wi->iface->close(task->wi);
+		task->wi = NULL;
+	}
+	struct vy_slice *slice, *next_slice;
+	rlist_foreach_entry_safe(slice, &task->part_slices, in_range,
+				 next_slice)
+		vy_slice_delete(slice);
+	rlist_create(&task->part_slices);
+	for (int i = 0; i < task->subtask_count; i++)
+		vy_task_compaction_close_wi(task->subtasks[i]);
+}
+
 static int
 vy_task_compaction_execute(struct vy_task *task)
 {
@@ -1438,6 +1562,226 @@ vy_task_compaction_execute(struct vy_task *task)
 	return vy_task_write_run(task, false);
 }
 
+/**
+ * Complete compaction of a range that was split in parts, see
+ * vy_task_subcompaction_new(). The compacted range is replaced
+ * with new ranges, one per part. Each of them stores the run
+ * written for the part and slices of the runs that weren't
+ * compacted cut to the part boundaries, like the ranges created
+ * by vy_lsm_split_range(). All changes are committed to vylog
+ * in one transaction.
+ */
+static int
+vy_task_subcompaction_complete(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	double compaction_time = ev_monotonic_now(loop()) - task->start_time;
+	struct vy_disk_stmt_counter compaction_output;
+	struct vy_disk_stmt_counter compaction_input;
+	struct vy_slice *first_slice = task->first_slice;
+	struct vy_slice *last_slice = task->last_slice;
+	struct vy_slice *slice, *new_slice;
+	struct vy_run *run, *new_run;
+	struct vy_range *part;
+
+	int part_count = task->subtask_count + 1;
+	assert(part_count <= VY_SUBCOMPACTION_MAX_PARTS);
+	struct vy_task *part_tasks[VY_SUBCOMPACTION_MAX_PARTS];
+	struct vy_range *parts[VY_SUBCOMPACTION_MAX_PARTS];
+	part_tasks[0] = task;
+	for (int i = 1; i < part_count; i++)
+		part_tasks[i] = task->subtasks[i - 1];
+	memset(parts, 0, sizeof(parts));
+
+	/*
+	 * Part slices reference the compacted runs so we must
+	 * delete them before looking for unused runs.
+	 */
+	vy_task_compaction_close_wi(task);
+
+	/* See the comment in vy_task_compaction_complete(). */
+	if (lsm->is_dropped) {
+		for (int i = 0; i < part_count; i++)
+			vy_run_unref(part_tasks[i]->new_run);
+		assert(heap_node_is_stray(&range->heap_node));
+		vy_range_heap_insert(&lsm->range_heap, range);
+		vy_scheduler_update_lsm(scheduler, lsm);
+		return 0;
+	}
+
+	/*
+	 * Build the list of runs that became unused
+	 * as a result of compaction.
+	 */
+	RLIST_HEAD(unused_runs);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		slice->run->compacted_slice_count++;
+		if (slice == last_slice)
+			break;
+	}
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		run = slice->run;
+		if (run->compacted_slice_count == run->slice_count)
+			rlist_add_entry(&unused_runs, run, in_unused);
+		slice->run->compacted_slice_count = 0;
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Allocate new ranges. The compacted slices are replaced
+	 * with a slice of the run written for the part while the
+	 * rest of the slices are cut to the part boundaries.
+	 */
+	for (int i = 0; i < part_count; i++) {
+		struct vy_task *part_task = part_tasks[i];
+		new_run = part_task->new_run;
+		part = vy_range_new(vy_log_next_id(), part_task->part_begin,
+				    part_task->part_end, lsm->cmp_def);
+		if (part == NULL)
+			goto fail;
+		parts[i] = part;
+		/*
+		 * vy_range_add_slice() adds a slice to the list head,
+		 * so to preserve the order of the slices list, we have
+		 * to iterate backward.
+		 */
+		bool is_compacted = false;
+		rlist_foreach_entry_reverse(slice, &range->slices, in_range) {
+			if (slice == last_slice)
+				is_compacted = true;
+			if (!is_compacted) {
+				if (vy_slice_cut(slice, vy_log_next_id(),
+						 part->begin, part->end,
+						 lsm->cmp_def, &new_slice) != 0)
+					goto fail;
+				if (new_slice != NULL)
+					vy_range_add_slice(part, new_slice);
+				continue;
+			}
+			if (slice != first_slice)
+				continue;
+			is_compacted = false;
+			if (vy_run_is_empty(new_run))
+				continue;
+			new_slice = vy_slice_new(vy_log_next_id(), new_run,
+						 vy_entry_none(),
+						 vy_entry_none(),
+						 lsm->cmp_def);
+			if (new_slice == NULL)
+				goto fail;
+			vy_range_add_slice(part, new_slice);
+		}
+		part->n_compactions = range->n_compactions + 1;
+		part->needs_compaction = range->needs_compaction;
+		vy_range_update_compaction_priority(part, &lsm->opts);
+		vy_range_update_dumps_per_compaction(part);
+	}
+
+	/*
+	 * Log change in metadata.
+	 */
+	vy_log_tx_begin();
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	for (int i = 0; i < part_count; i++) {
+		new_run = part_tasks[i]->new_run;
+		if (!vy_run_is_empty(new_run))
+			vy_log_create_run(lsm->id, new_run->id,
+					  new_run->dump_lsn,
+					  new_run->dump_count);
+	}
+	for (int i = 0; i < part_count; i++) {
+		part = parts[i];
+		vy_log_insert_range(lsm->id, part->id,
+				    tuple_data_or_null(part->begin.stmt),
+				    tuple_data_or_null(part->end.stmt));
+		rlist_foreach_entry(slice, &part->slices, in_range)
+			vy_log_insert_slice(part->id, slice->run->id, slice->id,
+					    tuple_data_or_null(slice->begin.stmt),
+					    tuple_data_or_null(slice->end.stmt));
+	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
+
+	/* See the comment in vy_task_compaction_complete(). */
+	rlist_foreach_entry(run, &unused_runs, in_unused) {
+		if (run->dump_lsn > vy_log_signature() ||
+		    scheduler->run_env->initial_join)
+			vy_run_remove_files(lsm->env->path, lsm->space_id,
+					    lsm->index_id, run->id);
+	}
+
+	/*
+	 * Account the new runs if they are not empty,
+	 * otherwise discard them.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_output);
+	for (int i = 0; i < part_count; i++) {
+		new_run = part_tasks[i]->new_run;
+		vy_disk_stmt_counter_add(&compaction_output, &new_run->count);
+		if (!vy_run_is_empty(new_run)) {
+			vy_lsm_add_run(lsm, new_run);
+			/* Drop the reference held by the task. */
+			vy_run_unref(new_run);
+		} else {
+			vy_run_discard(new_run);
+		}
+		part_tasks[i]->new_run = NULL;
+	}
+
+	/*
+	 * Replace the compacted range with the new ranges and
+	 * account compaction in LSM tree statistics.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_input);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		vy_disk_stmt_counter_add(&compaction_input, &slice->count);
+		if (slice == last_slice)
+			break;
+	}
+	vy_lsm_unacct_range(lsm, range);
+	/* The range was removed from the heap when the task started. */
+	assert(heap_node_is_stray(&range->heap_node));
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_lsm_remove_range(lsm, range);
+	for (int i = 0; i < part_count; i++) {
+		vy_lsm_add_range(lsm, parts[i]);
+		vy_lsm_acct_range(lsm, parts[i]);
+	}
+	lsm->range_tree_version++;
+	vy_lsm_acct_compaction(lsm, compaction_time,
+			       &compaction_input, &compaction_output);
+	scheduler->stat.compaction_input += compaction_input.bytes;
+	scheduler->stat.compaction_output += compaction_output.bytes;
+	scheduler->stat.compaction_time += compaction_time;
+	vy_scheduler_update_lsm(scheduler, lsm);
+
+	say_info("%s: completed compacting range %s in %d parts",
+		 vy_lsm_name(lsm), vy_range_str(range), part_count);
+
+	/*
+	 * Unaccount unused runs and delete the compacted range.
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_lsm_remove_run(lsm, run);
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	return 0;
+fail:
+	for (int i = 0; i < part_count; i++) {
+		if (parts[i] != NULL)
+			vy_range_delete(parts[i]);
+	}
+	return -1;
+}
+
 static int
 vy_task_compaction_complete(struct vy_task *task)
 {
@@ -1453,6 +1797,9 @@ vy_task_compaction_complete(struct vy_task *task)
 	struct vy_slice *slice, *next_slice, *new_slice = NULL;
 	struct vy_run *run;
 
+	if (task->subtask_count > 0)
+		return vy_task_subcompaction_complete(task);
+
 	/*
 	 * The LSM tree could have been dropped while we were writing the new
 	 * run. In this case we should discard the run without committing to
@@ -1612,8 +1959,7 @@ vy_task_compaction_abort(struct vy_task *task)
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
 
-	/* The iterator has been cleaned up in worker. */
-	task->wi->iface->close(task->wi);
+	vy_task_compaction_close_wi(task);
 
 	struct error *e = diag_last_error(&task->diag);
 	error_log(e);
@@ -1621,12 +1967,216 @@ vy_task_compaction_abort(struct vy_task *task)
 		  vy_lsm_name(lsm), vy_range_str(range));
 
 	vy_run_discard(task->new_run);
+	for (int i = 0; i < task->subtask_count; i++)
+		vy_run_discard(task->subtasks[i]->new_run);
 
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Allocate a new run for a compaction task and create a write
+ * iterator over the compacted slices. In case of subcompaction,
+ * the slices are cut to the boundaries of the part compacted
+ * by the task.
+ */
+static int
+vy_task_compaction_prepare(struct vy_task *task, bool is_last_level,
+			   int32_t dump_count, bool is_subcompaction)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+
+	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
+	if (new_run == NULL)
+		return -1;
+
+	/*
+	 * Compaction is throttled so as not to starve foreground
+	 * reads. The limit is shared evenly among compaction threads.
+	 */
+	uint64_t rate_limit = scheduler->run_env->compaction_io_rate_limit;
+	if (rate_limit > 0) {
+		task->rate_limit = MAX(rate_limit /
+				       scheduler->compaction_pool.size, 1);
+	}
+
+	struct vy_stmt_stream *wi;
+	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
+				   is_last_level, scheduler->read_views,
+				   lsm->index_id > 0 ? NULL :
+				   &task->deferred_delete_handler);
+	if (wi == NULL)
+		goto err_wi;
+	/*
+	 * Expired tuples are dropped by the primary index compaction.
+	 * Their secondary index entries are filtered out on lookup in
+	 * the primary index and purged when overwritten.
+	 */
+	struct space *space = space_by_id(lsm->space_id);
+	if (lsm->index_id == 0 && space != NULL && space->def->opts.ttl > 0) {
+		vy_write_iterator_set_ttl(wi, space->def->opts.ttl_field,
+					  clock_realtime() -
+					  space->def->opts.ttl);
+	}
+
+	struct vy_slice *slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		new_run->dump_lsn = MAX(new_run->dump_lsn,
+					slice->run->dump_lsn);
+		new_run->info.max_time = MAX(new_run->info.max_time,
+					     slice->run->info.max_time);
+		struct vy_slice *part_slice = slice;
+		if (is_subcompaction) {
+			if (vy_slice_cut(slice, 0, task->part_begin,
+					 task->part_end, lsm->cmp_def,
+					 &part_slice) != 0)
+				goto err_wi_sub;
+			if (part_slice != NULL) {
+				rlist_add_tail_entry(&task->part_slices,
+						     part_slice, in_range);
+			}
+		}
+		if (part_slice != NULL &&
+		    vy_write_iterator_new_slice(wi, part_slice,
+						lsm->disk_format) != 0)
+			goto err_wi_sub;
+		if (slice == task->last_slice)
+			break;
+	}
+	assert(new_run->dump_lsn >= 0);
+	new_run->dump_count = dump_count;
+
+	task->new_run = new_run;
+	task->wi = wi;
+	return 0;
+
+err_wi_sub:
+	task->wi = wi;
+	vy_task_compaction_close_wi(task);
+err_wi:
+	vy_run_discard(new_run);
+	return -1;
+}
+
+/**
+ * Split compaction of a big range in parts that are compacted in
+ * parallel by idle worker threads (subcompaction). The first part
+ * is compacted by the task itself while the rest of the parts are
+ * compacted by subtasks.
+ *
+ * The range is split by min keys of the pages of the oldest run
+ * being compacted, because it's supposed to be the biggest one,
+ * so that the parts are roughly of the same size. We never make
+ * a part smaller than the range size, because the parts replace
+ * the compacted range on completion and small ranges would have
+ * to be coalesced back.
+ */
+static int
+vy_task_subcompaction_new(struct vy_task *task)
+{
+	static struct vy_task_ops subcompaction_ops = {
+		.execute = vy_task_compaction_execute,
+		.complete = NULL,
+		.abort = NULL,
+	};
+
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	struct vy_slice *slice = task->last_slice;
+
+	int64_t max_parts = range->compaction_queue.bytes /
+			    vy_lsm_range_size(lsm);
+	max_parts = MIN(max_parts, VY_SUBCOMPACTION_MAX_PARTS);
+	max_parts = MIN(max_parts, (int64_t)slice->count.pages);
+	if (max_parts < 2)
+		return 0;
+
+	struct vy_worker *workers[VY_SUBCOMPACTION_MAX_PARTS - 1];
+	int worker_count = 0;
+	while (worker_count < max_parts - 1) {
+		struct vy_worker *worker;
+		worker = vy_worker_pool_get(&scheduler->compaction_pool);
+		if (worker == NULL)
+			break;
+		workers[worker_count++] = worker;
+	}
+
+	/*
+	 * Determine the parts' boundaries. Since a key may span
+	 * several pages, we have to skip duplicates.
+	 */
+	struct vy_entry split_keys[VY_SUBCOMPACTION_MAX_PARTS - 1];
+	int split_key_count = 0;
+	int part_count = worker_count + 1;
+	uint32_t page_count = slice->last_page_no - slice->first_page_no + 1;
+	struct vy_entry prev_key = range->begin;
+	for (int i = 1; i < part_count; i++) {
+		hint_t hint;
+		uint32_t page_no = slice->first_page_no +
+				   i * page_count / part_count;
+		const char *key_raw = vy_run_page_min_key(slice->run, page_no,
+							  &hint);
+		struct vy_entry key = vy_entry_key_from_msgpack(
+				lsm->env->key_format, lsm->cmp_def, key_raw);
+		if (key.stmt == NULL)
+			goto fail;
+		if ((prev_key.stmt != NULL &&
+		     vy_entry_compare(key, prev_key, lsm->cmp_def) <= 0) ||
+		    (range->end.stmt != NULL &&
+		     vy_entry_compare(key, range->end, lsm->cmp_def) >= 0)) {
+			tuple_unref(key.stmt);
+			continue;
+		}
+		split_keys[split_key_count++] = key;
+		prev_key = key;
+	}
+
+	/* Return the workers we don't need. */
+	while (worker_count > split_key_count)
+		vy_worker_pool_put(workers[--worker_count]);
+	if (split_key_count == 0)
+		return 0;
+
+	task->subtasks = calloc(split_key_count, sizeof(*task->subtasks));
+	if (task->subtasks == NULL) {
+		diag_set(OutOfMemory, split_key_count * sizeof(*task->subtasks),
+			 "calloc", "struct vy_task");
+		goto fail;
+	}
+	vy_task_set_part(task, range->begin, split_keys[0]);
+	for (int i = 0; i < split_key_count; i++) {
+		struct vy_task *subtask = vy_task_new(scheduler, workers[i],
+						      lsm, &subcompaction_ops);
+		if (subtask == NULL)
+			goto fail;
+		subtask->parent = task;
+		subtask->range = range;
+		subtask->first_slice = task->first_slice;
+		subtask->last_slice = task->last_slice;
+		subtask->bloom_fpr = task->bloom_fpr;
+		subtask->page_size = task->page_size;
+		subtask->is_covering = task->is_covering;
+		vy_task_set_part(subtask, split_keys[i],
+				 i < split_key_count - 1 ?
+				 split_keys[i + 1] : range->end);
+		task->subtasks[task->subtask_count++] = subtask;
+	}
+	for (int i = 0; i < split_key_count; i++)
+		tuple_unref(split_keys[i].stmt);
+	return 0;
+fail:
+	/* Workers assigned to subtasks are returned by the caller. */
+	for (int i = task->subtask_count; i < worker_count; i++)
+		vy_worker_pool_put(workers[i]);
+	for (int i = 0; i < split_key_count; i++)
+		tuple_unref(split_keys[i].stmt);
+	return -1;
+}
+
 static int
 vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		       struct vy_lsm *lsm, struct vy_task **p_task)
@@ -1652,30 +2202,12 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	if (task == NULL)
 		goto err_task;
 
-	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
-	if (new_run == NULL)
-		goto err_run;
-
-	struct vy_stmt_stream *wi;
-	bool is_last_level = (range->compaction_priority == range->slice_count);
-	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views,
-				   lsm->index_id > 0 ? NULL :
-				   &task->deferred_delete_handler);
-	if (wi == NULL)
-		goto err_wi;
-
+	/* Remember the slices we are compacting. */
 	struct vy_slice *slice;
 	int32_t dump_count = 0;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
-						lsm->disk_format) != 0)
-			goto err_wi_sub;
-		new_run->dump_lsn = MAX(new_run->dump_lsn,
-					slice->run->dump_lsn);
 		dump_count += slice->run->dump_count;
-		/* Remember the slices we are compacting. */
 		if (task->first_slice == NULL)
 			task->first_slice = slice;
 		task->last_slice = slice;
@@ -1684,8 +2216,8 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 			break;
 	}
 	assert(n == 0);
-	assert(new_run->dump_lsn >= 0);
-	if (range->compaction_priority == range->slice_count)
+	bool is_last_level = (range->compaction_priority == range->slice_count);
+	if (is_last_level)
 		dump_count -= slice->run->dump_count;
 	/*
 	 * Do not update dumps_per_compaction in case compaction
@@ -1693,17 +2225,26 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	 * such as splitting/coalescing ranges for no good reason.
 	 */
 	if (range->needs_compaction)
-		new_run->dump_count = slice->run->dump_count;
-	else
-		new_run->dump_count = dump_count;
-
-	range->needs_compaction = false;
+		dump_count = slice->run->dump_count;
 
 	task->range = range;
-	task->new_run = new_run;
-	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->is_covering = lsm->opts.covering;
+
+	if (vy_task_subcompaction_new(task) != 0)
+		goto err_prepare;
+	if (vy_task_compaction_prepare(task, is_last_level, dump_count,
+				       task->subtask_count > 0) != 0)
+		goto err_prepare;
+	for (int i = 0; i < task->subtask_count; i++) {
+		if (vy_task_compaction_prepare(task->subtasks[i], is_last_level,
+					       dump_count, true) != 0)
+			goto err_prepare;
+	}
+	task->subtasks_in_progress = task->subtask_count;
+
+	range->needs_compaction = false;
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1715,14 +2256,24 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	say_info("%s: started compacting range %s, runs %d/%d",
 		 vy_lsm_name(lsm), vy_range_str(range),
                  range->compaction_priority, range->slice_count);
+	if (task->subtask_count > 0) {
+		say_info("%s: compaction of range %s is split in %d parts",
+			 vy_lsm_name(lsm), vy_range_str(range),
+			 task->subtask_count + 1);
+	}
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
-err_wi:
-	vy_run_discard(new_run);
-err_run:
+err_prepare:
+	vy_task_compaction_close_wi(task);
+	if (task->new_run != NULL)
+		vy_run_discard(task->new_run);
+	for (int i = 0; i < task->subtask_count; i++) {
+		struct vy_task *subtask = task->subtasks[i];
+		if (subtask->new_run != NULL)
+			vy_run_discard(subtask->new_run);
+		vy_worker_pool_put(subtask->worker);
+	}
 	vy_task_delete(task);
 err_task:
 	diag_log();
@@ -1795,9 +2346,26 @@ static void
 vy_task_complete_f(struct cmsg *cmsg)
 {
 	struct vy_task *task = container_of(cmsg, struct vy_task, cmsg);
-	stailq_add_tail_entry(&task->scheduler->processed_tasks,
-			      task, in_processed);
-	fiber_cond_signal(&task->scheduler->scheduler_cond);
+	struct vy_scheduler *scheduler = task->scheduler;
+	if (task->parent != NULL) {
+		/*
+		 * A subtask doesn't need its worker anymore so we
+		 * return it to the pool right away. The subtask is
+		 * completed along with the parent task.
+		 */
+		vy_worker_pool_put(task->worker);
+		task->worker = NULL;
+		task = task->parent;
+		assert(task->subtasks_in_progress > 0);
+		task->subtasks_in_progress--;
+	} else {
+		task->is_executed = true;
+	}
+	if (task->is_executed && task->subtasks_in_progress == 0) {
+		stailq_add_tail_entry(&scheduler->processed_tasks,
+				      task, in_processed);
+	}
+	fiber_cond_signal(&scheduler->scheduler_cond);
 }
 
 /**
@@ -1967,6 +2535,14 @@ vy_task_complete(struct vy_task *task)
 		assert(!diag_is_empty(diag));
 		goto fail; /* ->execute fialed */
 	}
+	for (int i = 0; i < task->subtask_count; i++) {
+		struct vy_task *subtask = task->subtasks[i];
+		if (subtask->is_failed) {
+			assert(!diag_is_empty(&subtask->diag));
+			diag_move(&subtask->diag, diag);
+			goto fail;
+		}
+	}
 	ERROR_INJECT(ERRINJ_VY_TASK_COMPLETE, {
 			diag_set(ClientError, ER_INJECTION,
 			       "vinyl task completion");
@@ -2045,6 +2621,12 @@ vy_scheduler_f(va_list va)
 		/* Queue the task for execution. */
 		cmsg_init(&task->cmsg, vy_task_execute_route);
 		cpipe_push(&task->worker->worker_pipe, &task->cmsg);
+		for (int i = 0; i < task->subtask_count; i++) {
+			struct vy_task *subtask = task->subtasks[i];
+			cmsg_init(&subtask->cmsg, vy_task_execute_route);
+			cpipe_push(&subtask->worker->worker_pipe,
+				   &subtask->cmsg);
+		}
 
 		fiber_reschedule();
 		continue;
@@ -94,6 +94,11 @@ struct vy_run_iterator_stat {
 	 * prevent a disk read.
 	 */
 	int64_t bloom_miss;
+	/**
+	 * Number of times a run was skipped, because the search
+	 * key was out of the run's key range.
+	 */
+	int64_t skip;
 	/**
 	 * Number of statements actually read from the disk.
 	 * It may be greater than the number of statements
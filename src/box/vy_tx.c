@@ -54,6 +54,7 @@
 #include "vy_cache.h"
 #include "vy_lsm.h"
 #include "vy_mem.h"
+#include "vy_range_delete.h"
 #include "vy_stat.h"
 #include "vy_stmt.h"
 #include "vy_upsert.h"
@@ -350,6 +351,28 @@ vy_tx_create(struct vy_tx_manager *xm, struct vy_tx *tx)
 	rlist_create(&tx->on_destroy);
 	rlist_create(&tx->in_writers);
 	rlist_create(&tx->in_prepared);
+	rlist_create(&tx->range_deletes);
+}
+
+/** Free a range delete performed by a transaction. */
+static void
+vy_tx_range_delete_free(struct vy_tx_range_delete *rd)
+{
+	tuple_unref(rd->begin.stmt);
+	if (rd->end.stmt != NULL)
+		tuple_unref(rd->end.stmt);
+	vy_lsm_unref(rd->lsm);
+	free(rd);
+}
+
+/** Free all range deletes performed by a transaction. */
+static void
+vy_tx_free_range_deletes(struct vy_tx *tx)
+{
+	struct vy_tx_range_delete *rd, *tmp;
+	rlist_foreach_entry_safe(rd, &tx->range_deletes, in_tx, tmp)
+		vy_tx_range_delete_free(rd);
+	rlist_create(&tx->range_deletes);
 }
 
 void
@@ -365,6 +388,7 @@ vy_tx_destroy(struct vy_tx *tx)
 	struct txv *v, *tmp;
 	stailq_foreach_entry_safe(v, tmp, &tx->log, next_in_log)
 		txv_delete(v);
+	vy_tx_free_range_deletes(tx);
 
 	vy_tx_read_set_iter(&tx->read_set, NULL, vy_tx_read_set_free_cb, NULL);
 	rlist_del_entry(tx, in_writers);
@@ -383,7 +407,8 @@ vy_tx_abort(struct vy_tx *tx)
 static bool
 vy_tx_is_ro(struct vy_tx *tx)
 {
-	return write_set_empty(&tx->write_set);
+	return write_set_empty(&tx->write_set) &&
+	       rlist_empty(&tx->range_deletes);
 }
 
 /** Return true if the transaction is in read view. */
@@ -436,6 +461,47 @@ vy_tx_send_readers_to_read_view(struct vy_tx *tx, struct txv *v)
 	return 0;
 }
 
+/**
+ * Send to read view all transactions that are reading from
+ * the LSM tree affected by range delete @rd of transaction @tx.
+ * We don't bother looking up intervals intersecting the deleted
+ * range, because range deletes are rare.
+ */
+static int
+vy_tx_send_range_readers_to_read_view(struct vy_tx *tx,
+				      struct vy_tx_range_delete *rd)
+{
+	struct vy_read_interval *interval;
+	for (interval = vy_lsm_read_set_first(&rd->lsm->read_set);
+	     interval != NULL;
+	     interval = vy_lsm_read_set_next(&rd->lsm->read_set, interval)) {
+		struct vy_tx *reader = interval->tx;
+		if (reader == tx || reader->state != VINYL_TX_READY)
+			continue;
+		if (vy_tx_send_to_read_view(reader, INT64_MAX) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Abort all transactions that are reading from the LSM tree
+ * affected by range delete @rd of transaction @tx.
+ */
+static void
+vy_tx_abort_range_readers(struct vy_tx *tx, struct vy_tx_range_delete *rd)
+{
+	struct vy_read_interval *interval;
+	for (interval = vy_lsm_read_set_first(&rd->lsm->read_set);
+	     interval != NULL;
+	     interval = vy_lsm_read_set_next(&rd->lsm->read_set, interval)) {
+		struct vy_tx *reader = interval->tx;
+		if (reader == tx || reader->state != VINYL_TX_READY)
+			continue;
+		vy_tx_abort(reader);
+	}
+}
+
 /**
  * Abort all transaction that are reading key @v modified
  * by transaction @tx.
@@ -709,6 +775,11 @@ vy_tx_prepare(struct vy_tx *tx)
 		if (vy_tx_send_readers_to_read_view(tx, v))
 			return -1;
 	}
+	struct vy_tx_range_delete *rd;
+	rlist_foreach_entry(rd, &tx->range_deletes, in_tx) {
+		if (vy_tx_send_range_readers_to_read_view(tx, rd) != 0)
+			return -1;
+	}
 
 	/*
 	 * Flush transactional changes to the LSM tree.
@@ -799,6 +870,17 @@ vy_tx_prepare(struct vy_tx *tx)
 			return -1;
 		v->region_stmt = *region_stmt;
 	}
+	rlist_foreach_entry(rd, &tx->range_deletes, in_tx) {
+		struct vy_lsm *lsm = rd->lsm;
+		if (vy_lsm_rotate_mem_if_required(lsm) != 0)
+			return -1;
+		vy_mem_pin(lsm->mem);
+		rd->mem = lsm->mem;
+		rd->rd = vy_lsm_set_range_delete(lsm, rd->mem, rd->begin,
+						 rd->end, MAX_LSN + tx->psn);
+		if (rd->rd == NULL)
+			return -1;
+	}
 	assert(rlist_empty(&tx->in_prepared));
 	rlist_add_tail_entry(&xm->prepared, tx, in_prepared);
 	return 0;
@@ -834,6 +916,13 @@ vy_tx_commit(struct vy_tx *tx, int64_t lsn)
 		if (v->mem != NULL)
 			vy_mem_unpin(v->mem);
 	}
+	struct vy_tx_range_delete *rd;
+	rlist_foreach_entry(rd, &tx->range_deletes, in_tx) {
+		assert(rd->rd != NULL);
+		rd->rd->lsn = lsn;
+		vy_lsm_commit_range_delete(rd->lsm, rd->mem, rd->rd);
+		vy_mem_unpin(rd->mem);
+	}
 
 	/* Update read views of dependant transactions. */
 	if (tx->read_view != &xm->global_read_view)
@@ -871,12 +960,21 @@ vy_tx_rollback_after_prepare(struct vy_tx *tx)
 		if (v->mem != NULL)
 			vy_mem_unpin(v->mem);
 	}
+	struct vy_tx_range_delete *rd;
+	rlist_foreach_entry(rd, &tx->range_deletes, in_tx) {
+		if (rd->rd != NULL)
+			vy_lsm_rollback_range_delete(rd->lsm, rd->mem, rd->rd);
+		if (rd->mem != NULL)
+			vy_mem_unpin(rd->mem);
+	}
 
 	struct write_set_iterator it;
 	write_set_ifirst(&tx->write_set, &it);
 	while ((v = write_set_inext(&it)) != NULL) {
 		vy_tx_abort_readers(tx, v);
 	}
+	rlist_foreach_entry(rd, &tx->range_deletes, in_tx)
+		vy_tx_abort_range_readers(tx, rd);
 }
 
 void
@@ -903,6 +1001,11 @@ vy_tx_begin_statement(struct vy_tx *tx, struct space *space, void **savepoint)
 		return -1;
 	}
 	assert(tx->state == VINYL_TX_READY);
+	if (!rlist_empty(&tx->range_deletes)) {
+		diag_set(ClientError, ER_MULTISTATEMENT_TRANSACTION,
+			 "range delete");
+		return -1;
+	}
 	tx->last_stmt_space = space;
 	/*
 	 * When want to add to the writer list, can't rely on the log emptiness.
@@ -931,6 +1034,11 @@ vy_tx_rollback_statement(struct vy_tx *tx, void *svp)
 	/* Rollback statements in LIFO order. */
 	stailq_reverse(&tail);
 	struct txv *v, *tmp;
+	/*
+	 * A range delete can only be the only statement of
+	 * a transaction so it belongs to the rolled back one.
+	 */
+	vy_tx_free_range_deletes(tx);
 	stailq_foreach_entry_safe(v, tmp, &tail, next_in_log) {
 		write_set_remove(&tx->write_set, v);
 		if (v->overwritten != NULL) {
@@ -1087,10 +1195,30 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 		lsm->stat.upsert.squashed++;
 	}
 
+	struct tuple *copy = NULL;
+	if (old != NULL && lsm->opts.covering &&
+	    (vy_stmt_flags(entry.stmt) & VY_STMT_UPDATE) != 0) {
+		/*
+		 * The key was written by this transaction before so
+		 * the REPLACE may overwrite a tuple stored in the
+		 * covering index and hence mustn't be turned into
+		 * INSERT on dump, see vy_write_iterator_build_history().
+		 * Since the statement is shared with other indexes,
+		 * clear the flag in a copy.
+		 */
+		copy = vy_stmt_dup(entry.stmt);
+		if (copy == NULL)
+			return -1;
+		vy_stmt_set_flags(copy, vy_stmt_flags(copy) & ~VY_STMT_UPDATE);
+		entry.stmt = copy;
+	}
+
 	/* Allocate a MVCC container. */
 	struct txv *v = txv_new(tx, lsm, entry);
 	if (applied.stmt != NULL)
 		tuple_unref(applied.stmt);
+	if (copy != NULL)
+		tuple_unref(copy);
 	if (v == NULL)
 		return -1;
 
@@ -1139,11 +1267,21 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 		 * vinyl_space_build_index() as featuring bumped lsn).
 		 * Finally, we'll get missing tuple in secondary index after
 		 * it is built.
+		 *
+		 * A covering index does store full tuples so DELETE +
+		 * REPLACE must be written to it as is, and REPLACE +
+		 * DELETE is no-op only if the REPLACE doesn't overwrite
+		 * a statement written by this transaction.
 		 */
 		enum iproto_type type = vy_stmt_type(entry.stmt);
 		enum iproto_type old_type = vy_stmt_type(old->entry.stmt);
-		if ((type == IPROTO_DELETE) != (old_type == IPROTO_DELETE))
+		if (type == IPROTO_DELETE && old_type != IPROTO_DELETE) {
+			if (!lsm->opts.covering || old->overwritten == NULL)
+				v->is_nop = true;
+		} else if (type != IPROTO_DELETE &&
+			   old_type == IPROTO_DELETE && !lsm->opts.covering) {
 			v->is_nop = true;
+		}
 	}
 
 	v->overwritten = old;
@@ -1179,6 +1317,40 @@ vy_tx_set(struct vy_tx *tx, struct vy_lsm *lsm, struct tuple *stmt)
 	return 0;
 }
 
+int
+vy_tx_delete_range(struct vy_tx *tx, struct vy_lsm *lsm,
+		   struct vy_entry begin, struct vy_entry end)
+{
+	if (vy_tx_is_in_read_view(tx)) {
+		/* See the comment in vy_tx_set(). */
+		assert(vy_tx_is_ro(tx));
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		return -1;
+	}
+	assert(stailq_empty(&tx->log));
+	struct vy_tx_range_delete *rd = malloc(sizeof(*rd));
+	if (rd == NULL) {
+		diag_set(OutOfMemory, sizeof(*rd), "malloc",
+			 "struct vy_tx_range_delete");
+		return -1;
+	}
+	rd->lsm = lsm;
+	vy_lsm_ref(lsm);
+	rd->begin = begin;
+	tuple_ref(begin.stmt);
+	rd->end = end;
+	if (end.stmt != NULL)
+		tuple_ref(end.stmt);
+	rd->mem = NULL;
+	rd->rd = NULL;
+	rlist_add_tail_entry(&tx->range_deletes, rd, in_tx);
+	tx->write_set_version++;
+	tx->write_size += tuple_size(begin.stmt);
+	if (end.stmt != NULL)
+		tx->write_size += tuple_size(end.stmt);
+	return 0;
+}
+
 void
 vy_tx_manager_abort_writers_for_ddl(struct vy_tx_manager *xm,
 				    struct space *space, bool *need_wal_sync)
@@ -59,6 +59,7 @@ struct vy_tx_manager;
 struct vy_mem;
 struct vy_tx;
 struct vy_history;
+struct vy_range_delete;
 
 /** Transaction state. */
 enum tx_state {
@@ -113,6 +114,28 @@ struct txv {
 	struct txv *overwritten;
 };
 
+/**
+ * A range delete performed by a transaction.
+ * See also struct vy_range_delete.
+ */
+struct vy_tx_range_delete {
+	/** Link in vy_tx::range_deletes. */
+	struct rlist in_tx;
+	/** LSM tree this range delete is for. */
+	struct vy_lsm *lsm;
+	/** Begin of the deleted range (key, inclusive). */
+	struct vy_entry begin;
+	/**
+	 * End of the deleted range (key, exclusive) or none
+	 * if the range is unbounded.
+	 */
+	struct vy_entry end;
+	/** In-memory tree to insert the range delete into. */
+	struct vy_mem *mem;
+	/** Range delete inserted into the in-memory tree. */
+	struct vy_range_delete *rd;
+};
+
 /**
  * Index of all modifications made by a transaction.
  * Ordered by LSM tree, then by key.
@@ -203,6 +226,12 @@ struct vy_tx {
 	 * is not prepared.
 	 */
 	int64_t psn;
+	/**
+	 * Range deletes performed by this transaction, linked by
+	 * vy_tx_range_delete::in_tx. Range deletes bypass the write
+	 * set and are written to LSM trees on prepare.
+	 */
+	struct rlist range_deletes;
 	/* List of triggers invoked when this transaction ends. */
 	struct rlist on_destroy;
 };
@@ -446,6 +475,25 @@ vy_tx_track_point(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry);
 int
 vy_tx_set(struct vy_tx *tx, struct vy_lsm *lsm, struct tuple *stmt);
 
+/**
+ * Delete all keys in the range [begin, end) of an LSM tree.
+ * The range delete is written to the LSM tree on prepare.
+ * Since range deletes bypass the write set, a transaction
+ * with a range delete may not have other statements.
+ *
+ * @param tx    Transaction.
+ * @param lsm   LSM tree to delete the range from.
+ * @param begin Begin of the range (key, inclusive).
+ * @param end   End of the range (key, exclusive) or none
+ *              if the range is unbounded.
+ *
+ * @retval  0 Success
+ * @retval -1 Memory allocation error.
+ */
+int
+vy_tx_delete_range(struct vy_tx *tx, struct vy_lsm *lsm,
+		   struct vy_entry begin, struct vy_entry end);
+
 /**
  * Send an active transaction to a read view such that its vlsn is less than
  * the given prepared statement LSN. Returns 0 on success, -1 on memory
@@ -30,8 +30,10 @@
  */
 #include "vy_write_iterator.h"
 #include "vy_mem.h"
+#include "vy_range_delete.h"
 #include "vy_run.h"
 #include "vy_upsert.h"
+#include "space_ttl.h"
 #include "fiber.h"
 
 #define HEAP_FORWARD_DECLARATION
@@ -206,6 +208,29 @@ struct vy_write_iterator {
 	 * Last statement returned to the caller, pinned in memory.
 	 */
 	struct vy_entry last;
+	/**
+	 * Range deletes stored in the iterator sources. Statements
+	 * deleted by them are skipped unless visible from a read view.
+	 */
+	const struct vy_range_delete **range_deletes;
+	/** Number of entries in the @range_deletes array. */
+	uint32_t range_delete_count;
+	/** Capacity of the @range_deletes array. */
+	uint32_t range_delete_capacity;
+	/**
+	 * Index of the next range delete returned by
+	 * vy_write_iterator_next_range_delete().
+	 */
+	uint32_t next_range_delete;
+	/** Set if expired tuples should be dropped, see @ttl_deadline. */
+	bool has_ttl;
+	/** Number of the field storing the tuple update time. */
+	uint32_t ttl_field;
+	/**
+	 * Tuples updated at or before this time are considered
+	 * expired. Used only if @has_ttl is set.
+	 */
+	double ttl_deadline;
 	/**
 	 * Read views of the same key sorted by LSN in descending
 	 * order, starting from INT64_MAX.
@@ -466,9 +491,35 @@ vy_write_iterator_close(struct vy_stmt_stream *vstream)
 	rlist_foreach_entry_safe(src, &stream->src_list, in_src_list, tmp)
 		vy_write_iterator_delete_src(stream, src);
 	vy_source_heap_destroy(&stream->src_heap);
+	free(stream->range_deletes);
 	free(stream);
 }
 
+/**
+ * Add a range delete stored in a source to the iterator.
+ * @return 0 on success or -1 on error (diag is set).
+ */
+static int
+vy_write_iterator_add_range_delete(struct vy_write_iterator *stream,
+				   const struct vy_range_delete *rd)
+{
+	if (stream->range_delete_count == stream->range_delete_capacity) {
+		uint32_t capacity = MAX(stream->range_delete_capacity * 2, 8);
+		size_t size = capacity * sizeof(stream->range_deletes[0]);
+		const struct vy_range_delete **range_deletes =
+			realloc(stream->range_deletes, size);
+		if (range_deletes == NULL) {
+			diag_set(OutOfMemory, size, "realloc",
+				 "range deletes");
+			return -1;
+		}
+		stream->range_deletes = range_deletes;
+		stream->range_delete_capacity = capacity;
+	}
+	stream->range_deletes[stream->range_delete_count++] = rd;
+	return 0;
+}
+
 /**
  * Add a mem as a source of iterator.
  * @return 0 on success or -1 on error (diag is set).
@@ -481,6 +532,11 @@ vy_write_iterator_new_mem(struct vy_stmt_stream *vstream, struct vy_mem *mem)
 	if (src == NULL)
 		return -1;
 	vy_mem_stream_open(&src->mem_stream, mem);
+	struct vy_range_delete *rd;
+	rlist_foreach_entry(rd, &mem->range_deletes, in_mem) {
+		if (vy_write_iterator_add_range_delete(stream, rd) != 0)
+			return -1;
+	}
 	return 0;
 }
 
@@ -499,9 +555,80 @@ vy_write_iterator_new_slice(struct vy_stmt_stream *vstream,
 		return -1;
 	vy_slice_stream_open(&src->slice_stream, slice, stream->cmp_def,
 			     disk_format);
+	struct vy_run_info *info = &slice->run->info;
+	for (uint32_t i = 0; i < info->range_delete_count; i++) {
+		if (vy_write_iterator_add_range_delete(
+				stream, &info->range_deletes[i]) != 0)
+			return -1;
+	}
 	return 0;
 }
 
+void
+vy_write_iterator_set_ttl(struct vy_stmt_stream *vstream, uint32_t ttl_field,
+			  double deadline)
+{
+	struct vy_write_iterator *stream = (struct vy_write_iterator *)vstream;
+	assert(stream->is_primary);
+	stream->has_ttl = true;
+	stream->ttl_field = ttl_field;
+	stream->ttl_deadline = deadline;
+}
+
+const struct vy_range_delete *
+vy_write_iterator_next_range_delete(struct vy_stmt_stream *vstream)
+{
+	struct vy_write_iterator *stream = (struct vy_write_iterator *)vstream;
+	/* The oldest read view, which is INT64_MAX if there are none. */
+	int64_t oldest_vlsn = stream->read_views[stream->rv_count - 1].vlsn;
+	while (stream->next_range_delete < stream->range_delete_count) {
+		const struct vy_range_delete *rd =
+			stream->range_deletes[stream->next_range_delete++];
+		/*
+		 * If this is the last level and the range delete is
+		 * visible from all read views, all the statements it
+		 * deletes have been skipped so it may be purged.
+		 */
+		if (stream->is_last_level && rd->lsn <= oldest_vlsn)
+			continue;
+		return rd;
+	}
+	return NULL;
+}
+
+/**
+ * Return true if a statement is deleted by a range delete and
+ * isn't visible from any read view so it may be skipped.
+ */
+static bool
+vy_write_iterator_is_range_deleted(struct vy_write_iterator *stream,
+				   struct vy_entry entry)
+{
+	int64_t lsn = vy_stmt_lsn(entry.stmt);
+	for (uint32_t i = 0; i < stream->range_delete_count; i++) {
+		const struct vy_range_delete *rd = stream->range_deletes[i];
+		if (rd->lsn <= lsn ||
+		    !vy_range_delete_covers(rd, entry, stream->cmp_def))
+			continue;
+		/*
+		 * The statement must be kept if there's a read view
+		 * that was created after the statement, but before
+		 * the range delete.
+		 */
+		bool is_visible = false;
+		for (int j = 1; j < stream->rv_count; j++) {
+			int64_t vlsn = stream->read_views[j].vlsn;
+			if (vlsn >= lsn && vlsn < rd->lsn) {
+				is_visible = true;
+				break;
+			}
+		}
+		if (!is_visible)
+			return true;
+	}
+	return false;
+}
+
 /**
  * Go to the next tuple in terms of sorted (merged) input steams.
  * @return 0 on success or not 0 on error (diag is set).
@@ -739,6 +866,11 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 				break;
 		}
 
+		/* Skip statements deleted by range deletes. */
+		if (stream->range_delete_count > 0 &&
+		    vy_write_iterator_is_range_deleted(stream, src->entry))
+			goto next_lsn;
+
 		if (vy_stmt_lsn(src->entry.stmt) > current_rv_lsn) {
 			/*
 			 * Skip statements invisible to the current read
@@ -1045,6 +1177,24 @@ vy_write_iterator_build_read_views(struct vy_write_iterator *stream, int *count)
 		++*count;
 		prev = rv->entry;
 	}
+	/*
+	 * Drop an expired tuple unless an older version of the key is
+	 * visible from a read view, in which case dropping the newest
+	 * version would resurrect the older one. Since this is the last
+	 * level, there are no older versions on disk either.
+	 */
+	rv = &stream->read_views[0];
+	if (stream->has_ttl && stream->is_last_level &&
+	    stream->rv_used_count == 1 && rv->entry.stmt != NULL &&
+	    (vy_stmt_type(rv->entry.stmt) == IPROTO_REPLACE ||
+	     vy_stmt_type(rv->entry.stmt) == IPROTO_INSERT) &&
+	    space_ttl_tuple_is_expired(rv->entry.stmt, stream->ttl_field,
+				       stream->ttl_deadline)) {
+		vy_stmt_unref_if_possible(rv->entry.stmt);
+		rv->entry = vy_entry_none();
+		stream->rv_used_count--;
+		--*count;
+	}
 
 cleanup:
 	vy_write_iterator_history_destroy(stream, region, used);
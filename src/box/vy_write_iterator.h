@@ -199,6 +199,7 @@ struct tuple_format;
 struct tuple;
 struct vy_mem;
 struct vy_slice;
+struct vy_range_delete;
 
 /**
  * Callback invoked by the write iterator for tuples that were
@@ -268,5 +269,25 @@ vy_write_iterator_new_slice(struct vy_stmt_stream *stream,
 			    struct vy_slice *slice,
 			    struct tuple_format *disk_format);
 
+/**
+ * Make the iterator drop tuples that have a number not greater than
+ * @a deadline stored in the field @a ttl_field. Tuples are dropped
+ * only if this is the last LSM tree level and the dropped tuple isn't
+ * visible from any read view. May only be used for a primary index.
+ */
+void
+vy_write_iterator_set_ttl(struct vy_stmt_stream *stream, uint32_t ttl_field,
+			  double deadline);
+
+/**
+ * Return the next range delete that must be written to the output
+ * run or NULL if there are no more. Range deletes stored in the
+ * iterator sources are returned, except for those that don't need
+ * to be kept anymore, because this is the last LSM tree level and
+ * all the statements they delete have been purged.
+ */
+const struct vy_range_delete *
+vy_write_iterator_next_range_delete(struct vy_stmt_stream *stream);
+
 #endif /* INCLUDES_TARANTOOL_BOX_VY_WRITE_STREAM_H */
 
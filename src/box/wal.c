@@ -32,6 +32,7 @@
 
 #include "fiber.h"
 #include "fio.h"
+#include "fio_uring.h"
 #include "errinj.h"
 #include "error.h"
 #include "exception.h"
@@ -43,6 +44,7 @@
 #include "coio_task.h"
 #include "replication.h"
 #include "iproto_constants.h"
+#include "xrow_buf.h"
 
 enum {
 	/**
@@ -62,6 +64,11 @@ const char *wal_mode_STRS[WAL_MODE_MAX] = {
 	[WAL_FSYNC]	= "fsync",
 };
 
+const char *wal_io_backend_STRS[WAL_IO_BACKEND_MAX] = {
+	[WAL_IO_POSIX]	= "posix",
+	[WAL_IO_URING]	= "io_uring",
+};
+
 int wal_dir_lock = -1;
 
 RLIST_HEAD(wal_on_write);
@@ -173,6 +180,19 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Rows recently written to the WAL, kept in memory so that
+	 * replication relays don't need to read them from disk.
+	 * Unused if wal_relay_buffer_size is 0.
+	 */
+	struct xrow_buf relay_buf;
+	/** Set if relay_buf is used. */
+	bool relay_buf_enabled;
+	/**
+	 * Ring used for writing WAL files if the io_uring I/O
+	 * backend is enabled, otherwise NULL.
+	 */
+	struct fio_uring *uring;
 };
 
 struct wal_msg {
@@ -213,6 +233,13 @@ wal_dir(void)
 	return wal_writer_singleton.wal_dir.dirname;
 }
 
+struct xrow_buf *
+wal_relay_buf(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	return writer->relay_buf_enabled ? &writer->relay_buf : NULL;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg);
 
@@ -440,13 +467,19 @@ tx_notify_checkpoint(struct cmsg *msg)
  */
 static void
 wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
+		  enum wal_io_backend io_backend,
 		  const char *wal_dirname, int64_t wal_max_size,
+		  int64_t wal_relay_buffer_size,
 		  const struct tt_uuid *instance_uuid,
 		  wal_on_garbage_collection_f on_garbage_collection,
 		  wal_on_checkpoint_threshold_f on_checkpoint_threshold)
 {
 	writer->wal_mode = wal_mode;
 	writer->wal_max_size = wal_max_size;
+	writer->relay_buf_enabled = wal_mode != WAL_NONE &&
+				    wal_relay_buffer_size > 0;
+	if (writer->relay_buf_enabled)
+		xrow_buf_create(&writer->relay_buf, wal_relay_buffer_size);
 
 	journal_create(&writer->base,
 		       wal_mode == WAL_NONE ?
@@ -454,11 +487,29 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 		       wal_mode == WAL_NONE ?
 		       wal_write_none : wal_write);
 
+	writer->uring = NULL;
+	if (io_backend == WAL_IO_URING && wal_mode != WAL_NONE) {
+		writer->uring = fio_uring_new();
+		if (writer->uring == NULL) {
+			diag_log();
+			say_warn("failed to set up io_uring, "
+				 "falling back on the posix WAL I/O backend");
+		}
+	}
+
 	struct xlog_opts opts = xlog_opts_default;
 	opts.sync_is_async = true;
+	if (writer->uring != NULL) {
+		/*
+		 * Instead of opening WAL files with O_SYNC, submit
+		 * fdatasync() along with each write.
+		 */
+		opts.uring = writer->uring;
+		opts.sync_on_write = wal_mode == WAL_FSYNC;
+	}
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid, &opts);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
+	if (wal_mode == WAL_FSYNC && writer->uring == NULL)
 		writer->wal_dir.open_wflags |= O_SYNC;
 
 	stailq_create(&writer->rollback);
@@ -484,6 +535,10 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	if (writer->relay_buf_enabled)
+		xrow_buf_destroy(&writer->relay_buf);
+	if (writer->uring != NULL)
+		fio_uring_delete(writer->uring);
 }
 
 /** WAL writer thread routine. */
@@ -560,16 +615,18 @@ wal_open(struct wal_writer *writer)
 }
 
 int
-wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+wal_init(enum wal_mode wal_mode, enum wal_io_backend io_backend,
+	 const char *wal_dirname,
+	 int64_t wal_max_size, int64_t wal_relay_buffer_size,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold)
 {
 	/* Initialize the state. */
 	struct wal_writer *writer = &wal_writer_singleton;
-	wal_writer_create(writer, wal_mode, wal_dirname, wal_max_size,
-			  instance_uuid, on_garbage_collection,
-			  on_checkpoint_threshold);
+	wal_writer_create(writer, wal_mode, io_backend, wal_dirname,
+			  wal_max_size, wal_relay_buffer_size, instance_uuid,
+			  on_garbage_collection, on_checkpoint_threshold);
 
 	/* Start WAL thread. */
 	if (cord_costart(&writer->cord, "wal", wal_writer_f, NULL) != 0)
@@ -884,6 +941,12 @@ wal_opt_rotate(struct wal_writer *writer)
 	 * collection, see wal_collect_garbage().
 	 */
 	xdir_add_vclock(&writer->wal_dir, &writer->vclock);
+	/*
+	 * Let relays reading rows from memory know that they have
+	 * to switch to the new WAL, see relay_on_close_log_f().
+	 */
+	if (writer->relay_buf_enabled)
+		xrow_buf_start(&writer->relay_buf, &writer->vclock, true);
 
 	wal_notify_watchers(writer, WAL_EVENT_ROTATE);
 	return 0;
@@ -1084,6 +1147,13 @@ wal_write_to_disk(struct cmsg *msg)
 		err_code = JOURNAL_ENTRY_ERR_IO;
 		goto done;
 	}
+	/*
+	 * The WAL may have been opened for appending on startup,
+	 * in which case the relay buffer hasn't been started yet.
+	 */
+	if (writer->relay_buf_enabled &&
+	    !xrow_buf_is_started(&writer->relay_buf))
+		xrow_buf_start(&writer->relay_buf, &writer->vclock, false);
 
 	/* Ensure there's enough disk space before writing anything. */
 	if (wal_fallocate(writer, wal_msg->approx_len) != 0) {
@@ -1200,6 +1270,12 @@ wal_write_to_disk(struct cmsg *msg)
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
+	if (writer->relay_buf_enabled && last_committed != NULL) {
+		stailq_foreach_entry(entry, &wal_msg->commit, fifo) {
+			xrow_buf_write(&writer->relay_buf, entry->rows,
+				       entry->n_rows);
+		}
+	}
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
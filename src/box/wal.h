@@ -40,6 +40,7 @@
 struct fiber;
 struct wal_writer;
 struct tt_uuid;
+struct xrow_buf;
 
 enum wal_mode {
 	/**
@@ -74,6 +75,21 @@ enum {
 /** String constants for the supported modes. */
 extern const char *wal_mode_STRS[];
 
+enum wal_io_backend {
+	/** Write with writev(2), sync with fdatasync(2). */
+	WAL_IO_POSIX = 0,
+	/**
+	 * Submit a write and the following sync with a single
+	 * system call using io_uring(7).
+	 */
+	WAL_IO_URING,
+
+	WAL_IO_BACKEND_MAX
+};
+
+/** String constants for the supported I/O backends. */
+extern const char *wal_io_backend_STRS[];
+
 extern int wal_dir_lock;
 
 /**
@@ -106,8 +122,10 @@ typedef void (*wal_on_checkpoint_threshold_f)(void);
  * Start WAL thread and initialize WAL writer.
  */
 int
-wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+wal_init(enum wal_mode wal_mode, enum wal_io_backend io_backend,
+	 const char *wal_dirname, int64_t wal_max_size,
+	 int64_t wal_relay_buffer_size,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold);
 
@@ -130,6 +148,15 @@ wal_free(void);
 const char *
 wal_dir(void);
 
+/**
+ * Get the buffer of rows recently written to the WAL or NULL if
+ * the buffer is disabled, see wal_relay_buffer_size. The pointer
+ * never changes after box is configured first time. The buffer
+ * may be read from any thread.
+ */
+struct xrow_buf *
+wal_relay_buf(void);
+
 struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
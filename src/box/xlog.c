@@ -37,6 +37,8 @@
 #include "exception.h"
 #include "crc32.h"
 #include "fio.h"
+#include "fio_uring.h"
+#include "tt_pthread.h"
 #include <tarantool_eio.h>
 #include <msgpuck.h>
 
@@ -48,6 +50,7 @@
 #include "errinj.h"
 #include "salad/grp_alloc.h"
 #include "trivia/util.h"
+#include "tt_compression.h"
 
 /*
  * FALLOC_FL_KEEP_SIZE flag has existed since fallocate() was
@@ -97,6 +100,10 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.sync_on_write = false,
+	.uring = NULL,
+	.compress_threads = 0,
+	.compression_dict = NULL,
 };
 
 /* {{{ struct xlog_meta */
@@ -785,9 +792,14 @@ xlog_clear(struct xlog *l)
 	l->fd = -1;
 }
 
+static void
+xlog_compressor_delete(struct xlog_compressor *c);
+
 static void
 xlog_destroy(struct xlog *xlog)
 {
+	if (xlog->compressor != NULL)
+		xlog_compressor_delete(xlog->compressor);
 	assert(xlog->obuf.slabc == &cord()->slabc);
 	assert(xlog->zbuf.slabc == &cord()->slabc);
 	obuf_destroy(&xlog->obuf);
@@ -1040,6 +1052,127 @@ xlog_fallocate(struct xlog *log, size_t len)
 #endif /* HAVE_FALLOCATE */
 }
 
+/**
+ * Write buffers to an xlog file and sync the data if required.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_writev(struct xlog *log, struct iovec *iov, int iovcnt)
+{
+	if (log->opts.uring != NULL) {
+		return fio_uring_writev(log->opts.uring, log->fd, iov, iovcnt,
+					log->opts.sync_on_write);
+	}
+	ssize_t written = fio_writevn(log->fd, iov, iovcnt);
+	if (written >= 0 && log->opts.sync_on_write &&
+	    fdatasync(log->fd) < 0) {
+		say_syserror("%s: fdatasync failed", log->filename);
+		return -1;
+	}
+	return written;
+}
+
+/**
+ * Encode the fixheader of an xlog tx.
+ */
+static void
+xlog_tx_encode_fixheader(char *fixheader, log_magic_t magic, size_t len,
+			 uint32_t crc32c)
+{
+	memcpy(fixheader, &magic, sizeof(log_magic_t));
+	char *data = fixheader + sizeof(log_magic_t);
+	data = mp_encode_uint(data, len);
+	/* Encode crc32 for previous row */
+	data = mp_encode_uint(data, 0);
+	/* Encode crc32 for current row */
+	data = mp_encode_uint(data, crc32c);
+	/*
+	 * Encode a padding, to ensure the resulting
+	 * fixheader always has the same size.
+	 */
+	ssize_t padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
+	if (padding > 0) {
+		data = mp_encode_strl(data, padding - 1);
+		if (padding > 1) {
+			memset(data, 0, padding - 1);
+			data += padding - 1;
+		}
+	}
+}
+
+/**
+ * Max size of an xlog tx compressed with xlog_tx_compress().
+ */
+static size_t
+xlog_tx_compress_bound(const struct iovec *iov, int iovcnt)
+{
+	size_t size = XLOG_FIXHEADER_SIZE;
+	size_t offset = XLOG_FIXHEADER_SIZE;
+	for (int i = 0; i < iovcnt; i++) {
+		size += ZSTD_compressBound(iov[i].iov_len - offset);
+		offset = 0;
+	}
+	return size;
+}
+
+/**
+ * Compress an xlog tx. The first XLOG_FIXHEADER_SIZE bytes of @a iov
+ * are reserved for the fixheader of the uncompressed tx. The compressed
+ * tx, including its fixheader, is stored in @a out, which must be at
+ * least xlog_tx_compress_bound() bytes long. If @a dict isn't NULL,
+ * it's used for compression. May be called from any thread.
+ *
+ * @retval -1 error, @a error is set to the error message
+ * @retval >= 0 the size of the compressed tx
+ */
+static ssize_t
+xlog_tx_compress(ZSTD_CCtx *zctx, struct tt_compression_dict *dict,
+		 const struct iovec *iov, int iovcnt, char *out,
+		 const char **error)
+{
+	char *fixheader = out;
+	char *zdst = out + XLOG_FIXHEADER_SIZE;
+	uint32_t crc32c = 0;
+	if (dict != NULL) {
+		ZSTD_compressBegin_usingCDict(
+			zctx, tt_compression_dict_zstd_cdict(dict));
+	} else {
+		/* 3 is compression level. */
+		ZSTD_compressBegin(zctx, 3);
+	}
+	size_t offset = XLOG_FIXHEADER_SIZE;
+	for (int i = 0; i < iovcnt; i++) {
+		size_t src_size = iov[i].iov_len - offset;
+		/* Estimate max output buffer size. */
+		size_t zmax_size = ZSTD_compressBound(src_size);
+		size_t (*fcompress)(ZSTD_CCtx *, void *, size_t,
+				    const void *, size_t);
+		/* If it's the last iov, end the stream. */
+		if (i == iovcnt - 1)
+			fcompress = ZSTD_compressEnd;
+		else
+			fcompress = ZSTD_compressContinue;
+		size_t zsize = fcompress(zctx, zdst, zmax_size,
+					 (char *)iov[i].iov_base + offset,
+					 src_size);
+		if (ZSTD_isError(zsize)) {
+			*error = ZSTD_getErrorName(zsize);
+			return -1;
+		}
+		/* Update crc32c */
+		crc32c = crc32_calc(crc32c, zdst, zsize);
+		/* Advance output buffer to the end of compressed data. */
+		zdst += zsize;
+		/* Discount fixheader size for all iovs after first. */
+		offset = 0;
+	}
+	size_t len = zdst - out - XLOG_FIXHEADER_SIZE;
+	xlog_tx_encode_fixheader(fixheader, zrow_marker, len, crc32c);
+	return zdst - out;
+}
+
 /**
  * Write a sequence of uncompressed xrow objects.
  *
@@ -1054,13 +1187,6 @@ xlog_tx_write_plain(struct xlog *log)
 	 * now populate it with data.
 	 */
 	char *fixheader = (char *)log->obuf.iov[0].iov_base;
-	memcpy(fixheader, &row_marker, sizeof(log_magic_t));
-	char *data = fixheader + sizeof(log_magic_t);
-
-	data = mp_encode_uint(data,
-			      obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE);
-	/* Encode crc32 for previous row */
-	data = mp_encode_uint(data, 0);
 	/* Encode crc32 for current row */
 	uint32_t crc32c = 0;
 	struct iovec *iov;
@@ -1071,26 +1197,16 @@ xlog_tx_write_plain(struct xlog *log)
 				    iov->iov_len - offset);
 		offset = 0;
 	}
-	data = mp_encode_uint(data, crc32c);
-	/*
-	 * Encode a padding, to ensure the resulting
-	 * fixheader always has the same size.
-	 */
-	ssize_t padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
-	if (padding > 0) {
-		data = mp_encode_strl(data, padding - 1);
-		if (padding > 1) {
-			memset(data, 0, padding - 1);
-			data += padding - 1;
-		}
-	}
+	xlog_tx_encode_fixheader(fixheader, row_marker,
+				 obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE,
+				 crc32c);
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
 		return -1;
 	});
 
-	ssize_t written = fio_writevn(log->fd, log->obuf.iov, log->obuf.pos + 1);
+	ssize_t written = xlog_writev(log, log->obuf.iov, log->obuf.pos + 1);
 	if (written < 0) {
 		diag_set(SystemError, "failed to write to '%s' file",
 			 log->filename);
@@ -1107,85 +1223,32 @@ xlog_tx_write_plain(struct xlog *log)
 static off_t
 xlog_tx_write_zstd(struct xlog *log)
 {
-	char *fixheader = (char *)obuf_alloc(&log->zbuf,
-					     XLOG_FIXHEADER_SIZE);
-	if (fixheader == NULL) {
-		diag_set(OutOfMemory, XLOG_FIXHEADER_SIZE, "runtime arena",
+	struct iovec *iov = log->obuf.iov;
+	int iovcnt = log->obuf.pos + 1;
+	size_t zmax_size = xlog_tx_compress_bound(iov, iovcnt);
+	/* Allocate a destination buffer. */
+	char *zdst = (char *)obuf_reserve(&log->zbuf, zmax_size);
+	if (zdst == NULL) {
+		diag_set(OutOfMemory, zmax_size, "runtime arena",
 			 "compression buffer");
 		goto error;
 	}
-	uint32_t crc32c = 0;
-	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
-	size_t offset = XLOG_FIXHEADER_SIZE;
-	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
-		/* Estimate max output buffer size. */
-		size_t zmax_size = ZSTD_compressBound(iov->iov_len - offset);
-		/* Allocate a destination buffer. */
-		void *zdst = obuf_reserve(&log->zbuf, zmax_size);
-		if (!zdst) {
-			diag_set(OutOfMemory, zmax_size, "runtime arena",
-				  "compression buffer");
-			goto error;
-		}
-		size_t (*fcompress)(ZSTD_CCtx *, void *, size_t,
-				    const void *, size_t);
-		/*
-		 * If it's the last iov or the last
-		 * log has 0 bytes, end the stream.
-		 */
-		if (iov == log->obuf.iov + log->obuf.pos ||
-		    !(iov + 1)->iov_len) {
-			fcompress = ZSTD_compressEnd;
-		} else {
-			fcompress = ZSTD_compressContinue;
-		}
-		size_t zsize = fcompress(log->zctx, zdst, zmax_size,
-					 (char *)iov->iov_base + offset,
-					 iov->iov_len - offset);
-		if (ZSTD_isError(zsize)) {
-			diag_set(ClientError, ER_COMPRESSION,
-				 ZSTD_getErrorName(zsize));
-			goto error;
-		}
-		/* Advance output buffer to the end of compressed data. */
-		obuf_alloc(&log->zbuf, zsize);
-		/* Update crc32c */
-		crc32c = crc32_calc(crc32c, (char *)zdst, zsize);
-		/* Discount fixheader size for all iovs after first. */
-		offset = 0;
-	}
-
-	memcpy(fixheader, &zrow_marker, sizeof(log_magic_t));
-	char *data;
-	data = fixheader + sizeof(log_magic_t);
-	data = mp_encode_uint(data,
-			      obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE);
-	/* Encode crc32 for previous row */
-	data = mp_encode_uint(data, 0);
-	/* Encode crc32 for current row */
-	data = mp_encode_uint(data, crc32c);
-	/* Encode padding */
-	ssize_t padding;
-	padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
-	if (padding > 0) {
-		data = mp_encode_strl(data, padding - 1);
-		if (padding > 1) {
-			memset(data, 0, padding - 1);
-			data += padding - 1;
-		}
+	const char *zerror;
+	ssize_t zsize = xlog_tx_compress(log->zctx, log->opts.compression_dict,
+					 iov, iovcnt, zdst, &zerror);
+	if (zsize < 0) {
+		diag_set(ClientError, ER_COMPRESSION, zerror);
+		goto error;
 	}
+	obuf_alloc(&log->zbuf, zsize);
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		obuf_reset(&log->zbuf);
 		goto error;
 	});
 
 	ssize_t written;
-	written = fio_writevn(log->fd, log->zbuf.iov,
-			      log->zbuf.pos + 1);
+	written = xlog_writev(log, log->zbuf.iov, log->zbuf.pos + 1);
 	if (written < 0) {
 		diag_set(SystemError, "failed to write to '%s' file",
 			 log->filename);
@@ -1204,27 +1267,13 @@ xlog_tx_write_zstd(struct xlog *log)
 #define SYNC_ROUND_UP(size)	(SYNC_ROUND_DOWN(size + SYNC_MASK))
 
 /**
- * Writes xlog batch to file
+ * Update the xlog state after writing a tx: advance the offset
+ * and sync the file if needed. On write error, truncate the file
+ * to the last good position.
  */
 static ssize_t
-xlog_tx_write(struct xlog *log)
+xlog_tx_write_complete(struct xlog *log, ssize_t written)
 {
-	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
-		return 0;
-	ssize_t written;
-
-	if (!log->opts.no_compression &&
-	    obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
-		written = xlog_tx_write_zstd(log);
-	} else {
-		written = xlog_tx_write_plain(log);
-	}
-	ERROR_INJECT(ERRINJ_WAL_WRITE, {
-		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		written = -1;
-	});
-
-	obuf_reset(&log->obuf);
 	/*
 	 * Simplify recovery after a temporary write failure:
 	 * truncate the file to the best known good write
@@ -1242,8 +1291,6 @@ xlog_tx_write(struct xlog *log)
 	else
 		log->allocated = 0;
 	log->offset += written;
-	log->rows += log->tx_rows;
-	log->tx_rows = 0;
 	if ((log->opts.sync_interval && log->offset >=
 	    (off_t)(log->synced_size + log->opts.sync_interval)) ||
 	    (log->opts.rate_limit && log->offset >=
@@ -1285,6 +1332,379 @@ xlog_tx_write(struct xlog *log)
 	return written;
 }
 
+/* {{{ Parallel compression */
+
+/** State of an xlog tx compressed in a separate thread. */
+enum xlog_ztx_state {
+	/** The tx slot is unused. */
+	XLOG_ZTX_FREE,
+	/** The tx is waiting to be compressed or being compressed. */
+	XLOG_ZTX_QUEUED,
+	/** The tx is compressed and may be written. */
+	XLOG_ZTX_DONE,
+};
+
+/** Xlog tx compressed in a separate thread. */
+struct xlog_ztx {
+	/** State of the tx. Protected by the compressor mutex. */
+	enum xlog_ztx_state state;
+	/**
+	 * Uncompressed tx data. Allocated and freed in the thread
+	 * writing the xlog, only read by compression threads.
+	 */
+	struct obuf obuf;
+	/** Compressed tx including the fixheader. */
+	char *data;
+	/** Size of the memory allocated for the compressed tx. */
+	size_t capacity;
+	/** Size of the compressed tx. */
+	ssize_t size;
+	/** Compression error message or NULL. */
+	const char *error;
+};
+
+/** Compression thread. */
+struct xlog_zthread {
+	/** Thread that compresses txs. */
+	struct cord cord;
+	/** Compressor the thread belongs to. */
+	struct xlog_compressor *compressor;
+	/** The context of zstd compression. */
+	ZSTD_CCtx *zctx;
+};
+
+/**
+ * Pool of threads compressing xlog txs. Txs are compressed in
+ * parallel and written in the order they were submitted. The
+ * compressed data is the same as if the txs were compressed by
+ * the writer thread, so the file format doesn't change.
+ */
+struct xlog_compressor {
+	/** Protects the fields below shared with threads. */
+	pthread_mutex_t mutex;
+	/** Signaled when a tx is submitted or threads must stop. */
+	pthread_cond_t submit_cond;
+	/** Signaled when a tx is compressed. */
+	pthread_cond_t done_cond;
+	/** Ring of txs in flight. */
+	struct xlog_ztx *txs;
+	/** Size of the ring of txs. */
+	int tx_count;
+	/** Sequence number of the next tx to submit. */
+	int64_t submit_seq;
+	/** Sequence number of the next tx to compress. */
+	int64_t compress_seq;
+	/** Sequence number of the next tx to write. */
+	int64_t write_seq;
+	/** Set if threads must stop. */
+	bool is_stopping;
+	/** Compression threads. */
+	struct xlog_zthread *threads;
+	/** Number of compression threads. */
+	int thread_count;
+	/** Dictionary used for compression or NULL. */
+	struct tt_compression_dict *dict;
+};
+
+/** Compression thread function. */
+static int
+xlog_zthread_f(va_list ap)
+{
+	struct xlog_zthread *thread = va_arg(ap, struct xlog_zthread *);
+	struct xlog_compressor *c = thread->compressor;
+	tt_pthread_mutex_lock(&c->mutex);
+	while (true) {
+		while (!c->is_stopping && c->compress_seq == c->submit_seq)
+			tt_pthread_cond_wait(&c->submit_cond, &c->mutex);
+		if (c->is_stopping)
+			break;
+		struct xlog_ztx *tx = &c->txs[c->compress_seq++ % c->tx_count];
+		assert(tx->state == XLOG_ZTX_QUEUED);
+		tt_pthread_mutex_unlock(&c->mutex);
+
+		struct iovec *iov = tx->obuf.iov;
+		int iovcnt = tx->obuf.pos + 1;
+		size_t zmax_size = xlog_tx_compress_bound(iov, iovcnt);
+		if (tx->capacity < zmax_size) {
+			tx->capacity = zmax_size;
+			tx->data = xrealloc(tx->data, zmax_size);
+		}
+		tx->error = NULL;
+		tx->size = xlog_tx_compress(thread->zctx, c->dict, iov, iovcnt,
+					    tx->data, &tx->error);
+
+		tt_pthread_mutex_lock(&c->mutex);
+		tx->state = XLOG_ZTX_DONE;
+		tt_pthread_cond_broadcast(&c->done_cond);
+	}
+	tt_pthread_mutex_unlock(&c->mutex);
+	return 0;
+}
+
+/**
+ * Create a compressor and start its threads. Must be called from
+ * the thread writing the xlog.
+ */
+static struct xlog_compressor *
+xlog_compressor_new(int thread_count, struct tt_compression_dict *dict)
+{
+	assert(thread_count > 0);
+	struct xlog_compressor *c = xcalloc(1, sizeof(*c));
+	c->dict = dict;
+	tt_pthread_mutex_init(&c->mutex, NULL);
+	tt_pthread_cond_init(&c->submit_cond, NULL);
+	tt_pthread_cond_init(&c->done_cond, NULL);
+	/*
+	 * Let the writer fill the next tx while each thread is
+	 * busy compressing one.
+	 */
+	c->tx_count = 2 * thread_count;
+	c->txs = xcalloc(c->tx_count, sizeof(*c->txs));
+	for (int i = 0; i < c->tx_count; i++) {
+		obuf_create(&c->txs[i].obuf, &cord()->slabc,
+			    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+	}
+	c->threads = xcalloc(thread_count, sizeof(*c->threads));
+	for (int i = 0; i < thread_count; i++) {
+		struct xlog_zthread *thread = &c->threads[i];
+		thread->compressor = c;
+		thread->zctx = ZSTD_createCCtx();
+		if (thread->zctx == NULL) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 "failed to create context");
+			goto fail;
+		}
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "xlog.zstd.%d", i);
+		if (cord_costart(&thread->cord, name, xlog_zthread_f,
+				 thread) != 0) {
+			ZSTD_freeCCtx(thread->zctx);
+			goto fail;
+		}
+		c->thread_count++;
+	}
+	return c;
+fail:
+	xlog_compressor_delete(c);
+	return NULL;
+}
+
+/**
+ * Stop compression threads and free a compressor. Txs that haven't
+ * been written are discarded.
+ */
+static void
+xlog_compressor_delete(struct xlog_compressor *c)
+{
+	tt_pthread_mutex_lock(&c->mutex);
+	c->is_stopping = true;
+	tt_pthread_cond_broadcast(&c->submit_cond);
+	tt_pthread_mutex_unlock(&c->mutex);
+	for (int i = 0; i < c->thread_count; i++) {
+		struct xlog_zthread *thread = &c->threads[i];
+		if (cord_join(&thread->cord) != 0)
+			panic_syserror("xlog compression thread join failed");
+		ZSTD_freeCCtx(thread->zctx);
+	}
+	for (int i = 0; i < c->tx_count; i++) {
+		assert(c->txs[i].obuf.slabc == &cord()->slabc);
+		obuf_destroy(&c->txs[i].obuf);
+		free(c->txs[i].data);
+	}
+	tt_pthread_cond_destroy(&c->done_cond);
+	tt_pthread_cond_destroy(&c->submit_cond);
+	tt_pthread_mutex_destroy(&c->mutex);
+	free(c->threads);
+	free(c->txs);
+	free(c);
+}
+
+/**
+ * Write the oldest submitted tx to the xlog file. If @a wait is
+ * set, wait for the tx to be compressed, otherwise return 0 if it
+ * hasn't been compressed yet.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_compressor_write_next(struct xlog *log, bool wait)
+{
+	struct xlog_compressor *c = log->compressor;
+	assert(c->write_seq < c->submit_seq);
+	struct xlog_ztx *tx = &c->txs[c->write_seq % c->tx_count];
+	tt_pthread_mutex_lock(&c->mutex);
+	while (wait && tx->state != XLOG_ZTX_DONE)
+		tt_pthread_cond_wait(&c->done_cond, &c->mutex);
+	bool is_done = tx->state == XLOG_ZTX_DONE;
+	tt_pthread_mutex_unlock(&c->mutex);
+	if (!is_done)
+		return 0;
+
+	ssize_t written = tx->size;
+	bool is_injected = false;
+	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		is_injected = true;
+		written = -1;
+	});
+	if (written < 0) {
+		if (!is_injected)
+			diag_set(ClientError, ER_COMPRESSION, tx->error);
+	} else {
+		struct iovec iov = {
+			.iov_base = tx->data,
+			.iov_len = (size_t)written,
+		};
+		written = xlog_writev(log, &iov, 1);
+		if (written < 0) {
+			diag_set(SystemError, "failed to write to '%s' file",
+				 log->filename);
+		}
+	}
+	obuf_reset(&tx->obuf);
+	tx->state = XLOG_ZTX_FREE;
+	c->write_seq++;
+	return xlog_tx_write_complete(log, written);
+}
+
+/**
+ * Discard txs that have been submitted but not written yet.
+ * Called on error, because the txs following a failed one
+ * must not be written.
+ */
+static void
+xlog_compressor_discard(struct xlog *log)
+{
+	struct xlog_compressor *c = log->compressor;
+	tt_pthread_mutex_lock(&c->mutex);
+	for (; c->write_seq < c->submit_seq; c->write_seq++) {
+		struct xlog_ztx *tx = &c->txs[c->write_seq % c->tx_count];
+		while (tx->state != XLOG_ZTX_DONE)
+			tt_pthread_cond_wait(&c->done_cond, &c->mutex);
+		obuf_reset(&tx->obuf);
+		tx->state = XLOG_ZTX_FREE;
+	}
+	tt_pthread_mutex_unlock(&c->mutex);
+}
+
+/**
+ * Write all submitted txs to the xlog file.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_compressor_flush(struct xlog *log)
+{
+	struct xlog_compressor *c = log->compressor;
+	if (c == NULL)
+		return 0;
+	ssize_t total = 0;
+	while (c->write_seq < c->submit_seq) {
+		ssize_t written = xlog_compressor_write_next(log, true);
+		if (written < 0) {
+			xlog_compressor_discard(log);
+			return -1;
+		}
+		total += written;
+	}
+	return total;
+}
+
+/**
+ * Pass the current tx to a compression thread and write the txs that
+ * have already been compressed. Blocks only if all threads are busy.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_tx_write_async(struct xlog *log)
+{
+	if (log->compressor == NULL) {
+		log->compressor = xlog_compressor_new(
+					log->opts.compress_threads,
+					log->opts.compression_dict);
+		if (log->compressor == NULL)
+			return -1;
+	}
+	struct xlog_compressor *c = log->compressor;
+	ssize_t total = 0;
+	/* Make room for the new tx. */
+	if (c->submit_seq - c->write_seq == c->tx_count) {
+		ssize_t written = xlog_compressor_write_next(log, true);
+		if (written < 0)
+			goto error;
+		total += written;
+	}
+	struct xlog_ztx *tx = &c->txs[c->submit_seq % c->tx_count];
+	assert(tx->state == XLOG_ZTX_FREE);
+	assert(obuf_size(&tx->obuf) == 0);
+	/* Hand over the rows to the compression thread. */
+	struct obuf tmp = tx->obuf;
+	tx->obuf = log->obuf;
+	log->obuf = tmp;
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+	tt_pthread_mutex_lock(&c->mutex);
+	tx->state = XLOG_ZTX_QUEUED;
+	c->submit_seq++;
+	tt_pthread_cond_signal(&c->submit_cond);
+	tt_pthread_mutex_unlock(&c->mutex);
+	/* Write the txs that are ready without waiting. */
+	while (c->write_seq < c->submit_seq) {
+		ssize_t written = xlog_compressor_write_next(log, false);
+		if (written < 0)
+			goto error;
+		if (written == 0)
+			break;
+		total += written;
+	}
+	return total;
+error:
+	xlog_compressor_discard(log);
+	return -1;
+}
+
+/* }}} Parallel compression */
+
+/**
+ * Writes xlog batch to file
+ */
+static ssize_t
+xlog_tx_write(struct xlog *log)
+{
+	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
+		return 0;
+	bool compress = !log->opts.no_compression &&
+			obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD;
+	if (compress && log->opts.compress_threads > 0)
+		return xlog_tx_write_async(log);
+	/* Txs must be written in order. */
+	ssize_t pending = xlog_compressor_flush(log);
+	if (pending < 0)
+		return -1;
+
+	ssize_t written;
+	if (compress)
+		written = xlog_tx_write_zstd(log);
+	else
+		written = xlog_tx_write_plain(log);
+	ERROR_INJECT(ERRINJ_WAL_WRITE, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		written = -1;
+	});
+
+	obuf_reset(&log->obuf);
+	written = xlog_tx_write_complete(log, written);
+	if (written < 0)
+		return -1;
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+	return pending + written;
+}
+
 /*
  * Add a row to a log and possibly flush the log.
  *
@@ -1397,9 +1817,17 @@ ssize_t
 xlog_flush(struct xlog *log)
 {
 	assert(log->is_autocommit);
-	if (log->obuf.used == 0)
-		return 0;
-	return xlog_tx_write(log);
+	ssize_t written = 0;
+	if (log->obuf.used > 0) {
+		written = xlog_tx_write(log);
+		if (written < 0)
+			return -1;
+	}
+	/* Write the txs passed to compression threads. */
+	ssize_t pending = xlog_compressor_flush(log);
+	if (pending < 0)
+		return -1;
+	return written + pending;
 }
 
 static int
@@ -1461,7 +1889,7 @@ xlog_write_eof(struct xlog *l)
 int
 xlog_close(struct xlog *l, bool reuse_fd)
 {
-	int rc = xlog_write_eof(l);
+	int rc = xlog_compressor_flush(l) < 0 ? -1 : xlog_write_eof(l);
 	if (rc < 0)
 		say_error("%s: failed to write EOF marker: %s", l->filename,
 			  diag_last_error(diag_get())->errmsg);
@@ -1692,6 +2120,28 @@ xlog_fixheader_decode(struct xlog_fixheader *fixheader,
 	return 0;
 }
 
+/**
+ * Prepare a decompression stream for decompressing a zstd frame
+ * stored at @a data. If the frame was compressed with a dictionary,
+ * the dictionary is looked up among registered dictionaries.
+ */
+static int
+xlog_zdctx_init(ZSTD_DStream *zdctx, const char *data, const char *data_end)
+{
+	ZSTD_initDStream(zdctx);
+	unsigned dict_id = ZSTD_getDictID_fromFrame(data, data_end - data);
+	if (dict_id == 0)
+		return 0;
+	struct tt_compression_dict *dict = tt_compression_dict_lookup(dict_id);
+	if (dict == NULL) {
+		diag_set(XlogError, "unknown compression dictionary %u",
+			 dict_id);
+		return -1;
+	}
+	ZSTD_DCtx_refDDict(zdctx, tt_compression_dict_zstd_ddict(dict));
+	return 0;
+}
+
 int
 xlog_tx_decode(const char *data, const char *data_end,
 	       char *rows, char *rows_end, ZSTD_DStream *zdctx)
@@ -1733,7 +2183,8 @@ xlog_tx_decode(const char *data, const char *data_end,
 
 	/* Decompress zstd rows */
 	assert(fixheader.magic == zrow_marker);
-	ZSTD_initDStream(zdctx);
+	if (xlog_zdctx_init(zdctx, data, data_end) != 0)
+		return -1;
 	int rc = xlog_cursor_decompress(&rows, rows_end, &data, data_end,
 					zdctx);
 	if (rc < 0) {
@@ -1799,7 +2250,10 @@ xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 	};
 
 	assert(fixheader.magic == zrow_marker);
-	ZSTD_initDStream(zdctx);
+	if (xlog_zdctx_init(zdctx, rpos, data_end) != 0) {
+		ibuf_destroy(&tx_cursor->rows);
+		return -1;
+	}
 	int rc;
 	do {
 		if (ibuf_reserve(&tx_cursor->rows,
@@ -1887,6 +2341,35 @@ xlog_cursor_find_tx_magic(struct xlog_cursor *i)
 	return 0;
 }
 
+/**
+ * Called when an eof marker is found at the current cursor position.
+ * Checks that there is no more data in the file and switches the cursor
+ * to the EOF state.
+ *
+ * @retval 1 eof
+ * @retval -1 error
+ */
+static int
+xlog_cursor_eof_found(struct xlog_cursor *i)
+{
+	/*
+	 * A eof marker is read, check that there is no
+	 * more data in the file.
+	 */
+	int rc = xlog_cursor_ensure(i, sizeof(log_magic_t) + sizeof(char));
+
+	if (rc < 0)
+		return -1;
+	if (rc == 0) {
+		diag_set(XlogError, "%s: has some data after "
+			  "eof marker at %lld", i->name,
+			  xlog_cursor_pos(i));
+		return -1;
+	}
+	i->state = XLOG_CURSOR_EOF;
+	return 1;
+}
+
 int
 xlog_cursor_next_tx(struct xlog_cursor *i)
 {
@@ -1904,7 +2387,7 @@ xlog_cursor_next_tx(struct xlog_cursor *i)
 		return 1;
 	if (load_u32(i->rbuf.rpos) == eof_marker) {
 		/* eof marker found */
-		goto eof_found;
+		return xlog_cursor_eof_found(i);
 	}
 
 	ssize_t to_load;
@@ -1923,23 +2406,49 @@ xlog_cursor_next_tx(struct xlog_cursor *i)
 
 	i->state = XLOG_CURSOR_TX;
 	return 0;
-eof_found:
-	/*
-	 * A eof marker is read, check that there is no
-	 * more data in the file.
-	 */
-	rc = xlog_cursor_ensure(i, sizeof(log_magic_t) + sizeof(char));
+}
 
+int
+xlog_cursor_next_tx_raw(struct xlog_cursor *i, const char **data,
+			size_t *size)
+{
+	assert(xlog_cursor_is_open(i));
+	assert(i->state != XLOG_CURSOR_TX);
+	/* load at least magic to check eof */
+	int rc = xlog_cursor_ensure(i, sizeof(log_magic_t));
 	if (rc < 0)
 		return -1;
-	if (rc == 0) {
-		diag_set(XlogError, "%s: has some data after "
-			  "eof marker at %lld", i->name,
-			  xlog_cursor_pos(i));
-		return -1;
+	if (rc > 0)
+		return 1;
+	if (load_u32(i->rbuf.rpos) == eof_marker) {
+		/* eof marker found */
+		return xlog_cursor_eof_found(i);
+	}
+
+	while (true) {
+		const char *rpos = i->rbuf.rpos;
+		struct xlog_fixheader fixheader;
+		ssize_t to_load = xlog_fixheader_decode(&fixheader, &rpos,
+							i->rbuf.wpos);
+		if (to_load < 0)
+			return -1;
+		if (to_load == 0) {
+			ptrdiff_t avail = i->rbuf.wpos - rpos;
+			if (avail >= (ptrdiff_t)fixheader.len) {
+				*data = i->rbuf.rpos;
+				*size = rpos + fixheader.len - i->rbuf.rpos;
+				i->rbuf.rpos = (char *)rpos + fixheader.len;
+				return 0;
+			}
+			to_load = fixheader.len - avail;
+		}
+		/* not enough data in read buffer */
+		rc = xlog_cursor_ensure(i, ibuf_used(&i->rbuf) + to_load);
+		if (rc < 0)
+			return -1;
+		if (rc > 0)
+			return 1;
 	}
-	i->state = XLOG_CURSOR_EOF;
-	return 1;
 }
 
 int
@@ -42,13 +42,21 @@
 #include "small/ibuf.h"
 #include "small/obuf.h"
 
+struct fio_uring;
 struct iovec;
+struct tt_compression_dict;
+struct xlog_compressor;
 struct xrow_header;
 
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+enum {
+	/** Max number of threads used to compress xlog txs. */
+	XLOG_COMPRESS_THREADS_MAX = 64,
+};
+
 /**
  * This structure combines all xlog write options set on xlog
  * creation.
@@ -82,6 +90,34 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * If this flag is set, each write to the xlog file is
+	 * followed by fdatasync().
+	 */
+	bool sync_on_write;
+	/**
+	 * If set, data is written to the xlog file with io_uring
+	 * rather than writev(). A write and the following sync, see
+	 * sync_on_write, are submitted with a single system call.
+	 * The ring must only be used by the thread writing the xlog.
+	 */
+	struct fio_uring *uring;
+	/**
+	 * Number of threads used to compress xlog txs. If zero, txs
+	 * are compressed by the thread writing the xlog. Otherwise
+	 * txs are compressed in parallel and written asynchronously,
+	 * so xlog_tx_commit() and xlog_write_row() may return before
+	 * the data is written and the offset of the xlog is updated:
+	 * only xlog_flush() and xlog_close() wait for all the data to
+	 * be written.
+	 */
+	int compress_threads;
+	/**
+	 * Dictionary used for compression of xlog txs or NULL.
+	 * The dictionary must be registered, see tt_compression.h,
+	 * so that the xlog can be read back.
+	 */
+	struct tt_compression_dict *compression_dict;
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -401,6 +437,11 @@ struct xlog {
 	uint64_t synced_size;
 	/** Time when xlog wast synced last time */
 	double sync_time;
+	/**
+	 * Pool of threads compressing txs, created on demand if
+	 * xlog_opts::compress_threads is set.
+	 */
+	struct xlog_compressor *compressor;
 };
 
 /**
@@ -766,6 +807,29 @@ xlog_cursor_close(struct xlog_cursor *cursor, bool reuse_fd);
 int
 xlog_cursor_next_tx(struct xlog_cursor *cursor);
 
+/**
+ * Read next tx from xlog without validating or decompressing it.
+ *
+ * On success @a data points to the beginning of the tx fixheader and
+ * @a size is set to the size of the fixheader plus the tx body. The tx
+ * can then be decoded with xlog_tx_cursor_create() from any thread.
+ * The returned data stays valid only until the next call to any of the
+ * cursor functions.
+ *
+ * Must not be mixed with xlog_cursor_next_tx() and friends on the same
+ * cursor.
+ *
+ * @param cursor cursor
+ * @param[out] data raw tx data
+ * @param[out] size raw tx size
+ * @retval 0 succes
+ * @retval 1 eof
+ * retval -1 error, check diag
+ */
+int
+xlog_cursor_next_tx_raw(struct xlog_cursor *cursor, const char **data,
+			size_t *size);
+
 /**
  * Fetch next xrow from current xlog tx
  *
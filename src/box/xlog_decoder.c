@@ -0,0 +1,347 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "xlog_decoder.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cbus.h"
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "say.h"
+#include "trivia/util.h"
+#include "xlog.h"
+#include "xrow.h"
+
+enum {
+	/**
+	 * Number of transactions that may be in flight per decoder
+	 * thread. Two would be enough to keep a thread busy while tx
+	 * applies rows of another transaction, a couple more smooth
+	 * out the difference in transaction sizes.
+	 */
+	XLOG_DECODER_TXS_PER_THREAD = 4,
+};
+
+/** Decoder thread. */
+struct xlog_decoder_thread {
+	/** Thread that decodes transactions. */
+	struct cord cord;
+	/** Pipe from tx to the decoder thread. */
+	struct cpipe decoder_pipe;
+	/** Pipe from the decoder thread to tx. */
+	struct cpipe tx_pipe;
+	/** ZSTD context used for decompression. */
+	ZSTD_DStream *zdctx;
+	/** Route of a transaction decoding message. */
+	struct cmsg_hop decode_route[2];
+	/** Route of a message releasing a decoded transaction. */
+	struct cmsg_hop release_route[2];
+};
+
+/** Xlog transaction passed between tx and decoder threads. */
+struct xlog_decoder_tx {
+	/** Base class. */
+	struct cmsg base;
+	/** Decoder this transaction belongs to. */
+	struct xlog_decoder *decoder;
+	/** Thread the transaction is decoded by. */
+	struct xlog_decoder_thread *thread;
+	/**
+	 * Raw transaction data including the fixheader, as read from
+	 * the file. Allocated and freed in tx.
+	 */
+	char *data;
+	/** Size of the raw transaction data. */
+	size_t data_size;
+	/** Size of the memory allocated for the raw data. */
+	size_t data_capacity;
+	/**
+	 * Decoded transaction. Its buffer is allocated from the decoder
+	 * thread slab cache so it can only be destroyed there.
+	 */
+	struct xlog_tx_cursor tx_cursor;
+	/** Set if tx_cursor was created and must be destroyed. */
+	bool has_tx_cursor;
+	/** Decoded rows. Bodies point to tx_cursor.rows. */
+	struct xrow_header *rows;
+	/** Number of decoded rows. */
+	int row_count;
+	/** Number of rows the rows array has room for. */
+	int row_capacity;
+	/** Set if the message is owned by tx. */
+	bool is_ready;
+	/** Decoding error, if any. */
+	struct diag diag;
+};
+
+struct xlog_decoder {
+	/** Cursor raw transactions are read from. */
+	struct xlog_cursor *cursor;
+	/** Decoder threads. */
+	struct xlog_decoder_thread *threads;
+	/** Number of decoder threads. */
+	int thread_count;
+	/** Ring of transactions in flight. */
+	struct xlog_decoder_tx *txs;
+	/** Size of the ring of transactions. */
+	int tx_count;
+	/** Sequence number of the next transaction to read. */
+	int64_t read_seq;
+	/** Sequence number of the transaction rows are returned from. */
+	int64_t next_seq;
+	/** Position of the next row in the current transaction. */
+	int next_row;
+	/** Set when the cursor has been read to the end. */
+	bool is_eof;
+	/** Signaled when a transaction is returned to tx. */
+	struct fiber_cond cond;
+};
+
+/** Decoder thread function. */
+static int
+xlog_decoder_thread_f(va_list ap)
+{
+	struct xlog_decoder_thread *thread =
+		va_arg(ap, struct xlog_decoder_thread *);
+	struct cbus_endpoint endpoint;
+
+	cpipe_create(&thread->tx_pipe, "tx_prio");
+	cbus_endpoint_create(&endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cpipe_destroy(&thread->tx_pipe);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	return 0;
+}
+
+/** Free the decoded data of a transaction. Runs in a decoder thread. */
+static void
+xlog_decoder_tx_release(struct xlog_decoder_tx *tx)
+{
+	if (tx->has_tx_cursor) {
+		xlog_tx_cursor_destroy(&tx->tx_cursor);
+		tx->has_tx_cursor = false;
+	}
+	tx->row_count = 0;
+}
+
+/** Decode a transaction. Runs in a decoder thread. */
+static void
+xlog_decoder_decode_f(struct cmsg *base)
+{
+	struct xlog_decoder_tx *tx = (struct xlog_decoder_tx *)base;
+	xlog_decoder_tx_release(tx);
+
+	const char *data = tx->data;
+	const char *data_end = tx->data + tx->data_size;
+	ssize_t rc = xlog_tx_cursor_create(&tx->tx_cursor, &data, data_end,
+					   tx->thread->zdctx);
+	if (rc > 0) {
+		diag_set(XlogError, "tx is truncated");
+		goto error;
+	}
+	if (rc < 0)
+		goto error;
+	tx->has_tx_cursor = true;
+
+	struct xrow_header row;
+	while ((rc = xlog_tx_cursor_next_row(&tx->tx_cursor, &row)) == 0) {
+		if (tx->row_count == tx->row_capacity) {
+			int capacity = MAX(tx->row_capacity * 2, 64);
+			tx->rows = xrealloc(tx->rows,
+					    capacity * sizeof(*tx->rows));
+			tx->row_capacity = capacity;
+		}
+		tx->rows[tx->row_count++] = row;
+	}
+	if (rc < 0)
+		goto error;
+	return;
+error:
+	diag_move(diag_get(), &tx->diag);
+}
+
+/** Free the decoded data of a transaction. Runs in a decoder thread. */
+static void
+xlog_decoder_release_f(struct cmsg *base)
+{
+	xlog_decoder_tx_release((struct xlog_decoder_tx *)base);
+}
+
+/** Return a transaction to the decoder. Runs in tx. */
+static void
+xlog_decoder_ready_f(struct cmsg *base)
+{
+	struct xlog_decoder_tx *tx = (struct xlog_decoder_tx *)base;
+	tx->is_ready = true;
+	fiber_cond_broadcast(&tx->decoder->cond);
+}
+
+/** Wait until all the transactions are returned to tx. */
+static void
+xlog_decoder_wait_all(struct xlog_decoder *decoder)
+{
+	for (int i = 0; i < decoder->tx_count; i++) {
+		while (!decoder->txs[i].is_ready)
+			fiber_cond_wait(&decoder->cond);
+	}
+}
+
+/**
+ * Read raw transactions from the cursor and send them to decoder
+ * threads until all the ring slots are busy or EOF is reached.
+ */
+static int
+xlog_decoder_fill(struct xlog_decoder *decoder)
+{
+	while (!decoder->is_eof &&
+	       decoder->read_seq - decoder->next_seq < decoder->tx_count) {
+		const char *data;
+		size_t size;
+		int rc = xlog_cursor_next_tx_raw(decoder->cursor, &data, &size);
+		if (rc < 0)
+			return -1;
+		if (rc > 0) {
+			decoder->is_eof = true;
+			break;
+		}
+		struct xlog_decoder_tx *tx =
+			&decoder->txs[decoder->read_seq % decoder->tx_count];
+		assert(tx->is_ready);
+		if (tx->data_capacity < size) {
+			tx->data = xrealloc(tx->data, size);
+			tx->data_capacity = size;
+		}
+		memcpy(tx->data, data, size);
+		tx->data_size = size;
+		tx->is_ready = false;
+		cmsg_init(&tx->base, tx->thread->decode_route);
+		cpipe_push(&tx->thread->decoder_pipe, &tx->base);
+		decoder->read_seq++;
+	}
+	return 0;
+}
+
+int
+xlog_decoder_next(struct xlog_decoder *decoder, struct xrow_header *row)
+{
+	while (true) {
+		if (xlog_decoder_fill(decoder) != 0)
+			return -1;
+		if (decoder->next_seq == decoder->read_seq) {
+			assert(decoder->is_eof);
+			return 1;
+		}
+		struct xlog_decoder_tx *tx =
+			&decoder->txs[decoder->next_seq % decoder->tx_count];
+		while (!tx->is_ready)
+			fiber_cond_wait(&decoder->cond);
+		if (!diag_is_empty(&tx->diag)) {
+			diag_move(&tx->diag, diag_get());
+			return -1;
+		}
+		if (decoder->next_row < tx->row_count) {
+			*row = tx->rows[decoder->next_row++];
+			return 0;
+		}
+		decoder->next_seq++;
+		decoder->next_row = 0;
+	}
+}
+
+struct xlog_decoder *
+xlog_decoder_new(struct xlog_cursor *cursor, int thread_count)
+{
+	assert(thread_count > 0 && thread_count <= XLOG_DECODER_THREADS_MAX);
+	struct xlog_decoder *decoder = xcalloc(1, sizeof(*decoder));
+	decoder->cursor = cursor;
+	fiber_cond_create(&decoder->cond);
+	decoder->threads = xcalloc(thread_count, sizeof(*decoder->threads));
+	for (int i = 0; i < thread_count; i++) {
+		struct xlog_decoder_thread *thread = &decoder->threads[i];
+		thread->zdctx = ZSTD_createDStream();
+		if (thread->zdctx == NULL) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "failed to create context");
+			goto fail;
+		}
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "xlog.decoder.%d", i);
+		if (cord_costart(&thread->cord, name,
+				 xlog_decoder_thread_f, thread) != 0) {
+			ZSTD_freeDStream(thread->zdctx);
+			goto fail;
+		}
+		cpipe_create(&thread->decoder_pipe, name);
+		thread->decode_route[0].f = xlog_decoder_decode_f;
+		thread->decode_route[0].pipe = &thread->tx_pipe;
+		thread->decode_route[1].f = xlog_decoder_ready_f;
+		thread->decode_route[1].pipe = NULL;
+		thread->release_route[0].f = xlog_decoder_release_f;
+		thread->release_route[0].pipe = &thread->tx_pipe;
+		thread->release_route[1].f = xlog_decoder_ready_f;
+		thread->release_route[1].pipe = NULL;
+		decoder->thread_count++;
+	}
+	/*
+	 * The number of transactions is a multiple of the number of
+	 * threads so a ring slot is always handled by the same thread.
+	 */
+	decoder->tx_count = thread_count * XLOG_DECODER_TXS_PER_THREAD;
+	decoder->txs = xcalloc(decoder->tx_count, sizeof(*decoder->txs));
+	for (int i = 0; i < decoder->tx_count; i++) {
+		struct xlog_decoder_tx *tx = &decoder->txs[i];
+		tx->decoder = decoder;
+		tx->thread = &decoder->threads[i % thread_count];
+		tx->is_ready = true;
+		diag_create(&tx->diag);
+	}
+	return decoder;
+fail:
+	xlog_decoder_delete(decoder);
+	return NULL;
+}
+
+void
+xlog_decoder_delete(struct xlog_decoder *decoder)
+{
+	xlog_decoder_wait_all(decoder);
+	/* Decoded data can only be freed by the thread that allocated it. */
+	for (int i = 0; i < decoder->tx_count; i++) {
+		struct xlog_decoder_tx *tx = &decoder->txs[i];
+		if (!tx->has_tx_cursor)
+			continue;
+		tx->is_ready = false;
+		cmsg_init(&tx->base, tx->thread->release_route);
+		cpipe_push(&tx->thread->decoder_pipe, &tx->base);
+	}
+	xlog_decoder_wait_all(decoder);
+	for (int i = 0; i < decoder->thread_count; i++) {
+		struct xlog_decoder_thread *thread = &decoder->threads[i];
+		cbus_stop_loop(&thread->decoder_pipe);
+		cpipe_destroy(&thread->decoder_pipe);
+		if (cord_join(&thread->cord) != 0)
+			panic_syserror("xlog decoder: thread join failed");
+		ZSTD_freeDStream(thread->zdctx);
+	}
+	for (int i = 0; i < decoder->tx_count; i++) {
+		struct xlog_decoder_tx *tx = &decoder->txs[i];
+		assert(!tx->has_tx_cursor);
+		diag_destroy(&tx->diag);
+		free(tx->data);
+		free(tx->rows);
+	}
+	free(decoder->txs);
+	free(decoder->threads);
+	fiber_cond_destroy(&decoder->cond);
+	free(decoder);
+}
@@ -0,0 +1,64 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct xlog_cursor;
+struct xrow_header;
+
+enum {
+	/** Max number of threads used by a parallel xlog decoder. */
+	XLOG_DECODER_THREADS_MAX = 64,
+};
+
+/**
+ * Parallel xlog decoder.
+ *
+ * Raw xlog transactions are read from the file in the caller's thread
+ * and then dispatched in round-robin fashion to a pool of decoder
+ * threads which validate checksums, decompress the data and decode
+ * rows, including the msgpack validation of row bodies. Decoded rows
+ * are returned to the caller in the file order.
+ *
+ * The decoder is supposed to be used in the tx thread, as it relies on
+ * the tx_prio cbus endpoint to receive decoded transactions.
+ */
+struct xlog_decoder;
+
+/**
+ * Create a parallel decoder for the given open cursor and start its
+ * threads. The cursor must not be used directly until the decoder is
+ * deleted. Returns NULL and sets diag on error.
+ */
+struct xlog_decoder *
+xlog_decoder_new(struct xlog_cursor *cursor, int thread_count);
+
+/**
+ * Stop decoder threads and free the decoder. The cursor is not closed.
+ * If xlog_decoder_next() returned 1, the cursor is in EOF state.
+ */
+void
+xlog_decoder_delete(struct xlog_decoder *decoder);
+
+/**
+ * Fetch the next row. The row data stays valid until the next call to
+ * this function.
+ *
+ * @retval 0 for Ok
+ * @retval 1 for EOF
+ * @retval -1 for error, check diag
+ */
+int
+xlog_decoder_next(struct xlog_decoder *decoder, struct xrow_header *row);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
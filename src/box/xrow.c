@@ -739,11 +739,12 @@ iproto_prepare_header(struct obuf *buf, struct obuf_svp *svp, size_t size)
 /** Reply select with IPROTO_DATA. */
 void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		    uint64_t schema_version, uint32_t count)
+		    uint64_t schema_version, uint32_t count,
+		    size_t splice_size)
 {
 	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
 	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
-			     obuf_size(buf) - svp->used -
+			     obuf_size(buf) - svp->used + splice_size -
 			     IPROTO_HEADER_LEN);
 
 	struct iproto_body_bin body = iproto_body_bin;
@@ -756,7 +757,8 @@ iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 int
 iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
 				  uint64_t sync, uint64_t schema_version,
-				  uint32_t count, const char *packed_pos,
+				  uint32_t count, size_t splice_size,
+				  const char *packed_pos,
 				  const char *packed_pos_end)
 {
 	size_t packed_pos_size = packed_pos_end - packed_pos;
@@ -776,7 +778,7 @@ iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
 
 	char *pos = (char *)obuf_svp_to_ptr(buf, svp);
 	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
-			     obuf_size(buf) - svp->used -
+			     obuf_size(buf) - svp->used + splice_size -
 			     IPROTO_HEADER_LEN);
 
 	struct iproto_body_bin body = iproto_body_bin_with_position;
@@ -763,18 +763,23 @@ iproto_prepare_select_with_position(struct obuf *buf, struct obuf_svp *svp)
 /**
  * Write select header to a preallocated buffer.
  * This function doesn't throw (and we rely on this in iproto.cc).
+ * @a splice_size is the size of the result set data that is sent
+ * separately from @a buf.
  */
 void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		    uint64_t schema_version, uint32_t count);
+		    uint64_t schema_version, uint32_t count,
+		    size_t splice_size);
 
 /**
  * Write extended select header to a preallocated buffer.
+ * See iproto_reply_select() for @a splice_size.
  */
 int
 iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
 				  uint64_t sync, uint64_t schema_version,
-				  uint32_t count, const char *packed_pos,
+				  uint32_t count, size_t splice_size,
+				  const char *packed_pos,
 				  const char *packed_pos_end);
 
 /**
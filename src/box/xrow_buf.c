@@ -0,0 +1,175 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "xrow_buf.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "fiber.h"
+#include "small/ibuf.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "xrow.h"
+
+void
+xrow_buf_create(struct xrow_buf *buf, size_t size)
+{
+	memset(buf, 0, sizeof(*buf));
+	tt_pthread_mutex_init(&buf->mutex, NULL);
+	buf->chunk_size = MAX(size / XROW_BUF_CHUNK_COUNT, 1);
+	buf->last_gen = 0;
+	vclock_create(&buf->vclock);
+}
+
+void
+xrow_buf_destroy(struct xrow_buf *buf)
+{
+	for (int i = 0; i < XROW_BUF_CHUNK_COUNT; i++)
+		free(buf->chunks[i].data);
+	tt_pthread_mutex_destroy(&buf->mutex);
+}
+
+/** Return the chunk with the given sequence number. */
+static inline struct xrow_buf_chunk *
+xrow_buf_chunk(struct xrow_buf *buf, uint64_t gen)
+{
+	return &buf->chunks[gen % XROW_BUF_CHUNK_COUNT];
+}
+
+/** Make sure the current chunk has room for @a size more bytes. */
+static void
+xrow_buf_chunk_reserve(struct xrow_buf_chunk *chunk, size_t size)
+{
+	if (chunk->used + size <= chunk->capacity)
+		return;
+	chunk->capacity = chunk->used + size;
+	chunk->data = xrealloc(chunk->data, chunk->capacity);
+}
+
+/** Start a new chunk. Must be called under the buffer mutex. */
+static void
+xrow_buf_start_locked(struct xrow_buf *buf, bool is_rotate)
+{
+	struct xrow_buf_chunk *chunk = xrow_buf_chunk(buf, ++buf->last_gen);
+	chunk->gen = buf->last_gen;
+	vclock_copy(&chunk->vclock, &buf->vclock);
+	chunk->is_rotate = is_rotate;
+	chunk->used = 0;
+	/* Shrink the chunk if it was grown to store a huge row. */
+	if (chunk->capacity != buf->chunk_size) {
+		chunk->capacity = buf->chunk_size;
+		chunk->data = xrealloc(chunk->data, chunk->capacity);
+	}
+}
+
+void
+xrow_buf_start(struct xrow_buf *buf, const struct vclock *vclock,
+	       bool is_rotate)
+{
+	tt_pthread_mutex_lock(&buf->mutex);
+	vclock_copy(&buf->vclock, vclock);
+	xrow_buf_start_locked(buf, is_rotate);
+	tt_pthread_mutex_unlock(&buf->mutex);
+}
+
+void
+xrow_buf_write(struct xrow_buf *buf, struct xrow_header **rows,
+	       int row_count)
+{
+	assert(xrow_buf_is_started(buf));
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	tt_pthread_mutex_lock(&buf->mutex);
+	for (int i = 0; i < row_count; i++) {
+		struct xrow_header *row = rows[i];
+		struct iovec iov[XROW_IOVMAX];
+		int iovcnt;
+		xrow_header_encode(row, /*sync=*/0, /*fixheader_len=*/0,
+				   iov, &iovcnt);
+		size_t size = 0;
+		for (int j = 0; j < iovcnt; j++)
+			size += iov[j].iov_len;
+		struct xrow_buf_chunk *chunk =
+			xrow_buf_chunk(buf, buf->last_gen);
+		if (chunk->used > 0 && chunk->used + size > buf->chunk_size) {
+			xrow_buf_start_locked(buf, false);
+			chunk = xrow_buf_chunk(buf, buf->last_gen);
+		}
+		/* A row may be bigger than a chunk. */
+		xrow_buf_chunk_reserve(chunk, size);
+		for (int j = 0; j < iovcnt; j++) {
+			memcpy(chunk->data + chunk->used, iov[j].iov_base,
+			       iov[j].iov_len);
+			chunk->used += iov[j].iov_len;
+		}
+		vclock_follow_xrow(&buf->vclock, row);
+	}
+	tt_pthread_mutex_unlock(&buf->mutex);
+	region_truncate(region, region_svp);
+}
+
+int
+xrow_buf_cursor_create(struct xrow_buf *buf, const struct vclock *vclock,
+		       struct xrow_buf_cursor *cursor)
+{
+	int rc = -1;
+	tt_pthread_mutex_lock(&buf->mutex);
+	/*
+	 * Look for the most recent chunk such that all the rows
+	 * preceding it have already been seen by the reader.
+	 */
+	uint64_t gen = buf->last_gen;
+	while (gen > 0) {
+		struct xrow_buf_chunk *chunk = xrow_buf_chunk(buf, gen);
+		if (chunk->gen != gen)
+			break;
+		if (vclock_compare_ignore0(&chunk->vclock, vclock) <= 0) {
+			cursor->gen = gen;
+			cursor->offset = 0;
+			rc = 0;
+			break;
+		}
+		gen--;
+	}
+	tt_pthread_mutex_unlock(&buf->mutex);
+	return rc;
+}
+
+int
+xrow_buf_cursor_next(struct xrow_buf *buf, struct xrow_buf_cursor *cursor,
+		     struct ibuf *out, bool *is_rotate)
+{
+	int rc = 0;
+	*is_rotate = false;
+	tt_pthread_mutex_lock(&buf->mutex);
+	struct xrow_buf_chunk *chunk = xrow_buf_chunk(buf, cursor->gen);
+	if (chunk->gen != cursor->gen) {
+		rc = -1;
+		goto out;
+	}
+	assert(cursor->offset <= chunk->used);
+	if (cursor->offset == chunk->used) {
+		if (cursor->gen == buf->last_gen) {
+			rc = 1;
+			goto out;
+		}
+		cursor->gen++;
+		cursor->offset = 0;
+		chunk = xrow_buf_chunk(buf, cursor->gen);
+		assert(chunk->gen == cursor->gen);
+		*is_rotate = chunk->is_rotate;
+	}
+	size_t size = chunk->used - cursor->offset;
+	if (size > 0) {
+		void *data = xibuf_alloc(out, size);
+		memcpy(data, chunk->data + cursor->offset, size);
+		cursor->offset = chunk->used;
+	}
+out:
+	tt_pthread_mutex_unlock(&buf->mutex);
+	return rc;
+}
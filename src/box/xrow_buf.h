@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vclock/vclock.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct ibuf;
+struct xrow_header;
+
+enum {
+	/** Number of chunks a buffer is split into. */
+	XROW_BUF_CHUNK_COUNT = 16,
+};
+
+/** A chunk of rows stored in a buffer. */
+struct xrow_buf_chunk {
+	/**
+	 * Sequence number of the chunk or 0 if the chunk has never
+	 * been used. Grows every time a chunk is reused.
+	 */
+	uint64_t gen;
+	/** Vclock of the last row written before the chunk. */
+	struct vclock vclock;
+	/** Set if the chunk starts a new WAL file. */
+	bool is_rotate;
+	/** Rows encoded in the xlog format, without fixheaders. */
+	char *data;
+	/** Size of the data. */
+	size_t used;
+	/** Size of the memory allocated for the data. */
+	size_t capacity;
+};
+
+/**
+ * In-memory buffer of recently written WAL rows.
+ *
+ * Rows are appended by the WAL thread to a ring of chunks. Once all
+ * the chunks are filled up, the oldest one is reused so the buffer
+ * keeps only the most recent rows. Readers, e.g. replication relays,
+ * may run in other threads: they copy rows out of the buffer under
+ * the buffer mutex and fall back on reading WAL files if they lag
+ * behind so much that the rows they need have been overwritten.
+ */
+struct xrow_buf {
+	/** Protects the chunks from concurrent access. */
+	pthread_mutex_t mutex;
+	/** Ring of chunks. */
+	struct xrow_buf_chunk chunks[XROW_BUF_CHUNK_COUNT];
+	/** Size of a chunk. */
+	size_t chunk_size;
+	/** Sequence number of the chunk rows are appended to. */
+	uint64_t last_gen;
+	/** Vclock of the last row written to the buffer. */
+	struct vclock vclock;
+};
+
+/** Position of a reader in a buffer. */
+struct xrow_buf_cursor {
+	/** Sequence number of the chunk to read. */
+	uint64_t gen;
+	/** Offset of the next row in the chunk. */
+	size_t offset;
+};
+
+/**
+ * Create a buffer keeping up to about @a size bytes of rows.
+ * The buffer doesn't store anything until xrow_buf_start() is called.
+ */
+void
+xrow_buf_create(struct xrow_buf *buf, size_t size);
+
+/** Free the memory used by a buffer. */
+void
+xrow_buf_destroy(struct xrow_buf *buf);
+
+/** Check if xrow_buf_start() has been called for a buffer. */
+static inline bool
+xrow_buf_is_started(const struct xrow_buf *buf)
+{
+	return buf->last_gen > 0;
+}
+
+/**
+ * Start a new chunk. Rows written after this call are appended to it.
+ * @a vclock is the vclock of the last row written to the WAL before
+ * the chunk. @a is_rotate is set if the chunk starts a new WAL file.
+ */
+void
+xrow_buf_start(struct xrow_buf *buf, const struct vclock *vclock,
+	       bool is_rotate);
+
+/**
+ * Append rows written to the WAL to a started buffer. The function
+ * never fails: if the rows don't fit in the current chunk, the next one
+ * is started, evicting the oldest rows.
+ */
+void
+xrow_buf_write(struct xrow_buf *buf, struct xrow_header **rows,
+	       int row_count);
+
+/**
+ * Position a cursor so that all the rows following @a vclock can be read
+ * from the buffer. The cursor may also point at some preceding rows, so
+ * the reader is supposed to skip rows with LSNs it has already seen.
+ * Returns -1 if some of the rows following @a vclock have already been
+ * evicted or the buffer hasn't been started.
+ */
+int
+xrow_buf_cursor_create(struct xrow_buf *buf, const struct vclock *vclock,
+		       struct xrow_buf_cursor *cursor);
+
+/**
+ * Copy the rows following the cursor position and stored in the same
+ * chunk to @a out and advance the cursor. If the rows of the current
+ * chunk have been read and there are newer chunks, the cursor moves to
+ * the next chunk, and @a is_rotate is set if that chunk starts a new WAL
+ * file. In this case the rows preceding the new WAL file must be handled
+ * by the caller before the ones copied by this call.
+ *
+ * @retval 0 rows were copied or the cursor moved to the next chunk
+ * @retval 1 all the rows stored in the buffer have been read
+ * @retval -1 the rows following the cursor have been evicted
+ */
+int
+xrow_buf_cursor_next(struct xrow_buf *buf, struct xrow_buf_cursor *cursor,
+		     struct ibuf *out, bool *is_rotate);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -31,6 +31,7 @@
 #include "cbus.h"
 
 #include <limits.h>
+#include <pmatomic.h>
 #include "fiber.h"
 #include "trigger.h"
 
@@ -46,8 +47,91 @@ struct cbus {
 	pthread_cond_t cond;
 	/** Connected endpoints */
 	struct rlist endpoints;
+	/** Statistics of all pipes, linked by cpipe_stat::in_cbus. */
+	struct rlist pipe_stats;
 };
 
+/**
+ * Pipe statistics. Allocated separately from the pipe, because
+ * some pipes are never destroyed, but may be freed.
+ */
+struct cpipe_stat {
+	/** Link in cbus::pipe_stats. */
+	struct rlist in_cbus;
+	/** The statistics. The counters are updated atomically. */
+	struct cbus_pipe_stat stat;
+};
+
+/**
+ * Add a value to a pipe statistics counter. Counters are only
+ * updated by the producer so an atomic read-modify-write isn't
+ * needed.
+ */
+static inline void
+cpipe_stat_add(uint64_t *counter, uint64_t value)
+{
+	uint64_t old = pm_atomic_load_explicit(counter,
+					       pm_memory_order_relaxed);
+	pm_atomic_store_explicit(counter, old + value,
+				 pm_memory_order_relaxed);
+}
+
+/**
+ * Push a batch of messages to the endpoint queue. The input list
+ * is emptied. Returns true if the queue was empty.
+ */
+static bool
+cbus_endpoint_push(struct cbus_endpoint *endpoint, struct stailq *input)
+{
+	assert(!stailq_empty(input));
+	/*
+	 * The queue is a stack so link the messages in the reverse
+	 * order for the consumer to restore the original order.
+	 */
+	struct stailq_entry *last = stailq_first(input);
+	stailq_reverse(input);
+	struct stailq_entry *first = stailq_first(input);
+	struct stailq_entry *head = pm_atomic_load_explicit(
+		&endpoint->output, pm_memory_order_relaxed);
+	do {
+		last->next.value = head;
+	} while (!pm_atomic_compare_exchange_weak(&endpoint->output,
+						  &head, first));
+	stailq_create(input);
+	return head == NULL;
+}
+
+/**
+ * Check if the consumer needs to be woken up after pushing messages
+ * to the endpoint queue.
+ */
+static inline bool
+cbus_endpoint_needs_wakeup(struct cbus_endpoint *endpoint, bool was_empty)
+{
+	/*
+	 * Pairs with the check of the queue in cbus_loop() after
+	 * clearing the flag: either the consumer sees the messages or
+	 * we see that the consumer isn't polling the queue anymore.
+	 */
+	return was_empty && !pm_atomic_load(&endpoint->is_polling);
+}
+
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
+{
+	struct stailq_entry *head = pm_atomic_exchange(&endpoint->output,
+						       NULL);
+	/* Restore the original message order. */
+	struct stailq batch;
+	stailq_create(&batch);
+	while (head != NULL) {
+		struct stailq_entry *next = head->next.value;
+		stailq_add(&batch, head);
+		head = next;
+	}
+	stailq_concat(output, &batch);
+}
+
 /** A singleton for all cords. */
 static struct cbus cbus;
 
@@ -106,6 +190,75 @@ acquire_consumer(struct cbus_endpoint **pipe_endpoint, const char *name)
 	tt_pthread_mutex_unlock(&cbus.mutex);
 }
 
+/** Allocate and register statistics of a pipe. */
+static struct cpipe_stat *
+cpipe_stat_new(const char *consumer)
+{
+	struct cpipe_stat *stat = xmalloc(sizeof(*stat));
+	memset(&stat->stat, 0, sizeof(stat->stat));
+	snprintf(stat->stat.producer, sizeof(stat->stat.producer), "%s",
+		 cord_name(cord()));
+	snprintf(stat->stat.consumer, sizeof(stat->stat.consumer), "%s",
+		 consumer);
+	tt_pthread_mutex_lock(&cbus.mutex);
+	rlist_add_tail_entry(&cbus.pipe_stats, stat, in_cbus);
+	tt_pthread_mutex_unlock(&cbus.mutex);
+	return stat;
+}
+
+/** Unregister and free statistics of a pipe. */
+static void
+cpipe_stat_delete(struct cpipe_stat *stat)
+{
+	tt_pthread_mutex_lock(&cbus.mutex);
+	rlist_del_entry(stat, in_cbus);
+	tt_pthread_mutex_unlock(&cbus.mutex);
+	free(stat);
+}
+
+struct cbus_pipe_stat *
+cbus_get_pipe_stat(struct region *region, int *count)
+{
+	tt_pthread_mutex_lock(&cbus.mutex);
+	int size = 0;
+	struct cpipe_stat *stat;
+	rlist_foreach_entry(stat, &cbus.pipe_stats, in_cbus)
+		size++;
+	struct cbus_pipe_stat *result =
+		xregion_alloc_array(region, struct cbus_pipe_stat, size);
+	*count = 0;
+	rlist_foreach_entry(stat, &cbus.pipe_stats, in_cbus) {
+		struct cbus_pipe_stat *s = NULL;
+		for (int i = 0; i < *count; i++) {
+			if (strcmp(result[i].producer,
+				   stat->stat.producer) == 0 &&
+			    strcmp(result[i].consumer,
+				   stat->stat.consumer) == 0) {
+				s = &result[i];
+				break;
+			}
+		}
+		if (s == NULL) {
+			s = &result[(*count)++];
+			memcpy(s->producer, stat->stat.producer,
+			       sizeof(s->producer));
+			memcpy(s->consumer, stat->stat.consumer,
+			       sizeof(s->consumer));
+			s->messages = 0;
+			s->batches = 0;
+			s->wakeups = 0;
+		}
+		s->messages += pm_atomic_load_explicit(
+			&stat->stat.messages, pm_memory_order_relaxed);
+		s->batches += pm_atomic_load_explicit(
+			&stat->stat.batches, pm_memory_order_relaxed);
+		s->wakeups += pm_atomic_load_explicit(
+			&stat->stat.wakeups, pm_memory_order_relaxed);
+	}
+	tt_pthread_mutex_unlock(&cbus.mutex);
+	return result;
+}
+
 void
 cpipe_create(struct cpipe *pipe, const char *consumer)
 {
@@ -118,6 +271,7 @@ cpipe_create(struct cpipe *pipe, const char *consumer)
 	ev_async_init(&pipe->flush_input, cpipe_flush_cb);
 	pipe->flush_input.data = pipe;
 	rlist_create(&pipe->on_flush);
+	pipe->stat = cpipe_stat_new(consumer);
 
 	acquire_consumer(&pipe->endpoint, consumer);
 }
@@ -166,11 +320,11 @@ cpipe_destroy(struct cpipe *pipe)
 	 * delivered.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
+	/* Add the pipe shutdown message as the last one. */
+	stailq_add_tail_entry(&pipe->input, poison, msg.fifo);
 	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
+	cbus_endpoint_push(endpoint, &pipe->input);
 	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
 	/* Count statistics */
 	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 	/*
@@ -184,6 +338,7 @@ cpipe_destroy(struct cpipe *pipe)
 
 	tt_pthread_setcancelstate(old_cancel_state, NULL);
 
+	cpipe_stat_delete(pipe->stat);
 	TRASH(pipe);
 }
 
@@ -226,14 +381,11 @@ lcpipe_flush(struct lcpipe *pipe)
 	int old_cancel_state;
 	tt_pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &old_cancel_state);
 
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	output_was_empty = stailq_empty(&endpoint->output);
 	/** Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
+	output_was_empty = cbus_endpoint_push(endpoint, &pipe->input);
 
 	pipe->n_input = 0;
-	if (output_was_empty) {
+	if (cbus_endpoint_needs_wakeup(endpoint, output_was_empty)) {
 		/* Count statistics */
 		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 
@@ -305,11 +457,11 @@ lcpipe_delete(struct lcpipe *pipe)
 	 * delivered.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
+	/* Add the pipe shutdown message as the last one. */
+	stailq_add_tail_entry(&pipe->input, poison, msg.fifo);
 	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
+	cbus_endpoint_push(endpoint, &pipe->input);
 	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
 	/* Count statistics */
 	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 	/*
@@ -339,6 +491,7 @@ cbus_create(struct cbus *bus)
 	(void) tt_pthread_cond_init(&bus->cond, NULL);
 
 	rlist_create(&bus->endpoints);
+	rlist_create(&bus->pipe_stats);
 }
 
 static void
@@ -353,6 +506,9 @@ cbus_destroy(struct cbus *bus)
 	(void) tt_pthread_mutex_destroy(&bus->mutex);
 	(void) tt_pthread_cond_destroy(&bus->cond);
 	rmean_delete(bus->stats);
+	struct cpipe_stat *stat, *tmp;
+	rlist_foreach_entry_safe(stat, &bus->pipe_stats, in_cbus, tmp)
+		free(stat);
 }
 
 /**
@@ -376,7 +532,8 @@ cbus_endpoint_create(struct cbus_endpoint *endpoint, const char *name,
 	endpoint->n_pipes = 0;
 	fiber_cond_create(&endpoint->cond);
 	tt_pthread_mutex_init(&endpoint->mutex, NULL);
-	stailq_create(&endpoint->output);
+	endpoint->output = NULL;
+	endpoint->is_polling = false;
 	ev_async_init(&endpoint->async,
 		      (void (*)(ev_loop *, struct ev_async *, int)) fetch_cb);
 	endpoint->async.data = fetch_data;
@@ -423,7 +580,8 @@ cbus_endpoint_destroy_inner(struct cbus_endpoint *endpoint,
 	while (true) {
 		if (process_cb)
 			process_cb(endpoint);
-		if (endpoint->n_pipes == 0 && stailq_empty(&endpoint->output))
+		if (endpoint->n_pipes == 0 &&
+		    pm_atomic_load(&endpoint->output) == NULL)
 			break;
 		fiber_cond_wait(&endpoint->cond);
 	}
@@ -482,16 +640,17 @@ cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 	int old_cancel_state;
 	tt_pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &old_cancel_state);
 
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	output_was_empty = stailq_empty(&endpoint->output);
+	struct cbus_pipe_stat *stat = &pipe->stat->stat;
+	cpipe_stat_add(&stat->messages, pipe->n_input);
+	cpipe_stat_add(&stat->batches, 1);
 	/** Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
+	output_was_empty = cbus_endpoint_push(endpoint, &pipe->input);
 
 	pipe->n_input = 0;
-	if (output_was_empty) {
+	if (cbus_endpoint_needs_wakeup(endpoint, output_was_empty)) {
 		/* Count statistics */
 		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
+		cpipe_stat_add(&stat->wakeups, 1);
 
 		ev_async_send(endpoint->consumer, &endpoint->async);
 	}
@@ -777,27 +936,81 @@ cbus_unpair(struct cpipe *dest_pipe, struct cpipe *src_pipe,
 	cpipe_destroy(dest_pipe);
 }
 
-void
-cbus_process(struct cbus_endpoint *endpoint)
+/**
+ * Deliver all messages queued at the endpoint. Returns the number
+ * of delivered messages.
+ */
+static int
+cbus_deliver(struct cbus_endpoint *endpoint)
 {
 	struct stailq output;
 	stailq_create(&output);
 	cbus_endpoint_fetch(endpoint, &output);
+	int count = 0;
 	struct cmsg *msg, *msg_next;
-	stailq_foreach_entry_safe(msg, msg_next, &output, fifo)
+	stailq_foreach_entry_safe(msg, msg_next, &output, fifo) {
 		cmsg_deliver(msg);
+		count++;
+	}
+	return count;
 }
 
+void
+cbus_process(struct cbus_endpoint *endpoint)
+{
+	cbus_deliver(endpoint);
+}
+
+/**
+ * Bounds of the number of event loop iterations cbus_loop() polls
+ * the endpoint queue for before going to sleep.
+ */
+enum {
+	CBUS_LOOP_SPIN_MIN = 1,
+	CBUS_LOOP_SPIN_MAX = 128,
+};
+
 void
 cbus_loop(struct cbus_endpoint *endpoint)
 {
+	/*
+	 * After processing messages the loop polls the queue for
+	 * a few event loop iterations before going to sleep so that
+	 * producers don't need to wake it up while the load is high.
+	 * The number of iterations is doubled each time a message
+	 * arrives while polling and halved otherwise.
+	 */
+	int spin_limit = CBUS_LOOP_SPIN_MIN;
+	int spin_count = 0;
+	pm_atomic_store(&endpoint->is_polling, true);
 	while (true) {
-		cbus_process(endpoint);
+		int count = cbus_deliver(endpoint);
 		fiber_check_gc();
 		if (fiber_is_cancelled())
 			break;
-		fiber_yield();
+		if (count > 0) {
+			if (spin_count > 0)
+				spin_limit = MIN(spin_limit * 2,
+						 CBUS_LOOP_SPIN_MAX);
+			spin_count = 0;
+		}
+		if (spin_count < spin_limit) {
+			spin_count++;
+			fiber_reschedule();
+			continue;
+		}
+		spin_limit = MAX(spin_limit / 2, CBUS_LOOP_SPIN_MIN);
+		spin_count = 0;
+		pm_atomic_store(&endpoint->is_polling, false);
+		/*
+		 * Pairs with cbus_endpoint_needs_wakeup(): recheck
+		 * the queue in case a producer saw the flag set.
+		 */
+		if (pm_atomic_load(&endpoint->output) == NULL)
+			fiber_yield();
+		pm_atomic_store(&endpoint->is_polling, true);
 	}
+	pm_atomic_store(&endpoint->is_polling, false);
 }
 
 static void
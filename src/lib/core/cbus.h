@@ -109,6 +109,8 @@ cmsg_init(struct cmsg *msg, const struct cmsg_hop *route)
 void
 cmsg_deliver(struct cmsg *msg);
 
+struct cpipe_stat;
+
 /** A  uni-directional FIFO queue from one cord to another. */
 struct cpipe {
 	/** Staging area for pushed messages */
@@ -140,6 +142,11 @@ struct cpipe {
 	 * is not empty.
 	 */
 	struct rlist on_flush;
+	/**
+	 * Pipe statistics. Updated only by the producer, may be
+	 * read by any thread, see cbus_get_pipe_stat().
+	 */
+	struct cpipe_stat *stat;
 };
 
 /**
@@ -255,10 +262,24 @@ struct cbus_endpoint {
 	char name[FIBER_NAME_MAX];
 	/** Member of cbus->endpoints */
 	struct rlist in_cbus;
-	/** The lock around the pipe. */
+	/**
+	 * The lock held while a pipe is being disconnected from
+	 * the endpoint, so that the endpoint isn't destroyed
+	 * before the producer is done with it.
+	 */
 	pthread_mutex_t mutex;
-	/** A queue with incoming messages. */
-	struct stailq output;
+	/**
+	 * Incoming messages, linked in the reverse order. The
+	 * queue is lock-free: producers push batches of messages
+	 * with compare-and-swap while the consumer takes all
+	 * queued messages at once with an atomic exchange.
+	 */
+	struct stailq_entry *output;
+	/**
+	 * Set while the consumer polls the queue, see cbus_loop().
+	 * Producers don't need to wake up the consumer then.
+	 */
+	bool is_polling;
 	/** Consumer cord loop */
 	ev_loop *consumer;
 	/** Async to notify the consumer */
@@ -272,13 +293,31 @@ struct cbus_endpoint {
 /**
  * Fetch incomming messages to output
  */
-static inline void
-cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
-{
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	stailq_concat(output, &endpoint->output);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-}
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output);
+
+/** Statistics of pipes connecting a pair of cords. */
+struct cbus_pipe_stat {
+	/** Name of the producer cord. */
+	char producer[FIBER_NAME_INLINE];
+	/** Name of the consumer endpoint. */
+	char consumer[FIBER_NAME_MAX];
+	/** Number of messages sent to the consumer. */
+	uint64_t messages;
+	/** Number of times pipe input was flushed to the consumer. */
+	uint64_t batches;
+	/** Number of times the consumer was woken up. */
+	uint64_t wakeups;
+};
+
+/**
+ * Collect statistics of all pipes. Statistics of pipes that have
+ * the same producer and consumer names are summed up. Returns an
+ * array allocated on the given region and sets @a count to the
+ * number of its entries.
+ */
+struct cbus_pipe_stat *
+cbus_get_pipe_stat(struct region *region, int *count);
 
 /** Initialize the global singleton bus. */
 void
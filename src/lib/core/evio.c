@@ -57,6 +57,12 @@ struct evio_service_entry {
 	struct ev_io ev;
 	/** Pointer to the root evio_service, which contains this object */
 	struct evio_service *service;
+	/**
+	 * Set if the acceptor socket was bound by this entry on attach,
+	 * see evio_service_attach_reuseport(), and must be closed on
+	 * detach.
+	 */
+	bool owns_fd;
 };
 
 static inline bool
@@ -154,6 +160,21 @@ evio_setsockopt_server(int fd, int family, int type)
 	return 0;
 }
 
+/** Allow binding other sockets to the same address. */
+static int
+evio_setsockopt_reuseport(int fd)
+{
+#ifdef SO_REUSEPORT
+	int on = 1;
+	return sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#else
+	(void)fd;
+	errno = ENOPROTOOPT;
+	diag_set(SocketError, sio_socketname(fd), "setsockopt(SO_REUSEPORT)");
+	return -1;
+#endif
+}
+
 static inline const char *
 evio_service_name(struct evio_service *service)
 {
@@ -263,6 +284,9 @@ evio_service_entry_bind_addr(struct evio_service_entry *entry)
 	if (evio_setsockopt_server(fd, entry->addr.sa_family,
 				   SOCK_STREAM) != 0)
 		goto error;
+	if (entry->service->reuseport && entry->addr.sa_family != AF_UNIX &&
+	    evio_setsockopt_reuseport(fd) != 0)
+		goto error;
 
 	if (sio_bind(fd, &entry->addr, entry->addr_len) != 0)
 		goto error;
@@ -321,6 +345,7 @@ evio_service_entry_create(struct evio_service_entry *entry,
 	ev_io_set(&entry->ev, -1, 0);
 	entry->ev.data = entry;
 	entry->service = service;
+	entry->owns_fd = false;
 }
 
 /**
@@ -386,6 +411,9 @@ evio_service_entry_detach(struct evio_service_entry *entry)
 		ev_io_stop(entry->service->loop, &entry->ev);
 		entry->addr_len = 0;
 	}
+	if (entry->owns_fd && close(entry->ev.fd) < 0)
+		say_error("Failed to close socket: %s", tt_strerror(errno));
+	entry->owns_fd = false;
 	ev_io_set(&entry->ev, -1, 0);
 	uri_destroy(&entry->uri);
 }
@@ -394,6 +422,7 @@ evio_service_entry_detach(struct evio_service_entry *entry)
 static void
 evio_service_entry_stop(struct evio_service_entry *entry)
 {
+	assert(!entry->owns_fd);
 	iostream_ctx_destroy(&entry->io_ctx);
 
 	int service_fd = entry->ev.fd;
@@ -483,6 +512,27 @@ evio_service_attach(struct evio_service *dst, const struct evio_service *src)
 		evio_service_entry_attach(&dst->entries[i], &src->entries[i]);
 }
 
+int
+evio_service_attach_reuseport(struct evio_service *dst,
+			      const struct evio_service *src)
+{
+	assert(dst->entry_count == 0);
+	assert(src->reuseport);
+	dst->reuseport = true;
+	evio_service_create_entries(dst, src->entry_count);
+	for (int i = 0; i < src->entry_count; i++) {
+		struct evio_service_entry *entry = &dst->entries[i];
+		evio_service_entry_attach(entry, &src->entries[i]);
+		if (entry->addr.sa_family == AF_UNIX)
+			continue;
+		ev_io_set(&entry->ev, -1, 0);
+		if (evio_service_entry_bind_addr(entry) != 0)
+			return -1;
+		entry->owns_fd = true;
+	}
+	return 0;
+}
+
 void
 evio_service_detach(struct evio_service *service)
 {
@@ -88,6 +88,12 @@ struct evio_service {
         evio_accept_f on_accept;
         void *on_accept_param;
         ev_loop *loop;
+        /**
+         * Set SO_REUSEPORT on TCP acceptor sockets so that other
+         * services can bind to the same addresses, see
+         * evio_service_attach_reuseport().
+         */
+        bool reuseport;
 };
 
 /**
@@ -135,6 +141,17 @@ evio_service_stop(struct evio_service *service);
 void
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
 
+/**
+ * Same as evio_service_attach(), but instead of sharing TCP acceptor
+ * sockets with @a src, binds own sockets to the same addresses so that
+ * the kernel distributes incoming connections evenly among all the
+ * services. UNIX sockets are still shared. @a src must be bound with
+ * the reuseport flag set. The own sockets are closed on detach.
+ */
+int
+evio_service_attach_reuseport(struct evio_service *dst,
+			      const struct evio_service *src);
+
 bool
 evio_service_is_active(const struct evio_service *service);
 
@@ -0,0 +1,403 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "fio_uring.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "trivia/config.h"
+#include "trivia/util.h"
+#include "diag.h"
+#include "fio.h"
+#include "say.h"
+
+#if defined(HAVE_LINUX_IO_URING_H)
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+enum {
+	/** Number of submission queue entries. */
+	FIO_URING_ENTRIES = 16,
+	/**
+	 * Max number of write requests submitted with one system
+	 * call. One more entry is reserved for the sync request.
+	 */
+	FIO_URING_WRITE_MAX = FIO_URING_ENTRIES - 1,
+};
+
+struct fio_uring {
+	/** Ring file descriptor. */
+	int fd;
+	/** Submission queue ring, mapped from the kernel. */
+	void *sq_ring;
+	size_t sq_ring_size;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	/** Submission queue entries, mapped from the kernel. */
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+	/** Completion queue ring, mapped from the kernel. */
+	void *cq_ring;
+	size_t cq_ring_size;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_cqe *cqes;
+	/**
+	 * Number of the current fio_uring_writev() call, stored in
+	 * the user data of submitted requests. Used to ignore stale
+	 * completions left after a failed system call.
+	 */
+	uint32_t seq;
+	/** Copy of the buffers being written. */
+	struct iovec *iov;
+	/** Capacity of the iov array. */
+	int iov_capacity;
+};
+
+bool
+fio_uring_is_supported(void)
+{
+	return true;
+}
+
+struct fio_uring *
+fio_uring_new(void)
+{
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	int fd = syscall(__NR_io_uring_setup, FIO_URING_ENTRIES, &params);
+	if (fd < 0) {
+		diag_set(SystemError, "io_uring_setup");
+		return NULL;
+	}
+	if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+		close(fd);
+		diag_set(IllegalParams, "io_uring doesn't support writing "
+			 "at the current file position");
+		return NULL;
+	}
+	struct fio_uring *ring = xcalloc(1, sizeof(*ring));
+	ring->fd = fd;
+	ring->sq_ring_size = params.sq_off.array +
+			     params.sq_entries * sizeof(unsigned);
+	ring->sq_ring = mmap(NULL, ring->sq_ring_size,
+			     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			     fd, IORING_OFF_SQ_RING);
+	if (ring->sq_ring == MAP_FAILED) {
+		ring->sq_ring = NULL;
+		goto fail;
+	}
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqes_size,
+			  PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			  fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		ring->sqes = NULL;
+		goto fail;
+	}
+	ring->cq_ring_size = params.cq_off.cqes +
+			     params.cq_entries * sizeof(struct io_uring_cqe);
+	ring->cq_ring = mmap(NULL, ring->cq_ring_size,
+			     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			     fd, IORING_OFF_CQ_RING);
+	if (ring->cq_ring == MAP_FAILED) {
+		ring->cq_ring = NULL;
+		goto fail;
+	}
+	char *sq = ring->sq_ring;
+	ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+	ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+	char *cq = ring->cq_ring;
+	ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+	ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+	return ring;
+fail:
+	diag_set(SystemError, "failed to map io_uring");
+	fio_uring_delete(ring);
+	return NULL;
+}
+
+void
+fio_uring_delete(struct fio_uring *ring)
+{
+	if (ring->cq_ring != NULL)
+		munmap(ring->cq_ring, ring->cq_ring_size);
+	if (ring->sqes != NULL)
+		munmap(ring->sqes, ring->sqes_size);
+	if (ring->sq_ring != NULL)
+		munmap(ring->sq_ring, ring->sq_ring_size);
+	close(ring->fd);
+	free(ring->iov);
+	free(ring);
+}
+
+/** Get a submission queue entry for a new request. */
+static struct io_uring_sqe *
+fio_uring_get_sqe(struct fio_uring *ring, unsigned idx)
+{
+	unsigned tail = *ring->sq_tail;
+	unsigned i = tail & *ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[i];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->user_data = (uint64_t)ring->seq << 32 | idx;
+	ring->sq_array[i] = i;
+	/*
+	 * The kernel doesn't look at the entry until io_uring_enter()
+	 * is called, because submission queue polling isn't used, so
+	 * the caller may still fill the entry after this.
+	 */
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	return sqe;
+}
+
+/**
+ * Reap the completions of the current requests. Stores the result
+ * of the i-th request in res[i]. Returns the number of reaped
+ * completions.
+ */
+static unsigned
+fio_uring_reap(struct fio_uring *ring, int *res)
+{
+	unsigned reaped = 0;
+	unsigned head = *ring->cq_head;
+	unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	for (; head != tail; head++) {
+		struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+		if ((uint32_t)(cqe->user_data >> 32) != ring->seq)
+			continue;
+		unsigned idx = (uint32_t)cqe->user_data;
+		assert(idx < FIO_URING_ENTRIES);
+		res[idx] = cqe->res;
+		reaped++;
+	}
+	__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+	return reaped;
+}
+
+/**
+ * Drop the queued requests that haven't been submitted yet and wait
+ * for the submitted ones, @a pending in total with the dropped ones,
+ * to complete so that the kernel doesn't access the caller's buffers
+ * after fio_uring_writev() returns. Doesn't change errno.
+ */
+static void
+fio_uring_drain(struct fio_uring *ring, unsigned pending, int *res)
+{
+	int save_errno = errno;
+	unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+	unsigned unsubmitted = *ring->sq_tail - head;
+	assert(unsubmitted <= pending);
+	/*
+	 * Submission queue polling isn't used, so the kernel doesn't
+	 * look at the queue until io_uring_enter() is called.
+	 */
+	__atomic_store_n(ring->sq_tail, head, __ATOMIC_RELEASE);
+	pending -= unsubmitted;
+	while (pending > 0) {
+		if (syscall(__NR_io_uring_enter, ring->fd, 0, 1,
+			    IORING_ENTER_GETEVENTS, NULL, 0) < 0) {
+			if (errno == EINTR)
+				continue;
+			panic_syserror("io_uring_enter");
+		}
+		pending -= fio_uring_reap(ring, res);
+	}
+	errno = save_errno;
+}
+
+/**
+ * Submit the queued requests and wait until @a count of them complete.
+ * Stores the result of the i-th request in res[i]. On failure, waits
+ * for the submitted requests and drops the rest.
+ */
+static int
+fio_uring_wait(struct fio_uring *ring, unsigned count, int *res)
+{
+	unsigned completed = 0;
+	while (completed < count) {
+		unsigned to_submit = *ring->sq_tail -
+			__atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+		if (syscall(__NR_io_uring_enter, ring->fd, to_submit,
+			    1, IORING_ENTER_GETEVENTS, NULL, 0) < 0) {
+			if (errno == EINTR)
+				continue;
+			fio_uring_drain(ring, count - completed, res);
+			return -1;
+		}
+		completed += fio_uring_reap(ring, res);
+	}
+	return 0;
+}
+
+ssize_t
+fio_uring_writev(struct fio_uring *ring, int fd, const struct iovec *iov,
+		 int iovcnt, bool datasync)
+{
+	assert(iov != NULL && iovcnt >= 0);
+	/* Copy the buffers so as to be able to retry short writes. */
+	if (ring->iov_capacity < iovcnt) {
+		ring->iov_capacity = iovcnt;
+		ring->iov = xrealloc(ring->iov, iovcnt * sizeof(*iov));
+	}
+	memcpy(ring->iov, iov, iovcnt * sizeof(*iov));
+	struct iovec *pos = ring->iov;
+	struct iovec *end = ring->iov + iovcnt;
+	ssize_t written = 0;
+	bool synced = !datasync;
+	while (pos < end || !synced) {
+		ring->seq++;
+		/* Queue write requests linked with each other. */
+		size_t expected[FIO_URING_WRITE_MAX];
+		unsigned count = 0;
+		struct iovec *next = pos;
+		while (next < end && count < FIO_URING_WRITE_MAX) {
+			int cnt = MIN(end - next, IOV_MAX);
+			struct io_uring_sqe *sqe = fio_uring_get_sqe(ring,
+								     count);
+			sqe->opcode = IORING_OP_WRITEV;
+			sqe->flags = IOSQE_IO_LINK;
+			sqe->fd = fd;
+			sqe->addr = (uintptr_t)next;
+			sqe->len = cnt;
+			/* Write at the current file position. */
+			sqe->off = (uint64_t)-1;
+			expected[count] = 0;
+			for (int i = 0; i < cnt; i++)
+				expected[count] += next[i].iov_len;
+			next += cnt;
+			count++;
+		}
+		/*
+		 * Queue the sync request linked to the writes so that
+		 * it's only executed if all of them succeed.
+		 */
+		bool do_sync = datasync && next == end;
+		if (do_sync) {
+			struct io_uring_sqe *sqe = fio_uring_get_sqe(ring,
+								     count);
+			sqe->opcode = IORING_OP_FSYNC;
+			sqe->fd = fd;
+			sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+		} else {
+			assert(count > 0);
+			unsigned i = (*ring->sq_tail - 1) & *ring->sq_mask;
+			ring->sqes[i].flags &= ~IOSQE_IO_LINK;
+		}
+		int res[FIO_URING_ENTRIES];
+		if (fio_uring_wait(ring, count + do_sync, res) != 0) {
+			diag_set(SystemError, "io_uring_enter, [%s]",
+				 fio_filename(fd));
+			say_syserror("io_uring_enter, [%s]", fio_filename(fd));
+			return -1;
+		}
+		/*
+		 * If a write fails or is short, the following requests
+		 * of the chain are cancelled. Advance past the data that
+		 * has been written and retry the rest.
+		 */
+		bool is_short = false;
+		for (unsigned i = 0; i < count && !is_short; i++) {
+			if (res[i] < 0) {
+				if (res[i] == -ECANCELED || res[i] == -EINTR ||
+				    res[i] == -EAGAIN)
+					break;
+				errno = -res[i];
+				diag_set(SystemError, "writev, [%s]",
+					 fio_filename(fd));
+				say_syserror("writev, [%s]", fio_filename(fd));
+				return -1;
+			}
+			if (res[i] == 0 && expected[i] > 0) {
+				/* Retrying would loop forever. */
+				errno = EIO;
+				diag_set(SystemError, "writev, [%s]: "
+					 "nothing written", fio_filename(fd));
+				say_syserror("writev, [%s]: nothing written",
+					     fio_filename(fd));
+				return -1;
+			}
+			is_short = (size_t)res[i] < expected[i];
+			written += res[i];
+			size_t nwr = res[i];
+			while (pos < end && nwr >= pos->iov_len) {
+				nwr -= pos->iov_len;
+				pos++;
+			}
+			if (nwr > 0) {
+				pos->iov_base = (char *)pos->iov_base + nwr;
+				pos->iov_len -= nwr;
+			}
+		}
+		if (do_sync && pos == end) {
+			if (res[count] < 0 && res[count] != -ECANCELED &&
+			    res[count] != -EINTR) {
+				errno = -res[count];
+				diag_set(SystemError, "fdatasync, [%s]",
+					 fio_filename(fd));
+				say_syserror("fdatasync, [%s]",
+					     fio_filename(fd));
+				return -1;
+			}
+			synced = res[count] >= 0;
+		}
+		/* Skip empty buffers left at the end. */
+		while (pos < end && pos->iov_len == 0)
+			pos++;
+	}
+	return written;
+}
+
+#else /* !defined(HAVE_LINUX_IO_URING_H) */
+
+bool
+fio_uring_is_supported(void)
+{
+	return false;
+}
+
+struct fio_uring *
+fio_uring_new(void)
+{
+	diag_set(IllegalParams, "io_uring is not supported");
+	return NULL;
+}
+
+void
+fio_uring_delete(struct fio_uring *ring)
+{
+	(void)ring;
+	unreachable();
+}
+
+ssize_t
+fio_uring_writev(struct fio_uring *ring, int fd, const struct iovec *iov,
+		 int iovcnt, bool datasync)
+{
+	(void)ring;
+	(void)fd;
+	(void)iov;
+	(void)iovcnt;
+	(void)datasync;
+	unreachable();
+	return -1;
+}
+
+#endif /* !defined(HAVE_LINUX_IO_URING_H) */
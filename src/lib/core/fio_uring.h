@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct iovec;
+
+/**
+ * A minimal io_uring(7) instance used for writing files.
+ *
+ * Unlike writev(2) followed by fdatasync(2), a write and the following
+ * sync are submitted to the kernel as a linked chain of requests with
+ * a single system call. A ring isn't thread-safe: it must only be used
+ * by one thread at a time.
+ */
+struct fio_uring;
+
+/**
+ * Check if io_uring is supported by the build. The kernel may still
+ * lack support, in which case fio_uring_new() fails.
+ */
+bool
+fio_uring_is_supported(void);
+
+/**
+ * Create a new ring. Returns NULL and sets diag on failure, e.g. if
+ * the kernel doesn't support io_uring or doesn't support writing at
+ * the current file position with it.
+ */
+struct fio_uring *
+fio_uring_new(void);
+
+/** Destroy a ring. */
+void
+fio_uring_delete(struct fio_uring *ring);
+
+/**
+ * Write the given buffers to a file at the current file position,
+ * re-trying short writes, and advance the file position. If @a datasync
+ * is set, the file data is synced once written, as with fdatasync(2).
+ * The iovec array isn't modified.
+ *
+ * Returns the number of bytes written. In case of error, writes
+ * a message to the error log, sets errno and returns -1.
+ */
+ssize_t
+fio_uring_writev(struct fio_uring *ring, int fd, const struct iovec *iov,
+		 int iovcnt, bool datasync);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
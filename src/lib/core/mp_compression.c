@@ -0,0 +1,158 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "trivia/config.h"
+
+#if defined(ENABLE_TUPLE_COMPRESSION)
+# error unimplemented
+#endif
+
+#include "mp_compression.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "msgpuck.h"
+#include "mp_extension_types.h"
+
+enum {
+	/** Max size of an MP_EXT header. */
+	MP_COMPRESSION_EXT_HEADER_MAX = 6,
+};
+
+bool
+mp_is_compression(const char *data)
+{
+	if (mp_typeof(*data) != MP_EXT)
+		return false;
+	int8_t type;
+	mp_decode_extl(&data, &type);
+	return type == MP_COMPRESSION;
+}
+
+size_t
+mp_compress_bound(size_t src_size, enum compression_type type)
+{
+	return MP_COMPRESSION_EXT_HEADER_MAX + mp_sizeof_uint(type) +
+	       mp_sizeof_uint(src_size) + tt_compress_bound(type, src_size);
+}
+
+char *
+mp_compress(char *dst, const char *src, size_t src_size,
+	    enum compression_type type, struct tt_compression_dict *dict)
+{
+	assert(type != COMPRESSION_TYPE_NONE && type < compression_type_MAX);
+	uint32_t header_size = mp_sizeof_uint(type) + mp_sizeof_uint(src_size);
+	/*
+	 * The size of the MP_EXT header depends on the size of the
+	 * compressed data so we compress the data leaving room for the
+	 * largest header and then move it to the actual position.
+	 */
+	char *data = dst + MP_COMPRESSION_EXT_HEADER_MAX + header_size;
+	ssize_t size = tt_compress(type, dict, src, src_size, data);
+	if (size < 0)
+		return NULL;
+	char *pos = mp_encode_extl(dst, MP_COMPRESSION, header_size + size);
+	pos = mp_encode_uint(pos, type);
+	pos = mp_encode_uint(pos, src_size);
+	assert(pos <= data);
+	memmove(pos, data, size);
+	return pos + size;
+}
+
+/**
+ * Decode the header of an MP_COMPRESSION extension payload ending at
+ * @a end. Returns -1 if the header is invalid.
+ */
+static int
+mp_decode_compression_header(const char **data, const char *end,
+			     enum compression_type *type, size_t *size)
+{
+	const char *pos = *data;
+	if (pos >= end || mp_typeof(*pos) != MP_UINT ||
+	    mp_check_uint(pos, end) > 0)
+		return -1;
+	uint64_t value = mp_decode_uint(&pos);
+	if (value == COMPRESSION_TYPE_NONE || value >= compression_type_MAX)
+		return -1;
+	*type = value;
+	if (pos >= end || mp_typeof(*pos) != MP_UINT ||
+	    mp_check_uint(pos, end) > 0)
+		return -1;
+	value = mp_decode_uint(&pos);
+	if (value == 0 || value > UINT32_MAX)
+		return -1;
+	*size = value;
+	*data = pos;
+	return 0;
+}
+
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size)
+{
+	const char *data = *src;
+	int8_t ext_type;
+	uint32_t len = mp_decode_extl(&data, &ext_type);
+	assert(ext_type == MP_COMPRESSION);
+	const char *end = data + len;
+	enum compression_type type;
+	size_t size;
+	if (mp_decode_compression_header(&data, end, &type, &size) != 0)
+		return 0;
+	if (dst_size < size)
+		return size;
+	if (tt_decompress(type, data, end - data, dst, size) != 0)
+		return 0;
+	*src = end;
+	return size;
+}
+
+/**
+ * Decompress an MP_COMPRESSION extension payload of @a len bytes
+ * to a new buffer. The buffer must be freed with free().
+ * Returns NULL if the data is corrupted.
+ */
+static char *
+mp_decompress_payload(const char **data, uint32_t len)
+{
+	const char *pos = *data;
+	const char *end = pos + len;
+	enum compression_type type;
+	size_t size;
+	if (mp_decode_compression_header(&pos, end, &type, &size) != 0)
+		return NULL;
+	char *buf = xmalloc(size);
+	const char *value = buf;
+	if (tt_decompress(type, pos, end - pos, buf, size) != 0 ||
+	    mp_check(&value, buf + size) != 0 || value != buf + size) {
+		free(buf);
+		return NULL;
+	}
+	*data = end;
+	return buf;
+}
+
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
+{
+	char *value = mp_decompress_payload(data, len);
+	if (value == NULL)
+		return -1;
+	int rc = mp_snprint(buf, size, value);
+	free(value);
+	return rc;
+}
+
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len)
+{
+	char *value = mp_decompress_payload(data, len);
+	if (value == NULL)
+		return -1;
+	int rc = mp_fprint(file, value);
+	free(value);
+	return rc;
+}
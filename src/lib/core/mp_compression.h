@@ -11,6 +11,7 @@
 # include "mp_compression_impl.h"
 #else /* !defined(ENABLE_TUPLE_COMPRESSION) */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include "tt_compression.h"
@@ -20,48 +21,57 @@
 extern "C" {
 #endif
 
-static inline char *
+/*
+ * A compressed MsgPack value is stored as MP_EXT of type MP_COMPRESSION.
+ * The extension payload consists of the compression type (MP_UINT),
+ * the size of the original value (MP_UINT), and the compressed data.
+ */
+
+/** Check if a MsgPack value is compressed. */
+bool
+mp_is_compression(const char *data);
+
+/**
+ * Return the max size of a MsgPack value of @a src_size bytes
+ * compressed with mp_compress().
+ */
+size_t
+mp_compress_bound(size_t src_size, enum compression_type type);
+
+/**
+ * Compress a MsgPack value of @a src_size bytes and encode it to
+ * @a dst, which must be at least mp_compress_bound() bytes long.
+ * If @a dict isn't NULL, it's used for compression. Returns the end
+ * of the encoded data or NULL on failure. Doesn't set diag.
+ */
+char *
 mp_compress(char *dst, const char *src, size_t src_size,
-	    enum compression_type type)
-{
-        (void)dst;
-        (void)src;
-        (void)src_size;
-        (void)type;
-        unreachable();
-        return NULL;
-}
+	    enum compression_type type, struct tt_compression_dict *dict);
 
-static inline size_t
-mp_decompress(const char **src, char *dst, size_t dst_size)
-{
-        (void)src;
-        (void)dst;
-        (void)dst_size;
-        unreachable();
-        return 0;
-}
+/**
+ * Decompress a MsgPack value encoded with mp_compress() and stored
+ * at @a src. Returns the size of the original value. If @a dst_size
+ * is less than that, nothing is written, like snprintf() does.
+ * Otherwise, the value is decompressed to @a dst and @a src is
+ * advanced past the compressed value. Returns 0 if the data is
+ * corrupted. Doesn't set diag.
+ */
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size);
 
-static inline int
-mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
-{
-        (void)buf;
-        (void)size;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/**
+ * Print the original value of an MP_COMPRESSION extension payload
+ * of @a len bytes to a buffer, in the same way as mp_snprint() does.
+ */
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len);
 
-static inline int
-mp_fprint_compression(FILE *file, const char **data, uint32_t len)
-{
-        (void)file;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/**
+ * Print the original value of an MP_COMPRESSION extension payload
+ * of @a len bytes to a file, in the same way as mp_fprint() does.
+ */
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -9,6 +9,285 @@
 # error unimplemented
 #endif
 
+#include "tt_compression.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zstd.h>
+#include <zdict.h>
+
+#include "trivia/util.h"
+#include "tt_pthread.h"
+
 const char *compression_type_strs[] = {
         "none",
+        "zstd",
+};
+
+enum {
+	/**
+	 * Zstd compression level. Tuples are compressed in the tx
+	 * thread so we prefer speed to compression ratio.
+	 */
+	TT_COMPRESSION_ZSTD_LEVEL = 1,
+};
+
+/** Compression contexts of a thread. */
+struct tt_compression_ctx {
+	ZSTD_CCtx *zstd_cctx;
+	ZSTD_DCtx *zstd_dctx;
 };
+
+/** Key used for freeing the contexts on thread exit. */
+static pthread_key_t tt_compression_ctx_key;
+static pthread_once_t tt_compression_ctx_key_once = PTHREAD_ONCE_INIT;
+
+/** Compression contexts of the current thread. */
+static __thread struct tt_compression_ctx *tt_compression_ctx;
+
+static void
+tt_compression_ctx_delete(void *arg)
+{
+	struct tt_compression_ctx *ctx = arg;
+	ZSTD_freeCCtx(ctx->zstd_cctx);
+	ZSTD_freeDCtx(ctx->zstd_dctx);
+	free(ctx);
+}
+
+static void
+tt_compression_ctx_key_create(void)
+{
+	tt_pthread_key_create(&tt_compression_ctx_key,
+			      tt_compression_ctx_delete);
+}
+
+/** Return the compression contexts of the current thread. */
+static struct tt_compression_ctx *
+tt_compression_ctx_get(void)
+{
+	if (tt_compression_ctx == NULL) {
+		tt_pthread_once(&tt_compression_ctx_key_once,
+				tt_compression_ctx_key_create);
+		struct tt_compression_ctx *ctx = xcalloc(1, sizeof(*ctx));
+		tt_pthread_setspecific(tt_compression_ctx_key, ctx);
+		tt_compression_ctx = ctx;
+	}
+	return tt_compression_ctx;
+}
+
+/** Return the zstd compression context of the current thread. */
+static ZSTD_CCtx *
+tt_compression_zstd_cctx(void)
+{
+	struct tt_compression_ctx *ctx = tt_compression_ctx_get();
+	if (ctx->zstd_cctx == NULL) {
+		ZSTD_CCtx *cctx = ZSTD_createCCtx();
+		if (cctx == NULL)
+			return NULL;
+		/*
+		 * The size of the original data is stored by the caller
+		 * so we don't need it in the frame header.
+		 */
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+				       TT_COMPRESSION_ZSTD_LEVEL);
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_contentSizeFlag, 0);
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 0);
+		ctx->zstd_cctx = cctx;
+	}
+	return ctx->zstd_cctx;
+}
+
+/** Return the zstd decompression context of the current thread. */
+static ZSTD_DCtx *
+tt_compression_zstd_dctx(void)
+{
+	struct tt_compression_ctx *ctx = tt_compression_ctx_get();
+	if (ctx->zstd_dctx == NULL)
+		ctx->zstd_dctx = ZSTD_createDCtx();
+	return ctx->zstd_dctx;
+}
+
+struct tt_compression_dict {
+	/** Dictionary identifier. */
+	uint32_t id;
+	/** Dictionary prepared for compression. */
+	ZSTD_CDict *zstd_cdict;
+	/** Dictionary prepared for decompression. */
+	ZSTD_DDict *zstd_ddict;
+	/** Size of the raw dictionary data. */
+	size_t size;
+	/** Raw dictionary data. */
+	char data[];
+};
+
+/**
+ * Registered dictionaries, indexed by identifier. Only updated
+ * by the tx thread, read by any thread.
+ */
+static struct tt_compression_dict *
+tt_compression_dicts[TT_COMPRESSION_DICT_ID_MAX];
+
+struct tt_compression_dict *
+tt_compression_dict_new(const char *data, size_t size)
+{
+	unsigned id = ZDICT_getDictID(data, size);
+	if (id == 0 || id >= TT_COMPRESSION_DICT_ID_MAX)
+		return NULL;
+	struct tt_compression_dict *dict = xmalloc(sizeof(*dict) + size);
+	dict->id = id;
+	dict->size = size;
+	memcpy(dict->data, data, size);
+	dict->zstd_cdict = ZSTD_createCDict(data, size,
+					    TT_COMPRESSION_ZSTD_LEVEL);
+	dict->zstd_ddict = ZSTD_createDDict(data, size);
+	if (dict->zstd_cdict == NULL || dict->zstd_ddict == NULL) {
+		tt_compression_dict_delete(dict);
+		return NULL;
+	}
+	return dict;
+}
+
+void
+tt_compression_dict_delete(struct tt_compression_dict *dict)
+{
+	assert(tt_compression_dicts[dict->id] != dict);
+	ZSTD_freeCDict(dict->zstd_cdict);
+	ZSTD_freeDDict(dict->zstd_ddict);
+	free(dict);
+}
+
+uint32_t
+tt_compression_dict_id(const struct tt_compression_dict *dict)
+{
+	return dict->id;
+}
+
+struct ZSTD_CDict_s *
+tt_compression_dict_zstd_cdict(struct tt_compression_dict *dict)
+{
+	return dict->zstd_cdict;
+}
+
+struct ZSTD_DDict_s *
+tt_compression_dict_zstd_ddict(struct tt_compression_dict *dict)
+{
+	return dict->zstd_ddict;
+}
+
+struct tt_compression_dict *
+tt_compression_dict_register(struct tt_compression_dict *dict)
+{
+	struct tt_compression_dict *old = tt_compression_dicts[dict->id];
+	if (old != NULL) {
+		bool is_same = old->size == dict->size &&
+			       memcmp(old->data, dict->data, dict->size) == 0;
+		tt_compression_dict_delete(dict);
+		return is_same ? old : NULL;
+	}
+	__atomic_store_n(&tt_compression_dicts[dict->id], dict,
+			 __ATOMIC_RELEASE);
+	return dict;
+}
+
+struct tt_compression_dict *
+tt_compression_dict_lookup(uint32_t id)
+{
+	if (id == 0 || id >= TT_COMPRESSION_DICT_ID_MAX)
+		return NULL;
+	return __atomic_load_n(&tt_compression_dicts[id], __ATOMIC_ACQUIRE);
+}
+
+ssize_t
+tt_compression_dict_train(const char *samples, const size_t *sizes,
+			  unsigned count, uint32_t id, char *buf,
+			  size_t capacity)
+{
+	assert(id > 0 && id < TT_COMPRESSION_DICT_ID_MAX);
+	size_t size = ZDICT_trainFromBuffer(buf, capacity, samples,
+					    sizes, count);
+	if (ZDICT_isError(size))
+		return -1;
+	/*
+	 * The dictionary identifier is stored in the dictionary header
+	 * right after the magic number in little-endian. The trainer
+	 * generates a random identifier so we overwrite it.
+	 */
+	assert(size >= 8);
+	for (int i = 0; i < 4; i++)
+		buf[4 + i] = (char)(id >> (8 * i));
+	assert(ZDICT_getDictID(buf, size) == id);
+	return size;
+}
+
+size_t
+tt_compress_bound(enum compression_type type, size_t size)
+{
+	switch (type) {
+	case COMPRESSION_TYPE_ZSTD:
+		return ZSTD_compressBound(size);
+	default:
+		unreachable();
+		return 0;
+	}
+}
+
+ssize_t
+tt_compress(enum compression_type type, struct tt_compression_dict *dict,
+	    const char *src, size_t size, char *dst)
+{
+	switch (type) {
+	case COMPRESSION_TYPE_ZSTD: {
+		ZSTD_CCtx *cctx = tt_compression_zstd_cctx();
+		if (cctx == NULL)
+			return -1;
+		size_t rc;
+		if (dict != NULL) {
+			rc = ZSTD_compress_usingCDict(
+				cctx, dst, ZSTD_compressBound(size), src,
+				size, dict->zstd_cdict);
+		} else {
+			rc = ZSTD_compress2(cctx, dst, ZSTD_compressBound(size),
+					    src, size);
+		}
+		if (ZSTD_isError(rc))
+			return -1;
+		return rc;
+	}
+	default:
+		unreachable();
+		return -1;
+	}
+}
+
+int
+tt_decompress(enum compression_type type, const char *src, size_t size,
+	      char *dst, size_t dst_size)
+{
+	switch (type) {
+	case COMPRESSION_TYPE_ZSTD: {
+		ZSTD_DCtx *dctx = tt_compression_zstd_dctx();
+		if (dctx == NULL)
+			return -1;
+		size_t rc;
+		unsigned dict_id = ZSTD_getDictID_fromFrame(src, size);
+		if (dict_id != 0) {
+			struct tt_compression_dict *dict =
+				tt_compression_dict_lookup(dict_id);
+			if (dict == NULL)
+				return -1;
+			rc = ZSTD_decompress_usingDDict(dctx, dst, dst_size,
+							src, size,
+							dict->zstd_ddict);
+		} else {
+			rc = ZSTD_decompressDCtx(dctx, dst, dst_size,
+						 src, size);
+		}
+		if (ZSTD_isError(rc) || rc != dst_size)
+			return -1;
+		return 0;
+	}
+	default:
+		return -1;
+	}
+}
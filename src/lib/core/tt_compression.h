@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <sys/types.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -21,11 +22,121 @@ extern "C" {
 
 enum compression_type {
         COMPRESSION_TYPE_NONE = 0,
+        COMPRESSION_TYPE_ZSTD,
         compression_type_MAX
 };
 
 extern const char *compression_type_strs[];
 
+enum {
+	/**
+	 * Max identifier of a compression dictionary plus one.
+	 * Zero is never used as a dictionary identifier.
+	 */
+	TT_COMPRESSION_DICT_ID_MAX = 4096,
+};
+
+/**
+ * Zstd dictionary trained on samples of the data it's supposed to
+ * compress. Dictionaries are identified by the numbers stored in
+ * their headers, which are also stored in the headers of zstd frames
+ * compressed with them so that decompression doesn't need to know
+ * which dictionary was used. A dictionary must be registered with
+ * tt_compression_dict_register() before any data compressed with it
+ * can be decompressed. Registered dictionaries are never freed.
+ */
+struct tt_compression_dict;
+
+/**
+ * Create a compression dictionary from the raw data returned by
+ * tt_compression_dict_train(). Returns NULL if the data isn't a valid
+ * zstd dictionary or its identifier is out of the allowed range.
+ * Doesn't set diag.
+ */
+struct tt_compression_dict *
+tt_compression_dict_new(const char *data, size_t size);
+
+/** Free a dictionary that wasn't registered. */
+void
+tt_compression_dict_delete(struct tt_compression_dict *dict);
+
+/** Return the identifier of a dictionary. */
+uint32_t
+tt_compression_dict_id(const struct tt_compression_dict *dict);
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+/** Return the zstd compression dictionary. */
+struct ZSTD_CDict_s *
+tt_compression_dict_zstd_cdict(struct tt_compression_dict *dict);
+
+/** Return the zstd decompression dictionary. */
+struct ZSTD_DDict_s *
+tt_compression_dict_zstd_ddict(struct tt_compression_dict *dict);
+
+/**
+ * Register a dictionary so that it can be used for decompression.
+ * If a dictionary with the same identifier has already been
+ * registered, the new dictionary is freed and the old one is
+ * returned, or NULL if the old one has different data. Otherwise
+ * @a dict is returned. Must be called from the tx thread.
+ */
+struct tt_compression_dict *
+tt_compression_dict_register(struct tt_compression_dict *dict);
+
+/**
+ * Find a registered dictionary by identifier. Returns NULL if not
+ * found. May be called from any thread.
+ */
+struct tt_compression_dict *
+tt_compression_dict_lookup(uint32_t id);
+
+/**
+ * Train a zstd dictionary with the given identifier on @a count
+ * samples stored one after another at @a samples, @a sizes[i] being
+ * the size of i-th sample. The raw dictionary data is stored in @a buf
+ * of @a capacity bytes, which also limits the dictionary size.
+ * Returns the dictionary size or -1 if there are too few samples or
+ * they are too small. Doesn't set diag. May be called from any thread.
+ */
+ssize_t
+tt_compression_dict_train(const char *samples, const size_t *sizes,
+			  unsigned count, uint32_t id, char *buf,
+			  size_t capacity);
+
+/**
+ * Return the max size of @a size bytes of data compressed with
+ * the given algorithm.
+ */
+size_t
+tt_compress_bound(enum compression_type type, size_t size);
+
+/**
+ * Compress @a size bytes of data stored at @a src to @a dst, which
+ * must be at least tt_compress_bound() bytes long. If @a dict isn't
+ * NULL, it's used for compression. Returns the size of the compressed
+ * data or -1 on failure. Doesn't set diag.
+ *
+ * Compression contexts are allocated per thread so the function may
+ * be called from any thread.
+ */
+ssize_t
+tt_compress(enum compression_type type, struct tt_compression_dict *dict,
+	    const char *src, size_t size, char *dst);
+
+/**
+ * Decompress @a size bytes of data stored at @a src to @a dst.
+ * @a dst_size must be equal to the size of the original data.
+ * The dictionary used for compression, if any, is looked up among
+ * registered dictionaries. Returns 0 on success, -1 if the data is
+ * corrupted or the dictionary isn't registered. Doesn't set diag.
+ * May be called from any thread.
+ */
+int
+tt_decompress(enum compression_type type, const char *src, size_t size,
+	      char *dst, size_t dst_size);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -177,6 +177,17 @@
  * bool bps_tree_view_iterator_next(view, itr);
  * bool bps_tree_iterator_prev(tree, itr);
  * bool bps_tree_view_iterator_prev(view, itr);
+ * // order statistics (BPS_INNER_CARD must be defined):
+ * struct bps_tree_iterator bps_tree_lower_bound_get_offset(tree, key, exact,
+ *							   offset);
+ * struct bps_tree_iterator bps_tree_view_lower_bound_get_offset(view, key,
+ *								exact, offset);
+ * struct bps_tree_iterator bps_tree_upper_bound_get_offset(tree, key, exact,
+ *							   offset);
+ * struct bps_tree_iterator bps_tree_view_upper_bound_get_offset(view, key,
+ *								exact, offset);
+ * struct bps_tree_iterator bps_tree_iterator_at(tree, offset);
+ * struct bps_tree_iterator bps_tree_view_iterator_at(view, offset);
  */
 /* }}} */
 
@@ -316,6 +327,17 @@
  * #define BPS_BLOCK_LINEAR_SEARCH
  */
 
+/**
+ * A switch that enables order statistics. If it is set, every inner
+ * block stores the number of elements (cardinality) of each of its
+ * child subtrees, so one can find the offset of the lower/upper bound
+ * of a key or position an iterator to the element with given offset in
+ * logarithmic time. The price is a lower fanout of inner blocks and
+ * the need to update all the blocks on the path to a leaf on every
+ * insertion and deletion. To turn it on,
+ * #define BPS_INNER_CARD
+ */
+
 /**
  * A switch that enables collection of executions of different
  * branches of code. Used only for debug purposes, I hope you
@@ -425,6 +447,17 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_upper_bound_elem _api_name(upper_bound_elem)
 #define bps_tree_view_upper_bound_elem _api_name(view_upper_bound_elem)
 #define bps_tree_approximate_count _api_name(approximate_count)
+#define bps_tree_lower_bound_get_offset_impl _bps_tree(lower_bound_get_offset)
+#define bps_tree_lower_bound_get_offset _api_name(lower_bound_get_offset)
+#define bps_tree_view_lower_bound_get_offset \
+	_api_name(view_lower_bound_get_offset)
+#define bps_tree_upper_bound_get_offset_impl _bps_tree(upper_bound_get_offset)
+#define bps_tree_upper_bound_get_offset _api_name(upper_bound_get_offset)
+#define bps_tree_view_upper_bound_get_offset \
+	_api_name(view_upper_bound_get_offset)
+#define bps_tree_iterator_at_impl _bps_tree(iterator_at)
+#define bps_tree_iterator_at _api_name(iterator_at)
+#define bps_tree_view_iterator_at _api_name(view_iterator_at)
 #define bps_tree_iterator_get_elem_impl _bps_tree(iterator_get_elem)
 #define bps_tree_iterator_get_elem _api_name(iterator_get_elem)
 #define bps_tree_view_iterator_get_elem _api_name(view_iterator_get_elem)
@@ -467,6 +500,12 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_collect_path _bps_tree(collect_path)
 #define bps_tree_touch_leaf_path_max_elem _bps_tree(touch_leaf_path_max_elem)
 #define bps_tree_touch_path _bps_tree(touch_path_max_elem)
+#define bps_tree_inner_card _bps_tree(inner_card)
+#define bps_tree_block_card _bps_tree(block_card)
+#define bps_tree_set_child_card _bps_tree(set_child_card)
+#define bps_tree_update_leaf_card _bps_tree(update_leaf_card)
+#define bps_tree_update_inner_card _bps_tree(update_inner_card)
+#define bps_tree_path_add_card _bps_tree(path_add_card)
 #define bps_tree_process_replace _bps_tree(process_replace)
 #define bps_tree_debug_memmove _bps_tree(debug_memmove)
 #define bps_tree_insert_into_leaf _bps_tree(insert_into_leaf)
@@ -1000,6 +1039,83 @@ bps_tree_view_upper_bound_elem(const struct bps_tree_view *view,
 static inline size_t
 bps_tree_approximate_count(const struct bps_tree *tree, bps_tree_key_t key);
 
+#ifdef BPS_INNER_CARD
+
+/**
+ * @brief Same as bps_tree_lower_bound, but also returns the offset of the
+ * element pointed by the iterator, i.e. the number of elements that are
+ * less than the key. Complexity is the same as of bps_tree_lower_bound.
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - pointer to a bool value, that will be set to true if
+ *  and element pointed by the iterator is equal to the key, false otherwise
+ *  Pass NULL if you don't need that info.
+ * @param offset - pointer to a size_t value, that will be set to the offset
+ *  of the element pointed by the iterator (the size of the tree if the
+ *  iterator is invalid). Pass NULL if you don't need that info.
+ * @return - Lower-bound iterator. Invalid if all elements are less than key.
+ */
+static inline struct bps_tree_iterator
+bps_tree_lower_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset);
+
+/**
+ * @brief Same as bps_tree_lower_bound_get_offset but for a tree view.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_lower_bound_get_offset(const struct bps_tree_view *view,
+				     bps_tree_key_t key, bool *exact,
+				     size_t *offset);
+
+/**
+ * @brief Same as bps_tree_upper_bound, but also returns the offset of the
+ * element pointed by the iterator, i.e. the number of elements that are
+ * less than or equal to the key.
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - pointer to a bool value, that will be set to true if
+ *  and element pointed by the (!)previous iterator is equal to the key,
+ *  false otherwise. Pass NULL if you don't need that info.
+ * @param offset - pointer to a size_t value, that will be set to the offset
+ *  of the element pointed by the iterator (the size of the tree if the
+ *  iterator is invalid). Pass NULL if you don't need that info.
+ * @return - Upper-bound iterator. Invalid if all elements are less or equal
+ *  than the key.
+ */
+static inline struct bps_tree_iterator
+bps_tree_upper_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset);
+
+/**
+ * @brief Same as bps_tree_upper_bound_get_offset but for a tree view.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_upper_bound_get_offset(const struct bps_tree_view *view,
+				     bps_tree_key_t key, bool *exact,
+				     size_t *offset);
+
+/**
+ * @brief Get an iterator to the element with the given offset, i.e. to
+ * the element that has exactly @a offset elements before it in the tree.
+ * Has logarithmic complexity.
+ * @param tree - pointer to a tree
+ * @param offset - offset of the element
+ * @return - Iterator to the element. Invalid if the offset is greater than
+ *  or equal to the size of the tree.
+ */
+static inline struct bps_tree_iterator
+bps_tree_iterator_at(const struct bps_tree *tree, size_t offset);
+
+/**
+ * @brief Same as bps_tree_iterator_at but for a tree view.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_iterator_at(const struct bps_tree_view *view, size_t offset);
+
+#endif /* BPS_INNER_CARD */
+
 /**
  * @brief Get a pointer to the element pointed by iterator.
  *  If iterator is detected as broken, it is invalidated and NULL returned.
@@ -1122,6 +1238,13 @@ bps_tree_debug_check_internal_functions(bool assertme);
 /* Same as BPS_TREE_MEMMOVE but takes count of values instead of memory size */
 #define BPS_TREE_DATAMOVE(dst, src, num, dst_bck, src_bck) \
 	BPS_TREE_MEMMOVE(dst, src, (num) * sizeof((dst)[0]), dst_bck, src_bck)
+/* Same as BPS_TREE_DATAMOVE but for child cardinalities, if there are any */
+#ifdef BPS_INNER_CARD
+#define BPS_TREE_CARDMOVE(dst, src, num, dst_bck, src_bck) \
+	BPS_TREE_DATAMOVE(dst, src, num, dst_bck, src_bck)
+#else
+#define BPS_TREE_CARDMOVE(dst, src, num, dst_bck, src_bck) ((void)0)
+#endif
 
 /**
  * Types of a block
@@ -1150,9 +1273,16 @@ enum bps_tree_max_sizes {
 		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block)
 		 - 2 * sizeof(bps_tree_block_id_t) )
 		/ sizeof(bps_tree_elem_t),
+#ifdef BPS_INNER_CARD
+	BPS_TREE_MAX_COUNT_IN_INNER =
+		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block))
+		/ (sizeof(bps_tree_elem_t) + sizeof(bps_tree_block_id_t)
+		   + sizeof(size_t)),
+#else
 	BPS_TREE_MAX_COUNT_IN_INNER =
 		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block))
 		/ (sizeof(bps_tree_elem_t) + sizeof(bps_tree_block_id_t)),
+#endif
 	BPS_TREE_MAX_DEPTH = 16
 };
 
@@ -1198,6 +1328,10 @@ struct bps_inner {
 	bps_tree_elem_t elems[BPS_TREE_MAX_COUNT_IN_INNER - 1];
 	/* Corresponding child IDs */
 	bps_tree_block_id_t child_ids[BPS_TREE_MAX_COUNT_IN_INNER];
+#ifdef BPS_INNER_CARD
+	/* Corresponding numbers of elements in child subtrees */
+	size_t child_cards[BPS_TREE_MAX_COUNT_IN_INNER];
+#endif
 };
 
 /**
@@ -1412,6 +1546,9 @@ bps_tree_build(struct bps_tree *t, bps_tree_elem_t *sorted_array,
 			}
 			parents[i]->child_ids[parents[i]->header.size] =
 				insert_id;
+#ifdef BPS_INNER_CARD
+			parents[i]->child_cards[parents[i]->header.size] = 0;
+#endif
 			if (new_id == (bps_tree_block_id_t)-1)
 				break;
 			if (i == depth - 2) {
@@ -1421,6 +1558,12 @@ bps_tree_build(struct bps_tree *t, bps_tree_elem_t *sorted_array,
 			}
 		}
 
+#ifdef BPS_INNER_CARD
+		for (bps_tree_block_id_t i = 0; i < depth - 1; i++)
+			parents[i]->child_cards[parents[i]->header.size] +=
+				leaf->header.size;
+#endif
+
 		bps_tree_elem_t insert_value = current[leaf->header.size - 1];
 		for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
 			parents[i]->header.size++;
@@ -2308,6 +2451,203 @@ bps_tree_approximate_count(const struct bps_tree *t, bps_tree_key_t key)
 	return result;
 }
 
+#ifdef BPS_INNER_CARD
+
+/**
+ * @brief Get the lower bound iterator and the offset of the element
+ * pointed by it. See bps_tree_lower_bound_get_offset for details.
+ */
+static inline struct bps_tree_iterator
+bps_tree_lower_bound_get_offset_impl(const struct bps_tree_common *tree,
+				     bps_tree_key_t key, bool *exact,
+				     size_t *offset)
+{
+	struct bps_tree_iterator res;
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	size_t local_offset;
+	if (!offset)
+		offset = &local_offset;
+	*offset = 0;
+	if (tree->root_id == (bps_tree_block_id_t)(-1)) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_block *block = bps_tree_root(tree);
+	bps_tree_block_id_t block_id = tree->root_id;
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos;
+		pos = bps_tree_find_ins_point_key(tree, inner->elems,
+						  inner->header.size - 1,
+						  key, exact);
+		for (bps_tree_pos_t j = 0; j < pos; j++)
+			*offset += inner->child_cards[j];
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block(tree, block_id);
+	}
+
+	struct bps_leaf *leaf = (struct bps_leaf *)block;
+	bps_tree_pos_t pos;
+	pos = bps_tree_find_ins_point_key(tree, leaf->elems, leaf->header.size,
+					  key, exact);
+	*offset += pos;
+	if (pos >= leaf->header.size) {
+		res.block_id = leaf->next_id;
+		res.pos = 0;
+	} else {
+		res.block_id = block_id;
+		res.pos = pos;
+	}
+	return res;
+}
+
+static inline struct bps_tree_iterator
+bps_tree_lower_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset)
+{
+	return bps_tree_lower_bound_get_offset_impl(&tree->common, key,
+						    exact, offset);
+}
+
+static inline struct bps_tree_iterator
+bps_tree_view_lower_bound_get_offset(const struct bps_tree_view *view,
+				     bps_tree_key_t key, bool *exact,
+				     size_t *offset)
+{
+	return bps_tree_lower_bound_get_offset_impl(&view->common, key,
+						    exact, offset);
+}
+
+/**
+ * @brief Get the upper bound iterator and the offset of the element
+ * pointed by it. See bps_tree_upper_bound_get_offset for details.
+ */
+static inline struct bps_tree_iterator
+bps_tree_upper_bound_get_offset_impl(const struct bps_tree_common *tree,
+				     bps_tree_key_t key, bool *exact,
+				     size_t *offset)
+{
+	struct bps_tree_iterator res;
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	size_t local_offset;
+	if (!offset)
+		offset = &local_offset;
+	*offset = 0;
+	bool exact_test;
+	if (tree->root_id == (bps_tree_block_id_t)(-1)) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_block *block = bps_tree_root(tree);
+	bps_tree_block_id_t block_id = tree->root_id;
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos;
+		pos = bps_tree_find_after_ins_point_key(tree, inner->elems,
+							inner->header.size - 1,
+							key, &exact_test);
+		if (exact_test)
+			*exact = true;
+		for (bps_tree_pos_t j = 0; j < pos; j++)
+			*offset += inner->child_cards[j];
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block(tree, block_id);
+	}
+
+	struct bps_leaf *leaf = (struct bps_leaf *)block;
+	bps_tree_pos_t pos;
+	pos = bps_tree_find_after_ins_point_key(tree, leaf->elems,
+						leaf->header.size,
+						key, &exact_test);
+	if (exact_test)
+		*exact = true;
+	*offset += pos;
+	if (pos >= leaf->header.size) {
+		res.block_id = leaf->next_id;
+		res.pos = 0;
+	} else {
+		res.block_id = block_id;
+		res.pos = pos;
+	}
+	return res;
+}
+
+static inline struct bps_tree_iterator
+bps_tree_upper_bound_get_offset(const struct bps_tree *tree,
+				bps_tree_key_t key, bool *exact,
+				size_t *offset)
+{
+	return bps_tree_upper_bound_get_offset_impl(&tree->common, key,
+						    exact, offset);
+}
+
+static inline struct bps_tree_iterator
+bps_tree_view_upper_bound_get_offset(const struct bps_tree_view *view,
+				     bps_tree_key_t key, bool *exact,
+				     size_t *offset)
+{
+	return bps_tree_upper_bound_get_offset_impl(&view->common, key,
+						    exact, offset);
+}
+
+/**
+ * @brief Get an iterator to the element with the given offset.
+ * See bps_tree_iterator_at for details.
+ */
+static inline struct bps_tree_iterator
+bps_tree_iterator_at_impl(const struct bps_tree_common *tree, size_t offset)
+{
+	struct bps_tree_iterator res;
+	if (offset >= tree->size) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_block *block = bps_tree_root(tree);
+	bps_tree_block_id_t block_id = tree->root_id;
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos = 0;
+		while (offset >= inner->child_cards[pos]) {
+			offset -= inner->child_cards[pos];
+			pos++;
+			assert(pos < inner->header.size);
+		}
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block(tree, block_id);
+	}
+
+	struct bps_leaf *leaf = (struct bps_leaf *)block;
+	assert(offset < (size_t)leaf->header.size);
+	(void)leaf;
+	res.block_id = block_id;
+	res.pos = offset;
+	return res;
+}
+
+static inline struct bps_tree_iterator
+bps_tree_iterator_at(const struct bps_tree *tree, size_t offset)
+{
+	return bps_tree_iterator_at_impl(&tree->common, offset);
+}
+
+static inline struct bps_tree_iterator
+bps_tree_view_iterator_at(const struct bps_tree_view *view, size_t offset)
+{
+	return bps_tree_iterator_at_impl(&view->common, offset);
+}
+
+#endif /* BPS_INNER_CARD */
+
 /**
  * @brief Get a pointer to the element pointed by iterator.
  *  If iterator is detected as broken, it is invalidated and NULL returned.
@@ -2711,6 +3051,132 @@ bps_tree_touch_path(struct bps_tree_common *tree,
 	}
 }
 
+#ifdef BPS_INNER_CARD
+/**
+ * @brief Number of elements in the subtree of an inner block
+ */
+static inline size_t
+bps_tree_inner_card(const struct bps_inner *inner)
+{
+	size_t card = 0;
+	for (bps_tree_pos_t i = 0; i < inner->header.size; i++)
+		card += inner->child_cards[i];
+	return card;
+}
+
+/**
+ * @brief Number of elements in the subtree of a block by it's ID
+ */
+static inline size_t
+bps_tree_block_card(const struct bps_tree_common *tree,
+		    bps_tree_block_id_t id)
+{
+	struct bps_block *block = bps_tree_restore_block(tree, id);
+	if (block->type == BPS_TREE_BT_LEAF)
+		return block->size;
+	assert(block->type == BPS_TREE_BT_INNER);
+	return bps_tree_inner_card((struct bps_inner *)block);
+}
+#endif
+
+/**
+ * @brief Set the cardinality of a child just inserted into inner block
+ */
+static inline void
+bps_tree_set_child_card(struct bps_tree_common *tree, struct bps_inner *inner,
+			bps_tree_pos_t pos)
+{
+#ifdef BPS_INNER_CARD
+	/* exclusive behaviuor for debug checks */
+	if (tree->root_id == (bps_tree_block_id_t) -1) {
+		inner->child_cards[pos] = 0;
+		return;
+	}
+	inner->child_cards[pos] =
+		bps_tree_block_card(tree, inner->child_ids[pos]);
+#else
+	(void)tree;
+	(void)inner;
+	(void)pos;
+#endif
+}
+
+/**
+ * @brief Refresh the cardinality of a leaf in the parent block.
+ * Does nothing if the leaf is not attached to the parent yet (when it
+ * is just created by a split) - it's cardinality is set on attaching.
+ */
+static inline void
+bps_tree_update_leaf_card(struct bps_tree_common *tree,
+			  struct bps_leaf_path_elem *leaf_path_elem)
+{
+#ifdef BPS_INNER_CARD
+	/* exclusive behaviuor for debug checks */
+	if (tree->root_id == (bps_tree_block_id_t) -1)
+		return;
+	struct bps_inner_path_elem *parent = leaf_path_elem->parent;
+	bps_tree_pos_t pos = leaf_path_elem->pos_in_parent;
+	if (parent == NULL || pos >= parent->block->header.size ||
+	    parent->block->child_ids[pos] != leaf_path_elem->block_id)
+		return;
+	parent->block->child_cards[pos] = leaf_path_elem->block->header.size;
+#else
+	(void)tree;
+	(void)leaf_path_elem;
+#endif
+}
+
+/**
+ * @brief Refresh the cardinality of an inner block in the parent block.
+ * Does nothing if the block is not attached to the parent yet.
+ */
+static inline void
+bps_tree_update_inner_card(struct bps_tree_common *tree,
+			   struct bps_inner_path_elem *inner_path_elem)
+{
+#ifdef BPS_INNER_CARD
+	/* exclusive behaviuor for debug checks */
+	if (tree->root_id == (bps_tree_block_id_t) -1)
+		return;
+	struct bps_inner_path_elem *parent = inner_path_elem->parent;
+	bps_tree_pos_t pos = inner_path_elem->pos_in_parent;
+	if (parent == NULL || pos >= parent->block->header.size ||
+	    parent->block->child_ids[pos] != inner_path_elem->block_id)
+		return;
+	parent->block->child_cards[pos] =
+		bps_tree_inner_card(inner_path_elem->block);
+#else
+	(void)tree;
+	(void)inner_path_elem;
+#endif
+}
+
+/**
+ * @brief Add the delta to cardinalities of all subtrees on the path to
+ * a leaf. Is called before an element is inserted into or deleted from
+ * the leaf; element moves between blocks that can follow do not change
+ * the cardinalities of their common parents.
+ */
+static inline void
+bps_tree_path_add_card(struct bps_tree_common *tree,
+		       struct bps_leaf_path_elem *leaf_path_elem, int delta)
+{
+#ifdef BPS_INNER_CARD
+	bps_tree_pos_t pos = leaf_path_elem->pos_in_parent;
+	for (struct bps_inner_path_elem *path = leaf_path_elem->parent;
+	     path != NULL; path = path->parent) {
+		path->block = (struct bps_inner *)
+			bps_tree_touch_block(tree, path->block_id);
+		path->block->child_cards[pos] += delta;
+		pos = path->pos_in_parent;
+	}
+#else
+	(void)tree;
+	(void)leaf_path_elem;
+	(void)delta;
+#endif
+}
+
 /**
  * @brief Replace element by it's path and fill the *replaced argument
  */
@@ -2796,6 +3262,16 @@ bps_tree_debug_memmove(void *dst_arg, void *src_arg, size_t num,
 				assert(src < ((char *)src_inner->elems) +
 				       (BPS_TREE_MAX_COUNT_IN_INNER - 1) *
 				       sizeof(bps_tree_elem_t));
+#ifdef BPS_INNER_CARD
+			} else if (dst >= ((char *)dst_inner->child_cards) &&
+				   dst < ((char *)dst_inner->child_cards) +
+				   BPS_TREE_MAX_COUNT_IN_INNER *
+				   sizeof(size_t)) {
+				assert(src >= (char *)src_inner->child_cards);
+				assert(src < ((char *)src_inner->child_cards) +
+				       BPS_TREE_MAX_COUNT_IN_INNER *
+				       sizeof(size_t));
+#endif
 			} else {
 				assert(dst >= ((char *)dst_inner->child_ids));
 				assert(dst < ((char *)dst_inner->child_ids) +
@@ -2816,6 +3292,16 @@ bps_tree_debug_memmove(void *dst_arg, void *src_arg, size_t num,
 					(BPS_TREE_MAX_COUNT_IN_INNER - 1) *
 					sizeof(bps_tree_elem_t)) {
 				/* nothing to do due to if condition */
+#ifdef BPS_INNER_CARD
+			} else if (dst >= ((char *)dst_inner->child_cards)
+				   && dst <= ((char *)dst_inner->child_cards) +
+				   BPS_TREE_MAX_COUNT_IN_INNER * sizeof(size_t)
+				   && src >= (char *)src_inner->child_cards
+				   && src <= ((char *)src_inner->child_cards) +
+				   BPS_TREE_MAX_COUNT_IN_INNER *
+				   sizeof(size_t)) {
+				/* nothing to do due to if condition */
+#endif
 			} else {
 				assert(dst >= ((char *)dst_inner->child_ids));
 				assert(dst <= ((char *)dst_inner->child_ids) +
@@ -2890,12 +3376,16 @@ bps_tree_insert_into_inner(struct bps_tree_common *tree,
 		BPS_TREE_DATAMOVE(inner->child_ids + pos + 1,
 				  inner->child_ids + pos,
 				  inner->header.size - pos, inner, inner);
+		BPS_TREE_CARDMOVE(inner->child_cards + pos + 1,
+				  inner->child_cards + pos,
+				  inner->header.size - pos, inner, inner);
 	} else {
 		if (pos > 0)
 			inner->elems[pos - 1] = *inner_path_elem->max_elem_copy;
 		*inner_path_elem->max_elem_copy = max_elem;
 	}
 	inner->child_ids[pos] = block_id;
+	bps_tree_set_child_card(tree, inner, pos);
 
 	inner->header.size++;
 }
@@ -2947,6 +3437,11 @@ bps_tree_delete_from_inner(struct bps_tree_common *tree,
 
 	assert(pos >= 0);
 	assert(pos < inner->header.size);
+#ifdef BPS_INNER_CARD
+	/* Only a child which elements were moved away can be deleted */
+	assert(tree->root_id == (bps_tree_block_id_t) -1 ||
+	       inner->child_cards[pos] == 0);
+#endif
 
 	if (pos < inner->header.size - 1) {
 		BPS_TREE_DATAMOVE(inner->elems + pos, inner->elems + pos + 1,
@@ -2954,6 +3449,9 @@ bps_tree_delete_from_inner(struct bps_tree_common *tree,
 		BPS_TREE_DATAMOVE(inner->child_ids + pos,
 				  inner->child_ids + pos + 1,
 				  inner->header.size - 1 - pos, inner, inner);
+		BPS_TREE_CARDMOVE(inner->child_cards + pos,
+				  inner->child_cards + pos + 1,
+				  inner->header.size - 1 - pos, inner, inner);
 	} else if (pos > 0) {
 		*inner_path_elem->max_elem_copy = inner->elems[pos - 1];
 	}
@@ -2996,6 +3494,8 @@ bps_tree_move_elems_to_right_leaf(struct bps_tree_common *tree,
 		*a_leaf_path_elem->max_elem_copy =
 			a->elems[a->header.size - 1];
 	*b_leaf_path_elem->max_elem_copy = b->elems[b->header.size - 1];
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem);
 }
 
 /**
@@ -3025,8 +3525,13 @@ bps_tree_move_elems_to_right_inner(struct bps_tree_common *tree,
 
 	BPS_TREE_DATAMOVE(b->child_ids + num, b->child_ids,
 			  b->header.size, b, b);
+	BPS_TREE_CARDMOVE(b->child_cards + num, b->child_cards,
+			  b->header.size, b, b);
 	BPS_TREE_DATAMOVE(b->child_ids, a->child_ids + a->header.size - num,
 			  num, b, a);
+	BPS_TREE_CARDMOVE(b->child_cards,
+			  a->child_cards + a->header.size - num,
+			  num, b, a);
 
 	if (!move_to_empty)
 		BPS_TREE_DATAMOVE(b->elems + num, b->elems,
@@ -3044,6 +3549,8 @@ bps_tree_move_elems_to_right_inner(struct bps_tree_common *tree,
 
 	a->header.size -= num;
 	b->header.size += num;
+	bps_tree_update_inner_card(tree, a_inner_path_elem);
+	bps_tree_update_inner_card(tree, b_inner_path_elem);
 }
 
 /**
@@ -3076,6 +3583,8 @@ bps_tree_move_elems_to_left_leaf(struct bps_tree_common *tree,
 	a->header.size += num;
 	b->header.size -= num;
 	*a_leaf_path_elem->max_elem_copy = a->elems[a->header.size - 1];
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem);
 }
 
 /**
@@ -3105,8 +3614,12 @@ bps_tree_move_elems_to_left_inner(struct bps_tree_common *tree,
 
 	BPS_TREE_DATAMOVE(a->child_ids + a->header.size, b->child_ids,
 			  num, a, b);
+	BPS_TREE_CARDMOVE(a->child_cards + a->header.size, b->child_cards,
+			  num, a, b);
 	BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num,
 			  b->header.size - num, b, b);
+	BPS_TREE_CARDMOVE(b->child_cards, b->child_cards + num,
+			  b->header.size - num, b, b);
 
 	if (!move_to_empty)
 		a->elems[a->header.size - 1] =
@@ -3123,6 +3636,8 @@ bps_tree_move_elems_to_left_inner(struct bps_tree_common *tree,
 
 	a->header.size += num;
 	b->header.size -= num;
+	bps_tree_update_inner_card(tree, a_inner_path_elem);
+	bps_tree_update_inner_card(tree, b_inner_path_elem);
 }
 
 /**
@@ -3192,6 +3707,8 @@ bps_tree_insert_and_move_elems_to_right_leaf(
 		*b_leaf_path_elem->max_elem_copy =
 			b->elems[b->header.size - 1];
 	tree->size++;
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem);
 	return ret;
 }
 
@@ -3231,6 +3748,8 @@ bps_tree_insert_and_move_elems_to_right_inner(
 	if (!move_to_empty) {
 		BPS_TREE_DATAMOVE(b->child_ids + num, b->child_ids,
 				  b->header.size, b, b);
+		BPS_TREE_CARDMOVE(b->child_cards + num, b->child_cards,
+				  b->header.size, b, b);
 		BPS_TREE_DATAMOVE(b->elems + num, b->elems,
 				  b->header.size - 1, b, b);
 	}
@@ -3241,9 +3760,16 @@ bps_tree_insert_and_move_elems_to_right_inner(
 		BPS_TREE_DATAMOVE(b->child_ids,
 				  a->child_ids + a->header.size - num,
 				  num, b, a);
+		BPS_TREE_CARDMOVE(b->child_cards,
+				  a->child_cards + a->header.size - num,
+				  num, b, a);
 		BPS_TREE_DATAMOVE(a->child_ids + pos + 1, a->child_ids + pos,
 				  mid_part_size - num, a, a);
+		BPS_TREE_CARDMOVE(a->child_cards + pos + 1,
+				  a->child_cards + pos,
+				  mid_part_size - num, a, a);
 		a->child_ids[pos] = block_id;
+		bps_tree_set_child_card(tree, a, pos);
 
 		BPS_TREE_DATAMOVE(b->elems, a->elems + (a->header.size - num),
 				  num - 1, b, a);
@@ -3263,9 +3789,16 @@ bps_tree_insert_and_move_elems_to_right_inner(
 		BPS_TREE_DATAMOVE(b->child_ids,
 				  a->child_ids + a->header.size - num,
 				  num, b, a);
+		BPS_TREE_CARDMOVE(b->child_cards,
+				  a->child_cards + a->header.size - num,
+				  num, b, a);
 		BPS_TREE_DATAMOVE(a->child_ids + pos + 1, a->child_ids + pos,
 				  mid_part_size - num, a, a);
+		BPS_TREE_CARDMOVE(a->child_cards + pos + 1,
+				  a->child_cards + pos,
+				  mid_part_size - num, a, a);
 		a->child_ids[pos] = block_id;
+		bps_tree_set_child_card(tree, a, pos);
 
 		BPS_TREE_DATAMOVE(b->elems, a->elems + (a->header.size - num),
 				  num - 1, b, a);
@@ -3282,9 +3815,15 @@ bps_tree_insert_and_move_elems_to_right_inner(
 		BPS_TREE_DATAMOVE(b->child_ids,
 				  a->child_ids + a->header.size - num + 1,
 				  new_pos, b, a);
+		BPS_TREE_CARDMOVE(b->child_cards,
+				  a->child_cards + a->header.size - num + 1,
+				  new_pos, b, a);
 		b->child_ids[new_pos] = block_id;
+		bps_tree_set_child_card(tree, b, new_pos);
 		BPS_TREE_DATAMOVE(b->child_ids + new_pos + 1,
 				  a->child_ids + pos, mid_part_size, b, a);
+		BPS_TREE_CARDMOVE(b->child_cards + new_pos + 1,
+				  a->child_cards + pos, mid_part_size, b, a);
 
 		if (pos == a->header.size) {
 			/* +1 */
@@ -3329,6 +3868,8 @@ bps_tree_insert_and_move_elems_to_right_inner(
 
 	a->header.size -= (num - 1);
 	b->header.size += num;
+	bps_tree_update_inner_card(tree, a_inner_path_elem);
+	bps_tree_update_inner_card(tree, b_inner_path_elem);
 }
 
 /**
@@ -3397,6 +3938,8 @@ bps_tree_insert_and_move_elems_to_left_leaf(
 		*b_leaf_path_elem->max_elem_copy =
 			b->elems[b->header.size - 1];
 	tree->size++;
+	bps_tree_update_leaf_card(tree, a_leaf_path_elem);
+	bps_tree_update_leaf_card(tree, b_leaf_path_elem);
 	return ret;
 }
 
@@ -3438,12 +3981,20 @@ bps_tree_insert_and_move_elems_to_left_inner(
 		bps_tree_pos_t new_pos = pos - num; /* Can be 0 */
 		BPS_TREE_DATAMOVE(a->child_ids + a->header.size, b->child_ids,
 				  num, a, b);
+		BPS_TREE_CARDMOVE(a->child_cards + a->header.size,
+				  b->child_cards, num, a, b);
 		BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num,
 				  new_pos, b, b);
+		BPS_TREE_CARDMOVE(b->child_cards, b->child_cards + num,
+				  new_pos, b, b);
 		b->child_ids[new_pos] = block_id;
+		bps_tree_set_child_card(tree, b, new_pos);
 		BPS_TREE_DATAMOVE(b->child_ids + new_pos + 1,
 				  b->child_ids + pos,
 				  b->header.size - pos, b, b);
+		BPS_TREE_CARDMOVE(b->child_cards + new_pos + 1,
+				  b->child_cards + pos,
+				  b->header.size - pos, b, b);
 
 		if (!move_to_empty)
 			a->elems[a->header.size - 1] =
@@ -3479,12 +4030,21 @@ bps_tree_insert_and_move_elems_to_left_inner(
 		bps_tree_pos_t new_pos = a->header.size + pos; /* Can be 0 */
 		BPS_TREE_DATAMOVE(a->child_ids + a->header.size,
 				  b->child_ids, pos, a, b);
+		BPS_TREE_CARDMOVE(a->child_cards + a->header.size,
+				  b->child_cards, pos, a, b);
 		a->child_ids[new_pos] = block_id;
+		bps_tree_set_child_card(tree, a, new_pos);
 		BPS_TREE_DATAMOVE(a->child_ids + new_pos + 1,
 				  b->child_ids + pos, num - 1 - pos, a, b);
-		if (!move_all)
+		BPS_TREE_CARDMOVE(a->child_cards + new_pos + 1,
+				  b->child_cards + pos, num - 1 - pos, a, b);
+		if (!move_all) {
 			BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num - 1,
 					  b->header.size - num + 1, b, b);
+			BPS_TREE_CARDMOVE(b->child_cards,
+					  b->child_cards + num - 1,
+					  b->header.size - num + 1, b, b);
+		}
 
 		if (!move_to_empty)
 			a->elems[a->header.size - 1] =
@@ -3529,6 +4089,8 @@ bps_tree_insert_and_move_elems_to_left_inner(
 
 	a->header.size += num;
 	b->header.size -= (num - 1);
+	bps_tree_update_inner_card(tree, a_inner_path_elem);
+	bps_tree_update_inner_card(tree, b_inner_path_elem);
 }
 
 /**
@@ -3735,6 +4297,7 @@ bps_tree_process_insert_leaf(struct bps_tree_common *tree,
 			     bps_tree_block_id_t *inserted_in_block,
 			     bps_tree_pos_t *inserted_in_pos)
 {
+	bps_tree_path_add_card(tree, leaf_path_elem, 1);
 	if (bps_tree_leaf_free_size(leaf_path_elem->block)) {
 		bps_tree_insert_into_leaf(tree, leaf_path_elem, new_elem);
 		BPS_TREE_BRANCH_TRACE(tree, insert_leaf, 1 << 0x0);
@@ -3849,6 +4412,7 @@ bps_tree_process_insert_leaf(struct bps_tree_common *tree,
 	}
 
 	if (!bps_tree_reserve_blocks(tree, tree->depth + 1)) {
+		bps_tree_path_add_card(tree, leaf_path_elem, -1);
 		return -1;
 	}
 	bps_tree_block_id_t new_block_id = (bps_tree_block_id_t)(-1);
@@ -4094,6 +4658,8 @@ bps_tree_process_insert_leaf(struct bps_tree_common *tree,
 		new_root->header.size = 2;
 		new_root->child_ids[0] = tree->root_id;
 		new_root->child_ids[1] = new_block_id;
+		bps_tree_set_child_card(tree, new_root, 0);
+		bps_tree_set_child_card(tree, new_root, 1);
 		new_root->elems[0] = tree->max_elem;
 		tree->root_id = new_root_id;
 		tree->max_elem = new_max_elem;
@@ -4414,6 +4980,8 @@ bps_tree_process_insert_inner(struct bps_tree_common *tree,
 		new_root->header.size = 2;
 		new_root->child_ids[0] = tree->root_id;
 		new_root->child_ids[1] = new_block_id;
+		bps_tree_set_child_card(tree, new_root, 0);
+		bps_tree_set_child_card(tree, new_root, 1);
 		new_root->elems[0] = tree->max_elem;
 		tree->root_id = new_root_id;
 		tree->max_elem = new_max_elem;
@@ -4443,6 +5011,7 @@ static inline void
 bps_tree_process_delete_leaf(struct bps_tree_common *tree,
 			     struct bps_leaf_path_elem *leaf_path_elem)
 {
+	bps_tree_path_add_card(tree, leaf_path_elem, -1);
 	bps_tree_delete_from_leaf(tree, leaf_path_elem);
 
 	if (leaf_path_elem->block->header.size >=
@@ -5052,13 +5621,22 @@ bps_tree_debug_check_block(const struct bps_tree_common *tree,
 				result |= 0x4000000;
 		}
 
-		for (bps_tree_pos_t i = 0; i < block->size; i++)
+		for (bps_tree_pos_t i = 0; i < block->size; i++) {
+			size_t child_count = *calc_count;
 			result |= bps_tree_debug_check_block(tree,
 				bps_tree_restore_block(tree,
 						       inner->child_ids[i]),
 				inner->child_ids[i], level - 1, calc_count,
 				expected_prev_id, expected_this_id,
 				check_fullness_next);
+			child_count = *calc_count - child_count;
+#ifdef BPS_INNER_CARD
+			if (inner->child_cards[i] != child_count)
+				result |= 0x8000000;
+#else
+			(void)child_count;
+#endif
+		}
 		return result;
 	}
 }
@@ -6460,6 +7038,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 
 #undef BPS_TREE_MEMMOVE
 #undef BPS_TREE_DATAMOVE
+#undef BPS_TREE_CARDMOVE
 #undef BPS_TREE_BRANCH_TRACE
 
 /* {{{ Macros for custom naming of structs and functions */
@@ -6519,6 +7098,15 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_upper_bound_elem
 #undef bps_tree_view_upper_bound_elem
 #undef bps_tree_approximate_count
+#undef bps_tree_lower_bound_get_offset_impl
+#undef bps_tree_lower_bound_get_offset
+#undef bps_tree_view_lower_bound_get_offset
+#undef bps_tree_upper_bound_get_offset_impl
+#undef bps_tree_upper_bound_get_offset
+#undef bps_tree_view_upper_bound_get_offset
+#undef bps_tree_iterator_at_impl
+#undef bps_tree_iterator_at
+#undef bps_tree_view_iterator_at
 #undef bps_tree_iterator_get_elem_impl
 #undef bps_tree_iterator_get_elem
 #undef bps_tree_view_iterator_get_elem
@@ -6560,6 +7148,12 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_collect_path
 #undef bps_tree_touch_leaf_path_max_elem
 #undef bps_tree_touch_path
+#undef bps_tree_inner_card
+#undef bps_tree_block_card
+#undef bps_tree_set_child_card
+#undef bps_tree_update_leaf_card
+#undef bps_tree_update_inner_card
+#undef bps_tree_path_add_card
 #undef bps_tree_process_replace
 #undef bps_tree_debug_memmove
 #undef bps_tree_insert_into_leaf
@@ -431,6 +431,51 @@ static inline LIGHT_DATA_TYPE *
 LIGHT(view_iterator_get_and_next)(const struct LIGHT(view) *v,
 				  struct LIGHT(iterator) *itr);
 
+/**
+ * Element of an array passed to LIGHT(build_end).
+ */
+struct LIGHT(build_entry) {
+	/* hash of the value */
+	uint32_t hash;
+	/* the value */
+	LIGHT_DATA_TYPE value;
+};
+
+/**
+ * @brief Start bulk loading of an empty hash table: allocate the table
+ *  for the given number of values. Lookups in the table are not allowed
+ *  until LIGHT(build_end) is called.
+ * @param ht - pointer to a hash table struct
+ * @param count - number of values that will be loaded
+ * @return 0 if ok, -1 on memory error (the table is left empty)
+ */
+static inline int
+LIGHT(build_begin)(struct LIGHT(core) *ht, uint32_t count);
+
+/**
+ * @brief Get a slot where a value with the given hash is placed by
+ *  LIGHT(build_end). Can be called concurrently from several threads.
+ * @param ht - pointer to a hash table struct, see LIGHT(build_begin)
+ * @param hash - hash of a value
+ * @return slot of the value
+ */
+static inline uint32_t
+LIGHT(build_slot)(const struct LIGHT(core) *ht, uint32_t hash);
+
+/**
+ * @brief Finish bulk loading of a hash table. Never fails, since all the
+ *  memory is allocated by LIGHT(build_begin). Values are not checked for
+ *  duplicates.
+ * @param ht - pointer to a hash table struct, see LIGHT(build_begin)
+ * @param entries - values to load, sorted by LIGHT(build_slot) so that
+ *  the table is filled in the memory order
+ * @param count - number of values, not greater than passed to
+ *  LIGHT(build_begin)
+ */
+static inline void
+LIGHT(build_end)(struct LIGHT(core) *ht,
+		 const struct LIGHT(build_entry) *entries, uint32_t count);
+
 /* Functions definition */
 
 /**
@@ -1261,6 +1306,134 @@ LIGHT(view_iterator_get_and_next)(const struct LIGHT(view) *v,
 	return LIGHT(iterator_get_and_next_impl)(&v->common, itr);
 }
 
+/**
+ * @brief Start bulk loading of an empty hash table: allocate the table
+ *  for the given number of values.
+ * @param htab - pointer to a hash table struct
+ * @param count - number of values that will be loaded
+ * @return 0 if ok, -1 on memory error (the table is left empty)
+ */
+static inline int
+LIGHT(build_begin)(struct LIGHT(core) *htab, uint32_t count)
+{
+	struct LIGHT(common) *ht = &htab->common;
+	assert(ht->count == 0);
+	assert(ht->table_size == 0);
+	assert(ht->mtable->head.block_count == 0);
+	assert(!matras_is_read_view_created(ht->view));
+
+	/* Same geometry as after count insertions one by one. */
+	uint32_t table_size = (count + LIGHT_GROW_INCREMENT - 1) &
+			      ~(uint32_t)(LIGHT_GROW_INCREMENT - 1);
+	if (table_size == 0)
+		table_size = LIGHT_GROW_INCREMENT;
+	uint32_t cover_mask = LIGHT_GROW_INCREMENT - 1;
+	while (cover_mask < table_size - 1)
+		cover_mask = (cover_mask << 1) | (uint32_t)1;
+
+	for (uint32_t size = 0; size < table_size;
+	     size += LIGHT_GROW_INCREMENT) {
+		uint32_t slot;
+		struct LIGHT(record) *record = (struct LIGHT(record) *)
+			matras_alloc_range(ht->mtable, &slot,
+					   LIGHT_GROW_INCREMENT);
+		if (!record) {
+			for (; size > 0; size -= LIGHT_GROW_INCREMENT)
+				matras_dealloc_range(ht->mtable,
+						     LIGHT_GROW_INCREMENT);
+			return -1;
+		}
+		assert(slot == size);
+		/* Mark the records empty, the list is built later. */
+		for (int i = 0; i < LIGHT_GROW_INCREMENT; i++)
+			record[i].next = slot + i;
+	}
+	ht->table_size = table_size;
+	ht->cover_mask = cover_mask;
+	ht->empty_slot = LIGHT(end);
+	return 0;
+}
+
+static inline uint32_t
+LIGHT(build_slot)(const struct LIGHT(core) *htab, uint32_t hash)
+{
+	return LIGHT(slot)(&htab->common, hash);
+}
+
+/**
+ * @brief Finish bulk loading of a hash table.
+ * @param htab - pointer to a hash table struct
+ * @param entries - values to load, sorted by LIGHT(build_slot)
+ * @param count - number of values
+ */
+static inline void
+LIGHT(build_end)(struct LIGHT(core) *htab,
+		 const struct LIGHT(build_entry) *entries, uint32_t count)
+{
+	struct LIGHT(common) *ht = &htab->common;
+	assert(ht->count == 0);
+	assert(count <= ht->table_size);
+	assert(ht->table_size == ht->mtable->head.block_count);
+
+	/*
+	 * First, put the first value of each chain to its own slot.
+	 * Since the values are sorted by slot, the table is written
+	 * sequentially.
+	 */
+	uint32_t prev_slot = LIGHT(end);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t slot = LIGHT(slot)(ht, entries[i].hash);
+		assert(prev_slot == LIGHT(end) || prev_slot <= slot);
+		if (slot == prev_slot)
+			continue;
+		struct LIGHT(record) *record = LIGHT(touch_record)(ht, slot);
+		assert(record != NULL);
+		record->value = entries[i].value;
+		record->hash = entries[i].hash;
+		record->next = LIGHT(end);
+		prev_slot = slot;
+	}
+
+	/* Link the slots that are left empty into the list. */
+	uint32_t prev_empty_slot = LIGHT(end);
+	struct LIGHT(record) *prev_empty_record = NULL;
+	for (uint32_t slot = 0; slot < ht->table_size; slot++) {
+		struct LIGHT(record) *record = LIGHT(touch_record)(ht, slot);
+		assert(record != NULL);
+		if (record->next != slot)
+			continue;
+		LIGHT(set_empty_prev)(record, prev_empty_slot);
+		LIGHT(set_empty_next)(record, LIGHT(end));
+		if (prev_empty_record != NULL)
+			LIGHT(set_empty_next)(prev_empty_record, slot);
+		else
+			ht->empty_slot = slot;
+		prev_empty_slot = slot;
+		prev_empty_record = record;
+	}
+
+	/* Finally, put the rest of values to empty slots. */
+	prev_slot = LIGHT(end);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t slot = LIGHT(slot)(ht, entries[i].hash);
+		if (slot != prev_slot) {
+			prev_slot = slot;
+			continue;
+		}
+		uint32_t empty_slot = ht->empty_slot;
+		struct LIGHT(record) *empty_record =
+			LIGHT(detach_first_empty)(ht);
+		assert(empty_record != NULL);
+		struct LIGHT(record) *record = LIGHT(touch_record)(ht, slot);
+		assert(record != NULL);
+		empty_record->value = entries[i].value;
+		empty_record->hash = entries[i].hash;
+		empty_record->next = record->next;
+		record->next = empty_slot;
+	}
+	ht->count = count;
+}
+
 /*
  * Selfcheck of the internal state of hash table. Used only for debugging.
  * That means that you should not use this function.
@@ -195,6 +195,7 @@
 #cmakedefine HAVE_SO_NOSIGPIPE 1
 
 #cmakedefine HAVE_PRCTL_H 1
+#cmakedefine HAVE_LINUX_IO_URING_H 1
 
 #cmakedefine HAVE_UUIDGEN 1
 #cmakedefine HAVE_CLOCK_GETTIME 1
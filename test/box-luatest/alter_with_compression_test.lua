@@ -3,7 +3,7 @@ local t = require('luatest')
 
 local g = t.group("invalid compression type", t.helpers.matrix({
     engine = {'memtx', 'vinyl'},
-    compression = {'zstd', 'lz4'}
+    compression = {'lz4'}
 }))
 
 g.before_all(function(cg)
@@ -54,6 +54,33 @@ g.after_test('test_invalid_compression_type_during_setting_format', function(cg)
     end)
 end)
 
+g = t.group("vinyl compression")
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:stop()
+end)
+
+g.test_vinyl_compression = function(cg)
+    cg.server:exec(function()
+        local format = {{
+            name = 'x', type = 'unsigned', compression = 'zstd'
+        }}
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support compression",
+            box.schema.space.create, 'T', {engine = 'vinyl', format = format})
+        local s = box.schema.space.create('T', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support compression",
+            s.format, s, format)
+        s:drop()
+    end)
+end
+
 g = t.group("none compression", t.helpers.matrix({
     engine = {'memtx', 'vinyl'},
 }))
@@ -0,0 +1,53 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cbus_stat = function(cg)
+    cg.server:exec(function()
+        local stat = box.stat.cbus()
+        t.assert_type(stat, 'table')
+        local function wal_stat()
+            local s = box.stat.cbus().wal.main
+            t.assert_type(s, 'table')
+            return s
+        end
+        local before = wal_stat()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 10 do
+            s:replace({i})
+        end
+        s:drop()
+        local after = wal_stat()
+        t.assert_ge(after.messages - before.messages, 10)
+        t.assert_ge(after.batches - before.batches, 1)
+        t.assert_le(after.batches, after.messages)
+        t.assert_le(after.wakeups, after.batches)
+    end)
+end
+
+g.test_cbus_stat_iproto = function(cg)
+    local function tx_stat()
+        return cg.server:exec(function()
+            local s = box.stat.cbus().tx.iproto
+            t.assert_type(s, 'table')
+            return {messages = tonumber(s.messages)}
+        end)
+    end
+    local before = tx_stat()
+    for _ = 1, 10 do
+        cg.server:exec(function() end)
+    end
+    local after = tx_stat()
+    t.assert_ge(after.messages - before.messages, 10)
+end
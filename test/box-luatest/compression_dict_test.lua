@@ -0,0 +1,239 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_memtx = function(cg)
+    cg.server:exec(function()
+        local function dict_count()
+            local count = 0
+            for _, tuple in box.space._schema:pairs() do
+                if tuple.key:startswith('compression_dict.') then
+                    count = count + 1
+                end
+            end
+            return count
+        end
+        local function payload(i)
+            return string.format('{"name": "user%d", "status": "%s"}',
+                                 i, i % 3 == 0 and 'active' or 'blocked')
+        end
+        local s = box.schema.space.create('test', {
+            compression_dict = true,
+            format = {
+                {name = 'id', type = 'unsigned'},
+                {name = 'payload', type = 'string', compression = 'zstd'},
+            },
+        })
+        s:create_index('pk')
+        for i = 1, 2000 do
+            s:insert({i, payload(i)})
+        end
+        -- Short fields aren't compressed without a dictionary.
+        t.assert_equals(box.stat.memtx().compression.tuples, 0)
+
+        box.internal.train_compression_dict(s.id)
+        t.assert_equals(dict_count(), 1)
+        for i = 2001, 3000 do
+            s:insert({i, payload(i)})
+        end
+        local stat = box.stat.memtx().compression
+        t.assert_gt(stat.tuples, 0)
+        t.assert_gt(stat.ratio, 1)
+
+        -- Data compressed with the old dictionary remains readable
+        -- after the dictionary is retrained.
+        box.internal.train_compression_dict(s.id)
+        t.assert_equals(dict_count(), 2)
+        for i = 3001, 4000 do
+            s:insert({i, payload(i)})
+        end
+        t.assert_gt(box.stat.memtx().compression.tuples, stat.tuples)
+        for i = 1, 4000 do
+            t.assert_equals(s:get(i), {i, payload(i)})
+        end
+        box.snapshot()
+        for i = 4001, 4100 do
+            s:insert({i, payload(i)})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local function dict_count()
+            local count = 0
+            for _, tuple in box.space._schema:pairs() do
+                if tuple.key:startswith('compression_dict.') then
+                    count = count + 1
+                end
+            end
+            return count
+        end
+        local function payload(i)
+            return string.format('{"name": "user%d", "status": "%s"}',
+                                 i, i % 3 == 0 and 'active' or 'blocked')
+        end
+        local s = box.space.test
+        t.assert_equals(dict_count(), 2)
+        t.assert_gt(box.stat.memtx().compression.tuples, 0)
+        for i = 1, 4100 do
+            t.assert_equals(s:get(i), {i, payload(i)})
+        end
+        -- Dictionaries are deleted with the space.
+        s:drop()
+        t.assert_equals(dict_count(), 0)
+    end)
+end
+
+g.test_vinyl = function(cg)
+    cg.server:exec(function()
+        local function dict_count()
+            local count = 0
+            for _, tuple in box.space._schema:pairs() do
+                if tuple.key:startswith('compression_dict.') then
+                    count = count + 1
+                end
+            end
+            return count
+        end
+        local function payload(i)
+            return string.format('{"name": "user%d", "status": "%s"}',
+                                 i, i % 3 == 0 and 'active' or 'blocked')
+        end
+        local s = box.schema.space.create('test', {
+            engine = 'vinyl', compression_dict = true,
+        })
+        s:create_index('pk')
+        for i = 1, 2000 do
+            s:insert({i, payload(i)})
+        end
+        box.snapshot()
+        box.internal.train_compression_dict(s.id)
+        t.assert_equals(dict_count(), 1)
+        for i = 2001, 4000 do
+            s:insert({i, payload(i)})
+        end
+        box.snapshot()
+        box.internal.train_compression_dict(s.id)
+        t.assert_equals(dict_count(), 2)
+        for i = 4001, 6000 do
+            s:insert({i, payload(i)})
+        end
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.rows, 0)
+        end)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local function payload(i)
+            return string.format('{"name": "user%d", "status": "%s"}',
+                                 i, i % 3 == 0 and 'active' or 'blocked')
+        end
+        local s = box.space.test
+        for i = 1, 6000 do
+            t.assert_equals(s:get(i), {i, payload(i)})
+        end
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "test does not support compression dictionary training " ..
+            "without compression_dict option",
+            box.internal.train_compression_dict, s.id)
+        s:alter({compression_dict = true})
+        t.assert_error_msg_content_equals(
+            "Compression error: not enough data to train a dictionary",
+            box.internal.train_compression_dict, s.id)
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'compression_dict' " ..
+            "should be of type boolean",
+            box.schema.space.create, 'test2', {compression_dict = 1})
+    end)
+end
+
+-- Checks that a dictionary can't be replaced with a different one
+-- with the same identifier, e.g. trained by another master.
+g.test_conflict = function(cg)
+    cg.server:exec(function()
+        local bit = require('bit')
+        local msgpack = require('msgpack')
+        local function bin(data)
+            local n = #data
+            return msgpack.object_from_raw('\xc6' .. string.char(
+                bit.band(bit.rshift(n, 24), 0xff),
+                bit.band(bit.rshift(n, 16), 0xff),
+                bit.band(bit.rshift(n, 8), 0xff),
+                bit.band(n, 0xff)) .. data)
+        end
+        local s = box.schema.space.create('test', {compression_dict = true})
+        s:create_index('pk')
+        for i = 1, 2000 do
+            s:insert({i, string.format('{"name": "user%d"}', i)})
+        end
+        box.internal.train_compression_dict(s.id)
+        local row
+        for _, tuple in box.space._schema:pairs() do
+            if tuple.key:startswith('compression_dict.') then
+                row = tuple:totable()
+            end
+        end
+        t.assert_not_equals(row, nil)
+        local id = tonumber(row[1]:sub(#'compression_dict.' + 1))
+        box.space._schema:delete(row[1])
+        local data = row[3]:sub(1, -2) ..
+                     string.char((row[3]:byte(-1) + 1) % 256)
+        t.assert_error_msg_content_equals(
+            string.format("Compression error: compression dictionary " ..
+                          "%d conflicts with another dictionary with " ..
+                          "the same identifier", id),
+            box.space._schema.insert, box.space._schema,
+            {row[1], row[2], bin(data), row[4]})
+        -- The same dictionary may be stored again.
+        box.space._schema:insert({row[1], row[2], bin(row[3]), row[4]})
+    end)
+end
+
+g.test_drop_while_training = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {compression_dict = true})
+        s:create_index('pk')
+        for i = 1, 2000 do
+            s:insert({i, string.format('{"name": "user%d"}', i)})
+        end
+        local id = s.id
+        -- The fiber yields while waiting for the training thread.
+        local f = fiber.create(box.internal.train_compression_dict, id)
+        f:set_joinable(true)
+        s:drop()
+        local ok, err = f:join()
+        t.assert_not(ok)
+        t.assert_equals(err.type, 'ClientError')
+        t.assert_equals(err.code, box.error.NO_SUCH_SPACE)
+        for _, tuple in box.space._schema:pairs() do
+            t.assert_not(tuple.key:startswith('compression_dict.'))
+        end
+    end)
+end
@@ -0,0 +1,88 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('get_many', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {parts = {{1, 'unsigned'}}, page_size = 128})
+        s:create_index('sk', {parts = {{2, 'string'}}})
+        s:create_index('nu', {parts = {{3, 'unsigned'}}, unique = false})
+        for i = 1, 500 do
+            s:insert({i, 'v' .. i, i % 10})
+        end
+        box.snapshot()
+        -- Some keys are updated or deleted in memory.
+        for i = 1, 500, 5 do
+            s:replace({i, 'v' .. i, i % 10 + 1})
+        end
+        for i = 2, 500, 50 do
+            s:delete(i)
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_get_many = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local keys = {}
+        for i = 0, 501 do
+            table.insert(keys, i)
+        end
+        local result = s:get_many(keys)
+        t.assert_equals(#result, #keys)
+        for i, key in ipairs(keys) do
+            t.assert_equals(result[i], s:get(key), key)
+        end
+        t.assert_equals(s:get_many({}), {})
+        t.assert_equals(s.index.pk:get_many({{3}, {2}, {3}}),
+                        {{3, 'v3', 3}, box.NULL, {3, 'v3', 3}})
+        t.assert_equals(s.index.sk:get_many({'v6', 'v2', 'v1'}),
+                        {{6, 'v6', 7}, box.NULL, {1, 'v1', 2}})
+
+        -- Changes made by the current transaction are visible.
+        box.begin()
+        t.assert_equals(s:get_many({4, 52}), {{4, 'v4', 4}, box.NULL})
+        s:replace({52, 'v52', 2})
+        t.assert_equals(s:get_many({4, 52}),
+                        {{4, 'v4', 4}, {52, 'v52', 2}})
+        box.rollback()
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_content_equals(
+            "Get() doesn't support partial keys and non-unique indexes",
+            s.index.nu.get_many, s.index.nu, {1})
+        t.assert_error_msg_content_equals(
+            "Invalid key part count in an exact match (expected 1, got 2)",
+            s.get_many, s, {1, {1, 2}})
+        t.assert_error_msg_content_equals(
+            "Supplied key type of part 0 does not match index part type: " ..
+            "expected unsigned",
+            s.get_many, s, {1, 'x'})
+        t.assert_error_msg_content_equals(
+            "Usage: index:get_many({key1, key2, ...})",
+            s.get_many, s, 1)
+    end)
+end
@@ -126,6 +126,7 @@ local reference_table = {
         BEGIN = 14,
         COMMIT = 15,
         ROLLBACK = 16,
+        DELETE_RANGE = 17,
         RAFT = 30,
         RAFT_PROMOTE = 31,
         RAFT_DEMOTE = 32,
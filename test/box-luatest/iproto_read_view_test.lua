@@ -0,0 +1,114 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {iproto_read_view_staleness = 0.1},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {iproto_read_view = true})
+        s:create_index('pk')
+        s:create_index('sk', {type = 'hash', parts = {{2, 'unsigned'}}})
+        for i = 1, 10 do
+            s:insert({i, i * 10})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+        box.schema.space.create('secret', {iproto_read_view = true})
+        box.space.secret:create_index('pk')
+        box.space.secret:insert({1})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function select_count(cg)
+    return cg.server:exec(function()
+        return box.stat().SELECT.total
+    end)
+end
+
+-- Returns the number of requests processed by the tx thread, including
+-- the request sent by this function.
+local function tx_request_count(cg)
+    return cg.server:exec(function()
+        return box.stat.net().REQUESTS_IN_PROGRESS.total
+    end)
+end
+
+g.test_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local s = conn.space.test
+    -- Wait for the read view to be refreshed after the schema change.
+    t.helpers.retrying({}, function()
+        local count = tx_request_count(cg)
+        s:select({1})
+        t.assert_equals(tx_request_count(cg), count + 1)
+    end)
+    local select_count_before = select_count(cg)
+    local count = tx_request_count(cg)
+    t.assert_equals(s:select({5}), {{5, 50}})
+    t.assert_equals(s:select({8}, {iterator = 'ge'}),
+                    {{8, 80}, {9, 90}, {10, 100}})
+    t.assert_equals(s:select({3}, {iterator = 'req'}),
+                    {{3, 30}, {2, 20}, {1, 10}})
+    t.assert_equals(s:select({}, {offset = 2, limit = 3}),
+                    {{3, 30}, {4, 40}, {5, 50}})
+    t.assert_equals(s:select({11}), {})
+    t.assert_equals(s.index.sk:select({70}), {{7, 70}})
+    t.assert_equals(tx_request_count(cg), count + 1)
+    -- Selects served from the read view are accounted in box.stat().
+    t.assert_equals(select_count(cg), select_count_before + 6)
+
+    -- Unsupported requests are forwarded to tx.
+    count = tx_request_count(cg)
+    t.assert_equals(s:select({}, {after = {9}}), {{10, 100}})
+    t.assert_equals(tx_request_count(cg), count + 2)
+
+    -- New data become visible after the read view is refreshed.
+    cg.server:exec(function()
+        box.space.test:replace({11, 110})
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(s:select({11}), {{11, 110}})
+    end)
+
+    -- Access rights are checked.
+    t.assert_error_msg_content_equals(
+        "Read access to space 'secret' is denied for user 'guest'",
+        conn.space.secret.select, conn.space.secret, {1})
+    conn:close()
+end
+
+g.test_disable = function(cg)
+    cg.server:exec(function()
+        box.cfg({iproto_read_view_staleness = 0})
+    end)
+    local conn = net.connect(cg.server.net_box_uri)
+    local count = tx_request_count(cg)
+    t.assert_equals(conn.space.test:select({1}), {{1, 10}})
+    t.assert_equals(tx_request_count(cg), count + 2)
+    conn:close()
+    cg.server:exec(function()
+        box.cfg({iproto_read_view_staleness = 0.1})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'iproto_read_view_staleness': " ..
+            "the value must be greater than or equal to 0",
+            box.cfg, {iproto_read_view_staleness = -1})
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support iproto read view",
+            box.schema.space.create, 'vinyl',
+            {engine = 'vinyl', iproto_read_view = true})
+    end)
+end
@@ -0,0 +1,79 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+local THREAD_COUNT = 4
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {iproto_threads = THREAD_COUNT},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function(uri)
+        box.cfg({listen = uri, iproto_reuseport = false})
+    end, {cg.server.net_box_uri})
+end)
+
+-- Listens on the server unix socket and a TCP port and returns
+-- the TCP address.
+local function listen(cg, reuseport)
+    return cg.server:exec(function(uri, reuseport)
+        box.cfg({
+            listen = {uri, 'localhost:0'},
+            iproto_reuseport = reuseport,
+        })
+        t.assert_equals(box.cfg.iproto_reuseport, reuseport)
+        return box.info.listen[2]
+    end, {cg.server.net_box_uri, reuseport})
+end
+
+g.test_reuseport = function(cg)
+    t.skip_if(jit.os ~= 'Linux', 'SO_REUSEPORT balancing is Linux-only')
+    local uri = listen(cg, true)
+    local conns = {}
+    for i = 1, 40 do
+        local c = net.connect(uri)
+        t.assert_equals(c.state, 'active')
+        t.assert_equals(c:eval('return 1'), 1)
+        conns[i] = c
+    end
+    -- Connections are spread among all the threads.
+    cg.server:exec(function(thread_count)
+        local stat = box.stat.net.thread()
+        t.assert_equals(#stat, thread_count)
+        for i = 1, thread_count do
+            t.assert_gt(stat[i].CONNECTIONS.current, 0, i)
+        end
+    end, {THREAD_COUNT})
+    -- The unix socket still works.
+    local c = net.connect(cg.server.net_box_uri)
+    t.assert_equals(c:eval('return 1'), 1)
+    c:close()
+    -- Switching the mode re-binds the sockets.
+    uri = listen(cg, false)
+    c = net.connect(uri)
+    t.assert_equals(c:eval('return 1'), 1)
+    c:close()
+    for _, c in ipairs(conns) do
+        c:close()
+    end
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'iproto_reuseport': " ..
+            "should be of type boolean", box.cfg,
+            {iproto_reuseport = 'foo'})
+    end)
+end
@@ -0,0 +1,68 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('iproto_select_splice', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+    splice_size = {1, 4096, 0},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function(engine, splice_size)
+        require('internal.tweaks').iproto_select_splice_size = splice_size
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        for i = 1, 200 do
+            -- Mix tuples smaller and larger than the default threshold.
+            s:insert({i, string.rep(string.char(65 + i % 26),
+                                    i % 3 == 0 and 100 or 20000 + i)})
+        end
+    end, {cg.params.engine, cg.params.splice_size})
+    cg.conn = net.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+g.test_select = function(cg)
+    local expected = cg.server:exec(function()
+        return box.space.test:select()
+    end)
+    local s = cg.conn.space.test
+    t.assert_equals(s:select(), expected)
+    t.assert_equals(s:select({}, {limit = 1}), {expected[1]})
+    t.assert_equals(s:select({3}), {expected[3]})
+    t.assert_equals(s:get(4), expected[4])
+    t.assert_equals(s:select({}, {iterator = 'gt', limit = 0}), {})
+    t.assert_equals(s:select({}, {limit = 5, after = expected[5]}),
+                    {unpack(expected, 6, 10)})
+    if cg.params.engine == 'memtx' then
+        -- Selects with the position appended after the tuples.
+        local res, pos = s:select({}, {limit = 5, fetch_pos = true})
+        t.assert_equals(res, {unpack(expected, 1, 5)})
+        res = s:select({}, {limit = 5, after = pos})
+        t.assert_equals(res, {unpack(expected, 6, 10)})
+    end
+    -- Pipelined requests.
+    local futures = {}
+    for i = 1, 20 do
+        futures[i] = s:select({i * 10}, {iterator = 'le', limit = 10,
+                                        is_async = true})
+    end
+    for i = 1, 20 do
+        local r = futures[i]:wait_result()
+        t.assert_equals(#r, 10)
+        t.assert_equals(r[1], expected[i * 10])
+        t.assert_equals(r[10], expected[i * 10 - 9])
+    end
+    -- The server still serves requests after the tuples are gone.
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+    t.assert_equals(s:select(), {})
+    t.assert_equals(cg.conn:eval('return 1'), 1)
+end
@@ -0,0 +1,81 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+-- Fewer, as many, and more sort threads than bulk built indexes.
+local g = t.group('memtx_build_secondary_indexes', t.helpers.matrix({
+    memtx_sort_threads = {1, 4, 8},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_sort_threads = cg.params.memtx_sort_threads},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks that all kinds of secondary indexes are built correctly
+-- on recovery from a snapshot.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('str', {parts = {2, 'string'}})
+        s:create_index('nohint', {parts = {2, 'string'}, hint = false})
+        s:create_index('nullable', {
+            parts = {{3, 'unsigned', is_nullable = true}}, unique = false,
+        })
+        s:create_index('excluded', {
+            parts = {{3, 'unsigned', exclude_null = true}}, unique = false,
+        })
+        s:create_index('multikey', {
+            parts = {{'[4][*]', 'unsigned'}}, unique = false,
+        })
+        s:create_index('hash', {type = 'hash', parts = {2, 'string'}})
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, string.format('%08d', i),
+                      i % 2 == 0 and i or box.NULL, {i, i + 1}})
+        end
+        box.commit()
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:count(), 10000)
+        t.assert_equals(s.index.str:count(), 10000)
+        t.assert_equals(s.index.nohint:count(), 10000)
+        t.assert_equals(s.index.nullable:count(), 10000)
+        t.assert_equals(s.index.excluded:count(), 5000)
+        t.assert_equals(s.index.multikey:count(), 20000)
+        t.assert_equals(s.index.hash:count(), 10000)
+        t.assert_equals(s.index.str:select({}, {limit = 1})[1][1], 1)
+        t.assert_equals(s.index.excluded:select({}, {limit = 1})[1][1], 2)
+        t.assert_equals(#s.index.multikey:select({5000}), 2)
+        -- Check that the indexes are sorted by {key, pk}.
+        local fields = {str = 2, nohint = 2, nullable = 3, excluded = 3}
+        for name, field in pairs(fields) do
+            local prev
+            for _, tuple in s.index[name]:pairs() do
+                local key = {tuple[field] or -1, tuple[1]}
+                if prev ~= nil then
+                    t.assert(prev[1] < key[1] or
+                             prev[1] == key[1] and prev[2] < key[2], name)
+                end
+                prev = key
+            end
+        end
+        for i = 1, 10000, 997 do
+            local key = string.format('%08d', i)
+            t.assert_equals(s.index.str:get(key)[1], i)
+            t.assert_equals(s.index.nohint:get(key)[1], i)
+            t.assert_equals(s.index.hash:get(key)[1], i)
+        end
+        s:drop()
+    end)
+end
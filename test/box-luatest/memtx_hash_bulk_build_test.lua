@@ -0,0 +1,121 @@
+local fio = require('fio')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks hash indexes built in bulk on recovery.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        s:create_index('sk', {type = 'hash', parts = {2, 'string'}})
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, tostring(i)})
+        end
+        box.commit()
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.pk:len(), 10000)
+        t.assert_equals(s.index.sk:len(), 10000)
+        for i = 1, 10000 do
+            t.assert_equals(s.index.pk:get(i), {i, tostring(i)})
+            t.assert_equals(s.index.sk:get(tostring(i)), {i, tostring(i)})
+        end
+        s:insert({10001, '10001'})
+        t.assert_equals(s.index.sk:get('10001'), {10001, '10001'})
+    end)
+end
+
+-- Checks a hash index built in bulk on a populated space.
+g.test_create_index = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, tostring(i), i % 100})
+        end
+        box.commit()
+        local sk = s:create_index('sk', {type = 'hash', parts = {2, 'string'}})
+        t.assert_equals(sk:len(), 10000)
+        for i = 1, 10000 do
+            t.assert_equals(sk:get(tostring(i)), {i, tostring(i), i % 100})
+        end
+        t.assert_error_msg_contains(
+            'Duplicate key exists in unique index "sk2" in space "test"',
+            s.create_index, s, 'sk2', {type = 'hash', parts = {3, 'unsigned'}})
+        t.assert_equals(s.index.sk2, nil)
+        s:replace({1, '1', 1000})
+        t.assert_equals(sk:get('1'), {1, '1', 1000})
+    end)
+end
+
+local g_dup = t.group('memtx_hash_bulk_build_dup')
+
+g_dup.before_all(function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server = server:new({alias = 'dup'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DUPLICATE_ROW', true)
+        box.snapshot()
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DUPLICATE_ROW', false)
+    end)
+    cg.server:stop()
+end)
+
+g_dup.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+-- Checks recovery from a snapshot with duplicated rows.
+g_dup.test_recovery = function(cg)
+    local s = cg.server
+    s:start({wait_until_ready = false})
+    local log = fio.pathjoin(s.workdir, s.alias .. '.log')
+    t.helpers.retrying({}, function()
+        t.assert_not_equals(s:grep_log('Duplicate key exists in unique ' ..
+                                       'index "pk" in space "test"', nil,
+                                       {filename = log}), nil)
+        t.assert_not(s.process:is_alive())
+    end)
+    s:stop()
+    s.box_cfg = {force_recovery = true}
+    s:start()
+    s:exec(function()
+        local space = box.space.test
+        t.assert_equals(space:len(), 100)
+        for i = 1, 100 do
+            t.assert_equals(space:get(i), {i})
+        end
+    end)
+end
@@ -0,0 +1,48 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('memtx_recovery_threads', {
+    {recovery_threads = 1},
+    {recovery_threads = 4},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks that a snapshot decoded in threads is recovered correctly.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('primary')
+        s:create_index('secondary', {parts = {2, 'string'}})
+        box.begin()
+        for i = 1, 20000 do
+            s:insert({i, string.format('%08d', i), string.rep('x', i % 100)})
+        end
+        box.commit()
+        box.snapshot()
+    end)
+    cg.server:restart({
+        box_cfg = {memtx_recovery_threads = cg.params.recovery_threads},
+    })
+    cg.server:exec(function(recovery_threads)
+        t.assert_equals(box.cfg.memtx_recovery_threads, recovery_threads)
+        local s = box.space.test
+        t.assert_equals(s:count(), 20000)
+        t.assert_equals(s.index.secondary:count(), 20000)
+        for i = 1, 20000, 997 do
+            t.assert_equals(s:get(i),
+                            {i, string.format('%08d', i),
+                             string.rep('x', i % 100)})
+        end
+        s:drop()
+    end, {cg.params.recovery_threads})
+    t.assert(cg.server:grep_log('decoding snapshot in ' ..
+                                cg.params.recovery_threads .. ' threads'))
+end
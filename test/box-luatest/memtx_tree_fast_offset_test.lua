@@ -0,0 +1,170 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('memtx_tree_fast_offset', {{hint = true}, {hint = false}})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks count of a tree index with fast offset against a full scan.
+g.test_count = function(cg)
+    cg.server:exec(function(hint)
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {fast_offset = true, hint = hint})
+        local sk = s:create_index('sk', {
+            parts = {{2, 'unsigned'}, {3, 'unsigned', is_nullable = true}},
+            unique = false, fast_offset = true, hint = hint,
+        })
+        t.assert_equals(s.index.pk.fast_offset, true)
+        t.assert_equals(sk.fast_offset, true)
+        local function check()
+            local iterators = {'ALL', 'EQ', 'REQ', 'GE', 'GT', 'LE', 'LT'}
+            local keys = {{}, {-1}, {0}, {7}, {19}, {20}, {7, box.NULL},
+                          {7, 3}, {7, 100}}
+            for _, index in ipairs({s.index.pk, sk}) do
+                for _, it in ipairs(iterators) do
+                    for _, key in ipairs(keys) do
+                        local ok, expected = pcall(function()
+                            return #index:select(key, {iterator = it})
+                        end)
+                        if ok then
+                            t.assert_equals(
+                                index:count(key, {iterator = it}), expected,
+                                string.format('%s %s %s', index.name, it,
+                                              require('json').encode(key)))
+                        end
+                    end
+                end
+            end
+        end
+        check()
+        box.begin()
+        for i = 1, 2000 do
+            s:insert({i, i % 20, i % 7 ~= 0 and i % 5 or nil})
+        end
+        box.commit()
+        check()
+        for i = 1, 2000, 3 do
+            s:delete(i)
+        end
+        check()
+        t.assert_equals(s:count(), s:len())
+        t.assert_equals(sk:count(), sk:len())
+    end, {cg.params.hint})
+end
+
+-- Checks select with offset from a tree index with fast offset against
+-- an index without it.
+g.test_select_offset = function(cg)
+    cg.server:exec(function(hint)
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {fast_offset = true, hint = hint})
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false,
+                              fast_offset = true, hint = hint})
+        s:create_index('sk_ref', {parts = {2, 'unsigned'}, unique = false})
+        box.begin()
+        for i = 1, 1000 do
+            s:insert({i, i % 10})
+        end
+        box.commit()
+        for i = 1, 1000, 7 do
+            s:delete(i)
+        end
+        local iterators = {'ALL', 'EQ', 'REQ', 'GE', 'GT', 'LE', 'LT'}
+        local keys = {{}, {0}, {5}, {9}, {10}}
+        local offsets = {0, 1, 13, 99, 100, 500, 1000}
+        local sk, sk_ref = s.index.sk, s.index.sk_ref
+        for _, it in ipairs(iterators) do
+            for _, key in ipairs(keys) do
+                for _, offset in ipairs(offsets) do
+                    local opts = {iterator = it, offset = offset, limit = 5}
+                    local msg = string.format('%s %s %d', it,
+                                              require('json').encode(key),
+                                              offset)
+                    t.assert_equals(sk:select(key, opts),
+                                    sk_ref:select(key, opts), msg)
+                    local res = sk:select(key, {iterator = it, limit = 3})
+                    if #res > 0 then
+                        opts.after = res[#res]
+                        t.assert_equals(sk:select(key, opts),
+                                        sk_ref:select(key, opts), msg)
+                    end
+                end
+            end
+        end
+        t.assert_equals(s.index.pk:select({}, {offset = 855, limit = 2}),
+                        {{999, 9}, {1000, 0}})
+        t.assert_equals(s.index.pk:select({500}, {iterator = 'LT',
+                                                 offset = 10, limit = 1}),
+                        {{487, 7}})
+    end, {cg.params.hint})
+end
+
+-- Checks that a tree index with fast offset is built correctly on recovery
+-- and by alter.
+g.test_build = function(cg)
+    cg.server:exec(function(hint)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false,
+                              fast_offset = true, hint = hint})
+        box.begin()
+        for i = 1, 5000 do
+            s:insert({i, i % 100})
+        end
+        box.commit()
+        box.snapshot()
+    end, {cg.params.hint})
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.sk.fast_offset, true)
+        t.assert_equals(s.index.sk:count({50}), 50)
+        t.assert_equals(s.index.sk:count({50}, {iterator = 'LT'}), 2500)
+        t.assert_equals(s.index.sk:count({50}, {iterator = 'GT'}), 2450)
+        s.index.pk:alter({fast_offset = true})
+        t.assert_equals(s.index.pk.fast_offset, true)
+        t.assert_equals(s.index.pk:count({1000}, {iterator = 'LE'}), 1000)
+        s.index.sk:alter({fast_offset = false})
+        t.assert_equals(s.index.sk.fast_offset, nil)
+        t.assert_equals(s.index.sk:count({50}), 50)
+    end)
+end
+
+-- Checks validation of the fast_offset index option.
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_equals(
+            "Illegal parameters, options parameter 'fast_offset' should be " ..
+            "of type boolean",
+            s.create_index, s, 'pk', {fast_offset = 1})
+        t.assert_error_msg_contains(
+            "fast_offset is only reasonable with memtx tree index",
+            s.create_index, s, 'pk', {type = 'hash', fast_offset = true})
+        s:create_index('pk')
+        t.assert_error_msg_contains(
+            "multikey index can't use fast_offset",
+            s.create_index, s, 'mk',
+            {parts = {{'[2][*]', 'unsigned'}}, fast_offset = true})
+        local v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+        t.assert_error_msg_contains(
+            "fast_offset is only reasonable with memtx tree index",
+            v.create_index, v, 'pk', {fast_offset = true})
+        v:drop()
+    end)
+end
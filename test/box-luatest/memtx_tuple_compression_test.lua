@@ -0,0 +1,118 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'payload', type = 'string', compression = 'zstd'},
+            {name = 'name', type = 'string'},
+        }})
+        s:create_index('pk')
+        s:create_index('name', {parts = {'name'}, unique = false})
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_compression = function(cg)
+    cg.server:exec(function()
+        local function payload(i)
+            return string.rep('{"key": "value", "id": ' .. i .. '}', 100)
+        end
+        local s = box.space.test
+        for i = 1, 100 do
+            s:insert({i, payload(i), 'name' .. i % 10})
+        end
+        -- Short fields aren't compressed.
+        s:insert({101, 'short', 'name1'})
+        local stat = box.stat.memtx().compression
+        t.assert_equals(stat.tuples, 100)
+        t.assert_gt(stat.raw_size, 100 * #payload(1))
+        t.assert_lt(stat.compressed_size * 10, stat.raw_size)
+        t.assert_gt(stat.ratio, 10)
+
+        t.assert_equals(s:get(1), {1, payload(1), 'name1'})
+        t.assert_equals(s:get(101), {101, 'short', 'name1'})
+        t.assert_equals(s.index.name:select('name2', {limit = 1}),
+                        {{2, payload(2), 'name2'}})
+        t.assert_equals(s:select({}, {limit = 2}),
+                        {{1, payload(1), 'name1'}, {2, payload(2), 'name2'}})
+        t.assert_equals(s:update(3, {{'=', 'name', 'new'}}),
+                        {3, payload(3), 'new'})
+        t.assert_equals(s:replace({4, payload(40), 'name4'}),
+                        {4, payload(40), 'name4'})
+        t.assert_equals(s:delete(5), {5, payload(5), 'name5'})
+        t.assert_equals(s:get(3), {3, payload(3), 'new'})
+        t.assert_equals(s:get(4), {4, payload(40), 'name4'})
+        t.assert_equals(s:get(5), nil)
+
+        -- Rollback restores the compressed tuples.
+        box.begin()
+        s:delete(6)
+        s:replace({7, payload(70), 'name7'})
+        box.rollback()
+        t.assert_equals(s:get(6), {6, payload(6), 'name6'})
+        t.assert_equals(s:get(7), {7, payload(7), 'name7'})
+
+        t.assert_equals(box.stat.memtx().compression.tuples, 99)
+        -- Tuples of a truncated space are freed in background.
+        s:truncate()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.memtx().compression, {
+                tuples = 0, raw_size = 0, compressed_size = 0, ratio = 1,
+            })
+        end)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local function payload(i)
+            return string.rep('{"key": "value", "id": ' .. i .. '}', 100)
+        end
+        local s = box.space.test
+        for i = 1, 100 do
+            s:insert({i, payload(i), 'name' .. i})
+        end
+        box.snapshot()
+        for i = 101, 200 do
+            s:insert({i, payload(i), 'name' .. i})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local function payload(i)
+            return string.rep('{"key": "value", "id": ' .. i .. '}', 100)
+        end
+        local s = box.space.test
+        t.assert_equals(box.stat.memtx().compression.tuples, 200)
+        for i = 1, 200 do
+            t.assert_equals(s:get(i), {i, payload(i), 'name' .. i})
+        end
+    end)
+end
+
+g.test_indexed_field = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Indexed field does not support compression",
+            box.space.test.create_index, box.space.test, 'payload',
+            {parts = {'payload'}})
+    end)
+end
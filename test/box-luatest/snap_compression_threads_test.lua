@@ -0,0 +1,55 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {snap_compression_threads = 4},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks that a snapshot compressed in a pool of threads is recovered.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('primary')
+        box.begin()
+        for i = 1, 50000 do
+            s:insert({i, string.rep(tostring(i), 10)})
+        end
+        box.commit()
+        box.snapshot()
+        -- The number of threads may be changed between snapshots.
+        box.cfg{snap_compression_threads = 2}
+        s:replace({1, 'updated'})
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:count(), 50000)
+        t.assert_equals(s:get(1), {1, 'updated'})
+        for i = 2, 50000 do
+            t.assert_equals(s:get(i), {i, string.rep(tostring(i), 10)})
+        end
+        box.cfg{snap_compression_threads = 0}
+        box.snapshot()
+    end)
+end
+
+g.test_invalid_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'snap_compression_threads': " ..
+            "must be greater than or equal to 0 and less than or equal " ..
+            "to 64",
+            box.cfg, {snap_compression_threads = 100})
+    end)
+end
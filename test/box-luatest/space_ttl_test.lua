@@ -0,0 +1,165 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+local function check_memtx(expiry_index)
+    local clock = require('clock')
+    local s = box.schema.space.create('test', {
+        ttl = 60, ttl_field = 'mtime',
+        format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'mtime', type = 'number', is_nullable = true},
+        },
+    })
+    s:create_index('pk')
+    if expiry_index then
+        s:create_index('mtime', {parts = {'mtime'}, unique = false})
+    end
+    local now = clock.realtime()
+    for i = 1, 1000 do
+        -- Even tuples are expired, odd tuples aren't.
+        s:insert({i, i % 2 == 0 and now - 100 or now})
+    end
+    s:insert({1001})
+    t.helpers.retrying({}, function()
+        t.assert_equals(s:count(), 501)
+    end)
+    for i = 1, 1000 do
+        t.assert_equals(s:get(i) ~= nil, i % 2 == 1, i)
+    end
+    t.assert_equals(s:get(1001), {1001})
+end
+
+g.test_memtx = function(cg)
+    cg.server:exec(check_memtx, {false})
+end
+
+g.test_memtx_expiry_index = function(cg)
+    cg.server:exec(check_memtx, {true})
+end
+
+-- Checks that values sorting before numbers in an expiry index
+-- don't stop expiration.
+g.test_memtx_expiry_index_scalar = function(cg)
+    cg.server:exec(function()
+        local clock = require('clock')
+        local s = box.schema.space.create('test', {
+            ttl = 60, ttl_field = 'mtime',
+            format = {
+                {name = 'id', type = 'unsigned'},
+                {name = 'mtime', type = 'scalar', is_nullable = true},
+            },
+        })
+        s:create_index('pk')
+        s:create_index('mtime', {parts = {'mtime'}, unique = false})
+        -- More than checked by the expiration fiber in one step.
+        for i = 1, 2000 do
+            s:insert({i, i % 2 == 0})
+        end
+        s:insert({2001})
+        s:insert({2002, 0 / 0})
+        local now = clock.realtime()
+        s:insert({2003, now - 100})
+        s:insert({2004, now})
+        s:insert({2005, 'foo'})
+        t.helpers.retrying({}, function()
+            t.assert_equals(s:get(2003), nil)
+        end)
+        t.assert_equals(s:count(), 2004)
+    end)
+end
+
+g.test_memtx_alter = function(cg)
+    cg.server:exec(function()
+        local clock = require('clock')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local now = clock.realtime()
+        s:insert({1, now - 100})
+        s:insert({2, now})
+        s:alter({ttl = 10, ttl_field = 2})
+        t.helpers.retrying({}, function()
+            t.assert_equals(s:select(), {{2, now}})
+        end)
+    end)
+end
+
+g.test_vinyl = function(cg)
+    cg.server:exec(function()
+        local clock = require('clock')
+        local s = box.schema.space.create('test', {
+            engine = 'vinyl', ttl = 60, ttl_field = 2,
+        })
+        s:create_index('pk')
+        local now = clock.realtime()
+        for i = 1, 100 do
+            s:insert({i, i % 2 == 0 and now - 100 or now})
+        end
+        box.snapshot()
+        -- Expired tuples are visible until compacted.
+        t.assert_equals(s:count(), 100)
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.count, 1)
+        end)
+        t.assert_equals(s:count(), 50)
+        t.assert_equals(s.index.pk:stat().disk.rows, 50)
+        for i = 1, 100 do
+            t.assert_equals(s:get(i) ~= nil, i % 2 == 1, i)
+        end
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Failed to create space 'test': ttl must be non-negative",
+            box.schema.space.create, 'test', {ttl = -1})
+        t.assert_error_msg_content_equals(
+            "Failed to create space 'test': " ..
+            "ttl_field must be of a numeric type",
+            box.schema.space.create, 'test', {
+                ttl = 1, ttl_field = 'name',
+                format = {{'id', 'unsigned'}, {'name', 'string'}},
+            })
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, ttl_field: field 'foo' was not found",
+            box.schema.space.create, 'test', {ttl = 1, ttl_field = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'ttl' " ..
+            "should be of type number",
+            box.schema.space.create, 'test', {ttl = '1'})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, ttl_field must be set if ttl is set",
+            box.schema.space.create, 'test', {ttl = 60})
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, ttl_field must be set if ttl is set",
+            s.alter, s, {ttl = 60})
+        -- Bypass the Lua checks.
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': " ..
+            "ttl_field must be set if ttl is set",
+            box.space._space.update, box.space._space, s.id,
+            {{'=', 'flags', {ttl = 60}}})
+        s:drop()
+    end)
+end
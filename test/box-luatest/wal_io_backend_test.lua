@@ -0,0 +1,65 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('wal_io_backend', t.helpers.matrix({
+    wal_io_backend = {'posix', 'io_uring'},
+    wal_mode = {'write', 'fsync'},
+}))
+
+local function is_supported(cg)
+    return cg.params.wal_io_backend ~= 'io_uring' or jit.os == 'Linux'
+end
+
+g.before_all(function(cg)
+    if not is_supported(cg) then
+        return
+    end
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            wal_io_backend = cg.params.wal_io_backend,
+            wal_mode = cg.params.wal_mode,
+            wal_max_size = 64 * 1024,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+-- Checks that rows written with the given backend are recovered.
+g.test_recovery = function(cg)
+    t.skip_if(not is_supported(cg), 'io_uring is only supported on Linux')
+    cg.server:exec(function(params)
+        t.assert_equals(box.cfg.wal_io_backend, params.wal_io_backend)
+        local other = params.wal_io_backend == 'posix' and 'io_uring' or
+                      'posix'
+        t.assert_error_msg_content_equals(
+            "Can't set option 'wal_io_backend' dynamically",
+            box.cfg, {wal_io_backend = other})
+        local s = box.schema.space.create('test')
+        s:create_index('primary')
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', i % 500)})
+        end
+        -- Big transactions are written with many iovecs.
+        box.begin()
+        for i = 1001, 3000 do
+            s:insert({i, string.rep('x', i % 500)})
+        end
+        box.commit()
+    end, {cg.params})
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:count(), 3000)
+        for i = 1, 3000, 97 do
+            t.assert_equals(s:get(i), {i, string.rep('x', i % 500)})
+        end
+        s:drop()
+    end)
+end
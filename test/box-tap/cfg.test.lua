@@ -6,7 +6,7 @@ local socket = require('socket')
 local fio = require('fio')
 local uuid = require('uuid')
 local msgpack = require('msgpack')
-test:plan(112)
+test:plan(121)
 
 --------------------------------------------------------------------------------
 -- Invalid values
@@ -34,6 +34,8 @@ invalid('replication_sync_timeout', -1)
 invalid('replication_connect_timeout', -1)
 invalid('replication_connect_timeout', 0)
 invalid('replication_connect_quorum', -1)
+invalid('replication_apply_concurrency', 0)
+invalid('replication_apply_concurrency', 1001)
 invalid('wal_mode', 'invalid')
 invalid('listen', '//!')
 invalid('log', ':')
@@ -48,12 +50,19 @@ invalid('vinyl_run_count_per_level', 0)
 invalid('vinyl_run_size_ratio', 1)
 invalid('vinyl_bloom_fpr', 0)
 invalid('vinyl_bloom_fpr', 1.1)
+invalid('vinyl_compaction_io_rate_limit', -1)
 invalid('wal_queue_max_size', -1)
+invalid('wal_relay_buffer_size', -1)
+invalid('wal_io_backend', 'aio')
 invalid('sql_vdbe_max_steps', -1)
 invalid('memtx_sort_threads', 'all')
 invalid('memtx_sort_threads', -1)
 invalid('memtx_sort_threads', 0)
 invalid('memtx_sort_threads', 257)
+invalid('memtx_recovery_threads', -1)
+invalid('memtx_recovery_threads', 65)
+invalid('snap_compression_threads', -1)
+invalid('snap_compression_threads', 65)
 
 local function invalid_combinations(name, val)
     local status, result = pcall(box.cfg, val)
@@ -0,0 +1,101 @@
+local t = require('luatest')
+local cluster = require('luatest.replica_set')
+
+local g = t.group('parallel_apply')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new{}
+    cg.master = cg.cluster:build_and_add_server{alias = 'master'}
+    cg.replica = cg.cluster:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                cg.master.net_box_uri,
+            },
+            replication_apply_concurrency = 8,
+        },
+    }
+    cg.cluster:start()
+    cg.master:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}}})
+        local m = box.schema.space.create('memtx')
+        m:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+local function check(cg)
+    cg.replica:wait_for_vclock_of(cg.master)
+    local data = cg.master:exec(function()
+        return {box.space.test:select(), box.space.memtx:select()}
+    end)
+    cg.replica:exec(function(data)
+        t.assert_equals(box.space.test:select(), data[1])
+        t.assert_equals(box.space.memtx:select(), data[2])
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end, {data})
+end
+
+g.test_parallel_apply = function(cg)
+    -- Accumulate rows on the master so that the replica gets them in
+    -- big batches.
+    cg.replica:exec(function()
+        rawset(_G, 'replication', box.cfg.replication)
+        box.cfg{replication = {}}
+    end)
+    cg.master:exec(function()
+        local s = box.space.test
+        for i = 1, 1000 do
+            s:insert({i, i})
+        end
+        -- Transactions that modify different primary keys but depend
+        -- on each other via the secondary unique index.
+        for i = 1, 500 do
+            s:update({i}, {{'=', 2, i + 10000}})
+            s:insert({i + 1000, i})
+        end
+        for i = 1, 1000, 3 do
+            box.begin()
+            s:delete({i})
+            s:replace({i + 1, i + 20000})
+            box.commit()
+        end
+        for i = 1, 100 do
+            box.space.memtx:replace({i})
+            s:upsert({i, i + 30000}, {{'=', 2, i + 30000}})
+        end
+    end)
+    cg.replica:exec(function()
+        box.cfg{replication = rawget(_G, 'replication')}
+    end)
+    check(cg)
+end
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        t.assert_equals(box.cfg.replication_apply_concurrency, 8)
+        local msg = "Incorrect value for option " ..
+                    "'replication_apply_concurrency': must be greater " ..
+                    "than 0, less than or equal to 1000"
+        t.assert_error_msg_content_equals(msg, box.cfg,
+                                          {replication_apply_concurrency = 0})
+        t.assert_error_msg_content_equals(
+            msg, box.cfg, {replication_apply_concurrency = 1001})
+        box.cfg{replication_apply_concurrency = 1}
+    end)
+    cg.master:exec(function()
+        for i = 1, 100 do
+            box.space.test:replace({i, i + 40000})
+        end
+    end)
+    check(cg)
+    cg.replica:exec(function()
+        box.cfg{replication_apply_concurrency = 8}
+    end)
+end
@@ -0,0 +1,86 @@
+local t = require('luatest')
+local cluster = require('luatest.replica_set')
+
+local g = t.group('wal_relay_buffer')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new{}
+    cg.master = cg.cluster:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            wal_max_size = 32 * 1024,
+            wal_relay_buffer_size = 256 * 1024,
+        },
+    }
+    cg.replica = cg.cluster:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                cg.master.net_box_uri,
+            },
+        },
+    }
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+local function fill(server, first, last)
+    server:exec(function(first, last)
+        for i = first, last do
+            box.space.test:replace({i, string.rep('x', 1000)})
+        end
+    end, {first, last})
+end
+
+local function check(server, count)
+    server:exec(function(count)
+        t.assert_equals(box.space.test:count(), count)
+        for i = 1, count, 97 do
+            t.assert_equals(box.space.test:get(i),
+                            {i, string.rep('x', 1000)})
+        end
+    end, {count})
+end
+
+-- Checks that a replica following the master gets rows from memory,
+-- including the ones written after WAL rotations.
+g.test_follow = function(cg)
+    t.assert_equals(cg.master:exec(function()
+        return box.cfg.wal_relay_buffer_size
+    end), 256 * 1024)
+    fill(cg.master, 1, 100)
+    cg.replica:wait_for_vclock_of(cg.master)
+    check(cg.replica, 100)
+    t.assert(cg.master:grep_log('reading WAL from memory'))
+    t.helpers.retrying({}, cg.replica.assert_follows_upstream, cg.replica, 1)
+end
+
+-- Checks that a replica lagging behind the buffer falls back on
+-- reading WAL files and then switches back to memory.
+g.test_lag = function(cg)
+    cg.replica:stop()
+    fill(cg.master, 101, 1000)
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+    check(cg.replica, 1000)
+    fill(cg.master, 1001, 1100)
+    cg.replica:wait_for_vclock_of(cg.master)
+    check(cg.replica, 1100)
+    t.helpers.retrying({}, cg.replica.assert_follows_upstream, cg.replica, 1)
+end
+
+g.test_cfg = function(cg)
+    cg.master:exec(function()
+        t.assert_error_msg_content_equals(
+            "Can't set option 'wal_relay_buffer_size' dynamically",
+            box.cfg, {wal_relay_buffer_size = 0})
+    end)
+end
@@ -104,6 +104,29 @@ static int compare_key(const elem_t &a, long b)
 #undef bps_tree_key_t
 #undef bps_tree_arg_t
 
+/* tree with order statistics */
+#define BPS_TREE_NAME card
+#define BPS_TREE_BLOCK_SIZE 128 /* value is to low specially for tests */
+#define BPS_TREE_EXTENT_SIZE 2048 /* value is to low specially for tests */
+#define BPS_TREE_IS_IDENTICAL(a, b) (a == b)
+#define BPS_TREE_COMPARE(a, b, arg) compare(a, b)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) compare(a, b)
+#define bps_tree_elem_t type_t
+#define bps_tree_key_t type_t
+#define bps_tree_arg_t int
+#define BPS_INNER_CARD
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+#undef BPS_INNER_CARD
+
 /* tree for approximate_count test */
 #define BPS_TREE_NAME approx
 #define BPS_TREE_BLOCK_SIZE 128 /* value is to low specially for tests */
@@ -901,6 +924,101 @@ insert_successor_test()
 	footer();
 }
 
+/**
+ * Checks offsets returned by the order statistics functions against
+ * a brute force calculation.
+ */
+static void
+order_statistics_check(card *tree, const bool *present, type_t limit)
+{
+	size_t size = card_size(tree);
+	for (type_t key = -1; key <= limit; key++) {
+		size_t less = 0;
+		size_t less_or_equal = 0;
+		for (type_t v = 0; v < limit; v++) {
+			if (!present[v])
+				continue;
+			less += v < key;
+			less_or_equal += v <= key;
+		}
+		size_t offset = SIZE_MAX;
+		bool exact = false;
+		card_iterator itr = card_lower_bound_get_offset(tree, key,
+								&exact,
+								&offset);
+		fail_unless(offset == less);
+		fail_unless(exact == (key >= 0 && key < limit &&
+				      present[key]));
+		fail_unless(card_iterator_is_invalid(&itr) == (less == size));
+		offset = SIZE_MAX;
+		card_upper_bound_get_offset(tree, key, NULL, &offset);
+		fail_unless(offset == less_or_equal);
+	}
+	size_t offset = 0;
+	for (type_t v = 0; v < limit; v++) {
+		if (!present[v])
+			continue;
+		card_iterator itr = card_iterator_at(tree, offset);
+		type_t *elem = card_iterator_get_elem(tree, &itr);
+		fail_unless(elem != NULL && *elem == v);
+		offset++;
+	}
+	fail_unless(offset == size);
+	card_iterator itr = card_iterator_at(tree, size);
+	fail_unless(card_iterator_is_invalid(&itr));
+	fail_unless(card_debug_check(tree) == 0);
+}
+
+static void
+order_statistics_test()
+{
+	header();
+	srand(0);
+
+	const type_t limit = 2000;
+	bool present[limit];
+	card tree;
+
+	/* Random insertions and deletions. */
+	memset(present, 0, sizeof(present));
+	card_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+	for (int i = 0; i < 20000; i++) {
+		type_t v = rand() % limit;
+		/* Grow the tree first, then shrink it. */
+		if (rand() % 100 < (i < 10000 ? 75 : 25)) {
+			card_insert(&tree, v, NULL, NULL);
+			present[v] = true;
+		} else {
+			card_delete(&tree, v);
+			present[v] = false;
+		}
+		if (i % 1000 == 0)
+			order_statistics_check(&tree, present, limit);
+	}
+	order_statistics_check(&tree, present, limit);
+	card_destroy(&tree);
+
+	/* Bulk build and subsequent modifications. */
+	type_t arr[limit / 2];
+	memset(present, 0, sizeof(present));
+	for (type_t i = 0; i < limit / 2; i++) {
+		arr[i] = i * 2;
+		present[i * 2] = true;
+	}
+	card_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+	card_build(&tree, arr, limit / 2);
+	order_statistics_check(&tree, present, limit);
+	for (type_t i = 1; i < limit; i += 4) {
+		card_insert(&tree, i, NULL, NULL);
+		present[i] = true;
+		card_delete(&tree, i - 1);
+		present[i - 1] = false;
+	}
+	order_statistics_check(&tree, present, limit);
+	card_destroy(&tree);
+
+	footer();
+}
 
 int
 main(void)
@@ -918,4 +1036,5 @@ main(void)
 	insert_get_iterator();
 	delete_value_check();
 	insert_successor_test();
+	order_statistics_test();
 }
@@ -3,8 +3,10 @@
 #include <stdbool.h>
 #include <inttypes.h>
 #include <vector>
+#include <algorithm>
 #include <time.h>
 
+#include "trivia/util.h"
 #include "unit.h"
 
 typedef uint64_t hash_value_t;
@@ -321,6 +323,69 @@ iterator_freeze_check()
 	footer();
 }
 
+static void
+build_test()
+{
+	header();
+
+	const size_t counts[] = {1, 7, 8, 9, 100, 1000, 5000};
+	for (size_t c = 0; c < lengthof(counts); c++) {
+		size_t count = counts[c];
+		struct light_core ht;
+		light_create(&ht, light_extent_size,
+			     my_light_alloc, my_light_free, &extents_count, 0);
+		if (light_build_begin(&ht, count) != 0)
+			fail("build begin failed!", "true");
+		/* Every fourth value collides with the previous one. */
+		std::vector<struct light_build_entry> entries;
+		for (size_t i = 0; i < count; i++) {
+			struct light_build_entry entry;
+			entry.value = i;
+			entry.hash = i % 4 == 3 ? hash(i - 1) * 1024 :
+				     hash(i) * 1024;
+			entries.push_back(entry);
+		}
+		std::sort(entries.begin(), entries.end(),
+			  [&ht](const struct light_build_entry &a,
+				const struct light_build_entry &b) {
+				return light_build_slot(&ht, a.hash) <
+				       light_build_slot(&ht, b.hash);
+			  });
+		light_build_end(&ht, entries.data(), count);
+
+		if (light_count(&ht) != count)
+			fail("count check failed!", "true");
+		if (light_selfcheck(&ht))
+			fail("internal test failed!", "true");
+		for (size_t i = 0; i < count; i++) {
+			hash_t h = i % 4 == 3 ? hash(i - 1) * 1024 :
+				   hash(i) * 1024;
+			if (light_find(&ht, h, i) == light_end)
+				fail("find key failed!", "true");
+		}
+		/* The table must be usable as usual after the build. */
+		for (size_t i = count; i < 2 * count; i++)
+			light_insert(&ht, hash(i) * 1024, i);
+		if (light_count(&ht) != 2 * count)
+			fail("count check failed!", "true");
+		if (light_selfcheck(&ht))
+			fail("internal test failed!", "true");
+		for (size_t i = 0; i < count; i++) {
+			hash_t h = i % 4 == 3 ? hash(i - 1) * 1024 :
+				   hash(i) * 1024;
+			if (light_delete_value(&ht, h, i) != 0)
+				fail("delete failed!", "true");
+		}
+		if (light_count(&ht) != count)
+			fail("count check failed!", "true");
+		if (light_selfcheck(&ht))
+			fail("internal test failed!", "true");
+		light_destroy(&ht);
+	}
+
+	footer();
+}
+
 int
 main(int, const char**)
 {
@@ -329,6 +394,7 @@ main(int, const char**)
 	collision_test();
 	iterator_test();
 	iterator_freeze_check();
+	build_test();
 	if (extents_count != 0)
 		fail("memory leak!", "true");
 }
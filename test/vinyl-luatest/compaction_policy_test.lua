@@ -0,0 +1,123 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Writes a big run followed by three small runs of the same size.
+local function write_runs(policy)
+    local s = box.schema.space.create('test', {engine = 'vinyl'})
+    local i = s:create_index('pk', {
+        compaction_policy = policy, run_count_per_level = 5,
+    })
+    for k = 1, 1000 do
+        s:replace({k, string.rep('x', 100)})
+    end
+    box.snapshot()
+    for _ = 1, 3 do
+        for k = 1, 10 do
+            s:replace({k, string.rep('y', 100)})
+        end
+        box.snapshot()
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(i:stat().disk.compaction.queue.rows, 0)
+    end)
+    return i:stat()
+end
+
+g.test_tiered = function(cg)
+    local stat = cg.server:exec(write_runs, {'tiered'})
+    t.assert_equals(stat.run_count, 4)
+    t.assert_equals(stat.disk.compaction.count, 0)
+    t.assert_equals(stat.amplification.read, 4)
+end
+
+g.test_leveled = function(cg)
+    local stat = cg.server:exec(write_runs, {'leveled'})
+    t.assert_lt(stat.run_count, 4)
+    t.assert_ge(stat.disk.compaction.count, 1)
+    cg.server:exec(function()
+        t.assert_equals(box.space.test.index.pk.options.compaction_policy,
+                        'leveled')
+    end)
+end
+
+g.test_time_window = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {
+            compaction_policy = 'time_window', compaction_window = 1,
+            run_count_per_level = 1,
+        })
+        t.assert_equals(i.options.compaction_window, 1)
+        -- Runs dumped in different windows aren't merged.
+        for k = 1, 3 do
+            s:replace({k})
+            box.snapshot()
+            fiber.sleep(1.1)
+        end
+        t.assert_equals(i:stat().run_count, 3)
+        t.assert_equals(i:stat().disk.compaction.count, 0)
+
+        -- Runs dumped in the same window are merged.
+        i:alter({compaction_window = 1e9})
+        i = s.index.pk
+        for k = 4, 6 do
+            s:replace({k})
+            box.snapshot()
+        end
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().disk.compaction.queue.rows, 0)
+            t.assert_gt(i:stat().disk.compaction.count, 0)
+        end)
+        t.assert_equals(s:select(), {{1}, {2}, {3}, {4}, {5}, {6}})
+    end)
+end
+
+g.test_amplification = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk')
+        t.assert_equals(i:stat().amplification,
+                        {write = 0, read = 0, space = 0})
+        for k = 1, 100 do
+            s:replace({k, k})
+        end
+        box.snapshot()
+        local stat = i:stat().amplification
+        t.assert_gt(stat.write, 0)
+        t.assert_equals(stat.read, 1)
+        t.assert_equals(stat.space, 1)
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Wrong index options: compaction_policy must be one of " ..
+            "'tiered', 'leveled', 'time_window'",
+            s.create_index, s, 'pk', {compaction_policy = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Wrong index options: compaction_window must be greater than 0",
+            s.create_index, s, 'pk', {compaction_window = 0})
+    end)
+end
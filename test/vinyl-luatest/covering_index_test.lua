@@ -0,0 +1,134 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "primary index can't be covering",
+            s.create_index, s, 'pk', {covering = true})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "multikey index can't be covering",
+            s.create_index, s, 'sk', {
+                covering = true, parts = {{'[2][*]', 'unsigned'}},
+            })
+        local sk = s:create_index('sk', {
+            covering = true, parts = {{2, 'unsigned'}},
+        })
+        t.assert_equals(sk.covering, true)
+        t.assert_equals(s.index.pk.covering, nil)
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "covering index can't be used in a space with defer_deletes",
+            s.alter, s, {defer_deletes = true})
+        sk:alter({covering = false})
+        s:alter({defer_deletes = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "covering index can't be used in a space with defer_deletes",
+            sk.alter, sk, {covering = true})
+        s:alter({defer_deletes = false, ttl = 60, ttl_field = 3})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "covering index can't be used in a space with ttl",
+            sk.alter, sk, {covering = true})
+        s:alter({ttl = 0})
+        sk:alter({covering = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "covering index can't be used in a space with ttl",
+            s.alter, s, {ttl = 60})
+    end)
+end
+
+g.test_covering = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {
+            covering = true, unique = false, parts = {{2, 'unsigned'}},
+        })
+        for i = 1, 100 do
+            s:insert({i, i % 10, i})
+        end
+        box.snapshot()
+        -- Key parts unchanged.
+        for i = 1, 100, 2 do
+            s:update(i, {{'=', 3, i * 10}})
+        end
+        -- Key parts changed.
+        for i = 1, 100, 3 do
+            s:update(i, {{'+', 2, 10}})
+        end
+        for i = 1, 100, 5 do
+            s:replace({i, i % 10, -i})
+        end
+        box.begin()
+        for i = 1, 100, 7 do
+            s:update(i, {{'=', 3, 0}})
+            s:update(i, {{'=', 3, 1}})
+        end
+        for i = 4, 100, 11 do
+            s:update(i, {{'=', 3, 0}})
+            s:delete(i)
+        end
+        box.commit()
+        box.snapshot()
+    end)
+    local function check()
+        local s = box.space.test
+        local expected = s.index.pk:select()
+        table.sort(expected, function(a, b)
+            return a[2] < b[2] or (a[2] == b[2] and a[1] < b[1])
+        end)
+        local lookup = s.index.pk:stat().lookup
+        t.assert_equals(s.index.sk:select(), expected)
+        for k = 0, 19 do
+            local tuples = {}
+            for _, tuple in ipairs(expected) do
+                if tuple[2] == k then
+                    table.insert(tuples, tuple)
+                end
+            end
+            t.assert_equals(s.index.sk:select({k}), tuples)
+        end
+        -- Reads from the covering index don't touch the primary index.
+        t.assert_equals(s.index.pk:stat().lookup, lookup)
+    end
+    cg.server:exec(check)
+    cg.server:restart()
+    cg.server:exec(check)
+    cg.server:exec(function()
+        local s = box.space.test
+        s.index.sk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.sk:stat().disk.compaction.queue.rows, 0)
+        end)
+    end)
+    cg.server:exec(check)
+end
@@ -0,0 +1,107 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {vinyl_cache = 0, vinyl_page_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_page_cache = 0})
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_page_cache = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024, run_count_per_level = 100})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+
+        -- The cache is disabled by default.
+        box.stat.reset()
+        for i = 1, 1000 do
+            s:get(i)
+        end
+        t.assert_equals(box.stat.vinyl().page_cache, {
+            lookup = 0, hit = 0, put = 0, evict = 0,
+        })
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+
+        box.cfg({vinyl_page_cache = 10 * 1024 * 1024})
+        for i = 1, 1000 do
+            t.assert_equals(s:get(i), {i, string.rep('x', 100)})
+        end
+        local stat = box.stat.vinyl().page_cache
+        t.assert_gt(stat.put, 0)
+        t.assert_equals(stat.evict, 0)
+        t.assert_gt(box.stat.vinyl().memory.page_cache, 0)
+
+        -- Subsequent lookups are served from the cache.
+        box.stat.reset()
+        for i = 1, 1000 do
+            t.assert_equals(s:get(i), {i, string.rep('x', 100)})
+        end
+        stat = box.stat.vinyl().page_cache
+        t.assert_equals(stat.put, 0)
+        t.assert_equals(stat.hit, stat.lookup)
+        t.assert_gt(stat.hit, 0)
+        t.assert_equals(s.index.pk:stat().disk.iterator.read.rows, 0)
+
+        -- Pages are evicted when the cache size is reduced.
+        box.cfg({vinyl_page_cache = 16 * 1024})
+        stat = box.stat.vinyl().page_cache
+        t.assert_gt(stat.evict, 0)
+        t.assert_le(box.stat.vinyl().memory.page_cache, 16 * 1024)
+        for i = 1, 1000 do
+            t.assert_equals(s:get(i), {i, string.rep('x', 100)})
+        end
+        t.assert_le(box.stat.vinyl().memory.page_cache, 16 * 1024)
+
+        -- The cache is freed when disabled.
+        box.cfg({vinyl_page_cache = 0})
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+    end)
+end
+
+g.test_compaction = function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_page_cache = 10 * 1024 * 1024})
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024})
+        for i = 1, 100 do
+            s:insert({i, i})
+        end
+        box.snapshot()
+        for i = 1, 100 do
+            s:get(i)
+        end
+        for i = 1, 100 do
+            s:replace({i, i * 2})
+        end
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.rows, 0)
+        end)
+        -- Pages of the compacted runs aren't returned.
+        for i = 1, 100 do
+            t.assert_equals(s:get(i), {i, i * 2})
+        end
+    end)
+end
@@ -0,0 +1,122 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {vinyl_cache = 0, vinyl_partition_page_index = true},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_page_index_cache = 128 * 1024 * 1024})
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that all the data stored in the test space can be read.
+-- Only even keys from 2 to 2 * count are stored.
+local function check_reads(count)
+    local s = box.space.test
+    local function value(i)
+        return {i, string.rep('x', 100)}
+    end
+    for i = 1, 2 * count + 1 do
+        t.assert_equals(s:get(i), i % 2 == 0 and value(i) or nil)
+    end
+    local result = s:select({}, {fullscan = true})
+    t.assert_equals(#result, count)
+    t.assert_equals(result[1], value(2))
+    t.assert_equals(result[count], value(2 * count))
+    result = s:select({}, {iterator = 'lt', fullscan = true})
+    t.assert_equals(#result, count)
+    t.assert_equals(result[1], value(2 * count))
+    t.assert_equals(result[count], value(2))
+    t.assert_equals(s:select({count - 1}, {iterator = 'ge', limit = 3}),
+                    {value(count), value(count + 2), value(count + 4)})
+    t.assert_equals(s:select({count + 1}, {iterator = 'le', limit = 3}),
+                    {value(count), value(count - 2), value(count - 4)})
+end
+
+g.test_partitioned_index = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024, run_count_per_level = 100})
+        for i = 1, 3000 do
+            s:insert({2 * i, string.rep('x', 100)})
+        end
+        box.snapshot()
+        t.assert_gt(s.index.pk:stat().disk.pages, 3 * 128)
+    end)
+    cg.server:exec(check_reads, {3000})
+    cg.server:exec(function()
+        local s = box.space.test
+        local stat = box.stat.vinyl().page_index_cache
+        t.assert_gt(stat.lookup, stat.put)
+        t.assert_gt(stat.put, 2)
+        t.assert_equals(stat.evict, 0)
+        t.assert_gt(box.stat.vinyl().memory.page_index_cache, 0)
+        -- Missing keys are filtered out by partition bloom filters.
+        t.assert_gt(s.index.pk:stat().disk.iterator.bloom.hit, 0)
+
+        -- Partitions are evicted when the cache size is reduced.
+        box.cfg({vinyl_page_index_cache = 0})
+        t.assert_equals(box.stat.vinyl().memory.page_index_cache, 0)
+        t.assert_gt(box.stat.vinyl().page_index_cache.evict, 0)
+    end)
+    cg.server:exec(check_reads, {3000})
+    cg.server:restart()
+    cg.server:exec(check_reads, {3000})
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_gt(s.index.pk:stat().disk.pages, 3 * 128)
+        -- Compaction of a partitioned run.
+        for i = 1, 3000, 2 do
+            s:replace({2 * i, string.rep('x', 100)})
+        end
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.rows, 0)
+        end)
+        t.assert_equals(s.index.pk:stat().run_count, 1)
+    end)
+    cg.server:exec(check_reads, {3000})
+end
+
+-- Checks that large runs are written in the old format unless
+-- vinyl_partition_page_index is set.
+g.test_partitioning_disabled = function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_partition_page_index = false})
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024})
+        for i = 1, 3000 do
+            s:insert({2 * i, string.rep('x', 100)})
+        end
+        box.snapshot()
+        box.cfg({vinyl_partition_page_index = true})
+        t.assert_gt(s.index.pk:stat().disk.pages, 3 * 128)
+    end)
+    local function lookup()
+        return cg.server:exec(function()
+            return box.stat.vinyl().page_index_cache.lookup
+        end)
+    end
+    local count = lookup()
+    cg.server:exec(check_reads, {3000})
+    t.assert_equals(lookup(), count)
+    cg.server:restart()
+    cg.server:exec(check_reads, {3000})
+    t.assert_equals(lookup(), 0)
+end
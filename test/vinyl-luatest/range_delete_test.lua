@@ -0,0 +1,141 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Returns primary keys of all tuples stored in the test space.
+local function keys()
+    local result = {}
+    for _, tuple in box.space.test:pairs() do
+        table.insert(result, tuple[1])
+    end
+    return result
+end
+
+g.test_range_delete = function(cg)
+    cg.server:exec(function(keys)
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 100})
+        for i = 1, 10 do
+            s:insert({i})
+        end
+        box.snapshot()
+        for i = 11, 20 do
+            s:insert({i})
+        end
+        s:delete_range({3}, {8})
+        t.assert_equals(keys(), {1, 2, 8, 9, 10, 11, 12, 13, 14, 15,
+                                 16, 17, 18, 19, 20})
+        t.assert_equals(s:get(3), nil)
+        t.assert_equals(s:get(8), {8})
+        t.assert_equals(s:select({5}, {iterator = 'le'}), {{2}, {1}})
+
+        -- Tuples inserted after a range delete are visible.
+        s:insert({5})
+        t.assert_equals(s:get(5), {5})
+
+        -- The end of a range may be omitted.
+        s:delete_range({15})
+        t.assert_equals(keys(), {1, 2, 5, 8, 9, 10, 11, 12, 13, 14})
+        box.snapshot()
+        t.assert_equals(keys(), {1, 2, 5, 8, 9, 10, 11, 12, 13, 14})
+    end, {keys})
+    cg.server:restart()
+    cg.server:exec(function(keys)
+        local s = box.space.test
+        t.assert_equals(keys(), {1, 2, 5, 8, 9, 10, 11, 12, 13, 14})
+        -- Range deletes replayed from WAL are applied, too.
+        s:delete_range({}, {9})
+    end, {keys})
+    cg.server:restart()
+    cg.server:exec(function(keys)
+        local s = box.space.test
+        t.assert_equals(keys(), {9, 10, 11, 12, 13, 14})
+        -- Compaction reclaims deleted tuples and range deletes.
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.rows, 0)
+        end)
+        t.assert_equals(s.index.pk:stat().run_count, 1)
+        t.assert_equals(s.index.pk:stat().disk.rows, 6)
+        t.assert_equals(keys(), {9, 10, 11, 12, 13, 14})
+    end, {keys})
+end
+
+g.test_read_view = function(cg)
+    cg.server:exec(function(keys)
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 5 do
+            s:insert({i})
+        end
+        -- A transaction that read a deleted range is sent to a read view.
+        local ch = fiber.channel(1)
+        fiber.create(function()
+            box.begin()
+            local before = keys()
+            ch:get()
+            local after = keys()
+            box.commit()
+            ch:put({before, after})
+        end)
+        s:delete_range({2}, {4})
+        ch:put(true)
+        t.assert_equals(ch:get(), {{1, 2, 3, 4, 5}, {1, 2, 3, 4, 5}})
+        t.assert_equals(keys(), {1, 4, 5})
+    end, {keys})
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "memtx does not support range delete",
+            s.delete_range, s, {1}, {2})
+        s:drop()
+
+        s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Supplied key type of part 0 does not match index part type: " ..
+            "expected unsigned",
+            s.delete_range, s, {'x'}, {2})
+        box.begin()
+        s:insert({1})
+        t.assert_error_msg_content_equals(
+            "Can not perform range delete in a multi-statement transaction",
+            s.delete_range, s, {1}, {2})
+        box.rollback()
+        box.begin()
+        s:delete_range({1}, {2})
+        t.assert_error_msg_content_equals(
+            "Can not perform range delete in a multi-statement transaction",
+            s.insert, s, {1})
+        box.rollback()
+        s:create_index('sk', {parts = {{1, 'unsigned'}}})
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support range delete in spaces " ..
+            "with secondary indexes",
+            s.delete_range, s, {1}, {2})
+    end)
+end
@@ -0,0 +1,118 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        -- One dump thread and one compaction thread.
+        box_cfg = {vinyl_write_threads = 2, vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({vinyl_compaction_io_rate_limit = 0})
+        for _, name in ipairs({'test', 'blocker', 'cold', 'hot'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_compaction_io_rate_limit = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_compaction_io_rate_limit': " ..
+            "should be of type number", box.cfg,
+            {vinyl_compaction_io_rate_limit = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_compaction_io_rate_limit': " ..
+            "the value must be greater than or equal to 0", box.cfg,
+            {vinyl_compaction_io_rate_limit = -1})
+        box.cfg({vinyl_compaction_io_rate_limit = 1})
+        t.assert_equals(box.cfg.vinyl_compaction_io_rate_limit, 1)
+
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 2 do
+            for j = 1, 1000 do
+                s:replace({j, i})
+            end
+            box.snapshot()
+        end
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.rows, 0)
+        end)
+        t.assert_equals(s.index.pk:stat().run_count, 1)
+        t.assert_equals(s:count(), 1000)
+        t.assert_equals(s:get(500), {500, 2})
+    end)
+end
+
+-- Checks that ranges that are hot for reads are compacted first.
+g.test_read_aware_compaction = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local function create(name)
+            local s = box.schema.space.create(name, {engine = 'vinyl'})
+            s:create_index('pk', {run_count_per_level = 1})
+            return s
+        end
+        local function fill(s, value)
+            for i = 1, 50 do
+                s:replace({i, value})
+            end
+        end
+        local function compaction_count(s)
+            return s.index.pk:stat().disk.compaction.count
+        end
+
+        -- Occupy the only compaction thread.
+        box.error.injection.set('ERRINJ_VY_COMPACTION_DELAY', true)
+        local blocker = create('blocker')
+        fill(blocker, 1)
+        box.snapshot()
+        fill(blocker, 2)
+        box.snapshot()
+
+        local cold = create('cold')
+        local hot = create('hot')
+        fill(cold, 1)
+        fill(hot, 1)
+        box.snapshot()
+        for _ = 1, 5 do
+            for i = 1, 50 do
+                t.assert_equals(hot:get(i), {i, 1})
+            end
+        end
+        fill(cold, 2)
+        fill(hot, 2)
+        box.snapshot()
+        t.assert_equals(cold.index.pk:stat().run_count, 2)
+        t.assert_equals(hot.index.pk:stat().run_count, 2)
+
+        -- Slow down compaction to check the order.
+        box.error.injection.set('ERRINJ_VY_RUN_WRITE_STMT_TIMEOUT', 0.005)
+        box.error.injection.set('ERRINJ_VY_COMPACTION_DELAY', false)
+        while compaction_count(hot) + compaction_count(cold) == 0 do
+            fiber.sleep(0.001)
+        end
+        t.assert_equals(compaction_count(hot), 1)
+        t.assert_equals(compaction_count(cold), 0)
+        box.error.injection.set('ERRINJ_VY_RUN_WRITE_STMT_TIMEOUT', 0)
+        t.helpers.retrying({}, function()
+            t.assert_equals(compaction_count(cold), 1)
+        end)
+        t.assert_equals(cold:select(), hot:select())
+    end)
+end
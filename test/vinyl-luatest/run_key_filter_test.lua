@@ -0,0 +1,94 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that ITER_REQ prefix scans use bloom filters.
+g.test_req_bloom = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {parts = {{1, 'unsigned'}, {2, 'unsigned'}}})
+        for i = 1, 99, 2 do
+            for j = 1, 5 do
+                s:insert({i, j})
+            end
+        end
+        box.snapshot()
+
+        local function bloom_hit()
+            return s.index.pk:stat().disk.iterator.bloom.hit
+        end
+        local hit = bloom_hit()
+        for i = 2, 98, 2 do
+            t.assert_equals(s:select({i}, {iterator = 'REQ'}), {})
+        end
+        t.assert_gt(bloom_hit(), hit)
+
+        hit = bloom_hit()
+        t.assert_equals(s:select({3}, {iterator = 'REQ'}),
+                        {{3, 5}, {3, 4}, {3, 3}, {3, 2}, {3, 1}})
+        t.assert_equals(s:select({3, 2}, {iterator = 'REQ'}), {{3, 2}})
+        t.assert_equals(bloom_hit(), hit)
+    end)
+end
+
+-- Checks that runs are skipped if the search key is out of their range.
+g.test_key_range = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {parts = {{1, 'unsigned'}, {2, 'unsigned'}}})
+        for i = 10, 20 do
+            s:insert({i, i})
+        end
+        box.snapshot()
+
+        local function lookup()
+            return s.index.pk:stat().disk.iterator.lookup
+        end
+        local function skip()
+            return s.index.pk:stat().disk.iterator.skip
+        end
+        local count = lookup()
+        local skipped = skip()
+        t.assert_equals(s:select({21}, {iterator = 'GE'}), {})
+        t.assert_equals(s:select({20}, {iterator = 'GT'}), {})
+        t.assert_equals(s:select({9}, {iterator = 'LE'}), {})
+        t.assert_equals(s:select({10}, {iterator = 'LT'}), {})
+        t.assert_equals(s:select({5}, {iterator = 'EQ'}), {})
+        t.assert_equals(s:select({25}, {iterator = 'REQ'}), {})
+        t.assert_equals(s:get({30, 30}), nil)
+        t.assert_equals(lookup(), count)
+        t.assert_equals(skip(), skipped + 7)
+        skipped = skip()
+
+        t.assert_equals(s:select({20}, {iterator = 'GE'}), {{20, 20}})
+        t.assert_equals(s:select({19}, {iterator = 'GT'}), {{20, 20}})
+        t.assert_equals(s:select({10}, {iterator = 'LE'}), {{10, 10}})
+        t.assert_equals(s:select({11}, {iterator = 'LT'}), {{10, 10}})
+        t.assert_equals(s:select({10}, {iterator = 'EQ'}), {{10, 10}})
+        t.assert_equals(s:select({20}, {iterator = 'REQ'}), {{20, 20}})
+        t.assert_gt(lookup(), count)
+        t.assert_equals(skip(), skipped)
+        t.assert_equals(s:count(), 11)
+    end)
+end
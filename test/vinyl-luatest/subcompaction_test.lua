@@ -0,0 +1,84 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {vinyl_write_threads = 8},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_subcompaction = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {
+            range_size = 64 * 1024, page_size = 1024,
+            run_count_per_level = 100,
+        })
+        s:create_index('sk', {
+            parts = {{2, 'unsigned'}}, range_size = 64 * 1024,
+            page_size = 1024, run_count_per_level = 100,
+        })
+        for i = 1, 10000 do
+            s:insert({i, i, string.rep('x', 100)})
+        end
+        box.snapshot()
+        for i = 1, 10000, 2 do
+            s:replace({i, i + 10000, string.rep('y', 100)})
+        end
+        for i = 1, 10000, 3 do
+            s:delete(i)
+        end
+        box.snapshot()
+        t.assert_equals(s.index.pk:stat().range_count, 1)
+
+        -- The compacted range is replaced with a range per part.
+        for _, name in ipairs({'pk', 'sk'}) do
+            local i = s.index[name]
+            i:compact()
+            t.helpers.retrying({}, function()
+                t.assert_equals(i:stat().disk.compaction.queue.rows, 0)
+            end)
+            local stat = i:stat()
+            t.assert_gt(stat.range_count, 1, name)
+            t.assert_equals(stat.run_count, stat.range_count, name)
+        end
+    end)
+    local function check()
+        local s = box.space.test
+        local count = 0
+        for i = 1, 10000 do
+            local tuple = s:get(i)
+            if i % 3 == 1 then
+                t.assert_equals(tuple, nil)
+            else
+                count = count + 1
+                local v = i % 2 == 1 and {i, i + 10000, string.rep('y', 100)}
+                                      or {i, i, string.rep('x', 100)}
+                t.assert_equals(tuple, v)
+                t.assert_equals(s.index.sk:get(v[2]), v)
+            end
+        end
+        t.assert_equals(s:count(), count)
+        t.assert_equals(s.index.sk:count(), count)
+        t.assert_equals(#s:select({}, {fullscan = true}), count)
+    end
+    cg.server:exec(check)
+    cg.server:restart()
+    cg.server:exec(check)
+end
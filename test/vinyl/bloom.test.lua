@@ -21,7 +21,7 @@ s = box.schema.space.create('test', {engine = 'vinyl'})
 _ = s:create_index('pk', {parts = {1, 'unsigned', 2, 'unsigned', 3, 'unsigned', 4, 'unsigned'}})
 
 reflects = 0
-function cur_reflects() return box.space.test.index.pk:stat().disk.iterator.bloom.hit end
+function cur_reflects() local st = box.space.test.index.pk:stat().disk.iterator return st.bloom.hit + st.skip end
 function new_reflects() local o = reflects reflects = cur_reflects() return reflects - o end
 seeks = 0
 function cur_seeks() return box.space.test.index.pk:stat().disk.iterator.lookup end
@@ -89,7 +89,7 @@ box.cfg{vinyl_cache = 0}
 s = box.space.test
 
 reflects = 0
-function cur_reflects() return box.space.test.index.pk:stat().disk.iterator.bloom.hit end
+function cur_reflects() local st = box.space.test.index.pk:stat().disk.iterator return st.bloom.hit + st.skip end
 function new_reflects() local o = reflects reflects = cur_reflects() return reflects - o end
 seeks = 0
 function cur_seeks() return box.space.test.index.pk:stat().disk.iterator.lookup end
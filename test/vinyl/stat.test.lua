@@ -68,13 +68,15 @@ end;
 -- Return index statistics.
 --
 -- Note, latency measurement is beyond the scope of this test
--- so we just filter it out.
+-- so we just filter it out. Amplification is derived from other
+-- statistics so we filter it out, too.
 --
 -- Filter dump/compaction time as we need error injection to
 -- test them properly.
 function istat()
     local st = box.space.test.index.pk:stat()
     st.latency = nil
+    st.amplification = nil
     st.disk.dump.time = nil
     st.disk.compaction.time = nil
     return st
@@ -93,6 +95,10 @@ function gstat()
     st.scheduler.dump_time = nil
     st.scheduler.compaction_time = nil
     st.memory.level0 = nil
+    st.memory.page_cache = nil
+    st.memory.page_index_cache = nil
+    st.page_cache = nil
+    st.page_index_cache = nil
     return st
 end;
 